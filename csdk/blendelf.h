@@ -158,7 +158,23 @@
 #define ELF_LIST_PTR 0x0048
 #define ELF_RESOURCES 0x0049
 #define ELF_RENDER_STATION 0x004A
-#define ELF_OBJECT_TYPE_COUNT 0x004B
+#define ELF_ARRAY 0x004B
+#define ELF_JOB_QUEUE 0x004C
+#define ELF_SCENE_LOADER 0x004D
+#define ELF_PROFILER 0x004E
+#define ELF_PAK_MAPPING 0x004F
+#define ELF_OBJECT_TYPE_COUNT 0x0050
+#define ELF_MAX_JOB_THREADS 32
+#define ELF_BVH_LEAF_BUILD_SIZE 4
+#define ELF_BVH_LEAF_SIZE 8
+#define ELF_BVH_REBUILD_RATIO 4
+#define ELF_MAX_ARMATURE_LAYERS 4
+#define ELF_MAX_TEXT_BATCHES 64
+#define ELF_FRAME_TIME_SAMPLES 256
+#define ELF_FRAME_SPIN_TIME 0.002f
+#define ELF_PROFILE_FRAMES 64
+#define ELF_MAX_PROFILE_SCOPES 128
+#define ELF_MAX_PROFILE_DEPTH 16
 #define ELF_PERSPECTIVE 0x0000
 #define ELF_ORTHOGRAPHIC 0x0001
 #define ELF_BOX 0x0000
@@ -253,6 +269,9 @@
 #define ELF_QUA_W 0x000C
 #define ELF_OGG 0x0001
 #define ELF_WAV 0x0002
+#define ELF_SCRIPT_GC_FULL 0x0000
+#define ELF_SCRIPT_GC_STEP 0x0001
+#define ELF_SCRIPT_GC_AUTO 0x0002
 #define ELF_NO_ERROR 0x0000
 #define ELF_INVALID_FILE 0x0001
 #define ELF_CANT_OPEN_FILE 0x0002
@@ -354,6 +373,7 @@ typedef struct elfVertex				elfVertex;
 typedef struct elfFace					elfFace;
 typedef struct elfMeshData				elfMeshData;
 typedef struct elfRenderStation				elfRenderStation;
+typedef struct elfSceneLoader				elfSceneLoader;
 struct elfVec2i {
 	int x;
 	int y;
@@ -404,18 +424,40 @@ ELF_API void ELF_APIENTRY elfSetConfigWindowSize(elfConfig* config, int width, i
 ELF_API void ELF_APIENTRY elfSetConfigMultisamples(elfConfig* config, int multisamples);
 ELF_API void ELF_APIENTRY elfSetConfigFullscreen(elfConfig* config, unsigned char fullscreen);
 ELF_API void ELF_APIENTRY elfSetConfigTextureCompress(elfConfig* config, unsigned char textureCompress);
+ELF_API void ELF_APIENTRY elfSetConfigSaveTextureCompress(elfConfig* config, unsigned char saveTextureCompress);
 ELF_API void ELF_APIENTRY elfSetConfigTextureAnisotropy(elfConfig* config, float textureAnisotropy);
 ELF_API void ELF_APIENTRY elfSetConfigShadowMapSize(elfConfig* config, int shadowMapSize);
 ELF_API void ELF_APIENTRY elfSetConfigStart(elfConfig* config, const char* start);
 ELF_API void ELF_APIENTRY elfSetConfigLogPath(elfConfig* config, const char* logPath);
+ELF_API void ELF_APIENTRY elfSetConfigScriptGcMode(elfConfig* config, int mode);
+ELF_API void ELF_APIENTRY elfSetConfigScriptGcBudget(elfConfig* config, int budget);
+ELF_API void ELF_APIENTRY elfSetConfigThreadCount(elfConfig* config, int count);
+ELF_API void ELF_APIENTRY elfSetConfigMapPaks(elfConfig* config, unsigned char mapPaks);
+ELF_API void ELF_APIENTRY elfSetConfigLoadBudget(elfConfig* config, float loadBudget);
+ELF_API void ELF_APIENTRY elfSetConfigAnimationTolerance(elfConfig* config, float tolerance);
+ELF_API void ELF_APIENTRY elfSetConfigStepRate(elfConfig* config, float stepRate);
+ELF_API void ELF_APIENTRY elfSetConfigMaxSteps(elfConfig* config, int maxSteps);
+ELF_API void ELF_APIENTRY elfSetConfigHeadless(elfConfig* config, unsigned char headless);
+ELF_API void ELF_APIENTRY elfSetConfigBenchmarkTicks(elfConfig* config, int ticks);
 ELF_API elfVec2i ELF_APIENTRY elfGetConfigWindowSize(elfConfig* config);
 ELF_API int ELF_APIENTRY elfGetConfigMultisamples(elfConfig* config);
 ELF_API unsigned char ELF_APIENTRY elfGetConfigFullscreen(elfConfig* config);
 ELF_API unsigned char ELF_APIENTRY elfGetConfigTextureCompress(elfConfig* config);
+ELF_API unsigned char ELF_APIENTRY elfGetConfigSaveTextureCompress(elfConfig* config);
 ELF_API float ELF_APIENTRY elfGetConfigTextureAnisotropy(elfConfig* config);
 ELF_API int ELF_APIENTRY elfGetConfigShadowMapSize(elfConfig* config);
 ELF_API const char* ELF_APIENTRY elfGetConfigStart(elfConfig* config);
 ELF_API const char* ELF_APIENTRY elfGetConfigLogPath(elfConfig* config);
+ELF_API int ELF_APIENTRY elfGetConfigScriptGcMode(elfConfig* config);
+ELF_API int ELF_APIENTRY elfGetConfigScriptGcBudget(elfConfig* config);
+ELF_API int ELF_APIENTRY elfGetConfigThreadCount(elfConfig* config);
+ELF_API unsigned char ELF_APIENTRY elfGetConfigMapPaks(elfConfig* config);
+ELF_API float ELF_APIENTRY elfGetConfigLoadBudget(elfConfig* config);
+ELF_API float ELF_APIENTRY elfGetConfigAnimationTolerance(elfConfig* config);
+ELF_API float ELF_APIENTRY elfGetConfigStepRate(elfConfig* config);
+ELF_API int ELF_APIENTRY elfGetConfigMaxSteps(elfConfig* config);
+ELF_API unsigned char ELF_APIENTRY elfGetConfigHeadless(elfConfig* config);
+ELF_API int ELF_APIENTRY elfGetConfigBenchmarkTicks(elfConfig* config);
 ELF_API void ELF_APIENTRY elfWriteLogLine(const char* str);
 ELF_API void ELF_APIENTRY elfSetTitle(const char* title);
 ELF_API int ELF_APIENTRY elfGetWindowWidth();
@@ -456,15 +498,20 @@ ELF_API const char* ELF_APIENTRY elfGetErrorString();
 ELF_API int ELF_APIENTRY elfGetError();
 ELF_API unsigned char ELF_APIENTRY elfRun();
 ELF_API void ELF_APIENTRY elfQuit();
+ELF_API unsigned char ELF_APIENTRY elfIsHeadless();
+ELF_API float ELF_APIENTRY elfBenchmark(int ticks);
 ELF_API void ELF_APIENTRY elfSetF10Exit(unsigned char exit);
 ELF_API unsigned char ELF_APIENTRY elfGetF10Exit();
 ELF_API elfScene* ELF_APIENTRY elfLoadScene(const char* filePath);
+ELF_API elfSceneLoader* ELF_APIENTRY elfLoadSceneAsync(const char* filePath);
+ELF_API elfSceneLoader* ELF_APIENTRY elfGetSceneLoader();
 ELF_API void ELF_APIENTRY elfSetScene(elfScene* scene);
 ELF_API elfScene* ELF_APIENTRY elfGetScene();
 ELF_API void ELF_APIENTRY elfSetGui(elfGui* gui);
 ELF_API elfGui* ELF_APIENTRY elfGetGui();
 ELF_API float ELF_APIENTRY elfGetSync();
 ELF_API int ELF_APIENTRY elfGetFps();
+ELF_API float ELF_APIENTRY elfGetFrameTimePercentile(float percentile);
 ELF_API unsigned char ELF_APIENTRY elfSaveScreenShot(const char* filePath);
 ELF_API void ELF_APIENTRY elfSetFpsLimit(float fpsLimit);
 ELF_API float ELF_APIENTRY elfGetFpsLimit();
@@ -472,13 +519,35 @@ ELF_API void ELF_APIENTRY elfSetTickRate(float tickRate);
 ELF_API float ELF_APIENTRY elfGetTickRate();
 ELF_API void ELF_APIENTRY elfSetSpeed(float speed);
 ELF_API float ELF_APIENTRY elfGetSpeed();
+ELF_API void ELF_APIENTRY elfSetStepRate(float stepRate);
+ELF_API float ELF_APIENTRY elfGetStepRate();
+ELF_API void ELF_APIENTRY elfSetMaxSteps(int maxSteps);
+ELF_API int ELF_APIENTRY elfGetMaxSteps();
+ELF_API int ELF_APIENTRY elfGetSteps();
+ELF_API float ELF_APIENTRY elfGetStepAlpha();
+ELF_API void ELF_APIENTRY elfSetScriptGcMode(int mode);
+ELF_API int ELF_APIENTRY elfGetScriptGcMode();
+ELF_API void ELF_APIENTRY elfSetScriptGcBudget(int budget);
+ELF_API int ELF_APIENTRY elfGetScriptGcBudget();
+ELF_API int ELF_APIENTRY elfGetThreadCount();
 ELF_API void ELF_APIENTRY elfSetTextureCompress(unsigned char compress);
 ELF_API unsigned char ELF_APIENTRY elfGetTextureCompress();
+ELF_API void ELF_APIENTRY elfSetSaveTextureCompress(unsigned char compress);
+ELF_API unsigned char ELF_APIENTRY elfGetSaveTextureCompress();
+ELF_API void ELF_APIENTRY elfSetMapPaks(unsigned char mapPaks);
+ELF_API unsigned char ELF_APIENTRY elfGetMapPaks();
 ELF_API void ELF_APIENTRY elfSetTextureAnisotropy(float anisotropy);
 ELF_API float ELF_APIENTRY elfGetTextureAnisotropy();
 ELF_API void ELF_APIENTRY elfSetShadowMapSize(int size);
 ELF_API int ELF_APIENTRY elfGetShadowMapSize();
 ELF_API int ELF_APIENTRY elfGetPolygonsRendered();
+ELF_API int ELF_APIENTRY elfGetGlCalls();
+ELF_API int ELF_APIENTRY elfGetDrawCalls();
+ELF_API int ELF_APIENTRY elfGetInstancesDrawn();
+ELF_API int ELF_APIENTRY elfGetShaderSwitches();
+ELF_API int ELF_APIENTRY elfGetTextureSwitches();
+ELF_API int ELF_APIENTRY elfGetBlendSwitches();
+ELF_API int ELF_APIENTRY elfGetShaderProgramCount();
 ELF_API void ELF_APIENTRY elfSetBloom(float threshold);
 ELF_API void ELF_APIENTRY elfDisableBloom();
 ELF_API float ELF_APIENTRY elfGetBloomThreshold();
@@ -549,6 +618,20 @@ ELF_API unsigned char ELF_APIENTRY elfIsFramePlayerPaused(elfFramePlayer* player
 ELF_API elfTimer* ELF_APIENTRY elfCreateTimer();
 ELF_API void ELF_APIENTRY elfStartTimer(elfTimer* timer);
 ELF_API double ELF_APIENTRY elfGetElapsedTime(elfTimer* timer);
+ELF_API void ELF_APIENTRY elfSetProfiling(unsigned char enabled);
+ELF_API unsigned char ELF_APIENTRY elfIsProfiling();
+ELF_API void ELF_APIENTRY elfClearProfile();
+ELF_API int ELF_APIENTRY elfGetProfileFrameCount();
+ELF_API float ELF_APIENTRY elfGetProfileFrameTime();
+ELF_API int ELF_APIENTRY elfGetProfileScopeCount();
+ELF_API const char* ELF_APIENTRY elfGetProfileScopeName(int idx);
+ELF_API float ELF_APIENTRY elfGetProfileScopeTime(int idx);
+ELF_API int ELF_APIENTRY elfGetProfileScopeDepth(int idx);
+ELF_API float ELF_APIENTRY elfGetProfileTime(const char* name);
+ELF_API int ELF_APIENTRY elfGetProfileDrawCalls();
+ELF_API int ELF_APIENTRY elfGetProfileStateChanges();
+ELF_API int ELF_APIENTRY elfGetProfileUploads();
+ELF_API unsigned char ELF_APIENTRY elfSaveProfileTrace(const char* filePath);
 ELF_API elfImage* ELF_APIENTRY elfCreateEmptyImage(int width, int height, int bpp);
 ELF_API elfImage* ELF_APIENTRY elfCreateImageFromFile(const char* filePath);
 ELF_API void ELF_APIENTRY elfSetImagePixel(elfImage* image, int x, int y, float r, float g, float b, float a);
@@ -792,6 +875,13 @@ ELF_API float ELF_APIENTRY elfGetEntityArmatureSpeed(elfEntity* entity);
 ELF_API float ELF_APIENTRY elfGetEntityArmatureFrame(elfEntity* entity);
 ELF_API unsigned char ELF_APIENTRY elfIsEntityArmaturePlaying(elfEntity* entity);
 ELF_API unsigned char ELF_APIENTRY elfIsEntityArmaturePaused(elfEntity* entity);
+ELF_API void ELF_APIENTRY elfSetEntityArmatureLayerWeight(elfEntity* entity, int layer, float weight);
+ELF_API void ELF_APIENTRY elfSetEntityArmatureLayerFrame(elfEntity* entity, int layer, float frame);
+ELF_API void ELF_APIENTRY elfPlayEntityArmatureLayer(elfEntity* entity, int layer, float start, float end, float speed);
+ELF_API void ELF_APIENTRY elfLoopEntityArmatureLayer(elfEntity* entity, int layer, float start, float end, float speed);
+ELF_API void ELF_APIENTRY elfStopEntityArmatureLayer(elfEntity* entity, int layer);
+ELF_API float ELF_APIENTRY elfGetEntityArmatureLayerWeight(elfEntity* entity, int layer);
+ELF_API float ELF_APIENTRY elfGetEntityArmatureLayerFrame(elfEntity* entity, int layer);
 ELF_API elfArmature* ELF_APIENTRY elfGetEntityArmature(elfEntity* entity);
 ELF_API unsigned char ELF_APIENTRY elfGetEntityChanged(elfEntity* entity);
 ELF_API elfLight* ELF_APIENTRY elfCreateLight(const char* name);
@@ -905,6 +995,8 @@ ELF_API void ELF_APIENTRY elfSetSceneDebugDraw(elfScene* scene, unsigned char de
 ELF_API unsigned char ELF_APIENTRY elfGetSceneDebugDraw(elfScene* scene);
 ELF_API void ELF_APIENTRY elfSetSceneOcclusionCulling(elfScene* scene, unsigned char occlusionCulling);
 ELF_API unsigned char ELF_APIENTRY elfGetSceneOcclusionCulling(elfScene* scene);
+ELF_API void ELF_APIENTRY elfSetSceneSpatialIndex(elfScene* scene, unsigned char spatialIndex);
+ELF_API unsigned char ELF_APIENTRY elfGetSceneSpatialIndex(elfScene* scene);
 ELF_API void ELF_APIENTRY elfSetSceneGravity(elfScene* scene, float x, float y, float z);
 ELF_API elfVec3f ELF_APIENTRY elfGetSceneGravity(elfScene* scene);
 ELF_API void ELF_APIENTRY elfSetSceneAmbientColor(elfScene* scene, float r, float g, float b, float a);
@@ -934,6 +1026,7 @@ ELF_API elfCollision* ELF_APIENTRY elfGetSceneRayCastResult(elfScene* scene, flo
 ELF_API elfList* ELF_APIENTRY elfGetSceneRayCastResults(elfScene* scene, float x, float y, float z, float dx, float dy, float dz);
 ELF_API elfCollision* ELF_APIENTRY elfGetDebugSceneRayCastResult(elfScene* scene, float x, float y, float z, float dx, float dy, float dz);
 ELF_API elfList* ELF_APIENTRY elfGetDebugSceneRayCastResults(elfScene* scene, float x, float y, float z, float dx, float dy, float dz);
+ELF_API elfEntity* ELF_APIENTRY elfGetSceneRayCastEntity(elfScene* scene, float x, float y, float z, float dx, float dy, float dz);
 ELF_API elfCamera* ELF_APIENTRY elfGetSceneCameraByIndex(elfScene* scene, int idx);
 ELF_API elfEntity* ELF_APIENTRY elfGetSceneEntityByIndex(elfScene* scene, int idx);
 ELF_API elfLight* ELF_APIENTRY elfGetSceneLightByIndex(elfScene* scene, int idx);
@@ -971,6 +1064,10 @@ ELF_API elfList* ELF_APIENTRY elfGetSceneScripts(elfScene* scene);
 ELF_API elfList* ELF_APIENTRY elfGetSceneTextures(elfScene* scene);
 ELF_API elfList* ELF_APIENTRY elfGetSceneMaterials(elfScene* scene);
 ELF_API elfList* ELF_APIENTRY elfGetSceneModels(elfScene* scene);
+ELF_API const char* ELF_APIENTRY elfGetSceneLoaderFilePath(elfSceneLoader* loader);
+ELF_API float ELF_APIENTRY elfGetSceneLoaderProgress(elfSceneLoader* loader);
+ELF_API unsigned char ELF_APIENTRY elfIsSceneLoaderDone(elfSceneLoader* loader);
+ELF_API elfScene* ELF_APIENTRY elfGetSceneLoaderScene(elfSceneLoader* loader);
 ELF_API elfScript* ELF_APIENTRY elfCreateScript(const char* name);
 ELF_API elfScript* ELF_APIENTRY elfCreateScriptFromFile(const char* name, const char* filePath);
 ELF_API void ELF_APIENTRY elfSetScriptName(elfScript* script, const char* name);
@@ -980,6 +1077,8 @@ ELF_API void ELF_APIENTRY elfSetScriptText(elfScript* script, const char* text);
 ELF_API unsigned char ELF_APIENTRY elfIsScriptError(elfScript* script);
 ELF_API unsigned char ELF_APIENTRY elfRunString(const char* str);
 ELF_API unsigned char ELF_APIENTRY elfRunScript(elfScript* script);
+ELF_API float ELF_APIENTRY elfGetScriptGcTime();
+ELF_API int ELF_APIENTRY elfGetScriptMemory();
 ELF_API void ELF_APIENTRY elfSetAudioVolume(float volume);
 ELF_API float ELF_APIENTRY elfGetAudioVolume();
 ELF_API void ELF_APIENTRY elfSetAudioRolloff(float rolloff);
@@ -3,33 +3,28 @@ void elfActorIpoCallback(elfFramePlayer* player)
 {
 	elfActor* actor;
 	float frame;
-	elfVec3f pos;
-	elfVec3f rot;
-	elfVec3f scale;
-	elfVec4f qua;
+	float values[ELF_QUA_W+1];
 
 	actor = (elfActor*)elfGetFramePlayerUserData(player);
 	frame = elfGetFramePlayerFrame(player);
 
+	elfGetIpoValues(actor->ipo, frame, values);
+
 	if(actor->ipo->loc)
 	{
-		pos = elfGetIpoLoc(actor->ipo, frame);
-		elfSetActorPosition(actor, pos.x, pos.y, pos.z);
+		elfSetActorPosition(actor, values[ELF_LOC_X], values[ELF_LOC_Y], values[ELF_LOC_Z]);
 	}
 	if(actor->ipo->rot)
 	{
-		rot = elfGetIpoRot(actor->ipo, frame);
-		elfSetActorRotation(actor, rot.x, rot.y, rot.z);
+		elfSetActorRotation(actor, values[ELF_ROT_X], values[ELF_ROT_Y], values[ELF_ROT_Z]);
 	}
 	if(actor->ipo->scale)
 	{
-		scale = elfGetIpoScale(actor->ipo, frame);
-		if(actor->objType == ELF_ENTITY) elfSetEntityScale((elfEntity*)actor, scale.x, scale.y, scale.z);
+		if(actor->objType == ELF_ENTITY) elfSetEntityScale((elfEntity*)actor, values[ELF_SCALE_X], values[ELF_SCALE_Y], values[ELF_SCALE_Z]);
 	}
 	if(actor->ipo->qua)
 	{
-		qua = elfGetIpoQua(actor->ipo, frame);
-		elfSetActorOrientation(actor, qua.x, qua.y, qua.z, qua.w);
+		elfSetActorOrientation(actor, values[ELF_QUA_X], values[ELF_QUA_Y], values[ELF_QUA_Z], values[ELF_QUA_W]);
 	}
 }
 
@@ -109,9 +104,9 @@ void elfUpdateActor(elfActor* actor)
 		eng->actor = (elfObject*)actor;
 		elfIncRef((elfObject*)actor);
 
-		elfRunString("me = GetActor()");
+		elfBeginProfileScope(actor->name);
 		elfRunScript(actor->script);
-		elfRunString("me = nil");
+		elfEndProfileScope();
 
 		elfDecRef((elfObject*)actor);
 		eng->actor = NULL;
@@ -146,6 +141,52 @@ void elfActorPostDraw(elfActor* actor)
 	actor->moved = ELF_FALSE;
 }
 
+void elfStoreActorStep(elfActor* actor)
+{
+	gfxGetTransformPosition(actor->transform, &actor->prevPosition.x);
+	gfxGetTransformOrientation(actor->transform, &actor->prevOrientation.x);
+	actor->stepStored = ELF_TRUE;
+}
+
+void elfInterpolateActor(elfActor* actor, float alpha)
+{
+	float position[3];
+	float orient[4];
+
+	// actors added since the last step have nothing to interpolate from yet
+	if(!actor->stepStored) return;
+
+	gfxGetTransformPosition(actor->transform, &actor->stepPosition.x);
+	gfxGetTransformOrientation(actor->transform, &actor->stepOrientation.x);
+
+	if(!memcmp(&actor->stepPosition, &actor->prevPosition, sizeof(float)*3) &&
+		!memcmp(&actor->stepOrientation, &actor->prevOrientation, sizeof(float)*4)) return;
+
+	position[0] = actor->prevPosition.x+(actor->stepPosition.x-actor->prevPosition.x)*alpha;
+	position[1] = actor->prevPosition.y+(actor->stepPosition.y-actor->prevPosition.y)*alpha;
+	position[2] = actor->prevPosition.z+(actor->stepPosition.z-actor->prevPosition.z)*alpha;
+	gfxQuaSlerp(&actor->prevOrientation.x, &actor->stepOrientation.x, alpha, orient);
+
+	gfxSetTransformPosition(actor->transform, position[0], position[1], position[2]);
+	gfxSetTransformOrientation(actor->transform, orient[0], orient[1], orient[2], orient[3]);
+
+	actor->interpolated = ELF_TRUE;
+	actor->moved = ELF_TRUE;
+}
+
+void elfRestoreActorStep(elfActor* actor)
+{
+	if(!actor->interpolated) return;
+
+	gfxSetTransformPosition(actor->transform, actor->stepPosition.x, actor->stepPosition.y, actor->stepPosition.z);
+	gfxSetTransformOrientation(actor->transform, actor->stepOrientation.x,
+		actor->stepOrientation.y, actor->stepOrientation.z, actor->stepOrientation.w);
+
+	// the bounds were last calculated for the interpolated transform
+	actor->interpolated = ELF_FALSE;
+	actor->moved = ELF_TRUE;
+}
+
 void elfCleanActor(elfActor* actor)
 {
 	elfJoint* joint;
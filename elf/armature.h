@@ -23,6 +23,7 @@ void elfDestroyBone(void* data)
 	elfBone* bone = (elfBone*)data;
 
 	if(bone->name) elfDestroyString(bone->name);
+	if(bone->keys) free(bone->keys);
 	if(bone->frames) free(bone->frames);
 	
 	elfDecRef((elfObject*)bone->children);
@@ -190,51 +191,399 @@ ELF_API elfArmature* ELF_APIENTRY elfCreateArmature(const char* name)
 	return armature;
 }
 
-void elfDeformEntityWithArmature(elfArmature* armature, elfEntity* entity, float frame)
+void elfQuantizeBoneQua(const float* qua, short* result)
+{
+	float v;
+	int i;
+
+	for(i = 0; i < 4; i++)
+	{
+		v = qua[i];
+		if(v > 1.0f) v = 1.0f;
+		if(v < -1.0f) v = -1.0f;
+		result[i] = (short)floor(v*32767.0f+0.5f);
+	}
+}
+
+void elfDequantizeBoneQua(const short* qua, float* result)
 {
+	result[0] = qua[0]/32767.0f;
+	result[1] = qua[1]/32767.0f;
+	result[2] = qua[2]/32767.0f;
+	result[3] = qua[3]/32767.0f;
+}
+
+unsigned char elfBoneSpanFits(elfBoneFrame* frames, elfBoneKey* start, elfBoneKey* end, float tolerance)
+{
+	float startQua[4];
+	float endQua[4];
+	float qua[4];
+	float pos[3];
+	float t;
+	float err;
+	float flipErr;
 	int i, j;
+
+	elfDequantizeBoneQua(start->offsetQua, startQua);
+	elfDequantizeBoneQua(end->offsetQua, endQua);
+
+	for(i = start->frame+1; i < end->frame; i++)
+	{
+		t = (float)(i-start->frame)/(float)(end->frame-start->frame);
+
+		pos[0] = start->offsetPos.x+(end->offsetPos.x-start->offsetPos.x)*t;
+		pos[1] = start->offsetPos.y+(end->offsetPos.y-start->offsetPos.y)*t;
+		pos[2] = start->offsetPos.z+(end->offsetPos.z-start->offsetPos.z)*t;
+
+		if(fabs(pos[0]-frames[i].offsetPos.x) > tolerance ||
+			fabs(pos[1]-frames[i].offsetPos.y) > tolerance ||
+			fabs(pos[2]-frames[i].offsetPos.z) > tolerance) return ELF_FALSE;
+
+		gfxQuaSlerp(startQua, endQua, t, qua);
+
+		// q and -q are the same rotation
+		err = flipErr = 0.0f;
+		for(j = 0; j < 4; j++)
+		{
+			if(fabs(qua[j]-(&frames[i].offsetQua.x)[j]) > err) err = fabs(qua[j]-(&frames[i].offsetQua.x)[j]);
+			if(fabs(qua[j]+(&frames[i].offsetQua.x)[j]) > flipErr) flipErr = fabs(qua[j]+(&frames[i].offsetQua.x)[j]);
+		}
+
+		if(err > tolerance && flipErr > tolerance) return ELF_FALSE;
+	}
+
+	return ELF_TRUE;
+}
+
+void elfCompressBoneTrack(elfBone* bone, elfBoneFrame* frames, int frameCount, float tolerance)
+{
+	elfBoneKey candidate;
+	elfBoneKey best;
+	int i;
+
+	if(bone->keys) free(bone->keys);
+	if(bone->frames) free(bone->frames);
+	bone->keys = NULL;
+	bone->keyCount = 0;
+
+	if(frameCount < 1) return;
+
+	bone->keys = (elfBoneKey*)malloc(sizeof(elfBoneKey)*frameCount);
+
+	bone->keys[0].frame = 0;
+	bone->keys[0].offsetPos = frames[0].offsetPos;
+	elfQuantizeBoneQua(&frames[0].offsetQua.x, bone->keys[0].offsetQua);
+	bone->keyCount = 1;
+
+	// greedily stretch every key as far as linear interpolation stays within the tolerance,
+	// spans are capped so a long still pose doesn't turn the fit quadratic
+	while(bone->keys[bone->keyCount-1].frame < frameCount-1)
+	{
+		for(i = bone->keys[bone->keyCount-1].frame+1; i < frameCount && i-bone->keys[bone->keyCount-1].frame <= 256; i++)
+		{
+			candidate.frame = i;
+			candidate.offsetPos = frames[i].offsetPos;
+			elfQuantizeBoneQua(&frames[i].offsetQua.x, candidate.offsetQua);
+
+			if(i > bone->keys[bone->keyCount-1].frame+1 &&
+				!elfBoneSpanFits(frames, &bone->keys[bone->keyCount-1], &candidate, tolerance)) break;
+
+			best = candidate;
+		}
+
+		bone->keys[bone->keyCount++] = best;
+	}
+
+	bone->keys = (elfBoneKey*)realloc(bone->keys, sizeof(elfBoneKey)*bone->keyCount);
+}
+
+void elfSampleBoneTrack(elfBone* bone, int frameCount, float frame, float* pos, float* qua)
+{
+	elfBoneKey* keys;
+	float startQua[4];
+	float endQua[4];
+	float f;
+	float t;
+	int lo;
+	int hi;
+	int mid;
+
+	if(!bone->keyCount)
+	{
+		pos[0] = pos[1] = pos[2] = 0.0f;
+		qua[0] = qua[1] = qua[2] = 0.0f; qua[3] = 1.0f;
+		return;
+	}
+
+	keys = bone->keys;
+
+	// frames are numbered from one, keys from zero
+	f = frame-1.0f;
+	if(f < 0.0f) f = 0.0f;
+	if(f > frameCount-1) f = frameCount-1;
+
+	lo = 0;
+	hi = bone->keyCount-1;
+
+	if(f >= keys[hi].frame)
+	{
+		memcpy(pos, &keys[hi].offsetPos.x, sizeof(float)*3);
+		elfDequantizeBoneQua(keys[hi].offsetQua, qua);
+		return;
+	}
+
+	// the track is shared by every entity using the armature, so there is no cursor to keep, only a binary search
+	while(hi-lo > 1)
+	{
+		mid = (lo+hi)/2;
+		if(keys[mid].frame <= f) lo = mid;
+		else hi = mid;
+	}
+
+	t = (f-keys[lo].frame)/(float)(keys[hi].frame-keys[lo].frame);
+
+	pos[0] = keys[lo].offsetPos.x+(keys[hi].offsetPos.x-keys[lo].offsetPos.x)*t;
+	pos[1] = keys[lo].offsetPos.y+(keys[hi].offsetPos.y-keys[lo].offsetPos.y)*t;
+	pos[2] = keys[lo].offsetPos.z+(keys[hi].offsetPos.z-keys[lo].offsetPos.z)*t;
+
+	elfDequantizeBoneQua(keys[lo].offsetQua, startQua);
+	elfDequantizeBoneQua(keys[hi].offsetQua, endQua);
+	gfxQuaSlerp(startQua, endQua, t, qua);
+}
+
+unsigned char elfLoadArmatureFrames(elfArmature* armature)
+{
+	elfPak* pak;
+	elfPakIndex* index;
+	FILE* file;
+	elfBone* bone;
+	elfBoneFrame* frames;
+	int magic;
+	char name[ELF_NAME_LENGTH];
+	char parent[ELF_NAME_LENGTH];
+	int frameCount;
+	int boneCount;
 	int id;
+	float pos[3];
+	float qua[4];
+	int i, j;
+
+	if(!armature->filePath || armature->frameCount < 1) return ELF_FALSE;
+
+	// the keys are lossy, a resave goes back to the frames in the pak the armature came from
+	pak = elfCreatePakFromFile(armature->filePath);
+	if(!pak) return ELF_FALSE;
+
+	elfIncRef((elfObject*)pak);
+
+	index = elfGetPakIndexByName(pak, armature->name, ELF_ARMATURE);
+	if(!index)
+	{
+		elfDecRef((elfObject*)pak);
+		return ELF_FALSE;
+	}
+
+	file = elfGetPakFile(pak);
+	fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
+
+	magic = 0;
+	fread((char*)&magic, sizeof(int), 1, file);
+	fread(name, sizeof(char), ELF_NAME_LENGTH, file);
+	frameCount = boneCount = 0;
+	fread((char*)&frameCount, sizeof(int), 1, file);
+	fread((char*)&boneCount, sizeof(int), 1, file);
+
+	if(magic != ELF_ARMATURE_MAGIC || frameCount != armature->frameCount)
+	{
+		elfDecRef((elfObject*)pak);
+		return ELF_FALSE;
+	}
+
+	for(i = 0; i < boneCount && !feof(file); i++)
+	{
+		fread(name, sizeof(char), ELF_NAME_LENGTH, file);
+		fread(parent, sizeof(char), ELF_NAME_LENGTH, file);
+		fread((char*)&id, sizeof(int), 1, file);
+		fread((char*)pos, sizeof(float), 3, file);
+		fread((char*)qua, sizeof(float), 4, file);
+
+		bone = elfGetBoneFromArmatureById(id, armature);
+		if(bone && !strcmp(bone->name, name) && !bone->frames)
+		{
+			frames = (elfBoneFrame*)malloc(sizeof(elfBoneFrame)*frameCount);
+			memset(frames, 0x0, sizeof(elfBoneFrame)*frameCount);
+			for(j = 0; j < frameCount; j++)
+			{
+				fread((char*)&frames[j].pos.x, sizeof(float), 3, file);
+				fread((char*)&frames[j].qua.x, sizeof(float), 4, file);
+			}
+			bone->frames = frames;
+		}
+		else
+		{
+			fseek(file, sizeof(float)*7*frameCount, SEEK_CUR);
+		}
+	}
+
+	elfDecRef((elfObject*)pak);
+
+	return ELF_TRUE;
+}
+
+void elfUnloadArmatureFrames(elfArmature* armature)
+{
+	int i;
+
+	for(i = 0; i < armature->boneCount; i++)
+	{
+		if(armature->bones[i] && armature->bones[i]->frames)
+		{
+			free(armature->bones[i]->frames);
+			armature->bones[i]->frames = NULL;
+		}
+	}
+}
+
+unsigned char elfIsEntitySkinnedByShaders(elfEntity* entity)
+{
+	// a model with ids past the armature's bones would read unset palette entries,
+	// the cpu path skips those ids so it is left to that
+	return gfxGetVersion() >= 200 && entity->armature && entity->model && entity->model->weights &&
+		entity->armature->boneCount <= gfxGetMaxBones() && entity->model->maxBoneId < entity->armature->boneCount;
+}
+
+unsigned char elfPrepareEntitySkinning(elfArmature* armature, elfEntity* entity, float frame)
+{
+	int i, j;
 	float tempVec1[3];
-	float tempVec2[3];
-	int cid;
-	int nid;
-	float t;
+	float axis[3];
+	float* mat;
+	float frames[ELF_MAX_ARMATURE_LAYERS];
+	float weights[ELF_MAX_ARMATURE_LAYERS];
+	int layerCount;
+	float totalWeight;
+	float pos[3];
+	float qua[4];
+	float length;
 	float tempQua[4];
-	float* vertexBuffer;
-	float* normalBuffer;
-	float* origVertexBuffer;
-	float* origNormalBuffer;
 	elfBone* bone;
 	elfModel* model;
 
 	model = elfGetEntityModel(entity);
 
-	if(!model || !armature->boneCount || !model->boneids || !model->weights) return;
-
-	cid = ((int)frame)-1;
-	if(cid < 0) cid = 0;
-	nid = cid+1;
-	if(frame > armature->frameCount) cid = nid = armature->frameCount-1;
-	t = frame-((int)frame);
+	if(!model || !armature->boneCount || !model->boneids || !model->weights) return ELF_FALSE;
 
 	armature->curFrame = frame;
 	if(armature->curFrame > armature->frameCount) armature->curFrame = armature->frameCount;
 
+	// the layers that contribute to the pose, layer zero follows the frame asked for
+	layerCount = 0;
+	totalWeight = 0.0f;
+	for(i = 0; i < ELF_MAX_ARMATURE_LAYERS; i++)
+	{
+		if(entity->armatureLayers[i].weight <= 0.0f) continue;
+		if(i > 0 && !entity->armatureLayers[i].player) continue;
+
+		frames[layerCount] = i == 0 ? frame : elfGetFramePlayerFrame(entity->armatureLayers[i].player);
+		weights[layerCount] = entity->armatureLayers[i].weight;
+		totalWeight += weights[layerCount];
+		layerCount++;
+	}
+
+	// the bones are shared by every entity using the armature, so the palette is kept per entity
+	if(entity->paletteSize != armature->boneCount)
+	{
+		if(entity->palette) free(entity->palette);
+		entity->paletteSize = armature->boneCount;
+		entity->palette = (float*)malloc(sizeof(float)*16*entity->paletteSize);
+		memset(entity->palette, 0x0, sizeof(float)*16*entity->paletteSize);
+	}
+
 	for(i = 0; i < armature->boneCount; i++)
 	{
 		bone = armature->bones[i];
 		if(!bone) continue;
 
-		bone->curOffsetPos.x = bone->frames[cid].offsetPos.x+(bone->frames[nid].offsetPos.x-bone->frames[cid].offsetPos.x)*t;
-		bone->curOffsetPos.y = bone->frames[cid].offsetPos.y+(bone->frames[nid].offsetPos.y-bone->frames[cid].offsetPos.y)*t;
-		bone->curOffsetPos.z = bone->frames[cid].offsetPos.z+(bone->frames[nid].offsetPos.z-bone->frames[cid].offsetPos.z)*t;
+		memset(&bone->curOffsetPos, 0x0, sizeof(elfVec3f));
+		memset(&bone->curOffsetQua, 0x0, sizeof(elfVec4f));
+
+		// weighted sum of every layer's pose, the quaternions are kept in one hemisphere and renormalized
+		for(j = 0; j < layerCount; j++)
+		{
+			elfSampleBoneTrack(bone, armature->frameCount, frames[j], pos, qua);
+
+			if(j > 0 && bone->curOffsetQua.x*qua[0]+bone->curOffsetQua.y*qua[1]+
+				bone->curOffsetQua.z*qua[2]+bone->curOffsetQua.w*qua[3] < 0.0f)
+			{
+				qua[0] = -qua[0]; qua[1] = -qua[1]; qua[2] = -qua[2]; qua[3] = -qua[3];
+			}
+
+			bone->curOffsetPos.x += pos[0]*weights[j];
+			bone->curOffsetPos.y += pos[1]*weights[j];
+			bone->curOffsetPos.z += pos[2]*weights[j];
+			bone->curOffsetQua.x += qua[0]*weights[j];
+			bone->curOffsetQua.y += qua[1]*weights[j];
+			bone->curOffsetQua.z += qua[2]*weights[j];
+			bone->curOffsetQua.w += qua[3]*weights[j];
+		}
+
+		length = sqrt(bone->curOffsetQua.x*bone->curOffsetQua.x+bone->curOffsetQua.y*bone->curOffsetQua.y+
+			bone->curOffsetQua.z*bone->curOffsetQua.z+bone->curOffsetQua.w*bone->curOffsetQua.w);
+
+		if(totalWeight <= 0.0f || length < 0.0001f)
+		{
+			memset(&bone->curOffsetPos, 0x0, sizeof(elfVec3f));
+			bone->curOffsetQua.x = bone->curOffsetQua.y = bone->curOffsetQua.z = 0.0f;
+			bone->curOffsetQua.w = 1.0f;
+		}
+		else
+		{
+			bone->curOffsetPos.x /= totalWeight;
+			bone->curOffsetPos.y /= totalWeight;
+			bone->curOffsetPos.z /= totalWeight;
+			bone->curOffsetQua.x /= length;
+			bone->curOffsetQua.y /= length;
+			bone->curOffsetQua.z /= length;
+			bone->curOffsetQua.w /= length;
+		}
+
 		bone->curPos.x = bone->pos.x+bone->curOffsetPos.x;
 		bone->curPos.y = bone->pos.y+bone->curOffsetPos.y;
 		bone->curPos.z = bone->pos.z+bone->curOffsetPos.z;
 
-		gfxQuaSlerp(&bone->frames[cid].offsetQua.x, &bone->frames[nid].offsetQua.x, t, &bone->curOffsetQua.x);
 		gfxMulQuaQua(&bone->qua.x, &bone->curOffsetQua.x, tempQua);
 		memcpy(&bone->curQua.x, tempQua, sizeof(float)*4);
+
+		// the skinning matrix, rotation about the bone position followed by the offset.
+		// columns are the rotated axes and the translation pos+offset-rot*pos
+		mat = &entity->palette[i*16];
+
+		axis[0] = 1.0f; axis[1] = 0.0f; axis[2] = 0.0f;
+		gfxMulQuaVec(&bone->curOffsetQua.x, axis, &mat[0]);
+		axis[0] = 0.0f; axis[1] = 1.0f; axis[2] = 0.0f;
+		gfxMulQuaVec(&bone->curOffsetQua.x, axis, &mat[4]);
+		axis[0] = 0.0f; axis[1] = 0.0f; axis[2] = 1.0f;
+		gfxMulQuaVec(&bone->curOffsetQua.x, axis, &mat[8]);
+
+		gfxMulQuaVec(&bone->curOffsetQua.x, &bone->pos.x, tempVec1);
+		mat[12] = bone->pos.x+bone->curOffsetPos.x-tempVec1[0];
+		mat[13] = bone->pos.y+bone->curOffsetPos.y-tempVec1[1];
+		mat[14] = bone->pos.z+bone->curOffsetPos.z-tempVec1[2];
+
+		// the shaders upload the palette as full matrices, the last row has to be the affine one
+		mat[3] = mat[7] = mat[11] = 0.0f;
+		mat[15] = 1.0f;
+	}
+
+	// the shaders blend the palette per vertex when there are enough uniforms for it,
+	// the model's own buffers are drawn and nothing is left to skin here
+	if(elfIsEntitySkinnedByShaders(entity))
+	{
+		if(entity->vertices) gfxDecRef((gfxObject*)entity->vertices);
+		if(entity->normals) gfxDecRef((gfxObject*)entity->normals);
+		entity->vertices = NULL;
+		entity->normals = NULL;
+		return ELF_FALSE;
 	}
 
 	if(!entity->vertices)
@@ -249,50 +598,40 @@ void elfDeformEntityWithArmature(elfArmature* armature, elfEntity* entity, float
 		gfxIncRef((gfxObject*)entity->normals);
 	}
 
-	vertexBuffer = (float*)gfxGetVertexDataBuffer(entity->vertices);
-	normalBuffer = (float*)gfxGetVertexDataBuffer(entity->normals);
-	origVertexBuffer = (float*)gfxGetVertexDataBuffer(model->vertices);
-	origNormalBuffer = (float*)gfxGetVertexDataBuffer(model->normals);
+	return ELF_TRUE;
+}
+
+void elfSkinEntity(void* data)
+{
+	elfEntity* entity = (elfEntity*)data;
+	elfModel* model;
 
-	for(i = 0; i < model->verticeCount; i++)
-	{
-		memset(&vertexBuffer[i*3], 0x0, sizeof(float)*3);
-		memset(&normalBuffer[i*3], 0x0, sizeof(float)*3);
+	// runs on a worker thread, touches nothing but the entity's own buffers
+	model = entity->model;
+
+	gfxSkinVertices(entity->palette, entity->paletteSize,
+		(int*)gfxGetVertexDataBuffer(model->boneids), (float*)gfxGetVertexDataBuffer(model->weights),
+		(float*)gfxGetVertexDataBuffer(model->vertices), (float*)gfxGetVertexDataBuffer(model->normals),
+		model->verticeCount, (float*)gfxGetVertexDataBuffer(entity->vertices),
+		(float*)gfxGetVertexDataBuffer(entity->normals));
+}
+
+void elfFinishEntitySkinning(elfEntity* entity)
+{
+	entity->skinPending = ELF_FALSE;
 
-		for(j = 0; j < 4; j++)
-		{
-			id = model->boneids[i*4+j];
-
-			if(id < 0 || id > (int)armature->boneCount-1 || !(bone = armature->bones[id])) continue;
-
-			memcpy(tempVec1, &origVertexBuffer[i*3], sizeof(float)*3);
-			tempVec1[0] -= bone->pos.x;
-			tempVec1[1] -= bone->pos.y;
-			tempVec1[2] -= bone->pos.z;
-			gfxMulQuaVec(&bone->curOffsetQua.x, tempVec1, tempVec2);
-			tempVec2[0] += bone->pos.x;
-			tempVec2[1] += bone->pos.y;
-			tempVec2[2] += bone->pos.z;
-			tempVec2[0] += bone->curOffsetPos.x;
-			tempVec2[1] += bone->curOffsetPos.y;
-			tempVec2[2] += bone->curOffsetPos.z;
-
-			vertexBuffer[i*3] += tempVec2[0]*model->weights[i*4+j];
-			vertexBuffer[i*3+1] += tempVec2[1]*model->weights[i*4+j];
-			vertexBuffer[i*3+2] += tempVec2[2]*model->weights[i*4+j];
-
-			gfxMulQuaVec(&bone->curOffsetQua.x, &origNormalBuffer[i*3], tempVec1);
-
-			normalBuffer[i*3] += tempVec1[0]*model->weights[i*4+j];
-			normalBuffer[i*3+1] += tempVec1[1]*model->weights[i*4+j];
-			normalBuffer[i*3+2] += tempVec1[2]*model->weights[i*4+j];
-		}
-	}
-	
 	gfxUpdateVertexData(entity->vertices);
 	gfxUpdateVertexData(entity->normals);
 }
 
+void elfDeformEntityWithArmature(elfArmature* armature, elfEntity* entity, float frame)
+{
+	if(!elfPrepareEntitySkinning(armature, entity, frame)) return;
+
+	elfSkinEntity(entity);
+	elfFinishEntitySkinning(entity);
+}
+
 void elfDestroyArmature(void* data)
 {
 	elfArmature* armature = (elfArmature*)data;
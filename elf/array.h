@@ -0,0 +1,242 @@
+unsigned int elfGetArrayHash(elfObject* obj)
+{
+	return (unsigned int)(((size_t)obj >> 4)*2654435761u);
+}
+
+void elfRebuildArrayMap(elfArray* array, int mapSize)
+{
+	unsigned int h;
+	int i;
+
+	if(array->map) free(array->map);
+
+	array->mapSize = mapSize;
+	array->map = (int*)malloc(sizeof(int)*array->mapSize);
+	memset(array->map, 0x0, sizeof(int)*array->mapSize);
+
+	for(i = 0; i < array->length; i++)
+	{
+		h = elfGetArrayHash(array->objs[i])&(array->mapSize-1);
+		while(array->map[h]) h = (h+1)&(array->mapSize-1);
+		array->map[h] = i+1;
+	}
+}
+
+int elfGetArrayMapSlot(elfArray* array, elfObject* obj)
+{
+	unsigned int h;
+
+	h = elfGetArrayHash(obj)&(array->mapSize-1);
+	while(array->map[h])
+	{
+		if(array->objs[array->map[h]-1] == obj) return h;
+		h = (h+1)&(array->mapSize-1);
+	}
+
+	return -1;
+}
+
+void elfRemoveArrayMapSlot(elfArray* array, int slot)
+{
+	unsigned int i, j, k;
+	unsigned int mask;
+
+	// backward shift deletion, keeps the probe sequences intact without tombstones
+	mask = array->mapSize-1;
+	i = slot;
+	j = slot;
+	array->map[i] = 0;
+
+	while(1)
+	{
+		j = (j+1)&mask;
+		if(!array->map[j]) break;
+
+		k = elfGetArrayHash(array->objs[array->map[j]-1])&mask;
+		if((i <= j) ? (i < k && k <= j) : (i < k || k <= j)) continue;
+
+		array->map[i] = array->map[j];
+		array->map[j] = 0;
+		i = j;
+	}
+}
+
+elfArray* elfCreateArray(unsigned char indexed)
+{
+	elfArray* array;
+
+	array = (elfArray*)malloc(sizeof(elfArray));
+	memset(array, 0x0, sizeof(elfArray));
+	array->objType = ELF_ARRAY;
+	array->objDestr = elfDestroyArray;
+
+	array->size = 16;
+	array->objs = (elfObject**)malloc(sizeof(elfObject*)*array->size);
+
+	if(indexed) elfRebuildArrayMap(array, array->size*2);
+
+	elfIncObj(ELF_ARRAY);
+
+	return array;
+}
+
+void elfDestroyArray(void* data)
+{
+	elfArray* array = (elfArray*)data;
+
+	elfClearArray(array);
+	if(array->curRemoved) elfDecRef(array->curObj);
+
+	free(array->objs);
+	if(array->map) free(array->map);
+
+	free(array);
+
+	elfDecObj(ELF_ARRAY);
+}
+
+int elfGetArrayLength(elfArray* array)
+{
+	return array->length;
+}
+
+elfObject* elfGetArrayObject(elfArray* array, int idx)
+{
+	if(idx < 0 || idx > array->length-1) return NULL;
+	return array->objs[idx];
+}
+
+int elfGetArrayObjectIndex(elfArray* array, elfObject* obj)
+{
+	int slot;
+	int i;
+
+	if(array->map)
+	{
+		slot = elfGetArrayMapSlot(array, obj);
+		if(slot < 0) return -1;
+		return array->map[slot]-1;
+	}
+
+	for(i = 0; i < array->length; i++)
+	{
+		if(array->objs[i] == obj) return i;
+	}
+
+	return -1;
+}
+
+void elfAppendArrayObject(elfArray* array, elfObject* obj)
+{
+	unsigned int h;
+
+	if(!obj) return;
+
+	if(array->length == array->size)
+	{
+		array->size *= 2;
+		array->objs = (elfObject**)realloc(array->objs, sizeof(elfObject*)*array->size);
+	}
+
+	array->objs[array->length++] = obj;
+
+	if(array->map)
+	{
+		if(array->length*2 > array->mapSize)
+		{
+			elfRebuildArrayMap(array, array->mapSize*2);
+		}
+		else
+		{
+			h = elfGetArrayHash(obj)&(array->mapSize-1);
+			while(array->map[h]) h = (h+1)&(array->mapSize-1);
+			array->map[h] = array->length;
+		}
+	}
+
+	elfIncRef(obj);
+}
+
+elfObject* elfBeginArray(elfArray* array)
+{
+	array->cur = 0;
+
+	return elfGetArrayNext(array);
+}
+
+elfObject* elfGetArrayNext(elfArray* array)
+{
+	// the object handed out before was removed while it was in use, it is let go only now
+	if(array->curRemoved) elfDecRef(array->curObj);
+	array->curObj = NULL;
+	array->curRemoved = ELF_FALSE;
+
+	if(array->cur >= array->length)
+	{
+		array->cur = 0;
+		return NULL;
+	}
+
+	array->curObj = array->objs[array->cur++];
+
+	return array->curObj;
+}
+
+unsigned char elfRemoveArrayObjectByIndex(elfArray* array, int idx)
+{
+	elfObject* obj;
+	int last;
+	int fill;
+	int fillSlot;
+	int lastSlot;
+
+	if(idx < 0 || idx > array->length-1) return ELF_FALSE;
+
+	obj = array->objs[idx];
+	last = array->length-1;
+
+	// in the middle of a pass the hole is filled with the object handed out last and the last one
+	// takes its place, so the objects still to come stay in front of the cursor
+	fill = idx < array->cur ? array->cur-1 : idx;
+
+	if(array->map)
+	{
+		elfRemoveArrayMapSlot(array, elfGetArrayMapSlot(array, obj));
+		fillSlot = fill != idx ? elfGetArrayMapSlot(array, array->objs[fill]) : -1;
+		lastSlot = last != fill ? elfGetArrayMapSlot(array, array->objs[last]) : -1;
+		if(fillSlot > -1) array->map[fillSlot] = idx+1;
+		if(lastSlot > -1) array->map[lastSlot] = fill+1;
+	}
+
+	array->objs[idx] = array->objs[fill];
+	array->objs[fill] = array->objs[last];
+	array->length--;
+
+	if(idx < array->cur) array->cur--;
+
+	if(obj == array->curObj && !array->curRemoved) array->curRemoved = ELF_TRUE;
+	else elfDecRef(obj);
+
+	return ELF_TRUE;
+}
+
+unsigned char elfRemoveArrayObject(elfArray* array, elfObject* obj)
+{
+	return elfRemoveArrayObjectByIndex(array, elfGetArrayObjectIndex(array, obj));
+}
+
+void elfClearArray(elfArray* array)
+{
+	elfObject* obj;
+
+	if(array->map) memset(array->map, 0x0, sizeof(int)*array->mapSize);
+
+	array->cur = 0;
+
+	while(array->length > 0)
+	{
+		obj = array->objs[--array->length];
+		elfDecRef(obj);
+	}
+}
+
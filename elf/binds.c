@@ -708,6 +708,20 @@ static int lua_SetConfigTextureCompress(lua_State *L)
 	elfSetConfigTextureCompress(arg0, arg1);
 	return 0;
 }
+static int lua_SetConfigSaveTextureCompress(lua_State *L)
+{
+	elfConfig* arg0;
+	unsigned char arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigSaveTextureCompress", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigSaveTextureCompress", 1, "elfConfig");}
+	if(!lua_isboolean(L, 2)) {return lua_fail_arg(L, "SetConfigSaveTextureCompress", 2, "boolean");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (unsigned char)lua_toboolean(L, 2);
+	elfSetConfigSaveTextureCompress(arg0, arg1);
+	return 0;
+}
 static int lua_SetConfigTextureAnisotropy(lua_State *L)
 {
 	elfConfig* arg0;
@@ -764,6 +778,146 @@ static int lua_SetConfigLogPath(lua_State *L)
 	elfSetConfigLogPath(arg0, arg1);
 	return 0;
 }
+static int lua_SetConfigScriptGcMode(lua_State *L)
+{
+	elfConfig* arg0;
+	int arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigScriptGcMode", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigScriptGcMode", 1, "elfConfig");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "SetConfigScriptGcMode", 2, "number");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	elfSetConfigScriptGcMode(arg0, arg1);
+	return 0;
+}
+static int lua_SetConfigScriptGcBudget(lua_State *L)
+{
+	elfConfig* arg0;
+	int arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigScriptGcBudget", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigScriptGcBudget", 1, "elfConfig");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "SetConfigScriptGcBudget", 2, "number");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	elfSetConfigScriptGcBudget(arg0, arg1);
+	return 0;
+}
+static int lua_SetConfigThreadCount(lua_State *L)
+{
+	elfConfig* arg0;
+	int arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigThreadCount", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigThreadCount", 1, "elfConfig");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "SetConfigThreadCount", 2, "number");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	elfSetConfigThreadCount(arg0, arg1);
+	return 0;
+}
+static int lua_SetConfigMapPaks(lua_State *L)
+{
+	elfConfig* arg0;
+	unsigned char arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigMapPaks", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigMapPaks", 1, "elfConfig");}
+	if(!lua_isboolean(L, 2)) {return lua_fail_arg(L, "SetConfigMapPaks", 2, "boolean");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (unsigned char)lua_toboolean(L, 2);
+	elfSetConfigMapPaks(arg0, arg1);
+	return 0;
+}
+static int lua_SetConfigLoadBudget(lua_State *L)
+{
+	elfConfig* arg0;
+	float arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigLoadBudget", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigLoadBudget", 1, "elfConfig");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "SetConfigLoadBudget", 2, "number");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (float)lua_tonumber(L, 2);
+	elfSetConfigLoadBudget(arg0, arg1);
+	return 0;
+}
+static int lua_SetConfigAnimationTolerance(lua_State *L)
+{
+	elfConfig* arg0;
+	float arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigAnimationTolerance", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigAnimationTolerance", 1, "elfConfig");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "SetConfigAnimationTolerance", 2, "number");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (float)lua_tonumber(L, 2);
+	elfSetConfigAnimationTolerance(arg0, arg1);
+	return 0;
+}
+static int lua_SetConfigStepRate(lua_State *L)
+{
+	elfConfig* arg0;
+	float arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigStepRate", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigStepRate", 1, "elfConfig");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "SetConfigStepRate", 2, "number");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (float)lua_tonumber(L, 2);
+	elfSetConfigStepRate(arg0, arg1);
+	return 0;
+}
+static int lua_SetConfigMaxSteps(lua_State *L)
+{
+	elfConfig* arg0;
+	int arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigMaxSteps", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigMaxSteps", 1, "elfConfig");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "SetConfigMaxSteps", 2, "number");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	elfSetConfigMaxSteps(arg0, arg1);
+	return 0;
+}
+static int lua_SetConfigHeadless(lua_State *L)
+{
+	elfConfig* arg0;
+	unsigned char arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigHeadless", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigHeadless", 1, "elfConfig");}
+	if(!lua_isboolean(L, 2)) {return lua_fail_arg(L, "SetConfigHeadless", 2, "boolean");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (unsigned char)lua_toboolean(L, 2);
+	elfSetConfigHeadless(arg0, arg1);
+	return 0;
+}
+static int lua_SetConfigBenchmarkTicks(lua_State *L)
+{
+	elfConfig* arg0;
+	int arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetConfigBenchmarkTicks", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "SetConfigBenchmarkTicks", 1, "elfConfig");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "SetConfigBenchmarkTicks", 2, "number");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	elfSetConfigBenchmarkTicks(arg0, arg1);
+	return 0;
+}
 static int lua_GetConfigWindowSize(lua_State *L)
 {
 	elfVec2i result;
@@ -816,6 +970,19 @@ static int lua_GetConfigTextureCompress(lua_State *L)
 	lua_pushboolean(L, result);
 	return 1;
 }
+static int lua_GetConfigSaveTextureCompress(lua_State *L)
+{
+	unsigned char result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigSaveTextureCompress", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigSaveTextureCompress", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigSaveTextureCompress(arg0);
+	lua_pushboolean(L, result);
+	return 1;
+}
 static int lua_GetConfigTextureAnisotropy(lua_State *L)
 {
 	float result;
@@ -868,6 +1035,136 @@ static int lua_GetConfigLogPath(lua_State *L)
 	lua_pushstring(L, result);
 	return 1;
 }
+static int lua_GetConfigScriptGcMode(lua_State *L)
+{
+	int result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigScriptGcMode", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigScriptGcMode", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigScriptGcMode(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetConfigScriptGcBudget(lua_State *L)
+{
+	int result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigScriptGcBudget", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigScriptGcBudget", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigScriptGcBudget(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetConfigThreadCount(lua_State *L)
+{
+	int result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigThreadCount", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigThreadCount", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigThreadCount(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetConfigMapPaks(lua_State *L)
+{
+	unsigned char result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigMapPaks", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigMapPaks", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigMapPaks(arg0);
+	lua_pushboolean(L, result);
+	return 1;
+}
+static int lua_GetConfigLoadBudget(lua_State *L)
+{
+	float result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigLoadBudget", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigLoadBudget", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigLoadBudget(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetConfigAnimationTolerance(lua_State *L)
+{
+	float result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigAnimationTolerance", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigAnimationTolerance", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigAnimationTolerance(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetConfigStepRate(lua_State *L)
+{
+	float result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigStepRate", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigStepRate", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigStepRate(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetConfigMaxSteps(lua_State *L)
+{
+	int result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigMaxSteps", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigMaxSteps", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigMaxSteps(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetConfigHeadless(lua_State *L)
+{
+	unsigned char result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigHeadless", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigHeadless", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigHeadless(arg0);
+	lua_pushboolean(L, result);
+	return 1;
+}
+static int lua_GetConfigBenchmarkTicks(lua_State *L)
+{
+	int result;
+	elfConfig* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetConfigBenchmarkTicks", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_CONFIG)
+		{return lua_fail_arg(L, "GetConfigBenchmarkTicks", 1, "elfConfig");}
+	arg0 = (elfConfig*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetConfigBenchmarkTicks(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
 static int lua_WriteLogLine(lua_State *L)
 {
 	const char* arg0;
@@ -1236,6 +1533,25 @@ static int lua_Quit(lua_State *L)
 	elfQuit();
 	return 0;
 }
+static int lua_IsHeadless(lua_State *L)
+{
+	unsigned char result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "IsHeadless", lua_gettop(L), 0);}
+	result = elfIsHeadless();
+	lua_pushboolean(L, result);
+	return 1;
+}
+static int lua_Benchmark(lua_State *L)
+{
+	float result;
+	int arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "Benchmark", lua_gettop(L), 1);}
+	if(!lua_isnumber(L, 1)) {return lua_fail_arg(L, "Benchmark", 1, "number");}
+	arg0 = (int)lua_tonumber(L, 1);
+	result = elfBenchmark(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
 static int lua_SetF10Exit(lua_State *L)
 {
 	unsigned char arg0;
@@ -1265,6 +1581,27 @@ static int lua_LoadScene(lua_State *L)
 	else lua_pushnil(L);
 	return 1;
 }
+static int lua_LoadSceneAsync(lua_State *L)
+{
+	elfSceneLoader* result;
+	const char* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "LoadSceneAsync", lua_gettop(L), 1);}
+	if(!lua_isstring(L, 1)) {return lua_fail_arg(L, "LoadSceneAsync", 1, "string");}
+	arg0 = lua_tostring(L, 1);
+	result = elfLoadSceneAsync(arg0);
+	if(result) lua_create_elfObject(L, (elfObject*)result);
+	else lua_pushnil(L);
+	return 1;
+}
+static int lua_GetSceneLoader(lua_State *L)
+{
+	elfSceneLoader* result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetSceneLoader", lua_gettop(L), 0);}
+	result = elfGetSceneLoader();
+	if(result) lua_create_elfObject(L, (elfObject*)result);
+	else lua_pushnil(L);
+	return 1;
+}
 static int lua_SetScene(lua_State *L)
 {
 	elfScene* arg0;
@@ -1321,6 +1658,17 @@ static int lua_GetFps(lua_State *L)
 	lua_pushnumber(L, (lua_Number)result);
 	return 1;
 }
+static int lua_GetFrameTimePercentile(lua_State *L)
+{
+	float result;
+	float arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetFrameTimePercentile", lua_gettop(L), 1);}
+	if(!lua_isnumber(L, 1)) {return lua_fail_arg(L, "GetFrameTimePercentile", 1, "number");}
+	arg0 = (float)lua_tonumber(L, 1);
+	result = elfGetFrameTimePercentile(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
 static int lua_SaveScreenShot(lua_State *L)
 {
 	unsigned char result;
@@ -1383,6 +1731,98 @@ static int lua_GetSpeed(lua_State *L)
 	lua_pushnumber(L, (lua_Number)result);
 	return 1;
 }
+static int lua_SetStepRate(lua_State *L)
+{
+	float arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "SetStepRate", lua_gettop(L), 1);}
+	if(!lua_isnumber(L, 1)) {return lua_fail_arg(L, "SetStepRate", 1, "number");}
+	arg0 = (float)lua_tonumber(L, 1);
+	elfSetStepRate(arg0);
+	return 0;
+}
+static int lua_GetStepRate(lua_State *L)
+{
+	float result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetStepRate", lua_gettop(L), 0);}
+	result = elfGetStepRate();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_SetMaxSteps(lua_State *L)
+{
+	int arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "SetMaxSteps", lua_gettop(L), 1);}
+	if(!lua_isnumber(L, 1)) {return lua_fail_arg(L, "SetMaxSteps", 1, "number");}
+	arg0 = (int)lua_tonumber(L, 1);
+	elfSetMaxSteps(arg0);
+	return 0;
+}
+static int lua_GetMaxSteps(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetMaxSteps", lua_gettop(L), 0);}
+	result = elfGetMaxSteps();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetSteps(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetSteps", lua_gettop(L), 0);}
+	result = elfGetSteps();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetStepAlpha(lua_State *L)
+{
+	float result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetStepAlpha", lua_gettop(L), 0);}
+	result = elfGetStepAlpha();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_SetScriptGcMode(lua_State *L)
+{
+	int arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "SetScriptGcMode", lua_gettop(L), 1);}
+	if(!lua_isnumber(L, 1)) {return lua_fail_arg(L, "SetScriptGcMode", 1, "number");}
+	arg0 = (int)lua_tonumber(L, 1);
+	elfSetScriptGcMode(arg0);
+	return 0;
+}
+static int lua_GetScriptGcMode(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetScriptGcMode", lua_gettop(L), 0);}
+	result = elfGetScriptGcMode();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_SetScriptGcBudget(lua_State *L)
+{
+	int arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "SetScriptGcBudget", lua_gettop(L), 1);}
+	if(!lua_isnumber(L, 1)) {return lua_fail_arg(L, "SetScriptGcBudget", 1, "number");}
+	arg0 = (int)lua_tonumber(L, 1);
+	elfSetScriptGcBudget(arg0);
+	return 0;
+}
+static int lua_GetScriptGcBudget(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetScriptGcBudget", lua_gettop(L), 0);}
+	result = elfGetScriptGcBudget();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetThreadCount(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetThreadCount", lua_gettop(L), 0);}
+	result = elfGetThreadCount();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
 static int lua_SetTextureCompress(lua_State *L)
 {
 	unsigned char arg0;
@@ -1400,6 +1840,40 @@ static int lua_GetTextureCompress(lua_State *L)
 	lua_pushboolean(L, result);
 	return 1;
 }
+static int lua_SetSaveTextureCompress(lua_State *L)
+{
+	unsigned char arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "SetSaveTextureCompress", lua_gettop(L), 1);}
+	if(!lua_isboolean(L, 1)) {return lua_fail_arg(L, "SetSaveTextureCompress", 1, "boolean");}
+	arg0 = (unsigned char)lua_toboolean(L, 1);
+	elfSetSaveTextureCompress(arg0);
+	return 0;
+}
+static int lua_GetSaveTextureCompress(lua_State *L)
+{
+	unsigned char result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetSaveTextureCompress", lua_gettop(L), 0);}
+	result = elfGetSaveTextureCompress();
+	lua_pushboolean(L, result);
+	return 1;
+}
+static int lua_SetMapPaks(lua_State *L)
+{
+	unsigned char arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "SetMapPaks", lua_gettop(L), 1);}
+	if(!lua_isboolean(L, 1)) {return lua_fail_arg(L, "SetMapPaks", 1, "boolean");}
+	arg0 = (unsigned char)lua_toboolean(L, 1);
+	elfSetMapPaks(arg0);
+	return 0;
+}
+static int lua_GetMapPaks(lua_State *L)
+{
+	unsigned char result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetMapPaks", lua_gettop(L), 0);}
+	result = elfGetMapPaks();
+	lua_pushboolean(L, result);
+	return 1;
+}
 static int lua_SetTextureAnisotropy(lua_State *L)
 {
 	float arg0;
@@ -1442,6 +1916,62 @@ static int lua_GetPolygonsRendered(lua_State *L)
 	lua_pushnumber(L, (lua_Number)result);
 	return 1;
 }
+static int lua_GetGlCalls(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetGlCalls", lua_gettop(L), 0);}
+	result = elfGetGlCalls();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetDrawCalls(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetDrawCalls", lua_gettop(L), 0);}
+	result = elfGetDrawCalls();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetInstancesDrawn(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetInstancesDrawn", lua_gettop(L), 0);}
+	result = elfGetInstancesDrawn();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetShaderSwitches(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetShaderSwitches", lua_gettop(L), 0);}
+	result = elfGetShaderSwitches();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetTextureSwitches(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetTextureSwitches", lua_gettop(L), 0);}
+	result = elfGetTextureSwitches();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetBlendSwitches(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetBlendSwitches", lua_gettop(L), 0);}
+	result = elfGetBlendSwitches();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetShaderProgramCount(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetShaderProgramCount", lua_gettop(L), 0);}
+	result = elfGetShaderProgramCount();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
 static int lua_SetBloom(lua_State *L)
 {
 	float arg0;
@@ -2224,76 +2754,202 @@ static int lua_GetFramePlayerSpeed(lua_State *L)
 	lua_pushnumber(L, (lua_Number)result);
 	return 1;
 }
-static int lua_GetFramePlayerFrame(lua_State *L)
+static int lua_GetFramePlayerFrame(lua_State *L)
+{
+	float result;
+	elfFramePlayer* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetFramePlayerFrame", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_FRAME_PLAYER)
+		{return lua_fail_arg(L, "GetFramePlayerFrame", 1, "elfFramePlayer");}
+	arg0 = (elfFramePlayer*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetFramePlayerFrame(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_IsFramePlayerPlaying(lua_State *L)
+{
+	unsigned char result;
+	elfFramePlayer* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "IsFramePlayerPlaying", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_FRAME_PLAYER)
+		{return lua_fail_arg(L, "IsFramePlayerPlaying", 1, "elfFramePlayer");}
+	arg0 = (elfFramePlayer*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfIsFramePlayerPlaying(arg0);
+	lua_pushboolean(L, result);
+	return 1;
+}
+static int lua_IsFramePlayerPaused(lua_State *L)
+{
+	unsigned char result;
+	elfFramePlayer* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "IsFramePlayerPaused", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_FRAME_PLAYER)
+		{return lua_fail_arg(L, "IsFramePlayerPaused", 1, "elfFramePlayer");}
+	arg0 = (elfFramePlayer*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfIsFramePlayerPaused(arg0);
+	lua_pushboolean(L, result);
+	return 1;
+}
+static int lua_CreateTimer(lua_State *L)
+{
+	elfTimer* result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "CreateTimer", lua_gettop(L), 0);}
+	result = elfCreateTimer();
+	if(result) lua_create_elfObject(L, (elfObject*)result);
+	else lua_pushnil(L);
+	return 1;
+}
+static int lua_StartTimer(lua_State *L)
+{
+	elfTimer* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "StartTimer", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_TIMER)
+		{return lua_fail_arg(L, "StartTimer", 1, "elfTimer");}
+	arg0 = (elfTimer*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	elfStartTimer(arg0);
+	return 0;
+}
+static int lua_GetElapsedTime(lua_State *L)
+{
+	double result;
+	elfTimer* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetElapsedTime", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_TIMER)
+		{return lua_fail_arg(L, "GetElapsedTime", 1, "elfTimer");}
+	arg0 = (elfTimer*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetElapsedTime(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_SetProfiling(lua_State *L)
+{
+	unsigned char arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "SetProfiling", lua_gettop(L), 1);}
+	if(!lua_isboolean(L, 1)) {return lua_fail_arg(L, "SetProfiling", 1, "boolean");}
+	arg0 = (unsigned char)lua_toboolean(L, 1);
+	elfSetProfiling(arg0);
+	return 0;
+}
+static int lua_IsProfiling(lua_State *L)
+{
+	unsigned char result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "IsProfiling", lua_gettop(L), 0);}
+	result = elfIsProfiling();
+	lua_pushboolean(L, result);
+	return 1;
+}
+static int lua_ClearProfile(lua_State *L)
+{
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "ClearProfile", lua_gettop(L), 0);}
+	elfClearProfile();
+	return 0;
+}
+static int lua_GetProfileFrameCount(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetProfileFrameCount", lua_gettop(L), 0);}
+	result = elfGetProfileFrameCount();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetProfileFrameTime(lua_State *L)
+{
+	float result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetProfileFrameTime", lua_gettop(L), 0);}
+	result = elfGetProfileFrameTime();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetProfileScopeCount(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetProfileScopeCount", lua_gettop(L), 0);}
+	result = elfGetProfileScopeCount();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetProfileScopeName(lua_State *L)
+{
+	const char* result;
+	int arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetProfileScopeName", lua_gettop(L), 1);}
+	if(!lua_isnumber(L, 1)) {return lua_fail_arg(L, "GetProfileScopeName", 1, "number");}
+	arg0 = (int)lua_tonumber(L, 1);
+	result = elfGetProfileScopeName(arg0);
+	lua_pushstring(L, result);
+	return 1;
+}
+static int lua_GetProfileScopeTime(lua_State *L)
+{
+	float result;
+	int arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetProfileScopeTime", lua_gettop(L), 1);}
+	if(!lua_isnumber(L, 1)) {return lua_fail_arg(L, "GetProfileScopeTime", 1, "number");}
+	arg0 = (int)lua_tonumber(L, 1);
+	result = elfGetProfileScopeTime(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetProfileScopeDepth(lua_State *L)
 {
-	float result;
-	elfFramePlayer* arg0;
-	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetFramePlayerFrame", lua_gettop(L), 1);}
-	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
-		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_FRAME_PLAYER)
-		{return lua_fail_arg(L, "GetFramePlayerFrame", 1, "elfFramePlayer");}
-	arg0 = (elfFramePlayer*)((lua_elfObject*)lua_touserdata(L, 1))->object;
-	result = elfGetFramePlayerFrame(arg0);
+	int result;
+	int arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetProfileScopeDepth", lua_gettop(L), 1);}
+	if(!lua_isnumber(L, 1)) {return lua_fail_arg(L, "GetProfileScopeDepth", 1, "number");}
+	arg0 = (int)lua_tonumber(L, 1);
+	result = elfGetProfileScopeDepth(arg0);
 	lua_pushnumber(L, (lua_Number)result);
 	return 1;
 }
-static int lua_IsFramePlayerPlaying(lua_State *L)
+static int lua_GetProfileTime(lua_State *L)
 {
-	unsigned char result;
-	elfFramePlayer* arg0;
-	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "IsFramePlayerPlaying", lua_gettop(L), 1);}
-	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
-		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_FRAME_PLAYER)
-		{return lua_fail_arg(L, "IsFramePlayerPlaying", 1, "elfFramePlayer");}
-	arg0 = (elfFramePlayer*)((lua_elfObject*)lua_touserdata(L, 1))->object;
-	result = elfIsFramePlayerPlaying(arg0);
-	lua_pushboolean(L, result);
+	float result;
+	const char* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetProfileTime", lua_gettop(L), 1);}
+	if(!lua_isstring(L, 1)) {return lua_fail_arg(L, "GetProfileTime", 1, "string");}
+	arg0 = lua_tostring(L, 1);
+	result = elfGetProfileTime(arg0);
+	lua_pushnumber(L, (lua_Number)result);
 	return 1;
 }
-static int lua_IsFramePlayerPaused(lua_State *L)
+static int lua_GetProfileDrawCalls(lua_State *L)
 {
-	unsigned char result;
-	elfFramePlayer* arg0;
-	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "IsFramePlayerPaused", lua_gettop(L), 1);}
-	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
-		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_FRAME_PLAYER)
-		{return lua_fail_arg(L, "IsFramePlayerPaused", 1, "elfFramePlayer");}
-	arg0 = (elfFramePlayer*)((lua_elfObject*)lua_touserdata(L, 1))->object;
-	result = elfIsFramePlayerPaused(arg0);
-	lua_pushboolean(L, result);
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetProfileDrawCalls", lua_gettop(L), 0);}
+	result = elfGetProfileDrawCalls();
+	lua_pushnumber(L, (lua_Number)result);
 	return 1;
 }
-static int lua_CreateTimer(lua_State *L)
+static int lua_GetProfileStateChanges(lua_State *L)
 {
-	elfTimer* result;
-	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "CreateTimer", lua_gettop(L), 0);}
-	result = elfCreateTimer();
-	if(result) lua_create_elfObject(L, (elfObject*)result);
-	else lua_pushnil(L);
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetProfileStateChanges", lua_gettop(L), 0);}
+	result = elfGetProfileStateChanges();
+	lua_pushnumber(L, (lua_Number)result);
 	return 1;
 }
-static int lua_StartTimer(lua_State *L)
+static int lua_GetProfileUploads(lua_State *L)
 {
-	elfTimer* arg0;
-	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "StartTimer", lua_gettop(L), 1);}
-	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
-		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_TIMER)
-		{return lua_fail_arg(L, "StartTimer", 1, "elfTimer");}
-	arg0 = (elfTimer*)((lua_elfObject*)lua_touserdata(L, 1))->object;
-	elfStartTimer(arg0);
-	return 0;
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetProfileUploads", lua_gettop(L), 0);}
+	result = elfGetProfileUploads();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
 }
-static int lua_GetElapsedTime(lua_State *L)
+static int lua_SaveProfileTrace(lua_State *L)
 {
-	double result;
-	elfTimer* arg0;
-	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetElapsedTime", lua_gettop(L), 1);}
-	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
-		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_TIMER)
-		{return lua_fail_arg(L, "GetElapsedTime", 1, "elfTimer");}
-	arg0 = (elfTimer*)((lua_elfObject*)lua_touserdata(L, 1))->object;
-	result = elfGetElapsedTime(arg0);
-	lua_pushnumber(L, (lua_Number)result);
+	unsigned char result;
+	const char* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "SaveProfileTrace", lua_gettop(L), 1);}
+	if(!lua_isstring(L, 1)) {return lua_fail_arg(L, "SaveProfileTrace", 1, "string");}
+	arg0 = lua_tostring(L, 1);
+	result = elfSaveProfileTrace(arg0);
+	lua_pushboolean(L, result);
 	return 1;
 }
 static int lua_CreateEmptyImage(lua_State *L)
@@ -6007,6 +6663,132 @@ static int lua_IsEntityArmaturePaused(lua_State *L)
 	lua_pushboolean(L, result);
 	return 1;
 }
+static int lua_SetEntityArmatureLayerWeight(lua_State *L)
+{
+	elfEntity* arg0;
+	int arg1;
+	float arg2;
+	if(lua_gettop(L) != 3) {return lua_fail_arg_count(L, "SetEntityArmatureLayerWeight", lua_gettop(L), 3);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_ENTITY)
+		{return lua_fail_arg(L, "SetEntityArmatureLayerWeight", 1, "elfEntity");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "SetEntityArmatureLayerWeight", 2, "number");}
+	if(!lua_isnumber(L, 3)) {return lua_fail_arg(L, "SetEntityArmatureLayerWeight", 3, "number");}
+	arg0 = (elfEntity*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	arg2 = (float)lua_tonumber(L, 3);
+	elfSetEntityArmatureLayerWeight(arg0, arg1, arg2);
+	return 0;
+}
+static int lua_SetEntityArmatureLayerFrame(lua_State *L)
+{
+	elfEntity* arg0;
+	int arg1;
+	float arg2;
+	if(lua_gettop(L) != 3) {return lua_fail_arg_count(L, "SetEntityArmatureLayerFrame", lua_gettop(L), 3);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_ENTITY)
+		{return lua_fail_arg(L, "SetEntityArmatureLayerFrame", 1, "elfEntity");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "SetEntityArmatureLayerFrame", 2, "number");}
+	if(!lua_isnumber(L, 3)) {return lua_fail_arg(L, "SetEntityArmatureLayerFrame", 3, "number");}
+	arg0 = (elfEntity*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	arg2 = (float)lua_tonumber(L, 3);
+	elfSetEntityArmatureLayerFrame(arg0, arg1, arg2);
+	return 0;
+}
+static int lua_PlayEntityArmatureLayer(lua_State *L)
+{
+	elfEntity* arg0;
+	int arg1;
+	float arg2;
+	float arg3;
+	float arg4;
+	if(lua_gettop(L) != 5) {return lua_fail_arg_count(L, "PlayEntityArmatureLayer", lua_gettop(L), 5);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_ENTITY)
+		{return lua_fail_arg(L, "PlayEntityArmatureLayer", 1, "elfEntity");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "PlayEntityArmatureLayer", 2, "number");}
+	if(!lua_isnumber(L, 3)) {return lua_fail_arg(L, "PlayEntityArmatureLayer", 3, "number");}
+	if(!lua_isnumber(L, 4)) {return lua_fail_arg(L, "PlayEntityArmatureLayer", 4, "number");}
+	if(!lua_isnumber(L, 5)) {return lua_fail_arg(L, "PlayEntityArmatureLayer", 5, "number");}
+	arg0 = (elfEntity*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	arg2 = (float)lua_tonumber(L, 3);
+	arg3 = (float)lua_tonumber(L, 4);
+	arg4 = (float)lua_tonumber(L, 5);
+	elfPlayEntityArmatureLayer(arg0, arg1, arg2, arg3, arg4);
+	return 0;
+}
+static int lua_LoopEntityArmatureLayer(lua_State *L)
+{
+	elfEntity* arg0;
+	int arg1;
+	float arg2;
+	float arg3;
+	float arg4;
+	if(lua_gettop(L) != 5) {return lua_fail_arg_count(L, "LoopEntityArmatureLayer", lua_gettop(L), 5);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_ENTITY)
+		{return lua_fail_arg(L, "LoopEntityArmatureLayer", 1, "elfEntity");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "LoopEntityArmatureLayer", 2, "number");}
+	if(!lua_isnumber(L, 3)) {return lua_fail_arg(L, "LoopEntityArmatureLayer", 3, "number");}
+	if(!lua_isnumber(L, 4)) {return lua_fail_arg(L, "LoopEntityArmatureLayer", 4, "number");}
+	if(!lua_isnumber(L, 5)) {return lua_fail_arg(L, "LoopEntityArmatureLayer", 5, "number");}
+	arg0 = (elfEntity*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	arg2 = (float)lua_tonumber(L, 3);
+	arg3 = (float)lua_tonumber(L, 4);
+	arg4 = (float)lua_tonumber(L, 5);
+	elfLoopEntityArmatureLayer(arg0, arg1, arg2, arg3, arg4);
+	return 0;
+}
+static int lua_StopEntityArmatureLayer(lua_State *L)
+{
+	elfEntity* arg0;
+	int arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "StopEntityArmatureLayer", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_ENTITY)
+		{return lua_fail_arg(L, "StopEntityArmatureLayer", 1, "elfEntity");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "StopEntityArmatureLayer", 2, "number");}
+	arg0 = (elfEntity*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	elfStopEntityArmatureLayer(arg0, arg1);
+	return 0;
+}
+static int lua_GetEntityArmatureLayerWeight(lua_State *L)
+{
+	float result;
+	elfEntity* arg0;
+	int arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "GetEntityArmatureLayerWeight", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_ENTITY)
+		{return lua_fail_arg(L, "GetEntityArmatureLayerWeight", 1, "elfEntity");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "GetEntityArmatureLayerWeight", 2, "number");}
+	arg0 = (elfEntity*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	result = elfGetEntityArmatureLayerWeight(arg0, arg1);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetEntityArmatureLayerFrame(lua_State *L)
+{
+	float result;
+	elfEntity* arg0;
+	int arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "GetEntityArmatureLayerFrame", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_ENTITY)
+		{return lua_fail_arg(L, "GetEntityArmatureLayerFrame", 1, "elfEntity");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "GetEntityArmatureLayerFrame", 2, "number");}
+	arg0 = (elfEntity*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (int)lua_tonumber(L, 2);
+	result = elfGetEntityArmatureLayerFrame(arg0, arg1);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
 static int lua_GetEntityArmature(lua_State *L)
 {
 	elfArmature* result;
@@ -7631,6 +8413,33 @@ static int lua_GetSceneOcclusionCulling(lua_State *L)
 	lua_pushboolean(L, result);
 	return 1;
 }
+static int lua_SetSceneSpatialIndex(lua_State *L)
+{
+	elfScene* arg0;
+	unsigned char arg1;
+	if(lua_gettop(L) != 2) {return lua_fail_arg_count(L, "SetSceneSpatialIndex", lua_gettop(L), 2);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_SCENE)
+		{return lua_fail_arg(L, "SetSceneSpatialIndex", 1, "elfScene");}
+	if(!lua_isboolean(L, 2)) {return lua_fail_arg(L, "SetSceneSpatialIndex", 2, "boolean");}
+	arg0 = (elfScene*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (unsigned char)lua_toboolean(L, 2);
+	elfSetSceneSpatialIndex(arg0, arg1);
+	return 0;
+}
+static int lua_GetSceneSpatialIndex(lua_State *L)
+{
+	unsigned char result;
+	elfScene* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetSceneSpatialIndex", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_SCENE)
+		{return lua_fail_arg(L, "GetSceneSpatialIndex", 1, "elfScene");}
+	arg0 = (elfScene*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetSceneSpatialIndex(arg0);
+	lua_pushboolean(L, result);
+	return 1;
+}
 static int lua_SetSceneGravity(lua_State *L)
 {
 	elfScene* arg0;
@@ -8133,6 +8942,38 @@ static int lua_GetDebugSceneRayCastResults(lua_State *L)
 	else lua_pushnil(L);
 	return 1;
 }
+static int lua_GetSceneRayCastEntity(lua_State *L)
+{
+	elfEntity* result;
+	elfScene* arg0;
+	float arg1;
+	float arg2;
+	float arg3;
+	float arg4;
+	float arg5;
+	float arg6;
+	if(lua_gettop(L) != 7) {return lua_fail_arg_count(L, "GetSceneRayCastEntity", lua_gettop(L), 7);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_SCENE)
+		{return lua_fail_arg(L, "GetSceneRayCastEntity", 1, "elfScene");}
+	if(!lua_isnumber(L, 2)) {return lua_fail_arg(L, "GetSceneRayCastEntity", 2, "number");}
+	if(!lua_isnumber(L, 3)) {return lua_fail_arg(L, "GetSceneRayCastEntity", 3, "number");}
+	if(!lua_isnumber(L, 4)) {return lua_fail_arg(L, "GetSceneRayCastEntity", 4, "number");}
+	if(!lua_isnumber(L, 5)) {return lua_fail_arg(L, "GetSceneRayCastEntity", 5, "number");}
+	if(!lua_isnumber(L, 6)) {return lua_fail_arg(L, "GetSceneRayCastEntity", 6, "number");}
+	if(!lua_isnumber(L, 7)) {return lua_fail_arg(L, "GetSceneRayCastEntity", 7, "number");}
+	arg0 = (elfScene*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	arg1 = (float)lua_tonumber(L, 2);
+	arg2 = (float)lua_tonumber(L, 3);
+	arg3 = (float)lua_tonumber(L, 4);
+	arg4 = (float)lua_tonumber(L, 5);
+	arg5 = (float)lua_tonumber(L, 6);
+	arg6 = (float)lua_tonumber(L, 7);
+	result = elfGetSceneRayCastEntity(arg0, arg1, arg2, arg3, arg4, arg5, arg6);
+	if(result) lua_create_elfObject(L, (elfObject*)result);
+	else lua_pushnil(L);
+	return 1;
+}
 static int lua_GetSceneCameraByIndex(lua_State *L)
 {
 	elfCamera* result;
@@ -8746,6 +9587,59 @@ static int lua_GetSceneModels(lua_State *L)
 	else lua_pushnil(L);
 	return 1;
 }
+static int lua_GetSceneLoaderFilePath(lua_State *L)
+{
+	const char* result;
+	elfSceneLoader* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetSceneLoaderFilePath", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_SCENE_LOADER)
+		{return lua_fail_arg(L, "GetSceneLoaderFilePath", 1, "elfSceneLoader");}
+	arg0 = (elfSceneLoader*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetSceneLoaderFilePath(arg0);
+	lua_pushstring(L, result);
+	return 1;
+}
+static int lua_GetSceneLoaderProgress(lua_State *L)
+{
+	float result;
+	elfSceneLoader* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetSceneLoaderProgress", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_SCENE_LOADER)
+		{return lua_fail_arg(L, "GetSceneLoaderProgress", 1, "elfSceneLoader");}
+	arg0 = (elfSceneLoader*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetSceneLoaderProgress(arg0);
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_IsSceneLoaderDone(lua_State *L)
+{
+	unsigned char result;
+	elfSceneLoader* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "IsSceneLoaderDone", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_SCENE_LOADER)
+		{return lua_fail_arg(L, "IsSceneLoaderDone", 1, "elfSceneLoader");}
+	arg0 = (elfSceneLoader*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfIsSceneLoaderDone(arg0);
+	lua_pushboolean(L, result);
+	return 1;
+}
+static int lua_GetSceneLoaderScene(lua_State *L)
+{
+	elfScene* result;
+	elfSceneLoader* arg0;
+	if(lua_gettop(L) != 1) {return lua_fail_arg_count(L, "GetSceneLoaderScene", lua_gettop(L), 1);}
+	if(!lua_isuserdata(L, 1) || ((lua_elf_userdata*)lua_touserdata(L,1))->type != LUA_ELF_OBJECT ||
+		elfGetObjectType(((lua_elfObject*)lua_touserdata(L, 1))->object) != ELF_SCENE_LOADER)
+		{return lua_fail_arg(L, "GetSceneLoaderScene", 1, "elfSceneLoader");}
+	arg0 = (elfSceneLoader*)((lua_elfObject*)lua_touserdata(L, 1))->object;
+	result = elfGetSceneLoaderScene(arg0);
+	if(result) lua_create_elfObject(L, (elfObject*)result);
+	else lua_pushnil(L);
+	return 1;
+}
 static int lua_CreateScript(lua_State *L)
 {
 	elfScript* result;
@@ -8864,6 +9758,22 @@ static int lua_RunScript(lua_State *L)
 	lua_pushboolean(L, result);
 	return 1;
 }
+static int lua_GetScriptGcTime(lua_State *L)
+{
+	float result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetScriptGcTime", lua_gettop(L), 0);}
+	result = elfGetScriptGcTime();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
+static int lua_GetScriptMemory(lua_State *L)
+{
+	int result;
+	if(lua_gettop(L) != 0) {return lua_fail_arg_count(L, "GetScriptMemory", lua_gettop(L), 0);}
+	result = elfGetScriptMemory();
+	lua_pushnumber(L, (lua_Number)result);
+	return 1;
+}
 static int lua_SetAudioVolume(lua_State *L)
 {
 	float arg0;
@@ -10953,18 +11863,40 @@ static const struct luaL_reg lua_elf_functions[] = {
 	{"SetConfigMultisamples", lua_SetConfigMultisamples},
 	{"SetConfigFullscreen", lua_SetConfigFullscreen},
 	{"SetConfigTextureCompress", lua_SetConfigTextureCompress},
+	{"SetConfigSaveTextureCompress", lua_SetConfigSaveTextureCompress},
 	{"SetConfigTextureAnisotropy", lua_SetConfigTextureAnisotropy},
 	{"SetConfigShadowMapSize", lua_SetConfigShadowMapSize},
 	{"SetConfigStart", lua_SetConfigStart},
 	{"SetConfigLogPath", lua_SetConfigLogPath},
+	{"SetConfigScriptGcMode", lua_SetConfigScriptGcMode},
+	{"SetConfigScriptGcBudget", lua_SetConfigScriptGcBudget},
+	{"SetConfigThreadCount", lua_SetConfigThreadCount},
+	{"SetConfigMapPaks", lua_SetConfigMapPaks},
+	{"SetConfigLoadBudget", lua_SetConfigLoadBudget},
+	{"SetConfigAnimationTolerance", lua_SetConfigAnimationTolerance},
+	{"SetConfigStepRate", lua_SetConfigStepRate},
+	{"SetConfigMaxSteps", lua_SetConfigMaxSteps},
+	{"SetConfigHeadless", lua_SetConfigHeadless},
+	{"SetConfigBenchmarkTicks", lua_SetConfigBenchmarkTicks},
 	{"GetConfigWindowSize", lua_GetConfigWindowSize},
 	{"GetConfigMultisamples", lua_GetConfigMultisamples},
 	{"GetConfigFullscreen", lua_GetConfigFullscreen},
 	{"GetConfigTextureCompress", lua_GetConfigTextureCompress},
+	{"GetConfigSaveTextureCompress", lua_GetConfigSaveTextureCompress},
 	{"GetConfigTextureAnisotropy", lua_GetConfigTextureAnisotropy},
 	{"GetConfigShadowMapSize", lua_GetConfigShadowMapSize},
 	{"GetConfigStart", lua_GetConfigStart},
 	{"GetConfigLogPath", lua_GetConfigLogPath},
+	{"GetConfigScriptGcMode", lua_GetConfigScriptGcMode},
+	{"GetConfigScriptGcBudget", lua_GetConfigScriptGcBudget},
+	{"GetConfigThreadCount", lua_GetConfigThreadCount},
+	{"GetConfigMapPaks", lua_GetConfigMapPaks},
+	{"GetConfigLoadBudget", lua_GetConfigLoadBudget},
+	{"GetConfigAnimationTolerance", lua_GetConfigAnimationTolerance},
+	{"GetConfigStepRate", lua_GetConfigStepRate},
+	{"GetConfigMaxSteps", lua_GetConfigMaxSteps},
+	{"GetConfigHeadless", lua_GetConfigHeadless},
+	{"GetConfigBenchmarkTicks", lua_GetConfigBenchmarkTicks},
 	{"WriteLogLine", lua_WriteLogLine},
 	{"SetTitle", lua_SetTitle},
 	{"GetWindowWidth", lua_GetWindowWidth},
@@ -11005,15 +11937,20 @@ static const struct luaL_reg lua_elf_functions[] = {
 	{"GetError", lua_GetError},
 	{"Run", lua_Run},
 	{"Quit", lua_Quit},
+	{"IsHeadless", lua_IsHeadless},
+	{"Benchmark", lua_Benchmark},
 	{"SetF10Exit", lua_SetF10Exit},
 	{"GetF10Exit", lua_GetF10Exit},
 	{"LoadScene", lua_LoadScene},
+	{"LoadSceneAsync", lua_LoadSceneAsync},
+	{"GetSceneLoader", lua_GetSceneLoader},
 	{"SetScene", lua_SetScene},
 	{"GetScene", lua_GetScene},
 	{"SetGui", lua_SetGui},
 	{"GetGui", lua_GetGui},
 	{"GetSync", lua_GetSync},
 	{"GetFps", lua_GetFps},
+	{"GetFrameTimePercentile", lua_GetFrameTimePercentile},
 	{"SaveScreenShot", lua_SaveScreenShot},
 	{"SetFpsLimit", lua_SetFpsLimit},
 	{"GetFpsLimit", lua_GetFpsLimit},
@@ -11021,13 +11958,35 @@ static const struct luaL_reg lua_elf_functions[] = {
 	{"GetTickRate", lua_GetTickRate},
 	{"SetSpeed", lua_SetSpeed},
 	{"GetSpeed", lua_GetSpeed},
+	{"SetStepRate", lua_SetStepRate},
+	{"GetStepRate", lua_GetStepRate},
+	{"SetMaxSteps", lua_SetMaxSteps},
+	{"GetMaxSteps", lua_GetMaxSteps},
+	{"GetSteps", lua_GetSteps},
+	{"GetStepAlpha", lua_GetStepAlpha},
+	{"SetScriptGcMode", lua_SetScriptGcMode},
+	{"GetScriptGcMode", lua_GetScriptGcMode},
+	{"SetScriptGcBudget", lua_SetScriptGcBudget},
+	{"GetScriptGcBudget", lua_GetScriptGcBudget},
+	{"GetThreadCount", lua_GetThreadCount},
 	{"SetTextureCompress", lua_SetTextureCompress},
 	{"GetTextureCompress", lua_GetTextureCompress},
+	{"SetSaveTextureCompress", lua_SetSaveTextureCompress},
+	{"GetSaveTextureCompress", lua_GetSaveTextureCompress},
+	{"SetMapPaks", lua_SetMapPaks},
+	{"GetMapPaks", lua_GetMapPaks},
 	{"SetTextureAnisotropy", lua_SetTextureAnisotropy},
 	{"GetTextureAnisotropy", lua_GetTextureAnisotropy},
 	{"SetShadowMapSize", lua_SetShadowMapSize},
 	{"GetShadowMapSize", lua_GetShadowMapSize},
 	{"GetPolygonsRendered", lua_GetPolygonsRendered},
+	{"GetGlCalls", lua_GetGlCalls},
+	{"GetDrawCalls", lua_GetDrawCalls},
+	{"GetInstancesDrawn", lua_GetInstancesDrawn},
+	{"GetShaderSwitches", lua_GetShaderSwitches},
+	{"GetTextureSwitches", lua_GetTextureSwitches},
+	{"GetBlendSwitches", lua_GetBlendSwitches},
+	{"GetShaderProgramCount", lua_GetShaderProgramCount},
 	{"SetBloom", lua_SetBloom},
 	{"DisableBloom", lua_DisableBloom},
 	{"GetBloomThreshold", lua_GetBloomThreshold},
@@ -11098,6 +12057,20 @@ static const struct luaL_reg lua_elf_functions[] = {
 	{"CreateTimer", lua_CreateTimer},
 	{"StartTimer", lua_StartTimer},
 	{"GetElapsedTime", lua_GetElapsedTime},
+	{"SetProfiling", lua_SetProfiling},
+	{"IsProfiling", lua_IsProfiling},
+	{"ClearProfile", lua_ClearProfile},
+	{"GetProfileFrameCount", lua_GetProfileFrameCount},
+	{"GetProfileFrameTime", lua_GetProfileFrameTime},
+	{"GetProfileScopeCount", lua_GetProfileScopeCount},
+	{"GetProfileScopeName", lua_GetProfileScopeName},
+	{"GetProfileScopeTime", lua_GetProfileScopeTime},
+	{"GetProfileScopeDepth", lua_GetProfileScopeDepth},
+	{"GetProfileTime", lua_GetProfileTime},
+	{"GetProfileDrawCalls", lua_GetProfileDrawCalls},
+	{"GetProfileStateChanges", lua_GetProfileStateChanges},
+	{"GetProfileUploads", lua_GetProfileUploads},
+	{"SaveProfileTrace", lua_SaveProfileTrace},
 	{"CreateEmptyImage", lua_CreateEmptyImage},
 	{"CreateImageFromFile", lua_CreateImageFromFile},
 	{"SetImagePixel", lua_SetImagePixel},
@@ -11341,6 +12314,13 @@ static const struct luaL_reg lua_elf_functions[] = {
 	{"GetEntityArmatureFrame", lua_GetEntityArmatureFrame},
 	{"IsEntityArmaturePlaying", lua_IsEntityArmaturePlaying},
 	{"IsEntityArmaturePaused", lua_IsEntityArmaturePaused},
+	{"SetEntityArmatureLayerWeight", lua_SetEntityArmatureLayerWeight},
+	{"SetEntityArmatureLayerFrame", lua_SetEntityArmatureLayerFrame},
+	{"PlayEntityArmatureLayer", lua_PlayEntityArmatureLayer},
+	{"LoopEntityArmatureLayer", lua_LoopEntityArmatureLayer},
+	{"StopEntityArmatureLayer", lua_StopEntityArmatureLayer},
+	{"GetEntityArmatureLayerWeight", lua_GetEntityArmatureLayerWeight},
+	{"GetEntityArmatureLayerFrame", lua_GetEntityArmatureLayerFrame},
 	{"GetEntityArmature", lua_GetEntityArmature},
 	{"GetEntityChanged", lua_GetEntityChanged},
 	{"CreateLight", lua_CreateLight},
@@ -11454,6 +12434,8 @@ static const struct luaL_reg lua_elf_functions[] = {
 	{"GetSceneDebugDraw", lua_GetSceneDebugDraw},
 	{"SetSceneOcclusionCulling", lua_SetSceneOcclusionCulling},
 	{"GetSceneOcclusionCulling", lua_GetSceneOcclusionCulling},
+	{"SetSceneSpatialIndex", lua_SetSceneSpatialIndex},
+	{"GetSceneSpatialIndex", lua_GetSceneSpatialIndex},
 	{"SetSceneGravity", lua_SetSceneGravity},
 	{"GetSceneGravity", lua_GetSceneGravity},
 	{"SetSceneAmbientColor", lua_SetSceneAmbientColor},
@@ -11483,6 +12465,7 @@ static const struct luaL_reg lua_elf_functions[] = {
 	{"GetSceneRayCastResults", lua_GetSceneRayCastResults},
 	{"GetDebugSceneRayCastResult", lua_GetDebugSceneRayCastResult},
 	{"GetDebugSceneRayCastResults", lua_GetDebugSceneRayCastResults},
+	{"GetSceneRayCastEntity", lua_GetSceneRayCastEntity},
 	{"GetSceneCameraByIndex", lua_GetSceneCameraByIndex},
 	{"GetSceneEntityByIndex", lua_GetSceneEntityByIndex},
 	{"GetSceneLightByIndex", lua_GetSceneLightByIndex},
@@ -11520,6 +12503,10 @@ static const struct luaL_reg lua_elf_functions[] = {
 	{"GetSceneTextures", lua_GetSceneTextures},
 	{"GetSceneMaterials", lua_GetSceneMaterials},
 	{"GetSceneModels", lua_GetSceneModels},
+	{"GetSceneLoaderFilePath", lua_GetSceneLoaderFilePath},
+	{"GetSceneLoaderProgress", lua_GetSceneLoaderProgress},
+	{"IsSceneLoaderDone", lua_IsSceneLoaderDone},
+	{"GetSceneLoaderScene", lua_GetSceneLoaderScene},
 	{"CreateScript", lua_CreateScript},
 	{"CreateScriptFromFile", lua_CreateScriptFromFile},
 	{"SetScriptName", lua_SetScriptName},
@@ -11529,6 +12516,8 @@ static const struct luaL_reg lua_elf_functions[] = {
 	{"IsScriptError", lua_IsScriptError},
 	{"RunString", lua_RunString},
 	{"RunScript", lua_RunScript},
+	{"GetScriptGcTime", lua_GetScriptGcTime},
+	{"GetScriptMemory", lua_GetScriptMemory},
 	{"SetAudioVolume", lua_SetAudioVolume},
 	{"GetAudioVolume", lua_GetAudioVolume},
 	{"SetAudioRolloff", lua_SetAudioRolloff},
@@ -12146,9 +13135,57 @@ int luaopen_elf(lua_State* L)
 	lua_pushstring(L, "RENDER_STATION");
 	lua_pushnumber(L, 0x004A);
 	lua_settable(L, -3);
-	lua_pushstring(L, "OBJECT_TYPE_COUNT");
+	lua_pushstring(L, "ARRAY");
 	lua_pushnumber(L, 0x004B);
 	lua_settable(L, -3);
+	lua_pushstring(L, "JOB_QUEUE");
+	lua_pushnumber(L, 0x004C);
+	lua_settable(L, -3);
+	lua_pushstring(L, "SCENE_LOADER");
+	lua_pushnumber(L, 0x004D);
+	lua_settable(L, -3);
+	lua_pushstring(L, "PROFILER");
+	lua_pushnumber(L, 0x004E);
+	lua_settable(L, -3);
+	lua_pushstring(L, "PAK_MAPPING");
+	lua_pushnumber(L, 0x004F);
+	lua_settable(L, -3);
+	lua_pushstring(L, "OBJECT_TYPE_COUNT");
+	lua_pushnumber(L, 0x0050);
+	lua_settable(L, -3);
+	lua_pushstring(L, "MAX_JOB_THREADS");
+	lua_pushnumber(L, 32);
+	lua_settable(L, -3);
+	lua_pushstring(L, "BVH_LEAF_BUILD_SIZE");
+	lua_pushnumber(L, 4);
+	lua_settable(L, -3);
+	lua_pushstring(L, "BVH_LEAF_SIZE");
+	lua_pushnumber(L, 8);
+	lua_settable(L, -3);
+	lua_pushstring(L, "BVH_REBUILD_RATIO");
+	lua_pushnumber(L, 4);
+	lua_settable(L, -3);
+	lua_pushstring(L, "MAX_ARMATURE_LAYERS");
+	lua_pushnumber(L, 4);
+	lua_settable(L, -3);
+	lua_pushstring(L, "MAX_TEXT_BATCHES");
+	lua_pushnumber(L, 64);
+	lua_settable(L, -3);
+	lua_pushstring(L, "FRAME_TIME_SAMPLES");
+	lua_pushnumber(L, 256);
+	lua_settable(L, -3);
+	lua_pushstring(L, "FRAME_SPIN_TIME");
+	lua_pushnumber(L, 0.002f);
+	lua_settable(L, -3);
+	lua_pushstring(L, "PROFILE_FRAMES");
+	lua_pushnumber(L, 64);
+	lua_settable(L, -3);
+	lua_pushstring(L, "MAX_PROFILE_SCOPES");
+	lua_pushnumber(L, 128);
+	lua_settable(L, -3);
+	lua_pushstring(L, "MAX_PROFILE_DEPTH");
+	lua_pushnumber(L, 16);
+	lua_settable(L, -3);
 	lua_pushstring(L, "PERSPECTIVE");
 	lua_pushnumber(L, 0x0000);
 	lua_settable(L, -3);
@@ -12431,6 +13468,15 @@ int luaopen_elf(lua_State* L)
 	lua_pushstring(L, "WAV");
 	lua_pushnumber(L, 0x0002);
 	lua_settable(L, -3);
+	lua_pushstring(L, "SCRIPT_GC_FULL");
+	lua_pushnumber(L, 0x0000);
+	lua_settable(L, -3);
+	lua_pushstring(L, "SCRIPT_GC_STEP");
+	lua_pushnumber(L, 0x0001);
+	lua_settable(L, -3);
+	lua_pushstring(L, "SCRIPT_GC_AUTO");
+	lua_pushnumber(L, 0x0002);
+	lua_settable(L, -3);
 	lua_pushstring(L, "NO_ERROR");
 	lua_pushnumber(L, 0x0000);
 	lua_settable(L, -3);
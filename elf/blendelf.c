@@ -4,6 +4,7 @@
 #include <string.h>
 #include <stdarg.h>
 #include <math.h>
+#include <float.h>
 #include <malloc.h>
 #include <sys/types.h>
 
@@ -20,6 +21,8 @@
 	#include <windows.h>
 #else
 	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/time.h>
 #endif
 
 #include <FreeImage.h>
@@ -47,12 +50,15 @@ elfResources* res = NULL;
 #include "resource.h"
 #include "str.h"
 #include "list.h"
+#include "array.h"
+#include "jobs.h"
 #include "context.h"
 #include "engine.h"
 #include "renderstation.h"
 #include "resources.h"
 #include "frameplayer.h"
 #include "timer.h"
+#include "profiler.h"
 #include "image.h"
 #include "texture.h"
 #include "material.h"
@@ -63,7 +69,9 @@ elfResources* res = NULL;
 #include "entity.h"
 #include "light.h"
 #include "scene.h"
+#include "bvh.h"
 #include "pak.h"
+#include "loader.h"
 #include "postprocess.h"
 #include "script.h"
 #include "armature.h"
@@ -92,6 +100,14 @@ int main()
 		return -1;
 	}
 
+	// a headless benchmark runs the start scene for a fixed number of ticks and reports the throughput
+	if(config->headless && config->benchmarkTicks > 0)
+	{
+		printf("%.1f ticks per second\n", elfBenchmark(config->benchmarkTicks));
+		elfDeinit();
+		return 0;
+	}
+
 	script = elfCreateScriptFromFile("Init", "init.lua");
 	if(script)
 	{
@@ -189,7 +189,24 @@ extern "C" {
 #define ELF_LIST_PTR					0x0048
 #define ELF_RESOURCES					0x0049
 #define ELF_RENDER_STATION				0x004A
-#define ELF_OBJECT_TYPE_COUNT				0x004B	// <mdoc> NUMBER OF OBJECT TYPES
+#define ELF_ARRAY					0x004B
+#define ELF_JOB_QUEUE					0x004C
+#define ELF_SCENE_LOADER				0x004D
+#define ELF_PROFILER					0x004E
+#define ELF_PAK_MAPPING					0x004F
+#define ELF_OBJECT_TYPE_COUNT				0x0050	// <mdoc> NUMBER OF OBJECT TYPES
+
+#define ELF_MAX_JOB_THREADS				32
+#define ELF_BVH_LEAF_BUILD_SIZE				4
+#define ELF_BVH_LEAF_SIZE				8
+#define ELF_BVH_REBUILD_RATIO				4
+#define ELF_MAX_ARMATURE_LAYERS				4
+#define ELF_MAX_TEXT_BATCHES				64
+#define ELF_FRAME_TIME_SAMPLES				256
+#define ELF_FRAME_SPIN_TIME				0.002f
+#define ELF_PROFILE_FRAMES				64
+#define ELF_MAX_PROFILE_SCOPES				128
+#define ELF_MAX_PROFILE_DEPTH				16
 
 #define ELF_PERSPECTIVE					0x0000	// <mdoc> CAMERA MODE <mdocc> The camera modes used by camera internal functions
 #define ELF_ORTHOGRAPHIC				0x0001
@@ -299,6 +316,10 @@ extern "C" {
 #define ELF_OGG						0x0001	// <mdoc> SOUND FILE TYPES <mdocc> The sound file types returned by elf.GetSoundFileType
 #define ELF_WAV						0x0002
 
+#define ELF_SCRIPT_GC_FULL				0x0000	// <mdoc> SCRIPT GC MODES <mdocc> The script garbage collection modes used by elf.SetScriptGcMode. FULL does a full collection every frame, STEP runs incremental steps until the per frame budget is used up and AUTO leaves the pacing to the Lua collector
+#define ELF_SCRIPT_GC_STEP				0x0001
+#define ELF_SCRIPT_GC_AUTO				0x0002
+
 #define ELF_NO_ERROR					0x0000 // <mdoc> ERROR CODES <mdocc> error codes returned by elf.GetError
 #define ELF_INVALID_FILE				0x0001
 #define ELF_CANT_OPEN_FILE				0x0002
@@ -350,11 +371,21 @@ typedef struct elfObject				elfObject;
 typedef struct elfResource				elfResource;
 typedef struct elfGuiObject				elfGuiObject;
 typedef struct elfList					elfList;
+typedef struct elfArray					elfArray;
+typedef struct elfCullBatch				elfCullBatch;
+typedef struct elfRenderItem				elfRenderItem;
+typedef struct elfBvhNode				elfBvhNode;
+typedef struct elfBvh					elfBvh;
+typedef struct elfJob					elfJob;
+typedef struct elfJobQueue				elfJobQueue;
 typedef struct elfKeyEvent				elfKeyEvent;
 typedef struct elfCharEvent				elfCharEvent;
 typedef struct elfContext				elfContext;
 typedef struct elfEngine				elfEngine;
 typedef struct elfTimer					elfTimer;
+typedef struct elfProfileScope				elfProfileScope;
+typedef struct elfProfileFrame				elfProfileFrame;
+typedef struct elfProfiler				elfProfiler;
 
 typedef struct elfImage					elfImage;
 typedef struct elfTexture				elfTexture;
@@ -370,15 +401,21 @@ typedef struct elfLight					elfLight;
 typedef struct elfScene					elfScene;
 typedef struct elfPakIndex				elfPakIndex;
 typedef struct elfPak					elfPak;
+typedef struct elfPakMapping				elfPakMapping;
+typedef struct elfTextureDecode				elfTextureDecode;
+typedef struct elfSceneLoader				elfSceneLoader;
 typedef struct elfPostProcess				elfPostProcess;
 typedef struct elfScript				elfScript;
 typedef struct elfAudioDevice				elfAudioDevice;
 typedef struct elfAudioSource				elfAudioSource;
 typedef struct elfSound					elfSound;
 typedef struct elfBone					elfBone;
+typedef struct elfBoneFrame				elfBoneFrame;
+typedef struct elfBoneKey				elfBoneKey;
 typedef struct elfArmature				elfArmature;
 typedef struct elfString				elfString;
 typedef struct elfFont					elfFont;
+typedef struct elfTextBatch				elfTextBatch;
 typedef struct elfArea					elfArea;
 typedef struct elfLabel					elfLabel;
 typedef struct elfButton				elfButton;
@@ -397,7 +434,7 @@ typedef struct elfPhysicsObject				elfPhysicsObject;
 typedef struct elfPhysicsWorld				elfPhysicsWorld;
 typedef struct elfJoint					elfJoint;
 typedef struct elfResources				elfResources;
-typedef struct elfParticle				elfParticle;
+typedef struct elfParticlePool				elfParticlePool;
 typedef struct elfParticles				elfParticles;
 typedef struct elfFramePlayer				elfFramePlayer;
 typedef struct elfProperty				elfProperty;
@@ -505,6 +542,7 @@ ELF_API void ELF_APIENTRY elfInsertListObject(elfList* list, int idx, elfObject*
 ELF_API void ELF_APIENTRY elfAppendListObject(elfList* list, elfObject* obj);
 ELF_API unsigned char ELF_APIENTRY elfRemoveListObject(elfList* list, elfObject* obj);
 ELF_API elfObject* ELF_APIENTRY elfGetListObject(elfList* list, int idx);
+/* <!> */unsigned char elfIsListObject(elfList* list, elfObject* obj);
 ELF_API elfObject* ELF_APIENTRY elfBeginList(elfList* list);
 ELF_API elfObject* ELF_APIENTRY elfGetListNext(elfList* list);
 ELF_API elfObject* ELF_APIENTRY elfRBeginList(elfList* list);
@@ -513,6 +551,32 @@ ELF_API elfObject* ELF_APIENTRY elfGetListRNext(elfList* list);
 ELF_API void ELF_APIENTRY elfSeekList(elfList* list, elfObject* ptr);
 ELF_API void ELF_APIENTRY elfRSeekList(elfList* list, elfObject* ptr);
 
+//////////////////////////////// ARRAY ////////////////////////////////
+
+// <!!
+elfArray* elfCreateArray(unsigned char indexed);
+void elfDestroyArray(void* data);
+int elfGetArrayLength(elfArray* array);
+elfObject* elfGetArrayObject(elfArray* array, int idx);
+int elfGetArrayObjectIndex(elfArray* array, elfObject* obj);
+void elfAppendArrayObject(elfArray* array, elfObject* obj);
+elfObject* elfBeginArray(elfArray* array);
+elfObject* elfGetArrayNext(elfArray* array);
+unsigned char elfRemoveArrayObjectByIndex(elfArray* array, int idx);
+unsigned char elfRemoveArrayObject(elfArray* array, elfObject* obj);
+void elfClearArray(elfArray* array);
+// !!>
+
+//////////////////////////////// JOBS ////////////////////////////////
+
+// <!!
+elfJobQueue* elfCreateJobQueue(int threadCount);
+void elfDestroyJobQueue(void* data);
+int elfGetJobQueueThreadCount(elfJobQueue* queue);
+void elfAddJob(elfJobQueue* queue, void (*func)(void*), void* data);
+void elfWaitJobs(elfJobQueue* queue);
+// !!>
+
 /////////////////////////////// CONFIG ///////////////////////////////
 
 // <!!
@@ -526,19 +590,41 @@ ELF_API void elfSetConfigWindowSize(elfConfig* config, int width, int height);
 ELF_API void ELF_APIENTRY elfSetConfigMultisamples(elfConfig* config, int multisamples);
 ELF_API void ELF_APIENTRY elfSetConfigFullscreen(elfConfig* config, unsigned char fullscreen);
 ELF_API void ELF_APIENTRY elfSetConfigTextureCompress(elfConfig* config, unsigned char textureCompress);
+ELF_API void ELF_APIENTRY elfSetConfigSaveTextureCompress(elfConfig* config, unsigned char saveTextureCompress);
 ELF_API void ELF_APIENTRY elfSetConfigTextureAnisotropy(elfConfig* config, float textureAnisotropy);
 ELF_API void ELF_APIENTRY elfSetConfigShadowMapSize(elfConfig* config, int shadowMapSize);
 ELF_API void ELF_APIENTRY elfSetConfigStart(elfConfig* config, const char* start);
 ELF_API void ELF_APIENTRY elfSetConfigLogPath(elfConfig* config, const char* logPath);
+ELF_API void ELF_APIENTRY elfSetConfigScriptGcMode(elfConfig* config, int mode);
+ELF_API void ELF_APIENTRY elfSetConfigScriptGcBudget(elfConfig* config, int budget);
+ELF_API void ELF_APIENTRY elfSetConfigThreadCount(elfConfig* config, int count);
+ELF_API void ELF_APIENTRY elfSetConfigMapPaks(elfConfig* config, unsigned char mapPaks);
+ELF_API void ELF_APIENTRY elfSetConfigLoadBudget(elfConfig* config, float loadBudget);
+ELF_API void ELF_APIENTRY elfSetConfigAnimationTolerance(elfConfig* config, float tolerance);
+ELF_API void ELF_APIENTRY elfSetConfigStepRate(elfConfig* config, float stepRate);
+ELF_API void ELF_APIENTRY elfSetConfigMaxSteps(elfConfig* config, int maxSteps);
+ELF_API void ELF_APIENTRY elfSetConfigHeadless(elfConfig* config, unsigned char headless);
+ELF_API void ELF_APIENTRY elfSetConfigBenchmarkTicks(elfConfig* config, int ticks);
 
 ELF_API elfVec2i ELF_APIENTRY elfGetConfigWindowSize(elfConfig* config);
 ELF_API int ELF_APIENTRY elfGetConfigMultisamples(elfConfig* config);
 ELF_API unsigned char ELF_APIENTRY elfGetConfigFullscreen(elfConfig* config);
 ELF_API unsigned char ELF_APIENTRY elfGetConfigTextureCompress(elfConfig* config);
+ELF_API unsigned char ELF_APIENTRY elfGetConfigSaveTextureCompress(elfConfig* config);
 ELF_API float ELF_APIENTRY elfGetConfigTextureAnisotropy(elfConfig* config);
 ELF_API int ELF_APIENTRY elfGetConfigShadowMapSize(elfConfig* config);
 ELF_API const char* ELF_APIENTRY elfGetConfigStart(elfConfig* config);
 ELF_API const char* ELF_APIENTRY elfGetConfigLogPath(elfConfig* config);
+ELF_API int ELF_APIENTRY elfGetConfigScriptGcMode(elfConfig* config);
+ELF_API int ELF_APIENTRY elfGetConfigScriptGcBudget(elfConfig* config);
+ELF_API int ELF_APIENTRY elfGetConfigThreadCount(elfConfig* config);
+ELF_API unsigned char ELF_APIENTRY elfGetConfigMapPaks(elfConfig* config);
+ELF_API float ELF_APIENTRY elfGetConfigLoadBudget(elfConfig* config);
+ELF_API float ELF_APIENTRY elfGetConfigAnimationTolerance(elfConfig* config);
+ELF_API float ELF_APIENTRY elfGetConfigStepRate(elfConfig* config);
+ELF_API int ELF_APIENTRY elfGetConfigMaxSteps(elfConfig* config);
+ELF_API unsigned char ELF_APIENTRY elfGetConfigHeadless(elfConfig* config);
+ELF_API int ELF_APIENTRY elfGetConfigBenchmarkTicks(elfConfig* config);
 
 ///////////////////////////////// LOG /////////////////////////////////
 
@@ -567,6 +653,8 @@ void elfDestroyContext(void* data);
 
 unsigned char elfInitContext(int width, int height,
 		const char* title, int multisamples, unsigned char fullscreen);
+unsigned char elfInitHeadlessContext(int width, int height, const char* title);
+double elfGetSystemTime();
 void elfCloseWindow();
 
 unsigned char elfResizeContext(int width, int height);
@@ -610,8 +698,9 @@ void elfSetErrorNoSave(int code, const char* fmt, ...);
 
 elfEngine* elfCreateEngine();
 void elfDestroyEngine(void* data);
+int elfCompareFrameTimes(const void* a, const void* b);
 
-unsigned char elfInitEngine();
+unsigned char elfInitEngine(elfConfig* config);
 void elfDeinitEngine();
 // !!>
 
@@ -636,11 +725,15 @@ ELF_API int ELF_APIENTRY elfGetError();
 
 ELF_API unsigned char ELF_APIENTRY elfRun();
 ELF_API void ELF_APIENTRY elfQuit();
+ELF_API unsigned char ELF_APIENTRY elfIsHeadless();
+ELF_API float ELF_APIENTRY elfBenchmark(int ticks);
 
 ELF_API void ELF_APIENTRY elfSetF10Exit(unsigned char exit);
 ELF_API unsigned char ELF_APIENTRY elfGetF10Exit();
 
 ELF_API elfScene* ELF_APIENTRY elfLoadScene(const char* filePath);
+ELF_API elfSceneLoader* ELF_APIENTRY elfLoadSceneAsync(const char* filePath);
+ELF_API elfSceneLoader* ELF_APIENTRY elfGetSceneLoader();
 ELF_API void ELF_APIENTRY elfSetScene(elfScene* scene);
 ELF_API elfScene* ELF_APIENTRY elfGetScene();
 
@@ -649,6 +742,7 @@ ELF_API elfGui* ELF_APIENTRY elfGetGui();
 
 ELF_API float ELF_APIENTRY elfGetSync();
 ELF_API int ELF_APIENTRY elfGetFps();
+ELF_API float ELF_APIENTRY elfGetFrameTimePercentile(float percentile);
 
 ELF_API unsigned char ELF_APIENTRY elfSaveScreenShot(const char* filePath);
 
@@ -661,8 +755,26 @@ ELF_API float ELF_APIENTRY elfGetTickRate();
 ELF_API void ELF_APIENTRY elfSetSpeed(float speed);
 ELF_API float ELF_APIENTRY elfGetSpeed();
 
+ELF_API void ELF_APIENTRY elfSetStepRate(float stepRate);
+ELF_API float ELF_APIENTRY elfGetStepRate();
+ELF_API void ELF_APIENTRY elfSetMaxSteps(int maxSteps);
+ELF_API int ELF_APIENTRY elfGetMaxSteps();
+ELF_API int ELF_APIENTRY elfGetSteps();
+ELF_API float ELF_APIENTRY elfGetStepAlpha();
+
+ELF_API void ELF_APIENTRY elfSetScriptGcMode(int mode);
+ELF_API int ELF_APIENTRY elfGetScriptGcMode();
+ELF_API void ELF_APIENTRY elfSetScriptGcBudget(int budget);
+ELF_API int ELF_APIENTRY elfGetScriptGcBudget();
+
+ELF_API int ELF_APIENTRY elfGetThreadCount();
+
 ELF_API void ELF_APIENTRY elfSetTextureCompress(unsigned char compress);
 ELF_API unsigned char ELF_APIENTRY elfGetTextureCompress();
+ELF_API void ELF_APIENTRY elfSetSaveTextureCompress(unsigned char compress);
+ELF_API unsigned char ELF_APIENTRY elfGetSaveTextureCompress();
+ELF_API void ELF_APIENTRY elfSetMapPaks(unsigned char mapPaks);
+ELF_API unsigned char ELF_APIENTRY elfGetMapPaks();
 ELF_API void ELF_APIENTRY elfSetTextureAnisotropy(float anisotropy);
 ELF_API float ELF_APIENTRY elfGetTextureAnisotropy();
 
@@ -670,6 +782,13 @@ ELF_API void ELF_APIENTRY elfSetShadowMapSize(int size);
 ELF_API int ELF_APIENTRY elfGetShadowMapSize();
 
 ELF_API int ELF_APIENTRY elfGetPolygonsRendered();
+ELF_API int ELF_APIENTRY elfGetGlCalls();
+ELF_API int ELF_APIENTRY elfGetDrawCalls();
+ELF_API int ELF_APIENTRY elfGetInstancesDrawn();
+ELF_API int ELF_APIENTRY elfGetShaderSwitches();
+ELF_API int ELF_APIENTRY elfGetTextureSwitches();
+ELF_API int ELF_APIENTRY elfGetBlendSwitches();
+ELF_API int ELF_APIENTRY elfGetShaderProgramCount();
 
 ELF_API void ELF_APIENTRY elfSetBloom(float threshold);
 ELF_API void ELF_APIENTRY elfDisableBloom();
@@ -803,6 +922,33 @@ ELF_API elfTimer* ELF_APIENTRY elfCreateTimer();	// <mdoc> TIMER FUNCTIONS
 ELF_API void ELF_APIENTRY elfStartTimer(elfTimer* timer);
 ELF_API double ELF_APIENTRY elfGetElapsedTime(elfTimer* timer);
 
+//////////////////////////////// PROFILER ////////////////////////////////
+
+// <!!
+elfProfiler* elfCreateProfiler();
+void elfDestroyProfiler(void* data);
+void elfBeginProfileFrame(elfProfiler* profiler);
+void elfEndProfileFrame(elfProfiler* profiler);
+void elfBeginProfileScope(const char* name);
+void elfEndProfileScope();
+elfProfileFrame* elfGetLastProfileFrame();
+// !!>
+
+ELF_API void ELF_APIENTRY elfSetProfiling(unsigned char enabled);	// <mdoc> PROFILER FUNCTIONS
+ELF_API unsigned char ELF_APIENTRY elfIsProfiling();
+ELF_API void ELF_APIENTRY elfClearProfile();
+ELF_API int ELF_APIENTRY elfGetProfileFrameCount();
+ELF_API float ELF_APIENTRY elfGetProfileFrameTime();
+ELF_API int ELF_APIENTRY elfGetProfileScopeCount();
+ELF_API const char* ELF_APIENTRY elfGetProfileScopeName(int idx);
+ELF_API float ELF_APIENTRY elfGetProfileScopeTime(int idx);
+ELF_API int ELF_APIENTRY elfGetProfileScopeDepth(int idx);
+ELF_API float ELF_APIENTRY elfGetProfileTime(const char* name);
+ELF_API int ELF_APIENTRY elfGetProfileDrawCalls();
+ELF_API int ELF_APIENTRY elfGetProfileStateChanges();
+ELF_API int ELF_APIENTRY elfGetProfileUploads();
+ELF_API unsigned char ELF_APIENTRY elfSaveProfileTrace(const char* filePath);
+
 //////////////////////////////// IMAGE ////////////////////////////////
 
 /* <!> */ elfImage* elfCreateImage();
@@ -820,6 +966,9 @@ ELF_API elfColor ELF_APIENTRY elfGetImagePixel(elfImage* image, int x, int y);
 // <!!
 void* elfGetImageData(elfImage* image);
 unsigned char elfSaveImageData(const char* filePath, int width, int height, unsigned char bpp, void* data);
+int elfGetDxtLevelSizeBytes(int width, int height, unsigned char alpha);
+unsigned char* elfCompressImageData(const unsigned char* data, int width, int height, int bpp, int* sizeBytes);
+void elfDecodeDxtLevel(const unsigned char* in, int width, int height, unsigned char alpha, unsigned char* out);
 // !!>
 
 /////////////////////////////// TEXTURE ///////////////////////////////
@@ -844,6 +993,9 @@ ELF_API int ELF_APIENTRY elfGetTextureDataFormat(elfTexture* texture);
 // <!!
 gfxTexture* elfGetGfxTexture(elfTexture* texture);
 void elfSetTexture(int slot, elfTexture* texture, gfxShaderParams* shaderParams);
+unsigned char elfLoadTextureData(elfTexture* texture);
+void elfCompressTextureData(elfTexture* texture);
+void elfUnloadTextureData(elfTexture* texture);
 // !!>
 
 //////////////////////////////// MATERIAL ////////////////////////////////
@@ -908,6 +1060,10 @@ void elfSetMaterial(elfMaterial* material, int mode, gfxShaderParams* shaderPara
 void elfDestroyBezierPoint(void* data);
 void elfDestroyBezierCurve(void* data);
 void elfDestroyIpo(void* data);
+void elfBakeBezierCurve(elfBezierCurve* curve);
+void elfInsertBezierCurveKey(elfBezierCurve* curve, int idx, elfVec2f key);
+int elfFindBezierCurveKey(elfBezierCurve* curve, float x);
+void elfGetIpoValues(elfIpo* ipo, float x, float* values);
 // !!>
 
 ELF_API elfBezierPoint* ELF_APIENTRY elfCreateBezierPoint();	// <mdoc> IPO FUNCTIONS
@@ -959,6 +1115,9 @@ void elfInitActor(elfActor* actor, unsigned char camera);
 void elfUpdateActor(elfActor* actor);
 void elfActorPreDraw(elfActor* actor);
 void elfActorPostDraw(elfActor* actor);
+void elfStoreActorStep(elfActor* actor);
+void elfInterpolateActor(elfActor* actor, float alpha);
+void elfRestoreActorStep(elfActor* actor);
 void elfCleanActor(elfActor* actor);
 // !!>
 
@@ -1172,6 +1331,8 @@ float* elfGetModelTangents(elfModel* model);
 unsigned int* elfGetModelIndices(elfModel* model);
 
 void elfDrawModel(elfList* material, elfModel* model, int mode, gfxShaderParams* shaderParams);
+void elfDrawModelInstances(elfList* materials, elfModel* model, int mode, gfxShaderParams* shaderParams,
+	elfEntity** entities, float* matrices, int count);
 void elfDrawModelBoudingBox(elfModel* model, gfxShaderParams* shaderParams);
 // !!>
 
@@ -1179,6 +1340,7 @@ void elfDrawModelBoudingBox(elfModel* model, gfxShaderParams* shaderParams);
 
 // <!!
 void elfUpdateEntity(elfEntity* entity);
+unsigned char elfIsEntityArmaturePoseChanged(elfEntity* entity);
 void elfEntityPreDraw(elfEntity* entity);
 void elfEntityPostDraw(elfEntity* entity);
 void elfDestroyEntity(void* data);
@@ -1221,15 +1383,32 @@ ELF_API float ELF_APIENTRY elfGetEntityArmatureSpeed(elfEntity* entity);
 ELF_API float ELF_APIENTRY elfGetEntityArmatureFrame(elfEntity* entity);
 ELF_API unsigned char ELF_APIENTRY elfIsEntityArmaturePlaying(elfEntity* entity);
 ELF_API unsigned char ELF_APIENTRY elfIsEntityArmaturePaused(elfEntity* entity);
+/* <!> */ elfFramePlayer* elfGetEntityArmatureLayerPlayer(elfEntity* entity, int layer);
+ELF_API void ELF_APIENTRY elfSetEntityArmatureLayerWeight(elfEntity* entity, int layer, float weight);
+ELF_API void ELF_APIENTRY elfSetEntityArmatureLayerFrame(elfEntity* entity, int layer, float frame);
+ELF_API void ELF_APIENTRY elfPlayEntityArmatureLayer(elfEntity* entity, int layer, float start, float end, float speed);
+ELF_API void ELF_APIENTRY elfLoopEntityArmatureLayer(elfEntity* entity, int layer, float start, float end, float speed);
+ELF_API void ELF_APIENTRY elfStopEntityArmatureLayer(elfEntity* entity, int layer);
+ELF_API float ELF_APIENTRY elfGetEntityArmatureLayerWeight(elfEntity* entity, int layer);
+ELF_API float ELF_APIENTRY elfGetEntityArmatureLayerFrame(elfEntity* entity, int layer);
 
 ELF_API elfArmature* ELF_APIENTRY elfGetEntityArmature(elfEntity* entity);
 
 // <!!
 void elfResetEntityDebugPhysicsObject(elfEntity* entity);
 void elfDrawEntity(elfEntity* entity, int mode, gfxShaderParams* shaderParams);
+unsigned char elfIsEntityInstanceable(elfEntity* entity);
+unsigned char elfIsEntityTranslucent(elfEntity* entity);
+void elfDrawEntityInstances(elfEntity** entities, int count, float* matrices, int mode, gfxShaderParams* shaderParams);
 void elfDrawEntityBoundingBox(elfEntity* entity, gfxShaderParams* shaderParams);
+void elfBeginEntityQuery(elfEntity* entity, int frame, gfxShaderParams* shaderParams);
+unsigned char elfIsEntityOccluded(elfEntity* entity, int frame);
 void elfDrawEntityDebug(elfEntity* entity, gfxShaderParams* shaderParams);
 unsigned char elfCullEntity(elfEntity* entity, elfCamera* camera);
+void elfDestroyCullBatch(elfCullBatch* batch);
+void elfBeginCullBatch(elfCullBatch* batch);
+void elfAddCullBatchEntity(elfCullBatch* batch, elfEntity* entity);
+int elfCullBatchCamera(elfCullBatch* batch, elfCamera* camera);
 // !!>
 
 ELF_API unsigned char ELF_APIENTRY elfGetEntityChanged(elfEntity* entity);
@@ -1304,6 +1483,18 @@ ELF_API elfBone* ELF_APIENTRY elfGetBoneFromArmatureById(int id, elfArmature* ar
 // <!!
 void elfAddRootBoneToArmature(elfArmature* armature, elfBone* bone);
 
+void elfQuantizeBoneQua(const float* qua, short* result);
+void elfDequantizeBoneQua(const short* qua, float* result);
+unsigned char elfBoneSpanFits(elfBoneFrame* frames, elfBoneKey* start, elfBoneKey* end, float tolerance);
+void elfCompressBoneTrack(elfBone* bone, elfBoneFrame* frames, int frameCount, float tolerance);
+void elfSampleBoneTrack(elfBone* bone, int frameCount, float frame, float* pos, float* qua);
+unsigned char elfLoadArmatureFrames(elfArmature* armature);
+void elfUnloadArmatureFrames(elfArmature* armature);
+
+unsigned char elfIsEntitySkinnedByShaders(elfEntity* entity);
+unsigned char elfPrepareEntitySkinning(elfArmature* armature, elfEntity* entity, float frame);
+void elfSkinEntity(void* data);
+void elfFinishEntitySkinning(elfEntity* entity);
 void elfDeformEntityWithArmature(elfArmature* armature, elfEntity* entity, float frame);
 void elfDrawArmatureDebug(elfArmature* armature, gfxShaderParams* shaderParams);
 // !!>
@@ -1311,11 +1502,14 @@ void elfDrawArmatureDebug(elfArmature* armature, gfxShaderParams* shaderParams);
 //////////////////////////////// PARTICLES ////////////////////////////////
 
 // <!!
-elfParticle* elfCreateParticle();
-void elfDestroyParticle(void* data);
+void elfInitParticlePool(elfParticlePool* pool, int size);
+void elfDestroyParticlePool(elfParticlePool* pool);
+void elfRemoveParticle(elfParticlePool* pool, int idx);
+void elfInitNewParticle(elfParticles* particles, int idx);
 void elfParticlesPreDraw(elfParticles* particles);
 void elfParticlesPostDraw(elfParticles* particles);
 void elfUpdateParticles(elfParticles* particles, float sync);
+void elfSimulateParticles(void* data);
 void elfDestroyParticles(void* data);
 // !!>
 
@@ -1421,6 +1615,9 @@ void elfDrawSpriteDebug(elfSprite* sprite, gfxShaderParams* shaderParams);
 void elfUpdateScene(elfScene* scene, float sync);
 void elfScenePreDraw(elfScene* scene);
 void elfScenePostDraw(elfScene* scene);
+void elfStoreSceneStep(elfScene* scene);
+void elfInterpolateScene(elfScene* scene, float alpha);
+void elfRestoreSceneStep(elfScene* scene);
 void elfDestroyScene(void* data);
 // !!>
 
@@ -1443,6 +1640,9 @@ ELF_API unsigned char ELF_APIENTRY elfGetSceneDebugDraw(elfScene* scene);
 ELF_API void ELF_APIENTRY elfSetSceneOcclusionCulling(elfScene* scene, unsigned char occlusionCulling);
 ELF_API unsigned char ELF_APIENTRY elfGetSceneOcclusionCulling(elfScene* scene);
 
+ELF_API void ELF_APIENTRY elfSetSceneSpatialIndex(elfScene* scene, unsigned char spatialIndex);
+ELF_API unsigned char ELF_APIENTRY elfGetSceneSpatialIndex(elfScene* scene);
+
 ELF_API void ELF_APIENTRY elfSetSceneGravity(elfScene* scene, float x, float y, float z);
 ELF_API elfVec3f ELF_APIENTRY elfGetSceneGravity(elfScene* scene);
 
@@ -1478,6 +1678,7 @@ ELF_API elfCollision* ELF_APIENTRY elfGetSceneRayCastResult(elfScene* scene, flo
 ELF_API elfList* ELF_APIENTRY elfGetSceneRayCastResults(elfScene* scene, float x, float y, float z, float dx, float dy, float dz);
 ELF_API elfCollision* ELF_APIENTRY elfGetDebugSceneRayCastResult(elfScene* scene, float x, float y, float z, float dx, float dy, float dz);
 ELF_API elfList* ELF_APIENTRY elfGetDebugSceneRayCastResults(elfScene* scene, float x, float y, float z, float dx, float dy, float dz);
+ELF_API elfEntity* ELF_APIENTRY elfGetSceneRayCastEntity(elfScene* scene, float x, float y, float z, float dx, float dy, float dz);
 
 ELF_API elfCamera* ELF_APIENTRY elfGetSceneCameraByIndex(elfScene* scene, int idx);
 ELF_API elfEntity* ELF_APIENTRY elfGetSceneEntityByIndex(elfScene* scene, int idx);
@@ -1499,6 +1700,7 @@ ELF_API elfSprite* ELF_APIENTRY elfGetSceneSprite(elfScene* scene, const char* n
 ELF_API elfActor* ELF_APIENTRY elfGetSceneActor(elfScene* scene, const char* name);
 
 // <!!
+elfObject* elfGetScenePakObject(elfScene* scene, elfPakIndex* index);
 elfTexture* elfGetOrLoadTextureByName(elfScene* scene, const char* name);
 elfModel* elfGetOrLoadModelByName(elfScene* scene, const char* name);
 elfScript* elfGetOrLoadScriptByName(elfScene* scene, const char* name);
@@ -1534,6 +1736,14 @@ ELF_API unsigned char ELF_APIENTRY elfRemoveSceneSpriteByObject(elfScene* scene,
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneActorByObject(elfScene* scene, elfActor* actor);
 
 // <!!
+void elfBeginSceneCulling(elfScene* scene);
+void elfCullSceneEntities(elfScene* scene, elfCamera* camera);
+void elfQueueSceneEntity(elfScene* scene, elfEntity* entity);
+unsigned int elfHashRenderKeyResource(unsigned int hash, elfResource* resource);
+unsigned long long elfGetEntityRenderKey(elfEntity* entity, int mode, gfxShaderParams* shaderParams);
+int elfCompareRenderItems(const void* a, const void* b);
+unsigned char elfIsEntityDrawStateEqual(elfEntity* entA, elfEntity* entB);
+void elfDrawSceneQueue(elfScene* scene, int mode, gfxShaderParams* shaderParams);
 void elfDrawScene(elfScene* scene);
 void elfDrawSceneDebug(elfScene* scene);
 // !!>
@@ -1543,17 +1753,47 @@ ELF_API elfList* ELF_APIENTRY elfGetSceneTextures(elfScene* scene);
 ELF_API elfList* ELF_APIENTRY elfGetSceneMaterials(elfScene* scene);
 ELF_API elfList* ELF_APIENTRY elfGetSceneModels(elfScene* scene);
 
+//////////////////////////////// BVH ////////////////////////////////
+
+// <!!
+void elfDestroyBvh(elfBvh* bvh);
+void elfCalcBvhNodeBounds(elfBvh* bvh, int idx);
+int elfBuildBvhNode(elfBvh* bvh, int parent, int first, int count);
+void elfBuildBvh(elfBvh* bvh, elfArray* entities);
+float elfGetBvhBoxArea(elfVec3f* min, elfVec3f* max);
+float elfGetBvhNodeGrowth(elfBvhNode* node, elfEntity* entity);
+void elfInsertBvhEntity(elfBvh* bvh, elfEntity* entity);
+void elfRemoveBvhEntity(elfBvh* bvh, elfEntity* entity);
+void elfUpdateBvh(elfBvh* bvh, elfArray* entities);
+void elfRefitBvhEntity(elfBvh* bvh, elfEntity* entity);
+void elfCullBvhNode(elfBvh* bvh, int idx, elfCamera* camera, elfCullBatch* batch);
+int elfCullBvhCamera(elfBvh* bvh, elfCamera* camera, elfCullBatch* batch);
+void elfRayCastBvhNode(elfBvh* bvh, int idx, float* start, float* dir, float* closest, elfEntity** result);
+elfEntity* elfRayCastBvh(elfBvh* bvh, float* start, float* dir);
+// !!>
+
 //////////////////////////////// PAK ////////////////////////////////
 
 // <!!
 elfPakIndex* elfCreatePakIndex();
 void elfDestroyPakIndex(void* data);
+elfPakMapping* elfCreatePakMapping(char* data, long size);
+void elfDestroyPakMapping(void* data);
 elfPak* elfCreatePakFromFile(const char* filePath);
 void elfDestroyPak(void* data);
 
 const char* elfGetPakFilePath(elfPak* pak);
+FILE* elfGetPakFile(elfPak* pak);
+void* elfGetPakData(elfPak* pak, FILE* file, int sizeBytes);
+void elfReadPakData(elfPak* pak, FILE* file, void* buffer, int sizeBytes);
+void* elfGetPakBytes(elfPak* pak, FILE* file, int sizeBytes);
+void elfReleasePakData(elfPak* pak, void* data, int sizeBytes);
+void elfReleaseModelPakData(elfPak* pak, gfxVertexData* data);
+unsigned int elfAlignPakOffset(unsigned int offset);
+void elfAlignPakFile(FILE* file);
 int elfGetPakIndexCount(elfPak* pak);
 
+unsigned int elfGetPakIndexHash(const char* name, unsigned char type);
 elfPakIndex* elfGetPakIndexByName(elfPak* pak, const char* name, unsigned char type);
 elfPakIndex* elfGetPakIndexByIndex(elfPak* pak, int idx);
 unsigned char elfGetPakIndexType(elfPakIndex* index);
@@ -1583,9 +1823,15 @@ elfModel* elfCreateModelFromPak(FILE* file, const char* name, elfScene* scene);
 elfParticles* elfCreateParticlesFromPak(FILE* file, const char* name, elfScene* scene);
 elfScript* elfCreateScriptFromPak(FILE* file, const char* name, elfScene* scene);
 elfSprite* elfCreateSpriteFromPak(FILE* file, const char* name, elfScene* scene);
+unsigned char* elfDecodeTexture(char* mem, int length, int* width, int* height, unsigned char* bpp);
+elfTexture* elfCreateSceneTexture(const char* name, elfScene* scene);
+elfTexture* elfCreateTextureFromPixels(const char* name, elfScene* scene, int width, int height, unsigned char bpp, unsigned char* data);
+elfTexture* elfCreateTextureFromBlocks(const char* name, elfScene* scene, char* mem, int length);
 elfTexture* elfCreateTextureFromPak(FILE* file, const char* name, elfScene* scene);
 unsigned char elfLoadTextureDataFromPak(elfTexture* texture);
 
+elfScene* elfBeginSceneFromPak(const char* name, elfPak* pak);
+void elfLoadSceneIndexFromPak(elfScene* scene, elfPakIndex* index, const char* name, unsigned char* sceneRead);
 elfScene* elfCreateSceneFromPak(const char* name, elfPak* pak);
 
 void elfWriteActorHeader(elfActor* actor, FILE* file);
@@ -1603,6 +1849,21 @@ void elfWriteTextureToFile(elfTexture* texture, FILE* file);
 unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath);
 // !!>
 
+//////////////////////////////// SCENE LOADER ////////////////////////////////
+
+// <!!
+elfSceneLoader* elfCreateSceneLoader();
+void elfDestroySceneLoader(void* data);
+void elfDecodeSceneLoaderTexture(void* data);
+void elfStartSceneLoader(elfSceneLoader* loader, elfPak* pak);
+unsigned char elfUpdateSceneLoader(elfSceneLoader* loader, float budget);
+// !!>
+
+ELF_API const char* ELF_APIENTRY elfGetSceneLoaderFilePath(elfSceneLoader* loader);	// <mdoc> SCENE LOADER FUNCTIONS
+ELF_API float ELF_APIENTRY elfGetSceneLoaderProgress(elfSceneLoader* loader);
+ELF_API unsigned char ELF_APIENTRY elfIsSceneLoaderDone(elfSceneLoader* loader);
+ELF_API elfScene* ELF_APIENTRY elfGetSceneLoaderScene(elfSceneLoader* loader);
+
 //////////////////////////////// POST PROCESS ////////////////////////////////
 
 // <!!
@@ -1664,10 +1925,15 @@ void elfUpdateScripting();
 void elfDeinitScripting();
 
 void elfSetScriptError(int err, const char* msg);
+
+unsigned char elfCompileScript(elfScript* script);
+void elfReleaseScriptChunk(elfScript* script);
 // !!>
 
 ELF_API unsigned char ELF_APIENTRY elfRunString(const char* str);	// <mdoc> SCRIPTING FUNCTIONS
 ELF_API unsigned char ELF_APIENTRY elfRunScript(elfScript* script);
+ELF_API float ELF_APIENTRY elfGetScriptGcTime();
+ELF_API int ELF_APIENTRY elfGetScriptMemory();
 
 //////////////////////////////// AUDIO ////////////////////////////////
 
@@ -1725,7 +1991,7 @@ void elfDestroyCollision(void* data);
 
 elfPhysicsWorld* elfCreatePhysicsWorld();
 void elfDestroyPhysicsWorld(void* data);
-void elfUpdatePhysicsWorld(elfPhysicsWorld* world, float time);
+void elfUpdatePhysicsWorld(elfPhysicsWorld* world, float time, unsigned char fixed);
 
 void elfSetPhysicsWorldGravity(elfPhysicsWorld* world, float x, float y, float z);
 elfVec3f elfGetPhysicsWorldGravity(elfPhysicsWorld* world);
@@ -1825,6 +2091,9 @@ ELF_API int ELF_APIENTRY elfGetFontSize(elfFont* font);
 ELF_API int ELF_APIENTRY elfGetStringWidth(elfFont* font, const char* str);
 ELF_API int ELF_APIENTRY elfGetStringHeight(elfFont* font, const char* str);
 
+/* <!> */ void elfDestroyTextBatch(elfTextBatch* batch);
+/* <!> */ void elfBuildTextBatch(elfTextBatch* batch, elfFont* font, const char* str, int x, int y);
+/* <!> */ void elfDrawStringBatch(elfFont* font, const char* str, int x, int y, gfxShaderParams* shaderParams, elfTextBatch* batch);
 /* <!> */ void elfDrawString(elfFont* font, const char* str, int x, int y, gfxShaderParams* shaderParams);
 
 //////////////////////////////// GUI ////////////////////////////////
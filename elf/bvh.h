@@ -0,0 +1,412 @@
+void elfDestroyBvh(elfBvh* bvh)
+{
+	if(bvh->nodes) free(bvh->nodes);
+	if(bvh->entities) free(bvh->entities);
+	if(bvh->build) free(bvh->build);
+
+	memset(bvh, 0x0, sizeof(elfBvh));
+}
+
+void elfCalcBvhNodeBounds(elfBvh* bvh, int idx)
+{
+	elfBvhNode* node;
+	elfBvhNode* left;
+	elfBvhNode* right;
+	elfEntity* ent;
+	int i;
+
+	node = &bvh->nodes[idx];
+
+	if(node->left < 0)
+	{
+		// a leaf emptied by removals gets inverted bounds, they vanish in the parent and are never hit
+		if(!node->count)
+		{
+			node->min.x = node->min.y = node->min.z = FLT_MAX;
+			node->max.x = node->max.y = node->max.z = -FLT_MAX;
+			return;
+		}
+
+		ent = bvh->entities[node->first];
+		node->min = ent->cullAabbMin;
+		node->max = ent->cullAabbMax;
+
+		for(i = node->first+1; i < node->first+node->count; i++)
+		{
+			ent = bvh->entities[i];
+			if(ent->cullAabbMin.x < node->min.x) node->min.x = ent->cullAabbMin.x;
+			if(ent->cullAabbMin.y < node->min.y) node->min.y = ent->cullAabbMin.y;
+			if(ent->cullAabbMin.z < node->min.z) node->min.z = ent->cullAabbMin.z;
+			if(ent->cullAabbMax.x > node->max.x) node->max.x = ent->cullAabbMax.x;
+			if(ent->cullAabbMax.y > node->max.y) node->max.y = ent->cullAabbMax.y;
+			if(ent->cullAabbMax.z > node->max.z) node->max.z = ent->cullAabbMax.z;
+		}
+	}
+	else
+	{
+		left = &bvh->nodes[node->left];
+		right = &bvh->nodes[node->right];
+
+		node->min.x = elfFloatMin(left->min.x, right->min.x);
+		node->min.y = elfFloatMin(left->min.y, right->min.y);
+		node->min.z = elfFloatMin(left->min.z, right->min.z);
+		node->max.x = elfFloatMax(left->max.x, right->max.x);
+		node->max.y = elfFloatMax(left->max.y, right->max.y);
+		node->max.z = elfFloatMax(left->max.z, right->max.z);
+	}
+}
+
+int elfBuildBvhNode(elfBvh* bvh, int parent, int first, int count)
+{
+	elfEntity* ent;
+	elfEntity* tmp;
+	float cmin[3], cmax[3];
+	float center[3];
+	float mid;
+	int axis;
+	int idx;
+	int split;
+	int i, j;
+
+	if(bvh->nodeCount == bvh->nodeSize)
+	{
+		bvh->nodeSize *= 2;
+		bvh->nodes = (elfBvhNode*)realloc(bvh->nodes, sizeof(elfBvhNode)*bvh->nodeSize);
+	}
+
+	idx = bvh->nodeCount++;
+	memset(&bvh->nodes[idx], 0x0, sizeof(elfBvhNode));
+	bvh->nodes[idx].parent = parent;
+	bvh->nodes[idx].left = -1;
+	bvh->nodes[idx].right = -1;
+
+	if(count <= ELF_BVH_LEAF_BUILD_SIZE)
+	{
+		// every leaf gets room for ELF_BVH_LEAF_SIZE entities so inserts don't have to move the others
+		if((bvh->leafCount+1)*ELF_BVH_LEAF_SIZE > bvh->entitySize)
+		{
+			bvh->entitySize = (bvh->leafCount+1)*ELF_BVH_LEAF_SIZE*2;
+			bvh->entities = (elfEntity**)realloc(bvh->entities, sizeof(elfEntity*)*bvh->entitySize);
+		}
+
+		bvh->nodes[idx].first = bvh->leafCount*ELF_BVH_LEAF_SIZE;
+		bvh->nodes[idx].count = count;
+		bvh->leafCount++;
+
+		for(i = 0; i < count; i++)
+		{
+			bvh->entities[bvh->nodes[idx].first+i] = bvh->build[first+i];
+			bvh->build[first+i]->bvhNode = idx;
+		}
+		elfCalcBvhNodeBounds(bvh, idx);
+		return idx;
+	}
+
+	// split at the middle of the longest axis of the centroid bounds
+	for(i = first; i < first+count; i++)
+	{
+		ent = bvh->build[i];
+		for(j = 0; j < 3; j++)
+		{
+			center[j] = ((&ent->cullAabbMin.x)[j]+(&ent->cullAabbMax.x)[j])*0.5f;
+			if(i == first || center[j] < cmin[j]) cmin[j] = center[j];
+			if(i == first || center[j] > cmax[j]) cmax[j] = center[j];
+		}
+	}
+
+	axis = 0;
+	if(cmax[1]-cmin[1] > cmax[axis]-cmin[axis]) axis = 1;
+	if(cmax[2]-cmin[2] > cmax[axis]-cmin[axis]) axis = 2;
+	mid = (cmin[axis]+cmax[axis])*0.5f;
+
+	i = first;
+	j = first+count-1;
+	while(i <= j)
+	{
+		ent = bvh->build[i];
+		if(((&ent->cullAabbMin.x)[axis]+(&ent->cullAabbMax.x)[axis])*0.5f < mid)
+		{
+			i++;
+		}
+		else
+		{
+			tmp = bvh->build[j];
+			bvh->build[j] = ent;
+			bvh->build[i] = tmp;
+			j--;
+		}
+	}
+
+	split = i-first;
+	if(split == 0 || split == count) split = count/2;
+
+	i = elfBuildBvhNode(bvh, idx, first, split);
+	j = elfBuildBvhNode(bvh, idx, first+split, count-split);
+
+	bvh->nodes[idx].left = i;
+	bvh->nodes[idx].right = j;
+	elfCalcBvhNodeBounds(bvh, idx);
+
+	return idx;
+}
+
+void elfBuildBvh(elfBvh* bvh, elfArray* entities)
+{
+	int i;
+
+	bvh->dirty = ELF_FALSE;
+	bvh->refit = ELF_FALSE;
+	bvh->nodeCount = 0;
+	bvh->leafCount = 0;
+	bvh->changes = 0;
+	bvh->entityCount = entities->length;
+
+	if(bvh->buildSize < entities->length)
+	{
+		bvh->buildSize = entities->length;
+		bvh->build = (elfEntity**)realloc(bvh->build, sizeof(elfEntity*)*bvh->buildSize);
+	}
+
+	if(!bvh->entityCount) return;
+
+	if(!bvh->nodes)
+	{
+		bvh->nodeSize = 64;
+		bvh->nodes = (elfBvhNode*)malloc(sizeof(elfBvhNode)*bvh->nodeSize);
+	}
+
+	for(i = 0; i < entities->length; i++)
+	{
+		bvh->build[i] = (elfEntity*)entities->objs[i];
+	}
+
+	elfBuildBvhNode(bvh, -1, 0, bvh->entityCount);
+}
+
+float elfGetBvhBoxArea(elfVec3f* min, elfVec3f* max)
+{
+	float x, y, z;
+
+	x = max->x-min->x;
+	y = max->y-min->y;
+	z = max->z-min->z;
+
+	if(x < 0.0f || y < 0.0f || z < 0.0f) return 0.0f;
+
+	return x*y+y*z+z*x;
+}
+
+float elfGetBvhNodeGrowth(elfBvhNode* node, elfEntity* entity)
+{
+	elfVec3f min, max;
+
+	min.x = elfFloatMin(node->min.x, entity->cullAabbMin.x);
+	min.y = elfFloatMin(node->min.y, entity->cullAabbMin.y);
+	min.z = elfFloatMin(node->min.z, entity->cullAabbMin.z);
+	max.x = elfFloatMax(node->max.x, entity->cullAabbMax.x);
+	max.y = elfFloatMax(node->max.y, entity->cullAabbMax.y);
+	max.z = elfFloatMax(node->max.z, entity->cullAabbMax.z);
+
+	return elfGetBvhBoxArea(&min, &max)-elfGetBvhBoxArea(&node->min, &node->max);
+}
+
+void elfInsertBvhEntity(elfBvh* bvh, elfEntity* entity)
+{
+	elfBvhNode* node;
+	int idx;
+
+	if(bvh->dirty) return;
+
+	// inserts and removals wear the tree down, after enough of them it is built again on the next update
+	if(!bvh->nodeCount || bvh->changes > bvh->entityCount/ELF_BVH_REBUILD_RATIO)
+	{
+		bvh->dirty = ELF_TRUE;
+		return;
+	}
+
+	// walk down to the leaf whose bounds grow the least
+	idx = 0;
+	while(bvh->nodes[idx].left > -1)
+	{
+		node = &bvh->nodes[idx];
+		if(elfGetBvhNodeGrowth(&bvh->nodes[node->left], entity) <= elfGetBvhNodeGrowth(&bvh->nodes[node->right], entity))
+			idx = node->left;
+		else idx = node->right;
+	}
+
+	node = &bvh->nodes[idx];
+	if(node->count == ELF_BVH_LEAF_SIZE)
+	{
+		bvh->dirty = ELF_TRUE;
+		return;
+	}
+
+	bvh->entities[node->first+node->count++] = entity;
+	entity->bvhNode = idx;
+	bvh->entityCount++;
+	bvh->changes++;
+
+	// the bounds only grow, so the leaf and its ancestors are widened right away
+	for(; idx > -1; idx = bvh->nodes[idx].parent)
+	{
+		node = &bvh->nodes[idx];
+		node->min.x = elfFloatMin(node->min.x, entity->cullAabbMin.x);
+		node->min.y = elfFloatMin(node->min.y, entity->cullAabbMin.y);
+		node->min.z = elfFloatMin(node->min.z, entity->cullAabbMin.z);
+		node->max.x = elfFloatMax(node->max.x, entity->cullAabbMax.x);
+		node->max.y = elfFloatMax(node->max.y, entity->cullAabbMax.y);
+		node->max.z = elfFloatMax(node->max.z, entity->cullAabbMax.z);
+	}
+}
+
+void elfRemoveBvhEntity(elfBvh* bvh, elfEntity* entity)
+{
+	elfBvhNode* node;
+	int i;
+
+	if(bvh->dirty) return;
+
+	if(entity->bvhNode < 0 || entity->bvhNode >= bvh->nodeCount || bvh->nodes[entity->bvhNode].left > -1)
+	{
+		bvh->dirty = ELF_TRUE;
+		return;
+	}
+
+	node = &bvh->nodes[entity->bvhNode];
+
+	for(i = node->first; i < node->first+node->count; i++)
+	{
+		if(bvh->entities[i] == entity) break;
+	}
+
+	// the index may be left over from a tree the entity is not in anymore
+	if(i == node->first+node->count)
+	{
+		bvh->dirty = ELF_TRUE;
+		return;
+	}
+
+	bvh->entities[i] = bvh->entities[node->first+node->count-1];
+	node->count--;
+	node->refit = ELF_TRUE;
+
+	entity->bvhNode = -1;
+	bvh->entityCount--;
+	bvh->changes++;
+	bvh->refit = ELF_TRUE;
+}
+
+void elfUpdateBvh(elfBvh* bvh, elfArray* entities)
+{
+	int i;
+
+	if(bvh->dirty)
+	{
+		elfBuildBvh(bvh, entities);
+		return;
+	}
+
+	if(!bvh->refit) return;
+
+	// children are always stored after their parent, so one backwards pass refits the tree
+	for(i = bvh->nodeCount-1; i >= 0; i--)
+	{
+		if(!bvh->nodes[i].refit) continue;
+
+		elfCalcBvhNodeBounds(bvh, i);
+		bvh->nodes[i].refit = ELF_FALSE;
+		if(bvh->nodes[i].parent > -1) bvh->nodes[bvh->nodes[i].parent].refit = ELF_TRUE;
+	}
+
+	bvh->refit = ELF_FALSE;
+}
+
+void elfRefitBvhEntity(elfBvh* bvh, elfEntity* entity)
+{
+	if(bvh->dirty || entity->bvhNode < 0 || entity->bvhNode >= bvh->nodeCount || bvh->nodes[entity->bvhNode].left > -1) return;
+
+	bvh->nodes[entity->bvhNode].refit = ELF_TRUE;
+	bvh->refit = ELF_TRUE;
+}
+
+void elfCullBvhNode(elfBvh* bvh, int idx, elfCamera* camera, elfCullBatch* batch)
+{
+	elfBvhNode* node;
+	elfEntity* ent;
+	int i;
+
+	node = &bvh->nodes[idx];
+
+	if(!elfAabbInsideFrustum(camera, &node->min.x, &node->max.x)) return;
+
+	if(node->left < 0)
+	{
+		for(i = node->first; i < node->first+node->count; i++)
+		{
+			ent = bvh->entities[i];
+			if(!elfCullEntity(ent, camera)) elfAddCullBatchEntity(batch, ent);
+		}
+		return;
+	}
+
+	elfCullBvhNode(bvh, node->left, camera, batch);
+	elfCullBvhNode(bvh, node->right, camera, batch);
+}
+
+int elfCullBvhCamera(elfBvh* bvh, elfCamera* camera, elfCullBatch* batch)
+{
+	int i;
+
+	elfBeginCullBatch(batch);
+
+	if(bvh->nodeCount) elfCullBvhNode(bvh, 0, camera, batch);
+
+	for(i = 0; i < batch->count; i++) batch->visible[i] = i;
+	batch->visibleCount = batch->count;
+
+	return batch->visibleCount;
+}
+
+void elfRayCastBvhNode(elfBvh* bvh, int idx, float* start, float* dir, float* closest, elfEntity** result)
+{
+	elfBvhNode* node;
+	elfEntity* ent;
+	float t;
+	int i;
+
+	node = &bvh->nodes[idx];
+
+	if(!gfxRayBoxIntersect(start, dir, &node->min.x, &node->max.x, &t) || t >= *closest) return;
+
+	if(node->left < 0)
+	{
+		for(i = node->first; i < node->first+node->count; i++)
+		{
+			ent = bvh->entities[i];
+			if(!ent->model) continue;
+			if(gfxRayBoxIntersect(start, dir, &ent->cullAabbMin.x, &ent->cullAabbMax.x, &t) && t < *closest)
+			{
+				*closest = t;
+				*result = ent;
+			}
+		}
+		return;
+	}
+
+	elfRayCastBvhNode(bvh, node->left, start, dir, closest, result);
+	elfRayCastBvhNode(bvh, node->right, start, dir, closest, result);
+}
+
+elfEntity* elfRayCastBvh(elfBvh* bvh, float* start, float* dir)
+{
+	elfEntity* result;
+	float closest;
+
+	result = NULL;
+	closest = 2.0f;
+
+	if(bvh->nodeCount) elfRayCastBvhNode(bvh, 0, start, dir, &closest, &result);
+
+	return result;
+}
+
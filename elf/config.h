@@ -18,12 +18,23 @@ elfConfig* elfCreateConfig()
 	config->multisamples = 0;
 	config->fullscreen = ELF_FALSE;
 	config->textureCompress = ELF_FALSE;
+	config->saveTextureCompress = ELF_FALSE;
 	config->textureAnisotropy = 1.0f;
 	config->shadowMapSize = 1024;
 	config->fpsLimit = 0.0f;
 	config->tickRate = 0.0f;
 	config->speed = 1.0f;
+	config->stepRate = 0.0f;
+	config->maxSteps = 5;
+	config->headless = ELF_FALSE;
+	config->benchmarkTicks = 0;
 	config->f10Exit = ELF_TRUE;
+	config->scriptGcMode = ELF_SCRIPT_GC_FULL;
+	config->scriptGcBudget = 1000;
+	config->threadCount = 0;
+	config->mapPaks = ELF_TRUE;
+	config->loadBudget = 4.0f;
+	config->animationTolerance = 0.001f;
 
 	config->start = (char*)malloc(sizeof(char));
 	config->start[0] = '\0';
@@ -115,6 +126,10 @@ ELF_API elfConfig* ELF_APIENTRY elfReadConfig(const char* filePath)
 			{
 				config->textureCompress = elfReadSstBool(text, &pos);
 			}
+			else if(!strcmp(str, "saveTextureCompress"))
+			{
+				config->saveTextureCompress = elfReadSstBool(text, &pos);
+			}
 			else if(!strcmp(str, "textureAnisotropy"))
 			{
 				config->textureAnisotropy = elfReadSstFloat(text, &pos);
@@ -133,6 +148,46 @@ ELF_API elfConfig* ELF_APIENTRY elfReadConfig(const char* filePath)
 				if(config->logPath) free(config->logPath);
 				config->logPath = elfReadSstString(text, &pos);
 			}
+			else if(!strcmp(str, "scriptGcMode"))
+			{
+				elfSetConfigScriptGcMode(config, elfReadSstInt(text, &pos));
+			}
+			else if(!strcmp(str, "scriptGcBudget"))
+			{
+				elfSetConfigScriptGcBudget(config, elfReadSstInt(text, &pos));
+			}
+			else if(!strcmp(str, "threadCount"))
+			{
+				elfSetConfigThreadCount(config, elfReadSstInt(text, &pos));
+			}
+			else if(!strcmp(str, "mapPaks"))
+			{
+				config->mapPaks = elfReadSstBool(text, &pos);
+			}
+			else if(!strcmp(str, "loadBudget"))
+			{
+				elfSetConfigLoadBudget(config, elfReadSstFloat(text, &pos));
+			}
+			else if(!strcmp(str, "animationTolerance"))
+			{
+				elfSetConfigAnimationTolerance(config, elfReadSstFloat(text, &pos));
+			}
+			else if(!strcmp(str, "stepRate"))
+			{
+				elfSetConfigStepRate(config, elfReadSstFloat(text, &pos));
+			}
+			else if(!strcmp(str, "maxSteps"))
+			{
+				elfSetConfigMaxSteps(config, elfReadSstInt(text, &pos));
+			}
+			else if(!strcmp(str, "headless"))
+			{
+				elfSetConfigHeadless(config, elfReadSstBool(text, &pos));
+			}
+			else if(!strcmp(str, "benchmarkTicks"))
+			{
+				elfSetConfigBenchmarkTicks(config, elfReadSstInt(text, &pos));
+			}
 			else if(!strcmp(str, "{"))
 			{
 				scope++;
@@ -185,6 +240,11 @@ ELF_API void ELF_APIENTRY elfSetConfigTextureCompress(elfConfig* config, unsigne
 	config->textureCompress = !textureCompress == ELF_FALSE;
 }
 
+ELF_API void ELF_APIENTRY elfSetConfigSaveTextureCompress(elfConfig* config, unsigned char saveTextureCompress)
+{
+	config->saveTextureCompress = !saveTextureCompress == ELF_FALSE;
+}
+
 ELF_API void ELF_APIENTRY elfSetConfigTextureAnisotropy(elfConfig* config, float textureAnisotropy)
 {
 	config->textureAnisotropy = textureAnisotropy;
@@ -213,6 +273,64 @@ ELF_API void ELF_APIENTRY elfSetConfigLogPath(elfConfig* config, const char* log
 	memcpy(config->logPath, logPath, sizeof(char)*strlen(logPath));
 }
 
+ELF_API void ELF_APIENTRY elfSetConfigScriptGcMode(elfConfig* config, int mode)
+{
+	if(mode < ELF_SCRIPT_GC_FULL || mode > ELF_SCRIPT_GC_AUTO) return;
+	config->scriptGcMode = mode;
+}
+
+ELF_API void ELF_APIENTRY elfSetConfigScriptGcBudget(elfConfig* config, int budget)
+{
+	config->scriptGcBudget = budget;
+	if(config->scriptGcBudget < 0) config->scriptGcBudget = 0;
+}
+
+ELF_API void ELF_APIENTRY elfSetConfigThreadCount(elfConfig* config, int count)
+{
+	config->threadCount = count;
+	if(config->threadCount < 0) config->threadCount = 0;
+}
+
+ELF_API void ELF_APIENTRY elfSetConfigMapPaks(elfConfig* config, unsigned char mapPaks)
+{
+	config->mapPaks = !mapPaks == ELF_FALSE;
+}
+
+ELF_API void ELF_APIENTRY elfSetConfigLoadBudget(elfConfig* config, float loadBudget)
+{
+	config->loadBudget = loadBudget;
+	if(config->loadBudget < 0.0f) config->loadBudget = 0.0f;
+}
+
+ELF_API void ELF_APIENTRY elfSetConfigAnimationTolerance(elfConfig* config, float tolerance)
+{
+	config->animationTolerance = tolerance;
+	if(config->animationTolerance < 0.0f) config->animationTolerance = 0.0f;
+}
+
+ELF_API void ELF_APIENTRY elfSetConfigStepRate(elfConfig* config, float stepRate)
+{
+	config->stepRate = stepRate;
+	if(config->stepRate < 0.0f) config->stepRate = 0.0f;
+}
+
+ELF_API void ELF_APIENTRY elfSetConfigMaxSteps(elfConfig* config, int maxSteps)
+{
+	config->maxSteps = maxSteps;
+	if(config->maxSteps < 1) config->maxSteps = 1;
+}
+
+ELF_API void ELF_APIENTRY elfSetConfigHeadless(elfConfig* config, unsigned char headless)
+{
+	config->headless = !headless == ELF_FALSE;
+}
+
+ELF_API void ELF_APIENTRY elfSetConfigBenchmarkTicks(elfConfig* config, int ticks)
+{
+	config->benchmarkTicks = ticks;
+	if(config->benchmarkTicks < 0) config->benchmarkTicks = 0;
+}
+
 ELF_API elfVec2i ELF_APIENTRY elfGetConfigWindowSize(elfConfig* config)
 {
 	return config->windowSize;
@@ -233,6 +351,11 @@ ELF_API unsigned char ELF_APIENTRY elfGetConfigTextureCompress(elfConfig* config
 	return config->textureCompress;
 }
 
+ELF_API unsigned char ELF_APIENTRY elfGetConfigSaveTextureCompress(elfConfig* config)
+{
+	return config->saveTextureCompress;
+}
+
 ELF_API float ELF_APIENTRY elfGetConfigTextureAnisotropy(elfConfig* config)
 {
 	return config->textureAnisotropy;
@@ -253,3 +376,53 @@ ELF_API const char* ELF_APIENTRY elfGetConfigLogPath(elfConfig* config)
 	return config->logPath;
 }
 
+ELF_API int ELF_APIENTRY elfGetConfigScriptGcMode(elfConfig* config)
+{
+	return config->scriptGcMode;
+}
+
+ELF_API int ELF_APIENTRY elfGetConfigScriptGcBudget(elfConfig* config)
+{
+	return config->scriptGcBudget;
+}
+
+ELF_API int ELF_APIENTRY elfGetConfigThreadCount(elfConfig* config)
+{
+	return config->threadCount;
+}
+
+ELF_API unsigned char ELF_APIENTRY elfGetConfigMapPaks(elfConfig* config)
+{
+	return config->mapPaks;
+}
+
+ELF_API float ELF_APIENTRY elfGetConfigLoadBudget(elfConfig* config)
+{
+	return config->loadBudget;
+}
+
+ELF_API float ELF_APIENTRY elfGetConfigAnimationTolerance(elfConfig* config)
+{
+	return config->animationTolerance;
+}
+
+ELF_API float ELF_APIENTRY elfGetConfigStepRate(elfConfig* config)
+{
+	return config->stepRate;
+}
+
+ELF_API int ELF_APIENTRY elfGetConfigMaxSteps(elfConfig* config)
+{
+	return config->maxSteps;
+}
+
+ELF_API unsigned char ELF_APIENTRY elfGetConfigHeadless(elfConfig* config)
+{
+	return config->headless;
+}
+
+ELF_API int ELF_APIENTRY elfGetConfigBenchmarkTicks(elfConfig* config)
+{
+	return config->benchmarkTicks;
+}
+
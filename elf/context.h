@@ -195,6 +195,50 @@ unsigned char elfInitContext(int width, int height,
 	return ELF_TRUE;
 }
 
+unsigned char elfInitHeadlessContext(int width, int height, const char* title)
+{
+	if(ctx)
+	{
+		elfLogWrite("warning: can not open window twice\n");
+		return ELF_FALSE;
+	}
+
+	// keeps the window size and input state around for scripts, no window is opened but
+	// glfw is still initialized for its threads, mutexes and the processor count
+	ctx = elfCreateContext();
+	elfIncRef((elfObject*)ctx);
+
+	ctx->width = width;
+	ctx->height = height;
+	ctx->title = elfCreateString(title);
+	ctx->headless = ELF_TRUE;
+	ctx->startTime = elfGetSystemTime();
+
+	// glfw 2 needs a display to initialize on x11, without one the engine still runs, only on one thread
+	if(!glfwInit()) elfLogWrite("warning: can't initialize glfw, jobs run on the main thread\n");
+
+	return ELF_TRUE;
+}
+
+double elfGetSystemTime()
+{
+#if defined(ELF_WINDOWS)
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (double)counter.QuadPart/(double)frequency.QuadPart;
+#else
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	return (double)tv.tv_sec+(double)tv.tv_usec/1000000.0;
+#endif
+}
+
 void elfDeinitContext()
 {
 	if(!ctx) return;
@@ -210,7 +254,7 @@ unsigned char elfResizeContext(int width, int height)
 	if(width <= 0 || height <= 0 || (width == ctx->width &&
 		height == ctx->height)) return ELF_FALSE;
 
-	glfwSetWindowSize(width, height);
+	if(!ctx->headless) glfwSetWindowSize(width, height);
 	ctx->width = width;
 	ctx->height = height;
 
@@ -225,6 +269,8 @@ ELF_API void ELF_APIENTRY elfSetTitle(const char* title)
 
 	ctx->title = elfCreateString(title);
 
+	if(ctx->headless) return;
+
 	glfwSetWindowTitle(title);
 	glfwPollEvents();
 }
@@ -278,16 +324,29 @@ ELF_API const char* ELF_APIENTRY elfGetTitle()
 
 ELF_API double ELF_APIENTRY elfGetTime()
 {
+	if(ctx && ctx->headless) return elfGetSystemTime()-ctx->startTime;
 	return glfwGetTime();
 }
 
 ELF_API void ELF_APIENTRY elfSleep(float time)
 {
+	if(ctx && ctx->headless)
+	{
+#if defined(ELF_WINDOWS)
+		Sleep((DWORD)(time*1000.0f));
+#else
+		usleep((useconds_t)(time*1000000.0f));
+#endif
+		return;
+	}
+
 	glfwSleep(time);
 }
 
 ELF_API unsigned char ELF_APIENTRY elfIsWindowOpened()
 {
+	// there is no window to close, a headless run ends with elfQuit
+	if(ctx->headless) return ELF_TRUE;
 	return glfwGetWindowParam(GLFW_OPENED);
 }
 
@@ -310,6 +369,8 @@ void elfSwapBuffers()
 		}
 	}
 
+	if(ctx->headless) return;
+
 	glfwSwapBuffers();
 
 	for(i = 0; i < 16; i++)
@@ -458,7 +519,7 @@ ELF_API elfVec2i ELF_APIENTRY elfGetMouseForce()
 
 ELF_API void ELF_APIENTRY elfSetMousePosition(int x, int y)
 {
-	glfwSetMousePos(x, y);
+	if(!ctx->headless) glfwSetMousePos(x, y);
 
 	ctx->mousePosition[0] = x;
 	ctx->mousePosition[1] = y;
@@ -471,6 +532,12 @@ ELF_API void ELF_APIENTRY elfSetMousePosition(int x, int y)
 
 ELF_API void ELF_APIENTRY elfHideMouse(unsigned char hide)
 {
+	if(ctx->headless)
+	{
+		ctx->hideMouse = !hide == ELF_FALSE;
+		return;
+	}
+
 	if(hide)
 	{
 		glfwDisable(GLFW_MOUSE_CURSOR);
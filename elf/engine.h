@@ -14,10 +14,12 @@ elfEngine* elfCreateEngine()
 	engine->fpsTimer = elfCreateTimer();
 	engine->fpsLimitTimer = elfCreateTimer();
 	engine->timeSyncTimer = elfCreateTimer();
+	engine->frameTimer = elfCreateTimer();
 
 	elfIncRef((elfObject*)engine->fpsTimer);
 	elfIncRef((elfObject*)engine->fpsLimitTimer);
 	elfIncRef((elfObject*)engine->timeSyncTimer);
+	elfIncRef((elfObject*)engine->frameTimer);
 
 	engine->freeRun = ELF_TRUE;
 
@@ -35,6 +37,7 @@ void elfDestroyEngine(void* data)
 	elfDecRef((elfObject*)engine->fpsTimer);
 	elfDecRef((elfObject*)engine->fpsLimitTimer);
 	elfDecRef((elfObject*)engine->timeSyncTimer);
+	elfDecRef((elfObject*)engine->frameTimer);
 
 	if(engine->postProcess) elfDestroyPostProcess(engine->postProcess);
 
@@ -43,14 +46,19 @@ void elfDestroyEngine(void* data)
 
 	if(eng->guiFont) elfDecRef((elfObject*)eng->guiFont);
 
+	if(engine->loader) elfDecRef((elfObject*)engine->loader);
+	if(engine->jobs) elfDecRef((elfObject*)engine->jobs);
+	if(engine->profiler) elfDecRef((elfObject*)engine->profiler);
+
 	free(engine);
 
 	elfDecObj(ELF_ENGINE);
 }
 
-unsigned char elfInitEngine()
+unsigned char elfInitEngine(elfConfig* config)
 {
 	FILE* file;
+	int threadCount;
 
 	if(eng)
 	{
@@ -77,6 +85,17 @@ unsigned char elfInitEngine()
 		if(eng->guiFont) elfIncRef((elfObject*)eng->guiFont);
 	}
 
+	threadCount = config->threadCount;
+	if(!threadCount) threadCount = glfwGetNumberOfProcessors();
+
+	eng->jobs = elfCreateJobQueue(threadCount);
+	elfIncRef((elfObject*)eng->jobs);
+
+	elfLogWrite("job threads: %d\n", elfGetJobQueueThreadCount(eng->jobs));
+
+	eng->profiler = elfCreateProfiler();
+	elfIncRef((elfObject*)eng->profiler);
+
 	return ELF_TRUE;
 }
 
@@ -98,14 +117,19 @@ ELF_API unsigned char ELF_APIENTRY elfInit(elfConfig* config)
 	elfStartLog();
 	elfLogWrite("%s\n", elfGetVersion());
 
-	if(!elfInitContext(config->windowSize.x, config->windowSize.y, config->windowTitle, config->multisamples, config->fullscreen)) return ELF_FALSE;
-	if(!gfxInit())
+	if(config->headless)
+	{
+		if(!elfInitHeadlessContext(config->windowSize.x, config->windowSize.y, config->windowTitle)) return ELF_FALSE;
+	}
+	else if(!elfInitContext(config->windowSize.x, config->windowSize.y, config->windowTitle, config->multisamples, config->fullscreen)) return ELF_FALSE;
+
+	if(!gfxInit(config->headless))
 	{
 		elfDeinitContext();
 		return ELF_FALSE;
 	}
 	elfInitAudio();
-	elfInitEngine();
+	elfInitEngine(config);
 	elfInitRenderStation();
 	elfInitResources();
 	elfInitScripting();
@@ -125,11 +149,17 @@ ELF_API unsigned char ELF_APIENTRY elfInit(elfConfig* config)
 
 void elfLimitEngineFps()
 {
+	float remaining;
+
 	if(!elfAboutZero(eng->config->fpsLimit))
 	{
 		if(elfGetElapsedTime(eng->fpsLimitTimer) > 0.0f)
 		{
-			while(elfGetElapsedTime(eng->fpsLimitTimer) < 1.0f/(float)eng->config->fpsLimit);
+			// sleeping is only accurate to a millisecond or two, so the last stretch is spun
+			remaining = 1.0f/eng->config->fpsLimit-(float)elfGetElapsedTime(eng->fpsLimitTimer);
+			if(remaining > ELF_FRAME_SPIN_TIME) elfSleep(remaining-ELF_FRAME_SPIN_TIME);
+
+			while(elfGetElapsedTime(eng->fpsLimitTimer) < 1.0f/eng->config->fpsLimit);
 			elfStartTimer(eng->fpsLimitTimer);
 		}
 		else
@@ -139,11 +169,61 @@ void elfLimitEngineFps()
 	}
 }
 
+void elfStepEngine(float frameTime)
+{
+	float step;
+
+	step = 1.0f/eng->config->stepRate;
+
+	eng->stepTime += frameTime;
+	eng->steps = 0;
+	eng->sync = step;
+
+	if(eng->gui) elfUpdateGui(eng->gui, frameTime);
+
+	while(eng->stepTime >= step)
+	{
+		// past the cap the remaining backlog is dropped, the simulation slows down instead of spiraling
+		if(eng->steps >= eng->config->maxSteps)
+		{
+			eng->stepTime = 0.0f;
+			break;
+		}
+
+		if(eng->scene)
+		{
+			elfStoreSceneStep(eng->scene);
+			elfUpdateScene(eng->scene, step);
+		}
+
+		eng->stepTime -= step;
+		eng->steps++;
+	}
+
+	eng->stepAlpha = eng->stepTime/step;
+}
+
 void elfUpdateEngine()
 {
 	elfUpdateAudio();
 
-	if(elfGetElapsedTime(eng->timeSyncTimer) > 0.0f)
+	// the budget is in milliseconds, a finished scene replaces the current one the same way elfLoadScene does
+	if(eng->loader && elfUpdateSceneLoader(eng->loader, eng->config->loadBudget/1000.0f))
+	{
+		if(eng->loader->scene) elfSetScene(eng->loader->scene);
+
+		elfDecRef((elfObject*)eng->loader);
+		eng->loader = NULL;
+	}
+
+	if(elfGetElapsedTime(eng->timeSyncTimer) > 0.0f && !elfAboutZero(eng->config->stepRate))
+	{
+		// headless runs are not tied to the wall clock, every run simulates exactly one step
+		if(eng->config->headless) elfStepEngine(1.0f/eng->config->stepRate);
+		else elfStepEngine((float)elfGetElapsedTime(eng->timeSyncTimer)*eng->config->speed);
+		elfStartTimer(eng->timeSyncTimer);
+	}
+	else if(elfGetElapsedTime(eng->timeSyncTimer) > 0.0f)
 	{
 		if(elfAboutZero(eng->config->tickRate))
 			eng->sync = (eng->sync*2.0f+((float)elfGetElapsedTime(eng->timeSyncTimer)*eng->config->speed))/3.0f;
@@ -173,6 +253,14 @@ void elfCountEngineFps()
 {
 	eng->frames++;
 
+	if(elfGetElapsedTime(eng->frameTimer) > 0.0f)
+	{
+		eng->frameTimes[eng->frameTimeIndex] = (float)elfGetElapsedTime(eng->frameTimer);
+		eng->frameTimeIndex = (eng->frameTimeIndex+1)%ELF_FRAME_TIME_SAMPLES;
+		if(eng->frameTimeCount < ELF_FRAME_TIME_SAMPLES) eng->frameTimeCount++;
+	}
+	elfStartTimer(eng->frameTimer);
+
 	if(elfGetElapsedTime(eng->fpsTimer) > 0.0f)
 	{
 		if(elfGetElapsedTime(eng->fpsTimer) >= 1.0f)
@@ -188,12 +276,41 @@ void elfCountEngineFps()
 	}
 }
 
+unsigned char elfRunHeadless()
+{
+	if(eng->quit)
+	{
+		eng->freeRun = ELF_TRUE;
+		return ELF_FALSE;
+	}
+
+	elfBeginProfileFrame(eng->profiler);
+
+	// nothing is drawn, the post draw pass only clears the per frame actor flags
+	if(eng->scene) elfScenePostDraw(eng->scene);
+
+	elfSwapBuffers();
+
+	elfBeginProfileScope("wait");
+	elfLimitEngineFps();
+	elfEndProfileScope();
+	elfUpdateEngine();
+	elfEndProfileFrame(eng->profiler);
+	elfCountEngineFps();
+
+	eng->freeRun = ELF_TRUE;
+
+	return ELF_TRUE;
+}
+
 ELF_API unsigned char ELF_APIENTRY elfRun()
 {
 	if(!eng || !eng->freeRun) return ELF_FALSE;
 
 	eng->freeRun = ELF_FALSE;
 
+	if(eng->config->headless) return elfRunHeadless();
+
 	if((eng->config->f10Exit && elfGetKeyState(ELF_KEY_F10)) || !elfIsWindowOpened() || eng->quit)
 	{
 		eng->freeRun = ELF_TRUE;
@@ -201,6 +318,10 @@ ELF_API unsigned char ELF_APIENTRY elfRun()
 	}
 
 	gfxResetVerticesDrawn();
+	gfxResetGlCalls();
+	gfxResetDrawStats();
+
+	elfBeginProfileFrame(eng->profiler);
 
 	if(eng->postProcess)
 	{
@@ -216,10 +337,15 @@ ELF_API unsigned char ELF_APIENTRY elfRun()
 		gfxClearBuffers(0.0f, 0.0f, 0.0f, 1.0f, 1.0f);
 	}
 
+	// with a fixed step the actors are drawn between their last two simulated states
+	if(eng->scene && !elfAboutZero(eng->config->stepRate)) elfInterpolateScene(eng->scene, eng->stepAlpha);
+
 	if(eng->scene)
 	{
 		elfScenePreDraw(eng->scene);
+		elfBeginProfileScope("draw scene");
 		elfDrawScene(eng->scene);
+		elfEndProfileScope();
 		elfScenePostDraw(eng->scene);
 	}
 
@@ -231,21 +357,31 @@ ELF_API unsigned char ELF_APIENTRY elfRun()
 			if(eng->postProcess->dof || eng->postProcess->ssao)
 				gfxCopyFrameBuffer(eng->postProcess->mainRtDepth, 0, 0, 0, 0, elfGetWindowWidth(), elfGetWindowHeight());
 		}
+		elfBeginProfileScope("post process");
 		elfRunPostProcess(eng->postProcess, eng->scene);
+		elfEndProfileScope();
 	}
 	if(eng->scene && eng->scene->debugDraw) elfDrawSceneDebug(eng->scene);
-	if(eng->gui) elfDrawGui(eng->gui);
+	if(eng->scene) elfRestoreSceneStep(eng->scene);
+	if(eng->gui)
+	{
+		elfBeginProfileScope("gui");
+		elfDrawGui(eng->gui);
+		elfEndProfileScope();
+	}
 
 	elfSwapBuffers();
 
+	// the sleep of a capped frame gets its own scope so it doesn't hide in the frame time
+	elfBeginProfileScope("wait");
 	elfLimitEngineFps();
+	elfEndProfileScope();
 	elfUpdateEngine();
+	elfEndProfileFrame(eng->profiler);
 	elfCountEngineFps();
 
 	eng->freeRun = ELF_TRUE;
 
-	elfSleep(0.001f);
-
 	return ELF_TRUE;
 }
 
@@ -357,6 +493,32 @@ ELF_API void ELF_APIENTRY elfQuit()
 	eng->quit = ELF_TRUE;
 }
 
+ELF_API unsigned char ELF_APIENTRY elfIsHeadless()
+{
+	return eng->config->headless;
+}
+
+ELF_API float ELF_APIENTRY elfBenchmark(int ticks)
+{
+	double start;
+	double time;
+	int i;
+
+	if(ticks < 1) return 0.0f;
+
+	start = elfGetTime();
+	for(i = 0; i < ticks; i++)
+	{
+		if(!elfRun()) break;
+	}
+	time = elfGetTime()-start;
+
+	elfLogWrite("benchmark: %d ticks in %.3f seconds, %.1f ticks per second\n", i, time, time > 0.0 ? (double)i/time : 0.0);
+
+	if(time <= 0.0) return 0.0f;
+	return (float)((double)i/time);
+}
+
 ELF_API void ELF_APIENTRY elfSetF10Exit(unsigned char exit)
 {
 	eng->config->f10Exit = !(exit == ELF_FALSE);
@@ -382,6 +544,42 @@ ELF_API elfScene* ELF_APIENTRY elfLoadScene(const char* filePath)
 	return scene;
 }
 
+ELF_API elfSceneLoader* ELF_APIENTRY elfLoadSceneAsync(const char* filePath)
+{
+	elfSceneLoader* loader;
+	elfPak* pak;
+	const char* type;
+
+	loader = elfCreateSceneLoader();
+	loader->filePath = elfCreateString(filePath);
+
+	type = strrchr(filePath, '.');
+	if(type && !strcmp(type, ".pak"))
+	{
+		pak = elfCreatePakFromFile(filePath);
+		if(pak) elfStartSceneLoader(loader, pak);
+		else loader->done = ELF_TRUE;
+	}
+	else
+	{
+		// only paks are streamed, anything else goes through the importer in one go
+		loader->scene = elfCreateSceneFromFile("", filePath);
+		if(loader->scene) elfIncRef((elfObject*)loader->scene);
+		loader->done = ELF_TRUE;
+	}
+
+	if(eng->loader) elfDecRef((elfObject*)eng->loader);
+	eng->loader = loader;
+	elfIncRef((elfObject*)eng->loader);
+
+	return loader;
+}
+
+ELF_API elfSceneLoader* ELF_APIENTRY elfGetSceneLoader()
+{
+	return eng->loader;
+}
+
 ELF_API void ELF_APIENTRY elfSetScene(elfScene* scene)
 {
 	if(eng->scene) elfDecRef((elfObject*)eng->scene);
@@ -416,6 +614,32 @@ ELF_API int ELF_APIENTRY elfGetFps()
 	return eng->fps;
 }
 
+int elfCompareFrameTimes(const void* a, const void* b)
+{
+	if(*(const float*)a < *(const float*)b) return -1;
+	if(*(const float*)a > *(const float*)b) return 1;
+	return 0;
+}
+
+ELF_API float ELF_APIENTRY elfGetFrameTimePercentile(float percentile)
+{
+	float times[ELF_FRAME_TIME_SAMPLES];
+	int index;
+
+	// over the last ELF_FRAME_TIME_SAMPLES frames, 50 gives the median and 99 the worst hitches
+	if(!eng->frameTimeCount) return 0.0f;
+
+	memcpy(times, eng->frameTimes, sizeof(float)*eng->frameTimeCount);
+	qsort(times, eng->frameTimeCount, sizeof(float), elfCompareFrameTimes);
+
+	if(percentile < 0.0f) percentile = 0.0f;
+	if(percentile > 100.0f) percentile = 100.0f;
+
+	index = (int)(percentile/100.0f*(float)(eng->frameTimeCount-1)+0.5f);
+
+	return times[index];
+}
+
 ELF_API void ELF_APIENTRY elfSetFpsLimit(float fpsLimit)
 {
 	eng->config->fpsLimit = fpsLimit;
@@ -449,6 +673,63 @@ ELF_API float ELF_APIENTRY elfGetSpeed()
 	return eng->config->speed;
 }
 
+ELF_API void ELF_APIENTRY elfSetStepRate(float stepRate)
+{
+	elfSetConfigStepRate(eng->config, stepRate);
+	eng->stepTime = 0.0f;
+	eng->stepAlpha = 0.0f;
+}
+
+ELF_API float ELF_APIENTRY elfGetStepRate()
+{
+	return eng->config->stepRate;
+}
+
+ELF_API void ELF_APIENTRY elfSetMaxSteps(int maxSteps)
+{
+	elfSetConfigMaxSteps(eng->config, maxSteps);
+}
+
+ELF_API int ELF_APIENTRY elfGetMaxSteps()
+{
+	return eng->config->maxSteps;
+}
+
+ELF_API int ELF_APIENTRY elfGetSteps()
+{
+	return eng->steps;
+}
+
+ELF_API float ELF_APIENTRY elfGetStepAlpha()
+{
+	return eng->stepAlpha;
+}
+
+ELF_API void ELF_APIENTRY elfSetScriptGcMode(int mode)
+{
+	elfSetConfigScriptGcMode(eng->config, mode);
+}
+
+ELF_API int ELF_APIENTRY elfGetScriptGcMode()
+{
+	return eng->config->scriptGcMode;
+}
+
+ELF_API void ELF_APIENTRY elfSetScriptGcBudget(int budget)
+{
+	elfSetConfigScriptGcBudget(eng->config, budget);
+}
+
+ELF_API int ELF_APIENTRY elfGetScriptGcBudget()
+{
+	return eng->config->scriptGcBudget;
+}
+
+ELF_API int ELF_APIENTRY elfGetThreadCount()
+{
+	return elfGetJobQueueThreadCount(eng->jobs);
+}
+
 ELF_API unsigned char ELF_APIENTRY elfSaveScreenShot(const char* filePath)
 {
 	unsigned char* data;
@@ -478,6 +759,26 @@ ELF_API unsigned char ELF_APIENTRY elfGetTextureCompress()
 	return eng->config->textureCompress;
 }
 
+ELF_API void ELF_APIENTRY elfSetSaveTextureCompress(unsigned char compress)
+{
+	eng->config->saveTextureCompress = !compress == ELF_FALSE;
+}
+
+ELF_API unsigned char ELF_APIENTRY elfGetSaveTextureCompress()
+{
+	return eng->config->saveTextureCompress;
+}
+
+ELF_API void ELF_APIENTRY elfSetMapPaks(unsigned char mapPaks)
+{
+	eng->config->mapPaks = !mapPaks == ELF_FALSE;
+}
+
+ELF_API unsigned char ELF_APIENTRY elfGetMapPaks()
+{
+	return eng->config->mapPaks;
+}
+
 ELF_API void ELF_APIENTRY elfSetTextureAnisotropy(float anisotropy)
 {
 	eng->config->textureAnisotropy = anisotropy;
@@ -516,6 +817,42 @@ ELF_API int ELF_APIENTRY elfGetPolygonsRendered()
 	return gfxGetVerticesDrawn(GFX_TRIANGLES)/3+gfxGetVerticesDrawn(GFX_TRIANGLE_STRIP)/3;
 }
 
+ELF_API int ELF_APIENTRY elfGetGlCalls()
+{
+	return gfxGetGlCalls();
+}
+
+ELF_API int ELF_APIENTRY elfGetDrawCalls()
+{
+	return gfxGetDrawCalls();
+}
+
+ELF_API int ELF_APIENTRY elfGetInstancesDrawn()
+{
+	// what the draw call count would be if every instance was drawn on its own
+	return gfxGetInstancesDrawn();
+}
+
+ELF_API int ELF_APIENTRY elfGetShaderSwitches()
+{
+	return gfxGetShaderSwitches();
+}
+
+ELF_API int ELF_APIENTRY elfGetTextureSwitches()
+{
+	return gfxGetTextureSwitches();
+}
+
+ELF_API int ELF_APIENTRY elfGetBlendSwitches()
+{
+	return gfxGetBlendSwitches();
+}
+
+ELF_API int ELF_APIENTRY elfGetShaderProgramCount()
+{
+	return gfxGetShaderProgramCount();
+}
+
 ELF_API void ELF_APIENTRY elfSetBloom(float threshold)
 {
 	if(gfxGetVersion() < 200) return;
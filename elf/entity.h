@@ -11,13 +11,20 @@ ELF_API elfEntity* ELF_APIENTRY elfCreateEntity(const char* name)
 	elfInitActor((elfActor*)entity, ELF_FALSE);
 
 	entity->scale.x = entity->scale.y = entity->scale.z = 1.0f;
-	if(gfxGetVersion() >= 150) entity->query = gfxCreateQuery();
+	if(gfxGetVersion() >= 150)
+	{
+		entity->queries[0] = gfxCreateQuery();
+		entity->queries[1] = gfxCreateQuery();
+	}
 	entity->visible = ELF_TRUE;
 
 	entity->materials = elfCreateList();
 	elfIncRef((elfObject*)entity->materials);
 
 	entity->culled = ELF_TRUE;
+	entity->bvhNode = -1;
+	entity->queryFrames[0] = entity->queryFrames[1] = -1;
+	entity->testFrame = -1;
 
 	entity->dobject = elfCreatePhysicsObjectBox(0.2f, 0.2f, 0.2f, 0.0f, 0.0f, 0.0f, 0.f);
 	elfSetPhysicsObjectActor(entity->dobject, (elfActor*)entity);
@@ -28,6 +35,10 @@ ELF_API elfEntity* ELF_APIENTRY elfCreateEntity(const char* name)
 	entity->armaturePlayer = elfCreateFramePlayer();
 	elfIncRef((elfObject*)entity->armaturePlayer);
 
+	// layer zero is the armature player every entity has, the others are created when first used
+	entity->armatureLayers[0].player = entity->armaturePlayer;
+	entity->armatureLayers[0].weight = 1.0f;
+
 	if(name) entity->name = elfCreateString(name);
 
 	entity->id = ++res->entityIdCounter;
@@ -56,21 +67,52 @@ ELF_API void ELF_APIENTRY elfGenerateEntityTangents(elfEntity* entity)
 
 void elfUpdateEntity(elfEntity* entity)
 {
+	int i;
+
 	elfUpdateActor((elfActor*)entity);
-	elfUpdateFramePlayer(entity->armaturePlayer);
+
+	for(i = 0; i < ELF_MAX_ARMATURE_LAYERS; i++)
+	{
+		if(entity->armatureLayers[i].player) elfUpdateFramePlayer(entity->armatureLayers[i].player);
+	}
+}
+
+unsigned char elfIsEntityArmaturePoseChanged(elfEntity* entity)
+{
+	elfArmatureLayer* layer;
+	int i;
+
+	if(entity->armatureBlendChanged) return ELF_TRUE;
+
+	for(i = 0; i < ELF_MAX_ARMATURE_LAYERS; i++)
+	{
+		layer = &entity->armatureLayers[i];
+		if(!layer->player || layer->weight <= 0.0f) continue;
+		if(fabs(elfGetFramePlayerFrame(layer->player)-layer->prevFrame) > 0.0001f) return ELF_TRUE;
+	}
+
+	return ELF_FALSE;
 }
 
 void elfEntityPreDraw(elfEntity* entity)
 {
+	int i;
+
 	elfActorPreDraw((elfActor*)entity);
 
 	gfxGetTransformPosition(entity->transform, &entity->position.x);
 
-	if(entity->armature && fabs(elfGetFramePlayerFrame(entity->armaturePlayer)-entity->prevArmatureFrame) > 0.0001f &&
-		elfGetFramePlayerFrame(entity->armaturePlayer) <= entity->armature->frameCount)
+	if(entity->armature && elfIsEntityArmaturePoseChanged(entity))
 	{
-		elfDeformEntityWithArmature(entity->armature, entity, elfGetFramePlayerFrame(entity->armaturePlayer));
-		entity->prevArmatureFrame = elfGetFramePlayerFrame(entity->armaturePlayer);
+		// the vertices are skinned by the scene's job queue, see elfScenePreDraw
+		entity->skinPending = elfPrepareEntitySkinning(entity->armature, entity, elfGetFramePlayerFrame(entity->armaturePlayer));
+
+		for(i = 0; i < ELF_MAX_ARMATURE_LAYERS; i++)
+		{
+			if(entity->armatureLayers[i].player)
+				entity->armatureLayers[i].prevFrame = elfGetFramePlayerFrame(entity->armatureLayers[i].player);
+		}
+		entity->armatureBlendChanged = ELF_FALSE;
 	}
 
 	if(entity->moved)
@@ -87,6 +129,7 @@ void elfEntityPostDraw(elfEntity* entity)
 void elfDestroyEntity(void* data)
 {
 	elfEntity* entity = (elfEntity*)data;
+	int i;
 
 	elfCleanActor((elfActor*)entity);
 
@@ -94,11 +137,18 @@ void elfDestroyEntity(void* data)
 	if(entity->armature) elfDecRef((elfObject*)entity->armature);
 	if(entity->vertices) gfxDecRef((gfxObject*)entity->vertices);
 	if(entity->normals) gfxDecRef((gfxObject*)entity->normals);
-	if(gfxGetVersion() >= 150) {if(entity->query) gfxDestroyQuery(entity->query);}
+	if(entity->palette) free(entity->palette);
+	if(entity->queries[0]) gfxDestroyQuery(entity->queries[0]);
+	if(entity->queries[1]) gfxDestroyQuery(entity->queries[1]);
 
 	elfDecRef((elfObject*)entity->materials);
 	elfDecRef((elfObject*)entity->armaturePlayer);
 
+	for(i = 1; i < ELF_MAX_ARMATURE_LAYERS; i++)
+	{
+		if(entity->armatureLayers[i].player) elfDecRef((elfObject*)entity->armatureLayers[i].player);
+	}
+
 	free(entity);
 
 	elfDecObj(ELF_ENTITY);
@@ -211,6 +261,8 @@ void elfCalcEntityAabb(elfEntity* entity)
 	tmpVec.y = entity->bbMax.y-entity->bbMin.y;
 	tmpVec.z = entity->bbMax.z-entity->bbMin.z;
 	entity->cullRadius = gfxVecLength(&tmpVec.x)/2;
+
+	if(entity->scene) elfRefitBvhEntity(&entity->scene->bvh, entity);
 }
 
 void elfCalcEntityBoundingVolumes(elfEntity* entity, unsigned char newModel)
@@ -545,6 +597,72 @@ ELF_API unsigned char ELF_APIENTRY elfIsEntityArmaturePaused(elfEntity* entity)
 	return elfIsFramePlayerPaused(entity->armaturePlayer);
 }
 
+elfFramePlayer* elfGetEntityArmatureLayerPlayer(elfEntity* entity, int layer)
+{
+	if(layer < 0 || layer >= ELF_MAX_ARMATURE_LAYERS) return NULL;
+
+	if(!entity->armatureLayers[layer].player)
+	{
+		entity->armatureLayers[layer].player = elfCreateFramePlayer();
+		elfIncRef((elfObject*)entity->armatureLayers[layer].player);
+	}
+
+	return entity->armatureLayers[layer].player;
+}
+
+ELF_API void ELF_APIENTRY elfSetEntityArmatureLayerWeight(elfEntity* entity, int layer, float weight)
+{
+	if(layer < 0 || layer >= ELF_MAX_ARMATURE_LAYERS) return;
+
+	if(weight < 0.0f) weight = 0.0f;
+	if(entity->armatureLayers[layer].weight != weight) entity->armatureBlendChanged = ELF_TRUE;
+	entity->armatureLayers[layer].weight = weight;
+}
+
+ELF_API void ELF_APIENTRY elfSetEntityArmatureLayerFrame(elfEntity* entity, int layer, float frame)
+{
+	elfFramePlayer* player;
+
+	player = elfGetEntityArmatureLayerPlayer(entity, layer);
+	if(player) elfSetFramePlayerFrame(player, frame);
+}
+
+ELF_API void ELF_APIENTRY elfPlayEntityArmatureLayer(elfEntity* entity, int layer, float start, float end, float speed)
+{
+	elfFramePlayer* player;
+
+	player = elfGetEntityArmatureLayerPlayer(entity, layer);
+	if(player) elfPlayFramePlayer(player, start, end, speed);
+	entity->armatureBlendChanged = ELF_TRUE;
+}
+
+ELF_API void ELF_APIENTRY elfLoopEntityArmatureLayer(elfEntity* entity, int layer, float start, float end, float speed)
+{
+	elfFramePlayer* player;
+
+	player = elfGetEntityArmatureLayerPlayer(entity, layer);
+	if(player) elfLoopFramePlayer(player, start, end, speed);
+	entity->armatureBlendChanged = ELF_TRUE;
+}
+
+ELF_API void ELF_APIENTRY elfStopEntityArmatureLayer(elfEntity* entity, int layer)
+{
+	if(layer < 0 || layer >= ELF_MAX_ARMATURE_LAYERS || !entity->armatureLayers[layer].player) return;
+	elfStopFramePlayer(entity->armatureLayers[layer].player);
+}
+
+ELF_API float ELF_APIENTRY elfGetEntityArmatureLayerWeight(elfEntity* entity, int layer)
+{
+	if(layer < 0 || layer >= ELF_MAX_ARMATURE_LAYERS) return 0.0f;
+	return entity->armatureLayers[layer].weight;
+}
+
+ELF_API float ELF_APIENTRY elfGetEntityArmatureLayerFrame(elfEntity* entity, int layer)
+{
+	if(layer < 0 || layer >= ELF_MAX_ARMATURE_LAYERS || !entity->armatureLayers[layer].player) return 0.0f;
+	return elfGetFramePlayerFrame(entity->armatureLayers[layer].player);
+}
+
 ELF_API elfArmature* ELF_APIENTRY elfGetEntityArmature(elfEntity* entity)
 {
 	return entity->armature;
@@ -563,7 +681,7 @@ void elfPostDrawEntity(elfEntity* entity)
 {
 	if(entity->armature)
 	{
-		if(entity->vertices) gfxSetVertexArrayData(entity->model->vertexArray, GFX_VERTEX, entity->vertices);
+		if(entity->vertices) gfxSetVertexArrayData(entity->model->vertexArray, GFX_VERTEX, entity->model->vertices);
 		if(entity->normals) gfxSetVertexArrayData(entity->model->vertexArray, GFX_NORMAL, entity->model->normals);
 	}
 }
@@ -577,9 +695,72 @@ void elfDrawEntity(elfEntity* entity, int mode, gfxShaderParams* shaderParams)
 	gfxMulMatrix3Matrix4(gfxGetTransformNormalMatrix(entity->transform),
 			shaderParams->cameraMatrix, shaderParams->normalMatrix);
 
+	// skinned by the shaders, the model is drawn as is and the palette goes along with it
+	if(entity->armature && entity->palette && !entity->vertices)
+	{
+		shaderParams->bonePalette = entity->palette;
+		shaderParams->boneCount = entity->paletteSize;
+	}
+
 	elfPreDrawEntity(entity);
 	elfDrawModel(entity->materials, entity->model, mode, shaderParams);
 	elfPostDrawEntity(entity);
+
+	shaderParams->bonePalette = NULL;
+	shaderParams->boneCount = 0;
+}
+
+unsigned char elfIsEntityInstanceable(elfEntity* entity)
+{
+	float scale[3];
+
+	// skinned entities carry their own palette or vertices, and the instanced shaders
+	// derive the normal matrix from the modelview which only works for a uniform scale
+	if(!entity->model || !entity->visible || entity->armature) return ELF_FALSE;
+
+	gfxGetTransformScale(entity->transform, scale);
+	if(fabs(scale[0]-scale[1]) > 0.0001f || fabs(scale[0]-scale[2]) > 0.0001f) return ELF_FALSE;
+
+	return ELF_TRUE;
+}
+
+unsigned char elfIsEntityTranslucent(elfEntity* entity)
+{
+	elfMaterial* material;
+
+	// alpha tested materials are cut out and still write depth, only a diffuse alpha blends
+	for(material = (elfMaterial*)elfBeginList(entity->materials); material;
+		material = (elfMaterial*)elfGetListNext(entity->materials))
+	{
+		if(material->diffuseColor.a < 1.0f) return ELF_TRUE;
+	}
+
+	return ELF_FALSE;
+}
+
+void elfDrawEntityInstances(elfEntity** entities, int count, float* matrices, int mode, gfxShaderParams* shaderParams)
+{
+	int i;
+
+	for(i = 0; i < count; i++)
+	{
+		gfxMulMatrix4Matrix4(gfxGetTransformMatrix(entities[i]->transform),
+			shaderParams->cameraMatrix, &matrices[i*16]);
+	}
+
+	if(gfxIsInstancingSupported())
+	{
+		gfxSetInstanceMatrices(matrices, count);
+		shaderParams->instanceCount = count;
+	}
+
+	elfDrawModelInstances(entities[0]->materials, entities[0]->model, mode, shaderParams, entities, matrices, count);
+
+	if(shaderParams->instanceCount)
+	{
+		shaderParams->instanceCount = 0;
+		gfxSetInstanceMatrices(NULL, 0);
+	}
 }
 
 void elfDrawEntityBoundingBox(elfEntity* entity, gfxShaderParams* shaderParams)
@@ -593,6 +774,62 @@ void elfDrawEntityBoundingBox(elfEntity* entity, gfxShaderParams* shaderParams)
 	elfDrawBoundingBox(&entity->model->bbMin.x, &entity->model->bbMax.x);
 }
 
+void elfBeginEntityQuery(elfEntity* entity, int frame, gfxShaderParams* shaderParams)
+{
+	int slot;
+
+	// a query is not reissued before its result is read, with the gpu several
+	// frames behind a new query would throw away the result it is waiting on
+	if(entity->queryFrames[0] == -1) slot = 0;
+	else if(entity->queryFrames[1] == -1) slot = 1;
+	else return;
+
+	gfxBeginQuery(entity->queries[slot]);
+	elfDrawEntityBoundingBox(entity, shaderParams);
+	gfxEndQuery(entity->queries[slot]);
+
+	entity->queryFrames[slot] = frame;
+}
+
+unsigned char elfIsEntityOccluded(elfEntity* entity, int frame)
+{
+	int i, slot;
+	int result;
+
+	// an entity that wasn't tested last frame has just come into view and has no
+	// valid result yet, so it is drawn until a query says otherwise, the queries
+	// still pending from an older view are read but not trusted
+	if(entity->testFrame != frame-1)
+	{
+		entity->occluded = ELF_FALSE;
+		for(i = 0; i < 2; i++)
+		{
+			if(entity->queryFrames[i] != -1 && entity->queryFrames[i] < frame) entity->queryFrames[i] = -2;
+		}
+	}
+
+	// results that are back are read oldest first, one that isn't back yet
+	// keeps the last known state instead of stalling
+	while(ELF_TRUE)
+	{
+		slot = -1;
+		for(i = 0; i < 2; i++)
+		{
+			if(entity->queryFrames[i] == -1) continue;
+			if(slot == -1 || entity->queryFrames[i] < entity->queryFrames[slot]) slot = i;
+		}
+		if(slot == -1 || !gfxIsQueryResult(entity->queries[slot])) break;
+
+		result = gfxGetQueryResult(entity->queries[slot]);
+		if(entity->queryFrames[slot] != -2) entity->occluded = result < 1;
+		entity->queryFrames[slot] = -1;
+	}
+
+	entity->testFrame = frame;
+
+	return entity->occluded;
+}
+
 void elfDrawEntityDebug(elfEntity* entity, gfxShaderParams* shaderParams)
 {
 	float min[3];
@@ -727,6 +964,55 @@ unsigned char elfCullEntity(elfEntity* entity, elfCamera* camera)
 	return !elfAabbInsideFrustum(camera, &entity->cullAabbMin.x, &entity->cullAabbMax.x);
 }
 
+void elfDestroyCullBatch(elfCullBatch* batch)
+{
+	if(batch->aabbs) free(batch->aabbs);
+	if(batch->entities) free(batch->entities);
+	if(batch->visible) free(batch->visible);
+
+	memset(batch, 0x0, sizeof(elfCullBatch));
+}
+
+void elfBeginCullBatch(elfCullBatch* batch)
+{
+	batch->count = 0;
+	batch->visibleCount = 0;
+}
+
+void elfAddCullBatchEntity(elfCullBatch* batch, elfEntity* entity)
+{
+	float* block;
+	int lane;
+
+	if(batch->count == batch->size)
+	{
+		// keep the size a multiple of four so the last block is always complete
+		batch->size = batch->size ? batch->size*2 : 64;
+		batch->aabbs = (float*)realloc(batch->aabbs, sizeof(float)*6*batch->size);
+		batch->entities = (elfEntity**)realloc(batch->entities, sizeof(elfEntity*)*batch->size);
+		batch->visible = (int*)realloc(batch->visible, sizeof(int)*batch->size);
+		memset(&batch->aabbs[batch->count*6], 0x0, sizeof(float)*6*(batch->size-batch->count));
+	}
+
+	block = &batch->aabbs[(batch->count/4)*24];
+	lane = batch->count%4;
+
+	block[lane] = entity->cullAabbMin.x;
+	block[4+lane] = entity->cullAabbMin.y;
+	block[8+lane] = entity->cullAabbMin.z;
+	block[12+lane] = entity->cullAabbMax.x;
+	block[16+lane] = entity->cullAabbMax.y;
+	block[20+lane] = entity->cullAabbMax.z;
+
+	batch->entities[batch->count++] = entity;
+}
+
+int elfCullBatchCamera(elfCullBatch* batch, elfCamera* camera)
+{
+	batch->visibleCount = gfxAabbsInsideFrustum(camera->frustum, batch->aabbs, batch->count, batch->visible);
+	return batch->visibleCount;
+}
+
 ELF_API unsigned char ELF_APIENTRY elfGetEntityChanged(elfEntity* entity)
 {
 	return entity->moved;
@@ -22,6 +22,9 @@ ELF_API elfFont* ELF_APIENTRY elfCreateFontFromFile(const char* filePath, int si
 	int width;
 	int height;
 	unsigned char* data;
+	unsigned char* bitmaps[128];
+	int x, y;
+	int rowHeight;
 	int error;
 	int i, j, k;
 
@@ -69,6 +72,9 @@ ELF_API elfFont* ELF_APIENTRY elfCreateFontFromFile(const char* filePath, int si
 
 	slot = face->glyph;
 
+	// rasterize every glyph first, the atlas size depends on all of them
+	memset(bitmaps, 0x0, sizeof(unsigned char*)*128);
+
 	for(i = 33; i < 127; i++)
 	{
 		error = FT_Load_Char(face, (char)i, FT_LOAD_RENDER|FT_LOAD_FORCE_AUTOHINT);
@@ -82,27 +88,83 @@ ELF_API elfFont* ELF_APIENTRY elfCreateFontFromFile(const char* filePath, int si
 		height = slot->bitmap.rows;
 		if(width < 1 || height < 1) continue;
 
-		data = (unsigned char*)malloc(sizeof(unsigned char)*width*height*2);
+		bitmaps[i] = (unsigned char*)malloc(sizeof(unsigned char)*width*height);
 		for(j = 0; j < height; j++)
 		{
-			for(k = 0; k < width; k++)
-			{
-				data[j*width*2+k*2] = 255;
-				data[j*width*2+k*2+1] = slot->bitmap.buffer[((height-1)-j)*width+k];
-			}
+			memcpy(&bitmaps[i][j*width], &slot->bitmap.buffer[((height-1)-j)*width], sizeof(unsigned char)*width);
 		}
 
 		font->chars[i].code = (char)i;
+		font->chars[i].width = width;
+		font->chars[i].height = height;
 		font->chars[i].offsetX = width+size/7;
 		font->chars[i].offsetY = -(face->glyph->bitmap.rows-face->glyph->bitmap_top);
-		font->chars[i].texture = gfxCreate2dTexture(width, height, 0.0f, GFX_CLAMP, GFX_NEAREST, GFX_LUMINANCE_ALPHA, GFX_LUMINANCE_ALPHA, GFX_UBYTE, data);
 
 		if(-font->chars[i].offsetY > font->offsetY) font->offsetY = -font->chars[i].offsetY;
+	}
+
+	// shelf pack the glyphs with a pixel of padding, widening the atlas until it is no taller than wide
+	font->atlasWidth = 64;
+	while(1)
+	{
+		x = 1;
+		y = 1;
+		rowHeight = 0;
+
+		for(i = 33; i < 127; i++)
+		{
+			if(!bitmaps[i]) continue;
+
+			if(x+font->chars[i].width+1 > font->atlasWidth)
+			{
+				x = 1;
+				y += rowHeight+1;
+				rowHeight = 0;
+			}
+
+			font->chars[i].x = x;
+			font->chars[i].y = y;
+
+			x += font->chars[i].width+1;
+			if(font->chars[i].height > rowHeight) rowHeight = font->chars[i].height;
+		}
+
+		y += rowHeight+1;
+
+		if(y <= font->atlasWidth) break;
+		font->atlasWidth *= 2;
+	}
+
+	font->atlasHeight = 1;
+	while(font->atlasHeight < y) font->atlasHeight *= 2;
 
-		free(data);
-		data = NULL;
+	data = (unsigned char*)malloc(sizeof(unsigned char)*font->atlasWidth*font->atlasHeight*2);
+	for(j = 0; j < font->atlasWidth*font->atlasHeight; j++)
+	{
+		data[j*2] = 255;
+		data[j*2+1] = 0;
+	}
+
+	for(i = 33; i < 127; i++)
+	{
+		if(!bitmaps[i]) continue;
+
+		for(j = 0; j < font->chars[i].height; j++)
+		{
+			for(k = 0; k < font->chars[i].width; k++)
+			{
+				data[((font->chars[i].y+j)*font->atlasWidth+font->chars[i].x+k)*2+1] = bitmaps[i][j*font->chars[i].width+k];
+			}
+		}
+
+		free(bitmaps[i]);
 	}
 
+	font->atlas = gfxCreate2dTexture(font->atlasWidth, font->atlasHeight, 0.0f, GFX_CLAMP, GFX_NEAREST,
+		GFX_LUMINANCE_ALPHA, GFX_LUMINANCE_ALPHA, GFX_UBYTE, data);
+
+	free(data);
+
 	error = FT_Done_Face(face);
 	error = FT_Done_FreeType(library);
 
@@ -111,14 +173,12 @@ ELF_API elfFont* ELF_APIENTRY elfCreateFontFromFile(const char* filePath, int si
 
 void elfDestroyFont(void* data)
 {
-	int i;
 	elfFont* font = (elfFont*)data;
 
 	if(font->name) elfDestroyString(font->name);
 	if(font->filePath) elfDestroyString(font->filePath);
 
-	for(i = 0; i < 128; i++)
-		if(font->chars[i].texture) gfxDestroyTexture(font->chars[i].texture);
+	if(font->atlas) gfxDestroyTexture(font->atlas);
 
 	free(font);
 
@@ -161,8 +221,8 @@ ELF_API int ELF_APIENTRY elfGetStringWidth(elfFont* font, const char* str)
 		}
 		else
 		{
-			if(i != strlen(str)-1 || !chr->texture) ox += chr->offsetX;
-			else ox += gfxGetTextureWidth(chr->texture);
+			if(i != strlen(str)-1 || !chr->width) ox += chr->offsetX;
+			else ox += chr->width;
 		}
 		if(ox > x) x = ox;
 	}
@@ -190,25 +250,67 @@ ELF_API int ELF_APIENTRY elfGetStringHeight(elfFont* font, const char* str)
 		}
 		else
 		{
-			if(i != strlen(str)-1 || !chr->texture) ox += chr->offsetX;
-			else ox += gfxGetTextureWidth(chr->texture);
+			if(i != strlen(str)-1 || !chr->width) ox += chr->offsetX;
+			else ox += chr->width;
 		}
 	}
 
 	return y;
 }
 
-void elfDrawString(elfFont* font, const char* str, int x, int y, gfxShaderParams* shaderParams)
+void elfDestroyTextBatch(elfTextBatch* batch)
+{
+	if(batch->vertexArray) gfxDecRef((gfxObject*)batch->vertexArray);
+	if(batch->vertices) gfxDecRef((gfxObject*)batch->vertices);
+	if(batch->texCoords) gfxDecRef((gfxObject*)batch->texCoords);
+	if(batch->font) elfDecRef((elfObject*)batch->font);
+	if(batch->text) elfDestroyString(batch->text);
+
+	memset(batch, 0x0, sizeof(elfTextBatch));
+}
+
+void elfBuildTextBatch(elfTextBatch* batch, elfFont* font, const char* str, int x, int y)
 {
 	int ox;
 	int oy;
+	int length;
+	float gx, gy, gw, gh;
+	float tx, ty, tw, th;
+	float* vertexBuffer;
+	float* texCoordBuffer;
 	elfCharacter* chr;
 	unsigned int i;
 
+	length = strlen(str);
+
+	if(!batch->vertices || batch->size < length)
+	{
+		if(batch->vertexArray) gfxDecRef((gfxObject*)batch->vertexArray);
+		if(batch->vertices) gfxDecRef((gfxObject*)batch->vertices);
+		if(batch->texCoords) gfxDecRef((gfxObject*)batch->texCoords);
+
+		batch->size = length < 16 ? 16 : length;
+
+		batch->vertices = gfxCreateVertexData(3*6*batch->size, GFX_FLOAT, GFX_VERTEX_DATA_DYNAMIC);
+		batch->texCoords = gfxCreateVertexData(2*6*batch->size, GFX_FLOAT, GFX_VERTEX_DATA_DYNAMIC);
+		batch->vertexArray = gfxCreateVertexArray(GFX_FALSE);
+		gfxSetVertexArrayData(batch->vertexArray, GFX_VERTEX, batch->vertices);
+		gfxSetVertexArrayData(batch->vertexArray, GFX_TEX_COORD, batch->texCoords);
+
+		gfxIncRef((gfxObject*)batch->vertices);
+		gfxIncRef((gfxObject*)batch->texCoords);
+		gfxIncRef((gfxObject*)batch->vertexArray);
+	}
+
+	vertexBuffer = (float*)gfxGetVertexDataBuffer(batch->vertices);
+	texCoordBuffer = (float*)gfxGetVertexDataBuffer(batch->texCoords);
+
+	batch->count = 0;
+
 	ox = x;
 	oy = y;
 
-	for(i = 0; i < strlen(str); i++)
+	for(i = 0; i < (unsigned int)length; i++)
 	{
 		if(str[i] < 0) continue;
 		chr = &font->chars[(unsigned int)str[i]];
@@ -221,14 +323,94 @@ void elfDrawString(elfFont* font, const char* str, int x, int y, gfxShaderParams
 		}
 		else
 		{
-			if(!chr->texture) continue;
-			shaderParams->textureParams[0].texture = chr->texture;
-			shaderParams->textureParams[0].type = GFX_COLOR_MAP;
-			gfxSetShaderParams(shaderParams);
-			elfDrawTextured2dQuad((float)ox, (float)(oy+chr->offsetY+font->offsetY),
-				(float)gfxGetTextureWidth(chr->texture), (float)gfxGetTextureHeight(chr->texture));
+			if(!chr->width) continue;
+
+			gx = (float)ox;
+			gy = (float)(oy+chr->offsetY+font->offsetY);
+			gw = (float)chr->width;
+			gh = (float)chr->height;
+
+			tx = (float)chr->x/(float)font->atlasWidth;
+			ty = (float)chr->y/(float)font->atlasHeight;
+			tw = (float)chr->width/(float)font->atlasWidth;
+			th = (float)chr->height/(float)font->atlasHeight;
+
+			vertexBuffer[0] = gx; vertexBuffer[1] = gy+gh; vertexBuffer[2] = 0.0f;
+			vertexBuffer[3] = gx; vertexBuffer[4] = gy; vertexBuffer[5] = 0.0f;
+			vertexBuffer[6] = gx+gw; vertexBuffer[7] = gy+gh; vertexBuffer[8] = 0.0f;
+			vertexBuffer[9] = gx+gw; vertexBuffer[10] = gy+gh; vertexBuffer[11] = 0.0f;
+			vertexBuffer[12] = gx; vertexBuffer[13] = gy; vertexBuffer[14] = 0.0f;
+			vertexBuffer[15] = gx+gw; vertexBuffer[16] = gy; vertexBuffer[17] = 0.0f;
+
+			texCoordBuffer[0] = tx; texCoordBuffer[1] = ty+th;
+			texCoordBuffer[2] = tx; texCoordBuffer[3] = ty;
+			texCoordBuffer[4] = tx+tw; texCoordBuffer[5] = ty+th;
+			texCoordBuffer[6] = tx+tw; texCoordBuffer[7] = ty+th;
+			texCoordBuffer[8] = tx; texCoordBuffer[9] = ty;
+			texCoordBuffer[10] = tx+tw; texCoordBuffer[11] = ty;
+
+			vertexBuffer += 18;
+			texCoordBuffer += 12;
+			batch->count++;
+
 			ox += chr->offsetX;
 		}
 	}
+
+	gfxUpdateVertexData(batch->vertices);
+	gfxUpdateVertexData(batch->texCoords);
+
+	if(batch->font != font)
+	{
+		if(batch->font) elfDecRef((elfObject*)batch->font);
+		batch->font = font;
+		elfIncRef((elfObject*)batch->font);
+	}
+
+	if(batch->text) elfDestroyString(batch->text);
+	batch->text = elfCreateString(str);
+
+	batch->x = x;
+	batch->y = y;
+}
+
+void elfDrawStringBatch(elfFont* font, const char* str, int x, int y, gfxShaderParams* shaderParams, elfTextBatch* batch)
+{
+	if(!font->atlas) return;
+
+	// the vertices are only rebuilt when the text, font or position changed since the last draw
+	if(batch->font != font || batch->x != x || batch->y != y || !batch->text || strcmp(batch->text, str))
+		elfBuildTextBatch(batch, font, str, x, y);
+
+	if(!batch->count) return;
+
+	shaderParams->textureParams[0].texture = font->atlas;
+	shaderParams->textureParams[0].type = GFX_COLOR_MAP;
+	gfxSetShaderParams(shaderParams);
+	gfxDrawVertexArray(batch->vertexArray, 6*batch->count, GFX_TRIANGLES);
+}
+
+void elfDrawString(elfFont* font, const char* str, int x, int y, gfxShaderParams* shaderParams)
+{
+	elfTextBatch* batch;
+	int i;
+
+	// strings without a batch of their own share the render station's, looked up by font, text and
+	// position, a string that isn't there takes over the batch that went unused the longest
+	batch = &rnd->textBatches[0];
+	for(i = 0; i < ELF_MAX_TEXT_BATCHES; i++)
+	{
+		if(rnd->textBatches[i].font == font && rnd->textBatches[i].x == x && rnd->textBatches[i].y == y &&
+			rnd->textBatches[i].text && !strcmp(rnd->textBatches[i].text, str))
+		{
+			batch = &rnd->textBatches[i];
+			break;
+		}
+		if(rnd->textBatches[i].lastUse < batch->lastUse) batch = &rnd->textBatches[i];
+	}
+
+	batch->lastUse = ++rnd->textBatchUses;
+
+	elfDrawStringBatch(font, str, x, y, shaderParams, batch);
 }
 
@@ -117,6 +117,8 @@ void elfDestroyLabel(void* data)
 
 	if(label->font) elfDecRef((elfObject*)label->font);
 
+	elfDestroyTextBatch(&label->textBatch);
+
 	free(label);
 
 	elfDecObj(ELF_LABEL);
@@ -127,7 +129,7 @@ void elfDrawLabel(elfLabel* label, gfxShaderParams* shaderParams)
 	if(!label->visible || !label->font || !label->text) return;
 
 	gfxSetColor(&shaderParams->materialParams.diffuseColor, label->color.r, label->color.g, label->color.b, label->color.a);
-	elfDrawString(label->font, label->text, label->pos.x, label->pos.y, shaderParams);
+	elfDrawStringBatch(label->font, label->text, label->pos.x, label->pos.y, shaderParams, &label->textBatch);
 	shaderParams->textureParams[0].texture = NULL;
 }
 
@@ -214,6 +216,8 @@ void elfDestroyButton(void* data)
 
 	if(button->script) elfDecRef((elfObject*)button->script);
 
+	elfDestroyTextBatch(&button->textBatch);
+
 	free(button);
 
 	elfDecObj(ELF_BUTTON);
@@ -252,8 +256,8 @@ void elfDrawButton(elfButton* button, gfxShaderParams* shaderParams)
 		else gfxSetColor(&shaderParams->materialParams.diffuseColor, 0.5f, 0.5f, 0.5f, 0.6f);
 		gfxSetShaderParams(shaderParams);
 
-		elfDrawString(button->font, button->text, button->pos.x+(button->width-elfGetStringWidth(button->font, button->text))/2,
-			button->pos.y+(button->height-elfGetStringHeight(button->font, button->text))/2-button->font->offsetY/2, shaderParams);
+		elfDrawStringBatch(button->font, button->text, button->pos.x+(button->width-elfGetStringWidth(button->font, button->text))/2,
+			button->pos.y+(button->height-elfGetStringHeight(button->font, button->text))/2-button->font->offsetY/2, shaderParams, &button->textBatch);
 
 		shaderParams->textureParams[0].texture = NULL;
 	}
@@ -506,6 +510,8 @@ void elfDestroyTextField(void* data)
 	if(textField->text) elfDestroyString(textField->text);
 	if(textField->script) elfDecRef((elfObject*)textField->script);
 
+	elfDestroyTextBatch(&textField->textBatch);
+
 	free(textField);
 
 	elfDecObj(ELF_TEXT_FIELD);
@@ -579,7 +585,8 @@ void elfDrawTextField(elfTextField* textField, elfArea* area, gfxShaderParams* s
 
 		str = elfSubString(textField->text, textField->drawPos,
 			strlen(textField->text)-textField->drawPos);
-		elfDrawString(textField->font, str, textField->pos.x+textField->offsetX, textField->pos.y+textField->offsetY-textField->font->offsetY/2, shaderParams);
+		elfDrawStringBatch(textField->font, str, textField->pos.x+textField->offsetX, textField->pos.y+textField->offsetY-textField->font->offsetY/2,
+			shaderParams, &textField->textBatch);
 		elfDestroyString(str);
 
 		shaderParams->textureParams[0].texture = NULL;
@@ -210,3 +210,415 @@ unsigned char elfSaveImageData(const char* filePath, int width, int height, unsi
 	return ELF_TRUE;
 }
 
+unsigned short elfPackColor565(const int* color)
+{
+	return (unsigned short)(((color[0]*31+127)/255)<<11 | ((color[1]*63+127)/255)<<5 | ((color[2]*31+127)/255));
+}
+
+void elfUnpackColor565(unsigned short packed, int* color)
+{
+	color[0] = ((packed>>11)&31)*255/31;
+	color[1] = ((packed>>5)&63)*255/63;
+	color[2] = (packed&31)*255/31;
+}
+
+void elfEncodeDxtColorBlock(const unsigned char* rgba, unsigned char* out)
+{
+	int min[3];
+	int max[3];
+	int inset;
+	int axis;
+	int covariance;
+	int palette[4][3];
+	unsigned short c0, c1;
+	unsigned int indices;
+	int best, bestDist, dist, d;
+	int i, j, k;
+
+	// bounding box endpoints pulled in by a sixteenth
+	for(j = 0; j < 3; j++)
+	{
+		min[j] = 255;
+		max[j] = 0;
+	}
+
+	for(i = 0; i < 16; i++)
+	{
+		for(j = 0; j < 3; j++)
+		{
+			if(rgba[i*4+j] < min[j]) min[j] = rgba[i*4+j];
+			if(rgba[i*4+j] > max[j]) max[j] = rgba[i*4+j];
+		}
+	}
+
+	// pick the box diagonal that follows the colors, flipping the channels that fall
+	// while the widest one rises
+	axis = 0;
+	for(j = 1; j < 3; j++) if(max[j]-min[j] > max[axis]-min[axis]) axis = j;
+
+	for(j = 0; j < 3; j++)
+	{
+		if(j == axis) continue;
+
+		covariance = 0;
+		for(i = 0; i < 16; i++)
+			covariance += (rgba[i*4+axis]*2-min[axis]-max[axis])*(rgba[i*4+j]*2-min[j]-max[j]);
+
+		if(covariance < 0)
+		{
+			d = min[j];
+			min[j] = max[j];
+			max[j] = d;
+		}
+	}
+
+	for(j = 0; j < 3; j++)
+	{
+		inset = (max[j]-min[j])/16;
+		min[j] += inset;
+		max[j] -= inset;
+	}
+
+	c0 = elfPackColor565(max);
+	c1 = elfPackColor565(min);
+
+	if(c0 == c1)
+	{
+		out[0] = c0&0xFF; out[1] = c0>>8;
+		out[2] = c1&0xFF; out[3] = c1>>8;
+		out[4] = out[5] = out[6] = out[7] = 0;
+		return;
+	}
+
+	// c0 > c1 selects the four color mode
+	if(c0 < c1)
+	{
+		best = c0; c0 = c1; c1 = (unsigned short)best;
+	}
+
+	elfUnpackColor565(c0, palette[0]);
+	elfUnpackColor565(c1, palette[1]);
+	for(j = 0; j < 3; j++)
+	{
+		palette[2][j] = (2*palette[0][j]+palette[1][j])/3;
+		palette[3][j] = (palette[0][j]+2*palette[1][j])/3;
+	}
+
+	indices = 0;
+	for(i = 0; i < 16; i++)
+	{
+		best = 0;
+		bestDist = 0x7FFFFFFF;
+		for(k = 0; k < 4; k++)
+		{
+			dist = 0;
+			for(j = 0; j < 3; j++)
+			{
+				d = rgba[i*4+j]-palette[k][j];
+				dist += d*d;
+			}
+			if(dist < bestDist)
+			{
+				bestDist = dist;
+				best = k;
+			}
+		}
+		indices |= (unsigned int)best<<(i*2);
+	}
+
+	out[0] = c0&0xFF; out[1] = c0>>8;
+	out[2] = c1&0xFF; out[3] = c1>>8;
+	out[4] = indices&0xFF; out[5] = (indices>>8)&0xFF;
+	out[6] = (indices>>16)&0xFF; out[7] = (indices>>24)&0xFF;
+}
+
+void elfEncodeDxtAlphaBlock(const unsigned char* rgba, unsigned char* out)
+{
+	int a0, a1;
+	int palette[8];
+	int best, bestDist, dist;
+	int bits;
+	int i, k;
+
+	a0 = 0;
+	a1 = 255;
+	for(i = 0; i < 16; i++)
+	{
+		if(rgba[i*4+3] > a0) a0 = rgba[i*4+3];
+		if(rgba[i*4+3] < a1) a1 = rgba[i*4+3];
+	}
+
+	out[0] = (unsigned char)a0;
+	out[1] = (unsigned char)a1;
+	for(i = 2; i < 8; i++) out[i] = 0;
+
+	if(a0 == a1) return;
+
+	// a0 > a1 selects the eight value mode
+	palette[0] = a0;
+	palette[1] = a1;
+	for(k = 1; k < 7; k++) palette[k+1] = ((7-k)*a0+k*a1)/7;
+
+	for(i = 0; i < 16; i++)
+	{
+		best = 0;
+		bestDist = 256;
+		for(k = 0; k < 8; k++)
+		{
+			dist = abs(rgba[i*4+3]-palette[k]);
+			if(dist < bestDist)
+			{
+				bestDist = dist;
+				best = k;
+			}
+		}
+
+		bits = i*3;
+		out[2+bits/8] |= (unsigned char)(best<<(bits%8));
+		if(bits%8 > 5) out[2+bits/8+1] |= (unsigned char)(best>>(8-bits%8));
+	}
+}
+
+int elfGetDxtLevelSizeBytes(int width, int height, unsigned char alpha)
+{
+	return ((width+3)/4)*((height+3)/4)*(alpha ? 16 : 8);
+}
+
+void elfEncodeDxtLevel(const unsigned char* data, int width, int height, int bpp, unsigned char alpha, unsigned char* out)
+{
+	unsigned char block[64];
+	const unsigned char* pixel;
+	int x, y, bx, by, px, py;
+
+	for(by = 0; by < height; by += 4)
+	{
+		for(bx = 0; bx < width; bx += 4)
+		{
+			// gather the block as rgba, edge blocks repeat the last row and column
+			for(y = 0; y < 4; y++)
+			{
+				for(x = 0; x < 4; x++)
+				{
+					px = bx+x < width ? bx+x : width-1;
+					py = by+y < height ? by+y : height-1;
+					pixel = &data[(py*width+px)*(bpp/8)];
+
+					block[(y*4+x)*4] = pixel[2];
+					block[(y*4+x)*4+1] = pixel[1];
+					block[(y*4+x)*4+2] = pixel[0];
+					block[(y*4+x)*4+3] = bpp == 32 ? pixel[3] : 255;
+				}
+			}
+
+			if(alpha)
+			{
+				elfEncodeDxtAlphaBlock(block, out);
+				out += 8;
+			}
+
+			elfEncodeDxtColorBlock(block, out);
+			out += 8;
+		}
+	}
+}
+
+unsigned char* elfDownsampleImageData(const unsigned char* data, int width, int height, int bpp)
+{
+	unsigned char* out;
+	int nwidth, nheight;
+	int bytes;
+	int x, y, c, x1, y1;
+
+	bytes = bpp/8;
+	nwidth = width > 1 ? width/2 : 1;
+	nheight = height > 1 ? height/2 : 1;
+
+	out = (unsigned char*)malloc(sizeof(unsigned char)*nwidth*nheight*bytes);
+
+	for(y = 0; y < nheight; y++)
+	{
+		y1 = y*2+1 < height ? y*2+1 : y*2;
+		for(x = 0; x < nwidth; x++)
+		{
+			x1 = x*2+1 < width ? x*2+1 : x*2;
+			for(c = 0; c < bytes; c++)
+			{
+				out[(y*nwidth+x)*bytes+c] = (unsigned char)((data[(y*2*width+x*2)*bytes+c]+data[(y*2*width+x1)*bytes+c]+
+					data[(y1*width+x*2)*bytes+c]+data[(y1*width+x1)*bytes+c]+2)/4);
+			}
+		}
+	}
+
+	return out;
+}
+
+unsigned char* elfCompressImageData(const unsigned char* data, int width, int height, int bpp, int* sizeBytes)
+{
+	unsigned char* out;
+	unsigned char* level;
+	unsigned char* next;
+	unsigned char alpha;
+	int levelCount;
+	int levelSize;
+	int offset;
+	int w, h;
+	int ival;
+
+	if(bpp != 24 && bpp != 32) return NULL;
+
+	alpha = bpp == 32;
+
+	// payload: alpha flag, width, height, level count, then the size and blocks of every level down to 1x1
+	levelCount = 1;
+	*sizeBytes = sizeof(int)*4;
+	for(w = width, h = height; ; levelCount++)
+	{
+		*sizeBytes += sizeof(int)+elfGetDxtLevelSizeBytes(w, h, alpha);
+		if(w == 1 && h == 1) break;
+		w = w > 1 ? w/2 : 1;
+		h = h > 1 ? h/2 : 1;
+	}
+
+	out = (unsigned char*)malloc(*sizeBytes);
+
+	ival = alpha; memcpy(&out[0], &ival, sizeof(int));
+	memcpy(&out[sizeof(int)], &width, sizeof(int));
+	memcpy(&out[sizeof(int)*2], &height, sizeof(int));
+	memcpy(&out[sizeof(int)*3], &levelCount, sizeof(int));
+	offset = sizeof(int)*4;
+
+	level = (unsigned char*)data;
+	for(w = width, h = height; ; )
+	{
+		levelSize = elfGetDxtLevelSizeBytes(w, h, alpha);
+		memcpy(&out[offset], &levelSize, sizeof(int));
+		offset += sizeof(int);
+
+		elfEncodeDxtLevel(level, w, h, bpp, alpha, &out[offset]);
+		offset += levelSize;
+
+		if(w == 1 && h == 1) break;
+
+		next = elfDownsampleImageData(level, w, h, bpp);
+		if(level != data) free(level);
+		level = next;
+
+		w = w > 1 ? w/2 : 1;
+		h = h > 1 ? h/2 : 1;
+	}
+
+	if(level != data) free(level);
+
+	return out;
+}
+
+
+void elfDecodeDxtColorBlock(const unsigned char* in, unsigned char alpha, unsigned char* rgba)
+{
+	int palette[4][3];
+	unsigned short c0, c1;
+	unsigned int indices;
+	int i, j, k;
+
+	c0 = (unsigned short)(in[0] | in[1]<<8);
+	c1 = (unsigned short)(in[2] | in[3]<<8);
+	indices = (unsigned int)in[4] | (unsigned int)in[5]<<8 | (unsigned int)in[6]<<16 | (unsigned int)in[7]<<24;
+
+	elfUnpackColor565(c0, palette[0]);
+	elfUnpackColor565(c1, palette[1]);
+
+	// the same thirds the encoder picked its indices against, c0 <= c1 is the three color
+	// mode but only in dxt1, the color blocks of dxt5 always have four
+	for(j = 0; j < 3; j++)
+	{
+		if(c0 > c1 || alpha)
+		{
+			palette[2][j] = (2*palette[0][j]+palette[1][j])/3;
+			palette[3][j] = (palette[0][j]+2*palette[1][j])/3;
+		}
+		else
+		{
+			palette[2][j] = (palette[0][j]+palette[1][j])/2;
+			palette[3][j] = 0;
+		}
+	}
+
+	for(i = 0; i < 16; i++)
+	{
+		k = (indices>>(i*2))&3;
+		for(j = 0; j < 3; j++) rgba[i*4+j] = (unsigned char)palette[k][j];
+		rgba[i*4+3] = 255;
+	}
+}
+
+void elfDecodeDxtAlphaBlock(const unsigned char* in, unsigned char* rgba)
+{
+	int palette[8];
+	int bits;
+	int index;
+	int i, k;
+
+	palette[0] = in[0];
+	palette[1] = in[1];
+
+	// a0 > a1 is the eight value mode, otherwise six values plus fully transparent and opaque
+	if(palette[0] > palette[1])
+	{
+		for(k = 1; k < 7; k++) palette[k+1] = ((7-k)*palette[0]+k*palette[1])/7;
+	}
+	else
+	{
+		for(k = 1; k < 5; k++) palette[k+1] = ((5-k)*palette[0]+k*palette[1])/5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	for(i = 0; i < 16; i++)
+	{
+		bits = i*3;
+		index = in[2+bits/8]>>(bits%8);
+		if(bits%8 > 5) index |= in[2+bits/8+1]<<(8-bits%8);
+		rgba[i*4+3] = (unsigned char)palette[index&7];
+	}
+}
+
+void elfDecodeDxtLevel(const unsigned char* in, int width, int height, unsigned char alpha, unsigned char* out)
+{
+	unsigned char block[64];
+	unsigned char* pixel;
+	int bytes;
+	int x, y, bx, by;
+
+	bytes = alpha ? 4 : 3;
+
+	for(by = 0; by < height; by += 4)
+	{
+		for(bx = 0; bx < width; bx += 4)
+		{
+			if(alpha)
+			{
+				elfDecodeDxtColorBlock(in+8, ELF_TRUE, block);
+				elfDecodeDxtAlphaBlock(in, block);
+				in += 16;
+			}
+			else
+			{
+				elfDecodeDxtColorBlock(in, ELF_FALSE, block);
+				in += 8;
+			}
+
+			// back to bgr or bgra, edge blocks drop what lies past the image
+			for(y = 0; y < 4 && by+y < height; y++)
+			{
+				for(x = 0; x < 4 && bx+x < width; x++)
+				{
+					pixel = &out[((by+y)*width+bx+x)*bytes];
+					pixel[0] = block[(y*4+x)*4+2];
+					pixel[1] = block[(y*4+x)*4+1];
+					pixel[2] = block[(y*4+x)*4];
+					if(alpha) pixel[3] = block[(y*4+x)*4+3];
+				}
+			}
+		}
+	}
+}
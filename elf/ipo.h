@@ -26,6 +26,9 @@ ELF_API void ELF_APIENTRY elfSetBezierPointPosition(elfBezierPoint* point, float
 {
 	point->p.x = x;
 	point->p.y = y;
+
+	// the curve sorts and bakes its keys again the next time it is sampled
+	if(point->curve) point->curve->dirty = ELF_TRUE;
 }
 
 ELF_API void ELF_APIENTRY elfSetBezierPointControl1(elfBezierPoint* point, float x, float y)
@@ -78,6 +81,8 @@ void elfDestroyBezierCurve(void* data)
 
 	elfDecRef((elfObject*)curve->points);
 
+	if(curve->keys) free(curve->keys);
+
 	free(curve);
 
 	elfDecObj(ELF_BEZIER_CURVE);
@@ -96,22 +101,46 @@ ELF_API int ELF_APIENTRY elfGetBezierCurveType(elfBezierCurve* curve)
 	return curve->curveType;
 }
 
+void elfInsertBezierCurveKey(elfBezierCurve* curve, int idx, elfVec2f key)
+{
+	if(curve->keyCount == curve->keySize)
+	{
+		curve->keySize = curve->keySize ? curve->keySize*2 : 16;
+		curve->keys = (elfVec2f*)realloc(curve->keys, sizeof(elfVec2f)*curve->keySize);
+	}
+
+	memmove(&curve->keys[idx+1], &curve->keys[idx], sizeof(elfVec2f)*(curve->keyCount-idx));
+	curve->keys[idx] = key;
+	curve->keyCount++;
+}
+
 ELF_API void ELF_APIENTRY elfAddBezierCurvePoint(elfBezierCurve* curve, elfBezierPoint* point)
 {
 	int i;
 	elfBezierPoint* pnt;
 
+	point->curve = curve;
+
+	// the positions are baked into a flat key array here, points moved later mark the curve for a rebake
+	if(curve->dirty)
+	{
+		elfAppendListObject(curve->points, (elfObject*)point);
+		return;
+	}
+
 	for(i = 0, pnt = (elfBezierPoint*)elfBeginList(curve->points); pnt;
 		pnt = (elfBezierPoint*)elfGetListNext(curve->points), i++)
 	{
 		if(pnt->p.x > point->p.x)
 		{
 			elfInsertListObject(curve->points, i, (elfObject*)point);
+			elfInsertBezierCurveKey(curve, i, point->p);
 			return;
 		}
 	}
 
 	elfAppendListObject(curve->points, (elfObject*)point);
+	elfInsertBezierCurveKey(curve, curve->keyCount, point->p);
 }
 
 int elfGetCurvePointCount(elfBezierCurve* curve)
@@ -124,29 +153,85 @@ ELF_API elfBezierPoint* ELF_APIENTRY elfGetPointFromBezierCurve(elfBezierCurve*
 	return (elfBezierPoint*)elfGetListObject(curve->points, idx);
 }
 
-ELF_API float ELF_APIENTRY elfGetBezierCurveValue(elfBezierCurve* curve, float x)
+void elfBakeBezierCurve(elfBezierCurve* curve)
 {
-	elfBezierPoint* pnt;
-	elfBezierPoint* point1 = NULL;
-	elfBezierPoint* point2 = NULL;
-	float t;
+	elfListPtr* ptr;
+	elfListPtr* prev;
+	elfObject* obj;
+	int i;
 
-	for(pnt = (elfBezierPoint*)elfBeginList(curve->points); pnt;
-		pnt = (elfBezierPoint*)elfGetListNext(curve->points))
+	// insertion sort on the list itself, a moved point usually only shifts a few places
+	for(ptr = curve->points->first; ptr; ptr = ptr->next)
 	{
-		if(pnt->p.x > x)
+		obj = ptr->obj;
+		for(prev = ptr; prev->prev && ((elfBezierPoint*)prev->prev->obj)->p.x > ((elfBezierPoint*)obj)->p.x; prev = prev->prev)
 		{
-			point2 = pnt;
-			break;
+			prev->obj = prev->prev->obj;
 		}
-		point1 = pnt;
+		prev->obj = obj;
 	}
 
-	if(!point1 && !point2) return 0.0f;
-	if(!point2) return point1->p.y;
+	curve->keyCount = 0;
+	curve->cursor = 0;
 
-	t = (x-point1->p.x)/(point2->p.x-point1->p.x);
-	return point1->p.y+(point2->p.y-point1->p.y)*t;
+	for(i = 0, ptr = curve->points->first; ptr; ptr = ptr->next, i++)
+	{
+		elfInsertBezierCurveKey(curve, i, ((elfBezierPoint*)ptr->obj)->p);
+	}
+
+	curve->dirty = ELF_FALSE;
+}
+
+int elfFindBezierCurveKey(elfBezierCurve* curve, float x)
+{
+	elfVec2f* keys = curve->keys;
+	int i;
+	int lo;
+	int hi;
+	int mid;
+
+	// the caller guarantees keys[0].x <= x < keys[keyCount-1].x, so there always is a bracketing segment
+	i = curve->cursor;
+	if(i > curve->keyCount-2) i = 0;
+
+	if(keys[i].x <= x && keys[i+1].x > x) return i;
+
+	// playback mostly moves forward a segment at a time
+	if(i+2 < curve->keyCount && keys[i+1].x <= x && keys[i+2].x > x)
+	{
+		curve->cursor = i+1;
+		return i+1;
+	}
+
+	lo = 0;
+	hi = curve->keyCount-1;
+	while(hi-lo > 1)
+	{
+		mid = (lo+hi)/2;
+		if(keys[mid].x <= x) lo = mid;
+		else hi = mid;
+	}
+
+	curve->cursor = lo;
+
+	return lo;
+}
+
+ELF_API float ELF_APIENTRY elfGetBezierCurveValue(elfBezierCurve* curve, float x)
+{
+	elfVec2f* key;
+	float t;
+
+	if(curve->dirty) elfBakeBezierCurve(curve);
+
+	if(!curve->keyCount) return 0.0f;
+	if(x < curve->keys[0].x) return curve->keys[0].y;
+	if(x >= curve->keys[curve->keyCount-1].x) return curve->keys[curve->keyCount-1].y;
+
+	key = &curve->keys[elfFindBezierCurveKey(curve, x)];
+
+	t = (x-key[0].x)/(key[1].x-key[0].x);
+	return key[0].y+(key[1].y-key[0].y)*t;
 }
 
 ELF_API elfIpo* ELF_APIENTRY elfCreateIpo()
@@ -181,6 +266,8 @@ ELF_API unsigned char ELF_APIENTRY elfAddIpoCurve(elfIpo* ipo, elfBezierCurve* c
 {
 	elfBezierCurve* cur;
 
+	if(curve->curveType > ELF_QUA_W) return ELF_FALSE;
+
 	for(cur = (elfBezierCurve*)elfBeginList(ipo->curves); cur;
 		cur = (elfBezierCurve*)elfGetListNext(ipo->curves))
 	{
@@ -189,10 +276,12 @@ ELF_API unsigned char ELF_APIENTRY elfAddIpoCurve(elfIpo* ipo, elfBezierCurve* c
 
 	elfAppendListObject(ipo->curves, (elfObject*)curve);
 
+	ipo->channels[curve->curveType] = curve;
+
 	if(curve->curveType <= ELF_LOC_Z) ipo->loc = ELF_TRUE;
-	if(curve->curveType <= ELF_ROT_Z) ipo->rot = ELF_TRUE;
-	if(curve->curveType <= ELF_SCALE_Z) ipo->scale = ELF_TRUE;
-	if(curve->curveType <= ELF_QUA_W) ipo->qua = ELF_TRUE;
+	else if(curve->curveType <= ELF_ROT_Z) ipo->rot = ELF_TRUE;
+	else if(curve->curveType <= ELF_SCALE_Z) ipo->scale = ELF_TRUE;
+	else if(curve->curveType <= ELF_QUA_W) ipo->qua = ELF_TRUE;
 
 	return ELF_TRUE;
 }
@@ -207,75 +296,66 @@ ELF_API elfBezierCurve* ELF_APIENTRY elfGetCurveFromIpo(elfIpo* ipo, int idx)
 	return (elfBezierCurve*)elfGetListObject(ipo->curves, idx);
 }
 
+void elfGetIpoValues(elfIpo* ipo, float x, float* values)
+{
+	int i;
+
+	// samples every channel in one go, channels without a curve read as zero
+	for(i = 0; i <= ELF_QUA_W; i++)
+	{
+		values[i] = ipo->channels[i] ? elfGetBezierCurveValue(ipo->channels[i], x) : 0.0f;
+	}
+}
+
 ELF_API elfVec3f ELF_APIENTRY elfGetIpoLoc(elfIpo* ipo, float x)
 {
-	elfBezierCurve* curve;
 	elfVec3f result;
 
 	memset(&result, 0x0, sizeof(elfVec3f));
 
-	for(curve = (elfBezierCurve*)elfBeginList(ipo->curves); curve;
-		curve = (elfBezierCurve*)elfGetListNext(ipo->curves))
-	{
-		if(curve->curveType == ELF_LOC_X) result.x = elfGetBezierCurveValue(curve, x);
-		else if(curve->curveType == ELF_LOC_Y) result.y = elfGetBezierCurveValue(curve, x);
-		else if(curve->curveType == ELF_LOC_Z) result.z = elfGetBezierCurveValue(curve, x);
-	}
+	if(ipo->channels[ELF_LOC_X]) result.x = elfGetBezierCurveValue(ipo->channels[ELF_LOC_X], x);
+	if(ipo->channels[ELF_LOC_Y]) result.y = elfGetBezierCurveValue(ipo->channels[ELF_LOC_Y], x);
+	if(ipo->channels[ELF_LOC_Z]) result.z = elfGetBezierCurveValue(ipo->channels[ELF_LOC_Z], x);
 
 	return result;
 }
 
 ELF_API elfVec3f ELF_APIENTRY elfGetIpoRot(elfIpo* ipo, float x)
 {
-	elfBezierCurve* curve;
 	elfVec3f result;
 
 	memset(&result, 0x0, sizeof(elfVec3f));
 
-	for(curve = (elfBezierCurve*)elfBeginList(ipo->curves); curve;
-		curve = (elfBezierCurve*)elfGetListNext(ipo->curves))
-	{
-		if(curve->curveType == ELF_ROT_X) result.x = elfGetBezierCurveValue(curve, x);
-		else if(curve->curveType == ELF_ROT_Y) result.y = elfGetBezierCurveValue(curve, x);
-		else if(curve->curveType == ELF_ROT_Z) result.z = elfGetBezierCurveValue(curve, x);
-	}
+	if(ipo->channels[ELF_ROT_X]) result.x = elfGetBezierCurveValue(ipo->channels[ELF_ROT_X], x);
+	if(ipo->channels[ELF_ROT_Y]) result.y = elfGetBezierCurveValue(ipo->channels[ELF_ROT_Y], x);
+	if(ipo->channels[ELF_ROT_Z]) result.z = elfGetBezierCurveValue(ipo->channels[ELF_ROT_Z], x);
 
 	return result;
 }
 
 ELF_API elfVec3f ELF_APIENTRY elfGetIpoScale(elfIpo* ipo, float x)
 {
-	elfBezierCurve* curve;
 	elfVec3f result;
 
 	memset(&result, 0x0, sizeof(elfVec3f));
 
-	for(curve = (elfBezierCurve*)elfBeginList(ipo->curves); curve;
-		curve = (elfBezierCurve*)elfGetListNext(ipo->curves))
-	{
-		if(curve->curveType == ELF_SCALE_X) result.x = elfGetBezierCurveValue(curve, x);
-		else if(curve->curveType == ELF_SCALE_Y) result.y = elfGetBezierCurveValue(curve, x);
-		else if(curve->curveType == ELF_SCALE_Z) result.z = elfGetBezierCurveValue(curve, x);
-	}
+	if(ipo->channels[ELF_SCALE_X]) result.x = elfGetBezierCurveValue(ipo->channels[ELF_SCALE_X], x);
+	if(ipo->channels[ELF_SCALE_Y]) result.y = elfGetBezierCurveValue(ipo->channels[ELF_SCALE_Y], x);
+	if(ipo->channels[ELF_SCALE_Z]) result.z = elfGetBezierCurveValue(ipo->channels[ELF_SCALE_Z], x);
 
 	return result;
 }
 
 ELF_API elfVec4f ELF_APIENTRY elfGetIpoQua(elfIpo* ipo, float x)
 {
-	elfBezierCurve* curve;
 	elfVec4f result;
 
 	memset(&result, 0x0, sizeof(elfVec4f));
 
-	for(curve = (elfBezierCurve*)elfBeginList(ipo->curves); curve;
-		curve = (elfBezierCurve*)elfGetListNext(ipo->curves))
-	{
-		if(curve->curveType == ELF_QUA_X) result.x = elfGetBezierCurveValue(curve, x);
-		else if(curve->curveType == ELF_QUA_Y) result.y = elfGetBezierCurveValue(curve, x);
-		else if(curve->curveType == ELF_QUA_Z) result.z = elfGetBezierCurveValue(curve, x);
-		else if(curve->curveType == ELF_QUA_W) result.w = elfGetBezierCurveValue(curve, x);
-	}
+	if(ipo->channels[ELF_QUA_X]) result.x = elfGetBezierCurveValue(ipo->channels[ELF_QUA_X], x);
+	if(ipo->channels[ELF_QUA_Y]) result.y = elfGetBezierCurveValue(ipo->channels[ELF_QUA_Y], x);
+	if(ipo->channels[ELF_QUA_Z]) result.z = elfGetBezierCurveValue(ipo->channels[ELF_QUA_Z], x);
+	if(ipo->channels[ELF_QUA_W]) result.w = elfGetBezierCurveValue(ipo->channels[ELF_QUA_W], x);
 
 	return result;
 }
@@ -0,0 +1,154 @@
+void GLFWCALL elfJobWorker(void* arg)
+{
+	elfJobQueue* queue = (elfJobQueue*)arg;
+	elfJob job;
+
+	glfwLockMutex(queue->mutex);
+
+	while(1)
+	{
+		while(!queue->quit && queue->next >= queue->jobCount)
+			glfwWaitCond(queue->workCond, queue->mutex, GLFW_INFINITY);
+
+		if(queue->quit) break;
+
+		job = queue->jobs[queue->next++];
+
+		glfwUnlockMutex(queue->mutex);
+		job.func(job.data);
+		glfwLockMutex(queue->mutex);
+
+		queue->pending--;
+		if(!queue->pending) glfwSignalCond(queue->doneCond);
+	}
+
+	glfwUnlockMutex(queue->mutex);
+}
+
+elfJobQueue* elfCreateJobQueue(int threadCount)
+{
+	elfJobQueue* queue;
+	int i;
+
+	queue = (elfJobQueue*)malloc(sizeof(elfJobQueue));
+	memset(queue, 0x0, sizeof(elfJobQueue));
+	queue->objType = ELF_JOB_QUEUE;
+	queue->objDestr = elfDestroyJobQueue;
+
+	queue->jobSize = 64;
+	queue->jobs = (elfJob*)malloc(sizeof(elfJob)*queue->jobSize);
+
+	// the calling thread works through the queue as well while it waits,
+	// so only threadCount-1 workers are started
+	if(threadCount > ELF_MAX_JOB_THREADS) threadCount = ELF_MAX_JOB_THREADS;
+
+	if(threadCount > 1)
+	{
+		queue->mutex = glfwCreateMutex();
+		queue->workCond = glfwCreateCond();
+		queue->doneCond = glfwCreateCond();
+
+		queue->threads = (int*)malloc(sizeof(int)*(threadCount-1));
+
+		for(i = 0; i < threadCount-1; i++)
+		{
+			queue->threads[queue->threadCount] = glfwCreateThread(elfJobWorker, queue);
+			if(queue->threads[queue->threadCount] < 0)
+			{
+				elfLogWrite("warning: could only start %d of %d worker threads\n", queue->threadCount, threadCount-1);
+				break;
+			}
+			queue->threadCount++;
+		}
+	}
+
+	elfIncObj(ELF_JOB_QUEUE);
+
+	return queue;
+}
+
+void elfDestroyJobQueue(void* data)
+{
+	elfJobQueue* queue = (elfJobQueue*)data;
+	int i;
+
+	if(queue->mutex)
+	{
+		glfwLockMutex(queue->mutex);
+		queue->quit = ELF_TRUE;
+		glfwBroadcastCond(queue->workCond);
+		glfwUnlockMutex(queue->mutex);
+
+		for(i = 0; i < queue->threadCount; i++) glfwWaitThread(queue->threads[i], GLFW_WAIT);
+
+		glfwDestroyCond(queue->workCond);
+		glfwDestroyCond(queue->doneCond);
+		glfwDestroyMutex(queue->mutex);
+	}
+
+	if(queue->threads) free(queue->threads);
+	free(queue->jobs);
+
+	free(queue);
+
+	elfDecObj(ELF_JOB_QUEUE);
+}
+
+int elfGetJobQueueThreadCount(elfJobQueue* queue)
+{
+	return queue->threadCount+1;
+}
+
+void elfAddJob(elfJobQueue* queue, void (*func)(void*), void* data)
+{
+	if(!queue || !queue->threadCount)
+	{
+		func(data);
+		return;
+	}
+
+	glfwLockMutex(queue->mutex);
+
+	if(queue->jobCount == queue->jobSize)
+	{
+		queue->jobSize *= 2;
+		queue->jobs = (elfJob*)realloc(queue->jobs, sizeof(elfJob)*queue->jobSize);
+	}
+
+	queue->jobs[queue->jobCount].func = func;
+	queue->jobs[queue->jobCount].data = data;
+	queue->jobCount++;
+	queue->pending++;
+
+	glfwSignalCond(queue->workCond);
+	glfwUnlockMutex(queue->mutex);
+}
+
+void elfWaitJobs(elfJobQueue* queue)
+{
+	elfJob job;
+
+	if(!queue || !queue->threadCount) return;
+
+	glfwLockMutex(queue->mutex);
+
+	// help out with whatever has not been picked up yet
+	while(queue->next < queue->jobCount)
+	{
+		job = queue->jobs[queue->next++];
+
+		glfwUnlockMutex(queue->mutex);
+		job.func(job.data);
+		glfwLockMutex(queue->mutex);
+
+		queue->pending--;
+	}
+
+	while(queue->pending > 0) glfwWaitCond(queue->doneCond, queue->mutex, GLFW_INFINITY);
+
+	queue->jobCount = 0;
+	queue->next = 0;
+
+	glfwUnlockMutex(queue->mutex);
+}
+
@@ -156,6 +156,19 @@ ELF_API elfObject* ELF_APIENTRY elfGetListObject(elfList* list, int idx)
 	return NULL;
 }
 
+unsigned char elfIsListObject(elfList* list, elfObject* obj)
+{
+	elfListPtr* ptr;
+
+	// walks the pointers itself, so it can be called in the middle of a pass over the list
+	for(ptr = list->first; ptr; ptr = ptr->next)
+	{
+		if(ptr->obj == obj) return ELF_TRUE;
+	}
+
+	return ELF_FALSE;
+}
+
 ELF_API unsigned char ELF_APIENTRY elfRemoveListObject(elfList* list, elfObject* obj)
 {
 	elfListPtr* ptr;
@@ -0,0 +1,277 @@
+elfSceneLoader* elfCreateSceneLoader()
+{
+	elfSceneLoader* loader;
+
+	loader = (elfSceneLoader*)malloc(sizeof(elfSceneLoader));
+	memset(loader, 0x0, sizeof(elfSceneLoader));
+	loader->objType = ELF_SCENE_LOADER;
+	loader->objDestr = elfDestroySceneLoader;
+
+	loader->mutex = glfwCreateMutex();
+
+	elfIncObj(ELF_SCENE_LOADER);
+
+	return loader;
+}
+
+void elfDestroySceneLoader(void* data)
+{
+	elfSceneLoader* loader = (elfSceneLoader*)data;
+	int i;
+
+	// stops the workers, a decode that is still running finishes before this returns
+	if(loader->jobs) elfDecRef((elfObject*)loader->jobs);
+
+	if(loader->decodes)
+	{
+		for(i = 0; i < loader->decodeCount; i++)
+		{
+			if(loader->decodes[i].data) free(loader->decodes[i].data);
+			if(loader->decodes[i].blocks && !loader->pak->data) free(loader->decodes[i].blocks);
+		}
+		free(loader->decodes);
+	}
+
+	if(loader->filePath) elfDestroyString(loader->filePath);
+	if(loader->scene) elfDecRef((elfObject*)loader->scene);
+	if(loader->pak) elfDecRef((elfObject*)loader->pak);
+
+	glfwDestroyMutex(loader->mutex);
+
+	free(loader);
+
+	elfDecObj(ELF_SCENE_LOADER);
+}
+
+void elfDecodeSceneLoaderTexture(void* data)
+{
+	elfTextureDecode* decode = (elfTextureDecode*)data;
+	elfSceneLoader* loader = decode->loader;
+	elfPak* pak = loader->pak;
+	FILE* file;
+	char* mem;
+	int magic;
+	unsigned char type;
+	int length;
+	long offset;
+	long header;
+
+	// runs on a worker, so it only reads the pak and writes its own decode slot
+	offset = elfGetPakIndexOffset(decode->index);
+	header = sizeof(int)+sizeof(char)*ELF_NAME_LENGTH+sizeof(unsigned char)+sizeof(int);
+
+	if(pak->data)
+	{
+		if(offset+header <= pak->dataSize)
+		{
+			memcpy(&magic, pak->data+offset, sizeof(int));
+			memcpy(&type, pak->data+offset+sizeof(int)+sizeof(char)*ELF_NAME_LENGTH, sizeof(unsigned char));
+			memcpy(&length, pak->data+offset+header-sizeof(int), sizeof(int));
+
+			mem = pak->data+offset+header;
+			if(magic == ELF_TEXTURE_MAGIC && length > 0 && offset+header+length <= pak->dataSize)
+			{
+				if(type == 1)
+				{
+					decode->data = elfDecodeTexture(mem, length, &decode->width, &decode->height, &decode->bpp);
+					elfReleasePakData(pak, mem, length);
+				}
+				else if(type == 2)
+				{
+					// precompressed blocks need no decoding, they are uploaded straight from the mapping
+					decode->blocks = mem;
+					decode->blocksSize = length;
+				}
+			}
+		}
+	}
+	else
+	{
+		file = fopen(elfGetPakFilePath(pak), "rb");
+		if(file)
+		{
+			fseek(file, offset, SEEK_SET);
+
+			magic = 0;
+			type = 0;
+			length = 0;
+			fread((char*)&magic, sizeof(int), 1, file);
+			fseek(file, sizeof(char)*ELF_NAME_LENGTH, SEEK_CUR);
+			fread((char*)&type, sizeof(unsigned char), 1, file);
+			fread((char*)&length, sizeof(int), 1, file);
+
+			if(magic == ELF_TEXTURE_MAGIC && (type == 1 || type == 2) && length > 0)
+			{
+				mem = (char*)malloc(length);
+				if(fread(mem, sizeof(char), length, file) != (size_t)length)
+				{
+					free(mem);
+				}
+				else if(type == 1)
+				{
+					decode->data = elfDecodeTexture(mem, length, &decode->width, &decode->height, &decode->bpp);
+					free(mem);
+				}
+				else
+				{
+					decode->blocks = mem;
+					decode->blocksSize = length;
+				}
+			}
+
+			fclose(file);
+		}
+	}
+
+	glfwLockMutex(loader->mutex);
+	decode->decoded = ELF_TRUE;
+	glfwUnlockMutex(loader->mutex);
+}
+
+void elfStartSceneLoader(elfSceneLoader* loader, elfPak* pak)
+{
+	elfPakIndex* index;
+	int i;
+
+	loader->pak = pak;
+	elfIncRef((elfObject*)loader->pak);
+
+	loader->scene = elfBeginSceneFromPak("", pak);
+	elfIncRef((elfObject*)loader->scene);
+
+	for(index = (elfPakIndex*)elfBeginList(pak->indexes); index;
+		index = (elfPakIndex*)elfGetListNext(pak->indexes))
+	{
+		if(index->indexType == ELF_TEXTURE) loader->decodeCount++;
+	}
+
+	if(loader->decodeCount)
+	{
+		loader->decodes = (elfTextureDecode*)malloc(sizeof(elfTextureDecode)*loader->decodeCount);
+		memset(loader->decodes, 0x0, sizeof(elfTextureDecode)*loader->decodeCount);
+	}
+
+	loader->stepCount = loader->decodeCount+elfGetPakIndexCount(pak);
+
+	// a queue of its own, the frame jobs wait on the engine queue every frame and can't be held up by decoding
+	loader->jobs = elfCreateJobQueue(eng->jobs ? elfGetJobQueueThreadCount(eng->jobs) : 1);
+	elfIncRef((elfObject*)loader->jobs);
+
+	for(index = (elfPakIndex*)elfBeginList(pak->indexes), i = 0; index;
+		index = (elfPakIndex*)elfGetListNext(pak->indexes))
+	{
+		if(index->indexType != ELF_TEXTURE) continue;
+
+		loader->decodes[i].loader = loader;
+		loader->decodes[i].index = index;
+		elfAddJob(loader->jobs, elfDecodeSceneLoaderTexture, &loader->decodes[i]);
+		i++;
+	}
+
+	loader->next = (elfPakIndex*)elfBeginList(pak->indexes);
+}
+
+unsigned char elfUpdateSceneLoader(elfSceneLoader* loader, float budget)
+{
+	elfTextureDecode* decode;
+	elfTexture* texture;
+	elfPakIndex* index;
+	unsigned char decoded;
+	double start;
+
+	if(loader->done) return ELF_TRUE;
+
+	start = elfGetTime();
+
+	while(1)
+	{
+		if(loader->uploaded < loader->decodeCount)
+		{
+			// textures are uploaded in queue order, if the next one isn't decoded yet there is nothing to do this frame
+			decode = &loader->decodes[loader->uploaded];
+
+			glfwLockMutex(loader->mutex);
+			decoded = decode->decoded;
+			glfwUnlockMutex(loader->mutex);
+
+			if(!decoded) break;
+
+			if(decode->data)
+			{
+				texture = elfCreateTextureFromPixels(decode->index->name, loader->scene,
+					decode->width, decode->height, decode->bpp, decode->data);
+				if(texture)
+				{
+					elfAppendListObject(loader->scene->textures, (elfObject*)texture);
+					decode->index->object = (elfObject*)texture;
+				}
+
+				free(decode->data);
+				decode->data = NULL;
+			}
+			else if(decode->blocks)
+			{
+				texture = elfCreateTextureFromBlocks(decode->index->name, loader->scene, decode->blocks, decode->blocksSize);
+				if(texture)
+				{
+					elfAppendListObject(loader->scene->textures, (elfObject*)texture);
+					decode->index->object = (elfObject*)texture;
+				}
+
+				if(loader->pak->data) elfReleasePakData(loader->pak, decode->blocks, decode->blocksSize);
+				else free(decode->blocks);
+				decode->blocks = NULL;
+			}
+			else
+			{
+				elfLogWrite("warning: could not decode texture \"%s//%s\"\n", loader->filePath, decode->index->name);
+			}
+
+			loader->uploaded++;
+		}
+		else if(loader->next)
+		{
+			index = loader->next;
+
+			elfLoadSceneIndexFromPak(loader->scene, index, "", &loader->sceneRead);
+
+			elfSeekList(loader->pak->indexes, (elfObject*)index);
+			loader->next = (elfPakIndex*)elfGetListNext(loader->pak->indexes);
+		}
+		else
+		{
+			elfWaitJobs(loader->jobs);
+			loader->done = ELF_TRUE;
+			break;
+		}
+
+		loader->steps++;
+
+		if(elfGetTime()-start >= budget) break;
+	}
+
+	return loader->done;
+}
+
+ELF_API const char* ELF_APIENTRY elfGetSceneLoaderFilePath(elfSceneLoader* loader)
+{
+	return loader->filePath;
+}
+
+ELF_API float ELF_APIENTRY elfGetSceneLoaderProgress(elfSceneLoader* loader)
+{
+	if(loader->done || !loader->stepCount) return 1.0f;
+	return (float)loader->steps/(float)loader->stepCount;
+}
+
+ELF_API unsigned char ELF_APIENTRY elfIsSceneLoaderDone(elfSceneLoader* loader)
+{
+	return loader->done;
+}
+
+ELF_API elfScene* ELF_APIENTRY elfGetSceneLoaderScene(elfSceneLoader* loader)
+{
+	if(!loader->done) return NULL;
+	return loader->scene;
+}
+
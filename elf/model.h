@@ -270,9 +270,10 @@ void elfDestroyModel(void* data)
 	}
 
 	if(model->index) free(model->index);
-	if(model->weights) free(model->weights);
-	if(model->boneids) free(model->boneids);
+	if(model->weights) gfxDecRef((gfxObject*)model->weights);
+	if(model->boneids) gfxDecRef((gfxObject*)model->boneids);
 	if(model->triMesh) elfDecRef((elfObject*)model->triMesh);
+	if(model->mapping) elfDecRef((elfObject*)model->mapping);
 
 	free(model);
 
@@ -407,6 +408,83 @@ void elfDrawModel(elfList* materials, elfModel* model, int mode, gfxShaderParams
 	}
 }
 
+void elfDrawModelInstances(elfList* materials, elfModel* model, int mode, gfxShaderParams* shaderParams,
+	elfEntity** entities, float* matrices, int count)
+{
+	int i, j, k;
+	elfMaterial* material;
+	unsigned char found;
+
+	if(!model->vertexArray) return;
+
+	if(mode == ELF_DRAW_WITHOUT_LIGHTING)
+	{
+		found = ELF_FALSE;
+
+		for(material = (elfMaterial*)elfBeginList(materials); material;
+			material = (elfMaterial*)elfGetListNext(materials))
+		{
+			if(!material->lighting)
+			{
+				found = ELF_TRUE;
+				break;
+			}
+		}
+
+		if(!found) return;
+	}
+
+	gfxSetVertexArray(model->vertexArray);
+
+	for(i = 0, material = (elfMaterial*)elfBeginList(materials); i < (int)model->areaCount;
+		i++, material = (elfMaterial*)elfGetListNext(materials))
+	{
+		if(!model->areas[i].vertexIndex) continue;
+
+		if(material)
+		{
+			if(mode == ELF_DRAW_WITH_LIGHTING)
+			{
+				if(!material->lighting) continue;
+			}
+			else if(mode == ELF_DRAW_WITHOUT_LIGHTING)
+			{
+				if(material->lighting) continue;
+			}
+
+			elfSetMaterial(material, mode, shaderParams);
+		}
+		else
+		{
+			gfxSetMaterialParamsDefault(shaderParams);
+			for(j = 0; j < GFX_MAX_TEXTURES-1; j++)
+			{
+				if(shaderParams->textureParams[j].type != GFX_SHADOW_MAP)
+					shaderParams->textureParams[j].texture = 0;
+			}
+		}
+
+		if(shaderParams->instanceCount)
+		{
+			gfxSetShaderParams(shaderParams);
+			gfxDrawVertexIndexInstanced(model->areas[i].vertexIndex, GFX_TRIANGLES, count);
+		}
+		else
+		{
+			// no instancing, the material is still only set up once for the whole group
+			for(k = 0; k < count; k++)
+			{
+				memcpy(shaderParams->modelviewMatrix, &matrices[k*16], sizeof(float)*16);
+				gfxMulMatrix3Matrix4(gfxGetTransformNormalMatrix(entities[k]->transform),
+					shaderParams->cameraMatrix, shaderParams->normalMatrix);
+
+				gfxSetShaderParams(shaderParams);
+				gfxDrawVertexIndex(model->areas[i].vertexIndex, GFX_TRIANGLES);
+			}
+		}
+	}
+}
+
 void elfDrawModelBoundingBox(elfModel* model, gfxShaderParams* shaderParams)
 {
 	if(!model->vertexArray) return;
@@ -24,6 +24,36 @@ void elfDestroyPakIndex(void* data)
 	elfDecObj(ELF_PAK_INDEX);
 }
 
+elfPakMapping* elfCreatePakMapping(char* data, long size)
+{
+	elfPakMapping* mapping;
+
+	mapping = (elfPakMapping*)malloc(sizeof(elfPakMapping));
+	memset(mapping, 0x0, sizeof(elfPakMapping));
+	mapping->objType = ELF_PAK_MAPPING;
+	mapping->objDestr = elfDestroyPakMapping;
+
+	mapping->data = data;
+	mapping->size = size;
+
+	elfIncObj(ELF_PAK_MAPPING);
+
+	return mapping;
+}
+
+void elfDestroyPakMapping(void* data)
+{
+	elfPakMapping* mapping = (elfPakMapping*)data;
+
+#ifndef ELF_WINDOWS
+	if(mapping->data) munmap(mapping->data, mapping->size);
+#endif
+
+	free(mapping);
+
+	elfDecObj(ELF_PAK_MAPPING);
+}
+
 elfPak* elfCreatePakFromFile(const char* filePath)
 {
 	elfPak* pak;
@@ -37,6 +67,11 @@ elfPak* elfCreatePakFromFile(const char* filePath)
 	unsigned char type;
 	char name[ELF_NAME_LENGTH];
 	int offset;
+	int bucket;
+#ifndef ELF_WINDOWS
+	void* data;
+	long size;
+#endif
 
 	file = fopen(filePath, "rb");
 	if(!file)
@@ -67,6 +102,7 @@ elfPak* elfCreatePakFromFile(const char* filePath)
 	if(version > ELF_PAK_VERSION)
 	{
 		elfSetError(ELF_INVALID_FILE, "error: can't load \"%s\", new .pak version\n", filePath);
+		fclose(file);
 		return NULL;
 	}
 
@@ -85,6 +121,13 @@ elfPak* elfCreatePakFromFile(const char* filePath)
 	indexCount = 0;
 	fread((char*)&indexCount, sizeof(int), 1, file);
 
+	// keep the table at most half full, the index count is known up front so it never has to grow
+	pak->indexTableSize = 16;
+	while(pak->indexTableSize < indexCount*2) pak->indexTableSize *= 2;
+
+	pak->indexTable = (elfPakIndex**)malloc(sizeof(elfPakIndex*)*pak->indexTableSize);
+	memset(pak->indexTable, 0x0, sizeof(elfPakIndex*)*pak->indexTableSize);
+
 	for(i = 0; i < indexCount; i++)
 	{
 		type = 0;
@@ -111,11 +154,42 @@ elfPak* elfCreatePakFromFile(const char* filePath)
 		index->indexType = type;
 		index->name = elfCreateString(name);
 		index->offset = offset;
+		index->hash = elfGetPakIndexHash(name, type);
+
+		bucket = index->hash&(pak->indexTableSize-1);
+		index->hashNext = pak->indexTable[bucket];
+		pak->indexTable[bucket] = index;
 
 		elfAppendListObject(pak->indexes, (elfObject*)index);
 	}
 
-	fclose(file);
+	// the handle stays open for the lifetime of the pak so loaders don't reopen the file per resource
+	pak->file = file;
+
+#ifndef ELF_WINDOWS
+	// map the whole file copy-on-write, loaders use vertex data and texture blocks in place instead of
+	// reading them into buffers of their own, then drop the pages once uploaded. anything that isn't mapped falls back to fread
+	if(eng && eng->config && eng->config->mapPaks)
+	{
+		fseek(file, 0, SEEK_END);
+		size = ftell(file);
+
+		data = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fileno(file), 0);
+		if(data != MAP_FAILED)
+		{
+			pak->data = (char*)data;
+			pak->dataSize = size;
+
+			// the mapping outlives the pak for as long as models still use arrays in it
+			pak->mapping = elfCreatePakMapping(pak->data, pak->dataSize);
+			elfIncRef((elfObject*)pak->mapping);
+		}
+		else
+		{
+			elfLogWrite("warning: could not map \"%s\", reading it instead\n", filePath);
+		}
+	}
+#endif
 
 	return pak;
 }
@@ -125,8 +199,11 @@ void elfDestroyPak(void* data)
 	elfPak* pak = (elfPak*)data;
 
 	if(pak->filePath) elfDestroyString(pak->filePath);
+	if(pak->file) fclose(pak->file);
+	if(pak->mapping) elfDecRef((elfObject*)pak->mapping);
 
 	elfDecRef((elfObject*)pak->indexes);
+	if(pak->indexTable) free(pak->indexTable);
 
 	free(pak);
 
@@ -138,19 +215,120 @@ const char* elfGetPakFilePath(elfPak* pak)
 	return pak->filePath;
 }
 
+FILE* elfGetPakFile(elfPak* pak)
+{
+	return pak->file;
+}
+
+void* elfGetPakData(elfPak* pak, FILE* file, int sizeBytes)
+{
+	long pos;
+
+	if(!pak || !pak->data || sizeBytes < 1) return NULL;
+
+	pos = ftell(file);
+
+	// arrays handed out in place have to be usable as float and int arrays
+	if(pos < 0 || pos%4) return NULL;
+
+	return elfGetPakBytes(pak, file, sizeBytes);
+}
+
+void elfReadPakData(elfPak* pak, FILE* file, void* buffer, int sizeBytes)
+{
+	void* mapped;
+
+	// for arrays the loader changes, they are copied out of the mapping and its pages dropped
+	mapped = elfGetPakBytes(pak, file, sizeBytes);
+	if(mapped)
+	{
+		memcpy(buffer, mapped, sizeBytes);
+		elfReleasePakData(pak, mapped, sizeBytes);
+	}
+	else
+	{
+		fread((char*)buffer, sizeof(char), sizeBytes, file);
+	}
+}
+
+void* elfGetPakBytes(elfPak* pak, FILE* file, int sizeBytes)
+{
+	long pos;
+
+	if(!pak || !pak->data || sizeBytes < 1) return NULL;
+
+	pos = ftell(file);
+
+	if(pos < 0 || pos+sizeBytes > pak->dataSize) return NULL;
+
+	fseek(file, sizeBytes, SEEK_CUR);
+
+	return pak->data+pos;
+}
+
+void elfReleasePakData(elfPak* pak, void* data, int sizeBytes)
+{
+#ifndef ELF_WINDOWS
+	long pageSize;
+	long start;
+	long end;
+
+	if(!pak || !pak->data || !data) return;
+
+	// only drop the pages that lie entirely inside the range, the edges may be shared with data still in use
+	pageSize = sysconf(_SC_PAGESIZE);
+	start = ((char*)data-pak->data+pageSize-1)/pageSize*pageSize;
+	end = ((char*)data-pak->data+sizeBytes)/pageSize*pageSize;
+
+	if(end > start) madvise(pak->data+start, end-start, MADV_DONTNEED);
+#endif
+}
+
+void elfReleaseModelPakData(elfPak* pak, gfxVertexData* data)
+{
+	char* buffer;
+
+	if(!pak || !pak->data || !data) return;
+
+	// arrays that were read instead of used in place own their memory
+	buffer = (char*)gfxGetVertexDataBuffer(data);
+	if(buffer < pak->data || buffer >= pak->data+pak->dataSize) return;
+
+	elfReleasePakData(pak, buffer, gfxGetVertexDataSizeBytes(data));
+}
+
 int elfGetPakIndexCount(elfPak* pak)
 {
 	return elfGetListLength(pak->indexes);
 }
 
+unsigned int elfGetPakIndexHash(const char* name, unsigned char type)
+{
+	unsigned int hash;
+
+	hash = 2166136261u;
+	while(*name)
+	{
+		hash ^= (unsigned char)*name++;
+		hash *= 16777619u;
+	}
+
+	hash ^= type;
+	hash *= 16777619u;
+
+	return hash;
+}
+
 elfPakIndex* elfGetPakIndexByName(elfPak* pak, const char* name, unsigned char type)
 {
 	elfPakIndex* index;
+	unsigned int hash;
 
-	for(index = (elfPakIndex*)elfBeginList(pak->indexes); index;
-		index = (elfPakIndex*)elfGetListNext(pak->indexes))
+	hash = elfGetPakIndexHash(name, type);
+
+	for(index = pak->indexTable[hash&(pak->indexTableSize-1)]; index; index = index->hashNext)
 	{
-		if(!strcmp(index->name, name) && index->indexType == type) return index;
+		if(index->hash == hash && index->indexType == type && !strcmp(index->name, name)) return index;
 	}
 
 	return NULL;
@@ -162,6 +340,18 @@ elfPakIndex* elfGetPakIndexByIndex(elfPak* pak, int idx)
 	return (elfPakIndex*)elfGetListObject(pak->indexes, idx);
 }
 
+unsigned int elfAlignPakOffset(unsigned int offset)
+{
+	return (offset+3)&~3;
+}
+
+void elfAlignPakFile(FILE* file)
+{
+	char zero = 0;
+
+	while(ftell(file)%4) fwrite(&zero, sizeof(char), 1, file);
+}
+
 unsigned char elfGetPakIndexType(elfPakIndex* index)
 {
 	return index->objType;
@@ -609,6 +799,7 @@ elfArmature* elfCreateArmatureFromPak(FILE* file, const char* name, elfScene* sc
 	elfList* bones;
 	elfList* boneParents;
 	elfString* strObj;
+	elfBoneFrame* frames = NULL;
 	int i, j;
 	float boneInvQua[4];
 
@@ -638,6 +829,8 @@ elfArmature* elfCreateArmatureFromPak(FILE* file, const char* name, elfScene* sc
 		bones = elfCreateList();
 		boneParents = elfCreateList();
 
+		if(armature->frameCount > 0) frames = (elfBoneFrame*)malloc(sizeof(elfBoneFrame)*armature->frameCount);
+
 		for(i = 0; i < (int)armature->boneCount; i++)
 		{
 			bone = elfCreateBone(NULL);
@@ -654,22 +847,24 @@ elfArmature* elfCreateArmatureFromPak(FILE* file, const char* name, elfScene* sc
 
 			if(armature->frameCount > 0)
 			{
-				bone->frames = (elfBoneFrame*)malloc(sizeof(elfBoneFrame)*armature->frameCount);
 				for(j = 0; j < armature->frameCount; j++)
 				{
-					fread((char*)&bone->frames[j].pos.x, sizeof(float), 3, file);
-					fread((char*)&bone->frames[j].qua.x, sizeof(float), 4, file);
-					gfxMulQuaQua(&bone->frames[j].qua.x, boneInvQua, &bone->frames[j].offsetQua.x);
-					bone->frames[j].offsetPos.x = bone->frames[j].pos.x-bone->pos.x;
-					bone->frames[j].offsetPos.y = bone->frames[j].pos.y-bone->pos.y;
-					bone->frames[j].offsetPos.z = bone->frames[j].pos.z-bone->pos.z;
-					if(bone->frames[j].pos.x < armature->bbMin.x) armature->bbMin.x = bone->frames[j].pos.x;
-					if(bone->frames[j].pos.y < armature->bbMin.y) armature->bbMin.y = bone->frames[j].pos.y;
-					if(bone->frames[j].pos.z < armature->bbMin.z) armature->bbMin.z = bone->frames[j].pos.z;
-					if(bone->frames[j].pos.x > armature->bbMax.x) armature->bbMax.x = bone->frames[j].pos.x;
-					if(bone->frames[j].pos.y > armature->bbMax.y) armature->bbMax.y = bone->frames[j].pos.y;
-					if(bone->frames[j].pos.z > armature->bbMax.z) armature->bbMax.z = bone->frames[j].pos.z;
+					fread((char*)&frames[j].pos.x, sizeof(float), 3, file);
+					fread((char*)&frames[j].qua.x, sizeof(float), 4, file);
+					gfxMulQuaQua(&frames[j].qua.x, boneInvQua, &frames[j].offsetQua.x);
+					frames[j].offsetPos.x = frames[j].pos.x-bone->pos.x;
+					frames[j].offsetPos.y = frames[j].pos.y-bone->pos.y;
+					frames[j].offsetPos.z = frames[j].pos.z-bone->pos.z;
+					if(frames[j].pos.x < armature->bbMin.x) armature->bbMin.x = frames[j].pos.x;
+					if(frames[j].pos.y < armature->bbMin.y) armature->bbMin.y = frames[j].pos.y;
+					if(frames[j].pos.z < armature->bbMin.z) armature->bbMin.z = frames[j].pos.z;
+					if(frames[j].pos.x > armature->bbMax.x) armature->bbMax.x = frames[j].pos.x;
+					if(frames[j].pos.y > armature->bbMax.y) armature->bbMax.y = frames[j].pos.y;
+					if(frames[j].pos.z > armature->bbMax.z) armature->bbMax.z = frames[j].pos.z;
 				}
+
+				// only the reduced, quantized track is kept around
+				elfCompressBoneTrack(bone, frames, armature->frameCount, eng->config->animationTolerance);
 			}
 
 			strObj = elfCreateStringObject();
@@ -704,6 +899,8 @@ elfArmature* elfCreateArmatureFromPak(FILE* file, const char* name, elfScene* sc
 
 		elfDestroyList(boneParents);
 		elfDestroyList(bones);
+
+		if(frames) free(frames);
 	}
 
 	return armature;
@@ -941,10 +1138,13 @@ elfModel* elfCreateModelFromPak(FILE* file, const char* name, elfScene* scene)
 	unsigned char isTexCoords;
 	unsigned char isWeightsAndBoneids;
 	unsigned char junk;
-	float weights[4];
 	float length;
 	short int boneids[4];
+	float* skinWeights;
+	int* skinBoneids;
 	float* vertexBuffer;
+	void* mapped;
+	int j;
 
 	// read magic
 	fread((char*)&magic, sizeof(int), 1, file);
@@ -963,6 +1163,13 @@ elfModel* elfCreateModelFromPak(FILE* file, const char* name, elfScene* scene)
 	model->name = elfCreateString(rname);
 	model->filePath = elfCreateString(elfGetSceneFilePath(scene));
 
+	// vertex data used in place keeps the mapping alive, not the pak with its file and index
+	if(scene->pak && scene->pak->mapping)
+	{
+		model->mapping = scene->pak->mapping;
+		elfIncRef((elfObject*)model->mapping);
+	}
+
 	// read header
 	fread((char*)&model->verticeCount, sizeof(int), 1, file);
 	fread((char*)&model->frameCount, sizeof(int), 1, file);
@@ -999,11 +1206,18 @@ elfModel* elfCreateModelFromPak(FILE* file, const char* name, elfScene* scene)
 	}
 
 	// read vertices
-	model->vertices = gfxCreateVertexData(3*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC);
+	mapped = elfGetPakData(scene->pak, file, sizeof(float)*3*model->verticeCount);
+	if(mapped)
+	{
+		model->vertices = gfxCreateVertexDataFromBuffer(3*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC, mapped);
+	}
+	else
+	{
+		model->vertices = gfxCreateVertexData(3*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC);
+		fread((char*)gfxGetVertexDataBuffer(model->vertices), sizeof(float), 3*model->verticeCount, file);
+	}
 	gfxIncRef((gfxObject*)model->vertices);
 
-	fread((char*)gfxGetVertexDataBuffer(model->vertices), sizeof(float), 3*model->verticeCount, file);
-
 	// read index
 	model->index = (unsigned int*)malloc(sizeof(unsigned int)*model->indiceCount);
 
@@ -1015,12 +1229,19 @@ elfModel* elfCreateModelFromPak(FILE* file, const char* name, elfScene* scene)
 		fread((char*)&model->areas[i].indiceCount, sizeof(int), 1, file);
 		if(model->areas[i].indiceCount)
 		{
-			model->areas[i].index = gfxCreateVertexData(model->areas[i].indiceCount, GFX_UINT, GFX_VERTEX_DATA_STATIC);
+			mapped = elfGetPakData(scene->pak, file, sizeof(unsigned int)*model->areas[i].indiceCount);
+			if(mapped)
+			{
+				model->areas[i].index = gfxCreateVertexDataFromBuffer(model->areas[i].indiceCount, GFX_UINT, GFX_VERTEX_DATA_STATIC, mapped);
+			}
+			else
+			{
+				model->areas[i].index = gfxCreateVertexData(model->areas[i].indiceCount, GFX_UINT, GFX_VERTEX_DATA_STATIC);
+				fread((char*)gfxGetVertexDataBuffer(model->areas[i].index),
+					sizeof(unsigned int), model->areas[i].indiceCount, file);
+			}
 			gfxIncRef((gfxObject*)model->areas[i].index);
 
-			fread((char*)gfxGetVertexDataBuffer(model->areas[i].index),
-				sizeof(unsigned int), model->areas[i].indiceCount, file);
-
 			memcpy(&model->index[indicesRead], gfxGetVertexDataBuffer(model->areas[i].index),
 				gfxGetVertexDataSizeBytes(model->areas[i].index));
 
@@ -1028,49 +1249,74 @@ elfModel* elfCreateModelFromPak(FILE* file, const char* name, elfScene* scene)
 		}
 	}
 
-	model->normals = gfxCreateVertexData(3*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC);
+	mapped = elfGetPakData(scene->pak, file, sizeof(float)*3*model->verticeCount);
+	if(mapped)
+	{
+		model->normals = gfxCreateVertexDataFromBuffer(3*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC, mapped);
+	}
+	else
+	{
+		model->normals = gfxCreateVertexData(3*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC);
+		fread((char*)gfxGetVertexDataBuffer(model->normals), sizeof(float), 3*model->verticeCount, file);
+	}
 	gfxIncRef((gfxObject*)model->normals);
 
-	fread((char*)gfxGetVertexDataBuffer(model->normals), sizeof(float), 3*model->verticeCount, file);
-
 	// read tex coords
 	if(isTexCoords > 0)
 	{
-		model->texCoords = gfxCreateVertexData(2*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC);
+		mapped = elfGetPakData(scene->pak, file, sizeof(float)*2*model->verticeCount);
+		if(mapped)
+		{
+			model->texCoords = gfxCreateVertexDataFromBuffer(2*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC, mapped);
+		}
+		else
+		{
+			model->texCoords = gfxCreateVertexData(2*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC);
+			fread((char*)gfxGetVertexDataBuffer(model->texCoords), sizeof(float), 2*model->verticeCount, file);
+		}
 		gfxIncRef((gfxObject*)model->texCoords);
-
-		fread((char*)gfxGetVertexDataBuffer(model->texCoords), sizeof(float), 2*model->verticeCount, file);
 	}
 
 	// read weights and bone ids
 	if(isWeightsAndBoneids > 0)
 	{
-		model->weights = (float*)malloc(sizeof(float)*4*model->verticeCount);
-		for(i = 0; i < model->verticeCount; i++)
-		{
-			fread((char*)weights, sizeof(float), 4, file);
-			if(weights[0] > 1.0f) weights[0] = 1.0f;
-			if(weights[1] > 1.0f) weights[1] = 1.0f;
-			if(weights[2] > 1.0f) weights[2] = 1.0f;
-			if(weights[3] > 1.0f) weights[3] = 1.0f;
-			if(weights[0] < 0.0f) weights[0] = 0.0f;
-			if(weights[1] < 0.0f) weights[1] = 0.0f;
-			if(weights[2] < 0.0f) weights[2] = 0.0f;
-			if(weights[3] < 0.0f) weights[3] = 0.0f;
-			length = 1.0f/(weights[0]+weights[1]+weights[2]+weights[3]);
-			model->weights[i*4] = weights[0]*length;
-			model->weights[i*4+1] = weights[1]*length;
-			model->weights[i*4+2] = weights[2]*length;
-			model->weights[i*4+3] = weights[3]*length;
-		}
-		model->boneids = (int*)malloc(sizeof(int)*4*model->verticeCount);
+		// kept as vertex data, they are the skinning attributes when the entities are skinned by the shaders
+		model->weights = gfxCreateVertexData(4*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC);
+		gfxIncRef((gfxObject*)model->weights);
+		skinWeights = (float*)gfxGetVertexDataBuffer(model->weights);
+		elfReadPakData(scene->pak, file, skinWeights, sizeof(float)*4*model->verticeCount);
+
+		model->boneids = gfxCreateVertexData(4*model->verticeCount, GFX_INT, GFX_VERTEX_DATA_STATIC);
+		gfxIncRef((gfxObject*)model->boneids);
+		skinBoneids = (int*)gfxGetVertexDataBuffer(model->boneids);
 		for(i = 0; i < model->verticeCount; i++)
 		{
 			fread((char*)boneids, sizeof(short int), 4, file);
-			model->boneids[i*4] = boneids[0];
-			model->boneids[i*4+1] = boneids[1];
-			model->boneids[i*4+2] = boneids[2];
-			model->boneids[i*4+3] = boneids[3];
+			for(j = 0; j < 4; j++)
+			{
+				// unused slots are stored as negative ids, they would index outside the
+				// shader palette, so they point at the first bone with no weight instead
+				if(boneids[j] < 0)
+				{
+					boneids[j] = 0;
+					skinWeights[i*4+j] = 0.0f;
+				}
+				if(boneids[j] > model->maxBoneId) model->maxBoneId = boneids[j];
+				skinBoneids[i*4+j] = boneids[j];
+
+				if(skinWeights[i*4+j] > 1.0f) skinWeights[i*4+j] = 1.0f;
+				if(skinWeights[i*4+j] < 0.0f) skinWeights[i*4+j] = 0.0f;
+			}
+
+			length = skinWeights[i*4]+skinWeights[i*4+1]+skinWeights[i*4+2]+skinWeights[i*4+3];
+			if(length > 0.0f)
+			{
+				length = 1.0f/length;
+				skinWeights[i*4] *= length;
+				skinWeights[i*4+1] *= length;
+				skinWeights[i*4+2] *= length;
+				skinWeights[i*4+3] *= length;
+			}
 		}
 	}
 
@@ -1097,6 +1343,11 @@ elfModel* elfCreateModelFromPak(FILE* file, const char* name, elfScene* scene)
 	gfxSetVertexArrayData(model->vertexArray, GFX_VERTEX, model->vertices);
 	gfxSetVertexArrayData(model->vertexArray, GFX_NORMAL, model->normals);
 	if(isTexCoords > 0) gfxSetVertexArrayData(model->vertexArray, GFX_TEX_COORD, model->texCoords);
+	if(isWeightsAndBoneids > 0)
+	{
+		gfxSetVertexArrayData(model->vertexArray, GFX_WEIGHTS, model->weights);
+		gfxSetVertexArrayData(model->vertexArray, GFX_BONEIDS, model->boneids);
+	}
 
 	for(i = 0; i < model->areaCount; i++)
 	{
@@ -1107,6 +1358,16 @@ elfModel* elfCreateModelFromPak(FILE* file, const char* name, elfScene* scene)
 		}
 	}
 
+	// the buffers are uploaded by now, so the mapped pages can go. the mapping is copy-on-write
+	// and nothing wrote to them, so anything reading the arrays later pages them back in from the file
+	if(model->mapping)
+	{
+		elfReleaseModelPakData(scene->pak, model->vertices);
+		elfReleaseModelPakData(scene->pak, model->normals);
+		elfReleaseModelPakData(scene->pak, model->texCoords);
+		for(i = 0; i < model->areaCount; i++) elfReleaseModelPakData(scene->pak, model->areas[i].index);
+	}
+
 	return model;
 }
 
@@ -1274,66 +1535,62 @@ elfSprite* elfCreateSpriteFromPak(FILE* file, const char* name, elfScene* scene)
 	return sprite;
 }
 
-elfTexture* elfCreateTextureFromPak(FILE* file, const char* name, elfScene* scene)
+unsigned char* elfDecodeTexture(char* mem, int length, int* width, int* height, unsigned char* bpp)
 {
-	elfTexture* texture;
 	FIMEMORY* fiMem;
 	FIBITMAP* fiBitmap;
-	char* mem;
 	FREE_IMAGE_FORMAT fiFormat;
-	int magic;
-	char rname[ELF_NAME_LENGTH];
-	unsigned char type;
-	int width;
-	int height;
-	unsigned char bpp;
-	unsigned int length;
-	int format;
-	int internalFormat;
-	int dataFormat;
 	unsigned char* data;
 
-	fread((char*)&magic, sizeof(int), 1, file);
+	// doesn't touch any engine state, so it is safe to call from the loader threads
+	fiMem = FreeImage_OpenMemory((BYTE*)mem, length);
+	fiFormat = FreeImage_GetFileTypeFromMemory(fiMem, 0);
+	fiBitmap = FreeImage_LoadFromMemory(fiFormat, fiMem, 0);
 
-	if(magic != ELF_TEXTURE_MAGIC)
+	if(!fiBitmap)
 	{
-		elfSetError(ELF_INVALID_FILE, "error: invalid texture \"%s//%s\", wrong magic number\n", elfGetSceneFilePath(scene), name);
+		FreeImage_CloseMemory(fiMem);
 		return NULL;
 	}
 
-	fread(rname, sizeof(char), ELF_NAME_LENGTH, file);
-	fread((char*)&type, sizeof(unsigned char), 1, file);
+	*width = FreeImage_GetWidth(fiBitmap);
+	*height = FreeImage_GetHeight(fiBitmap);
+	*bpp = FreeImage_GetBPP(fiBitmap);
 
-	if(type == 1)
-	{
-		fread((char*)&length, sizeof(int), 1, file);
- 
-		mem = (char*)malloc(length);
-		fread(mem, sizeof(char), length, file);
+	data = (unsigned char*)malloc(sizeof(char)*(*width)*(*height)*((*bpp)/8));
+	FreeImage_ConvertToRawBits((BYTE*)data, fiBitmap, (*width)*((*bpp)/8), *bpp,
+		FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, FALSE);
 
-		fiMem = FreeImage_OpenMemory((BYTE*)mem, length);
-		fiFormat = FreeImage_GetFileTypeFromMemory(fiMem, 0);
-		fiBitmap = FreeImage_LoadFromMemory(fiFormat, fiMem, 0);
+	FreeImage_Unload(fiBitmap);
+	FreeImage_CloseMemory(fiMem);
 
-		width = FreeImage_GetWidth(fiBitmap);
-		height = FreeImage_GetHeight(fiBitmap);
-		bpp = FreeImage_GetBPP(fiBitmap);
+	return data;
+}
 
-		data = (unsigned char*)malloc(sizeof(char)*width*height*(bpp/8));
-		FreeImage_ConvertToRawBits((BYTE*)data, fiBitmap, width*(bpp/8), bpp,
-			FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, FALSE);
+elfTexture* elfCreateSceneTexture(const char* name, elfScene* scene)
+{
+	elfTexture* texture;
 
-		FreeImage_Unload(fiBitmap);
-		FreeImage_CloseMemory(fiMem);
+	texture = elfCreateTexture();
 
-		free(mem);
-	}
-	else
+	texture->name = elfCreateString(name);
+	texture->filePath = elfCreateString(elfGetSceneFilePath(scene));
+	if(scene->pak)
 	{
-		elfSetError(ELF_UNKNOWN_FORMAT, "error: can't load texture \"%s//%s\", unknown format\n", elfGetSceneFilePath(scene), rname);
-		return NULL;
+		texture->pak = scene->pak;
+		elfIncRef((elfObject*)texture->pak);
 	}
 
+	return texture;
+}
+
+elfTexture* elfCreateTextureFromPixels(const char* name, elfScene* scene, int width, int height, unsigned char bpp, unsigned char* data)
+{
+	elfTexture* texture;
+	int format;
+	int internalFormat;
+	int dataFormat;
+
 	switch(bpp)
 	{
 		case 8: format = GFX_LUMINANCE; internalFormat = GFX_LUMINANCE; dataFormat = GFX_UBYTE; break;
@@ -1342,22 +1599,105 @@ elfTexture* elfCreateTextureFromPak(FILE* file, const char* name, elfScene* scen
 		case 32: format = GFX_BGRA; internalFormat = eng->config->textureCompress ? GFX_COMPRESSED_RGBA : GFX_RGBA; dataFormat = GFX_UBYTE; break;
 		case 48: format = GFX_BGR; internalFormat = eng->config->textureCompress ? GFX_COMPRESSED_RGB : GFX_RGB; dataFormat = GFX_USHORT; break;
 		default:
-			elfSetError(ELF_INVALID_FILE, "error: unsupported bits per pixel value [%d] in texture \"%s//%s\"\n", (int)bpp, elfGetSceneFilePath(scene), rname);
-			free(data);
+			elfSetError(ELF_INVALID_FILE, "error: unsupported bits per pixel value [%d] in texture \"%s//%s\"\n", (int)bpp, elfGetSceneFilePath(scene), name);
 			return NULL;
 	}
 
-	texture = elfCreateTexture();
-
-	texture->name = elfCreateString(rname);
-	texture->filePath = elfCreateString(elfGetSceneFilePath(scene));
+	texture = elfCreateSceneTexture(name, scene);
 	texture->texture = gfxCreate2dTexture(width, height, eng->config->textureAnisotropy, GFX_REPEAT, GFX_LINEAR, format, internalFormat, dataFormat, data);
 
-	free(data);
+	if(!texture->texture)
+	{
+		elfSetError(ELF_CANT_CREATE, "error: can't create texture \"%s//%s\"\n", elfGetSceneFilePath(scene), name);
+		elfDestroyTexture(texture);
+		return NULL;
+	}
+
+	return texture;
+}
+
+elfTexture* elfCreateTextureFromBlocks(const char* name, elfScene* scene, char* mem, int length)
+{
+	elfTexture* texture;
+	void* levels[32];
+	int levelSizes[32];
+	unsigned char* pixels;
+	int alpha;
+	int width;
+	int height;
+	int levelCount;
+	int levelWidth;
+	int levelHeight;
+	int offset;
+	int i;
+
+	// the blocks go to the driver as they are stored, so the pak can hand them over unaligned
+	if(length < (int)sizeof(int)*4)
+	{
+		elfSetError(ELF_INVALID_FILE, "error: invalid compressed texture \"%s//%s\"\n", elfGetSceneFilePath(scene), name);
+		return NULL;
+	}
+
+	memcpy(&alpha, mem, sizeof(int));
+	memcpy(&width, mem+sizeof(int), sizeof(int));
+	memcpy(&height, mem+sizeof(int)*2, sizeof(int));
+	memcpy(&levelCount, mem+sizeof(int)*3, sizeof(int));
+	offset = sizeof(int)*4;
+
+	if((alpha != 0 && alpha != 1) || width < 1 || height < 1 || width > gfxGetMaxTextureSize() ||
+		height > gfxGetMaxTextureSize() || levelCount < 1 || levelCount > 32)
+	{
+		elfSetError(ELF_INVALID_FILE, "error: invalid compressed texture \"%s//%s\"\n", elfGetSceneFilePath(scene), name);
+		return NULL;
+	}
+
+	// every level has to hold exactly the blocks of its size, halving down to 1x1 and no further
+	levelWidth = width;
+	levelHeight = height;
+	for(i = 0; i < levelCount; i++)
+	{
+		if(offset+(int)sizeof(int) > length) break;
+		memcpy(&levelSizes[i], mem+offset, sizeof(int));
+		offset += sizeof(int);
+
+		if(levelSizes[i] != elfGetDxtLevelSizeBytes(levelWidth, levelHeight, (unsigned char)alpha) ||
+			(levelWidth == 1 && levelHeight == 1 && i < levelCount-1))
+		{
+			elfSetError(ELF_INVALID_FILE, "error: invalid level %d in compressed texture \"%s//%s\"\n", i, elfGetSceneFilePath(scene), name);
+			return NULL;
+		}
+
+		if(offset+levelSizes[i] > length) break;
+		levels[i] = mem+offset;
+		offset += levelSizes[i];
+
+		if(levelWidth > 1) levelWidth /= 2;
+		if(levelHeight > 1) levelHeight /= 2;
+	}
+
+	if(i < levelCount)
+	{
+		elfSetError(ELF_INVALID_FILE, "error: compressed texture \"%s//%s\" is truncated\n", elfGetSceneFilePath(scene), name);
+		return NULL;
+	}
+
+	// without s3tc support the top level is decoded here and the driver builds the mip chain
+	if(!gfxIsTextureCompressionSupported())
+	{
+		pixels = (unsigned char*)malloc(sizeof(unsigned char)*width*height*(alpha ? 4 : 3));
+		elfDecodeDxtLevel((unsigned char*)levels[0], width, height, (unsigned char)alpha, pixels);
+		texture = elfCreateTextureFromPixels(name, scene, width, height, alpha ? 32 : 24, pixels);
+		free(pixels);
+		return texture;
+	}
+
+	texture = elfCreateSceneTexture(name, scene);
+	texture->texture = gfxCreate2dCompressedTexture(width, height, eng->config->textureAnisotropy, GFX_REPEAT,
+		alpha ? GFX_DXT5 : GFX_DXT1, levelCount, levels, levelSizes);
 
 	if(!texture->texture)
 	{
-		elfSetError(ELF_CANT_CREATE, "error: can't create texture \"%s//%s\"\n", elfGetSceneFilePath(scene), rname);
+		elfSetError(ELF_CANT_CREATE, "error: can't create texture \"%s//%s\"\n", elfGetSceneFilePath(scene), name);
 		elfDestroyTexture(texture);
 		return NULL;
 	}
@@ -1365,20 +1705,79 @@ elfTexture* elfCreateTextureFromPak(FILE* file, const char* name, elfScene* scen
 	return texture;
 }
 
-elfScene* elfCreateSceneFromPak(const char* name, elfPak* pak)
+elfTexture* elfCreateTextureFromPak(FILE* file, const char* name, elfScene* scene)
 {
-	elfScene* scene;
-	elfCamera* camera;
-	elfEntity* entity;
-	elfLight* light;
-	elfSprite* sprite;
-	elfParticles* particles;
-	elfPakIndex* index;
-	FILE* file;
+	elfTexture* texture;
+	char* mem;
 	int magic;
 	char rname[ELF_NAME_LENGTH];
-	float ambientColor[4];
-	unsigned char sceneRead;
+	unsigned char type;
+	int width;
+	int height;
+	unsigned char bpp;
+	unsigned int length;
+	unsigned char* data;
+	unsigned char mapped;
+
+	fread((char*)&magic, sizeof(int), 1, file);
+
+	if(magic != ELF_TEXTURE_MAGIC)
+	{
+		elfSetError(ELF_INVALID_FILE, "error: invalid texture \"%s//%s\", wrong magic number\n", elfGetSceneFilePath(scene), name);
+		return NULL;
+	}
+
+	fread(rname, sizeof(char), ELF_NAME_LENGTH, file);
+	fread((char*)&type, sizeof(unsigned char), 1, file);
+
+	if(type != 1 && type != 2)
+	{
+		elfSetError(ELF_UNKNOWN_FORMAT, "error: can't load texture \"%s//%s\", unknown format\n", elfGetSceneFilePath(scene), rname);
+		return NULL;
+	}
+
+	fread((char*)&length, sizeof(int), 1, file);
+
+	mem = (char*)elfGetPakBytes(scene->pak, file, length);
+	mapped = mem != NULL;
+	if(!mapped)
+	{
+		mem = (char*)malloc(length);
+		fread(mem, sizeof(char), length, file);
+	}
+
+	if(type == 2)
+	{
+		texture = elfCreateTextureFromBlocks(rname, scene, mem, length);
+
+		if(mapped) elfReleasePakData(scene->pak, mem, length);
+		else free(mem);
+
+		return texture;
+	}
+
+	data = elfDecodeTexture(mem, length, &width, &height, &bpp);
+
+	// the encoded image isn't needed once decoded, let the kernel have the mapped pages back
+	if(mapped) elfReleasePakData(scene->pak, mem, length);
+	else free(mem);
+
+	if(!data)
+	{
+		elfSetError(ELF_INVALID_FILE, "error: can't decode texture \"%s//%s\"\n", elfGetSceneFilePath(scene), rname);
+		return NULL;
+	}
+
+	texture = elfCreateTextureFromPixels(rname, scene, width, height, bpp, data);
+
+	free(data);
+
+	return texture;
+}
+
+elfScene* elfBeginSceneFromPak(const char* name, elfPak* pak)
+{
+	elfScene* scene;
 
 	scene = elfCreateScene(NULL);
 
@@ -1388,44 +1787,62 @@ elfScene* elfCreateSceneFromPak(const char* name, elfPak* pak)
 	scene->pak = pak;
 	elfIncRef((elfObject*)pak);
 
-	sceneRead = ELF_FALSE;
-	for(index = (elfPakIndex*)elfBeginList(pak->indexes); index;
-		index = (elfPakIndex*)elfGetListNext(pak->indexes))
+	return scene;
+}
+
+void elfLoadSceneIndexFromPak(elfScene* scene, elfPakIndex* index, const char* name, unsigned char* sceneRead)
+{
+	FILE* file;
+	int magic;
+	char rname[ELF_NAME_LENGTH];
+	float ambientColor[4];
+
+	if(index->indexType == ELF_CAMERA) elfGetOrLoadCameraByName(scene, index->name);
+	else if(index->indexType == ELF_ENTITY) elfGetOrLoadEntityByName(scene, index->name);
+	else if(index->indexType == ELF_LIGHT) elfGetOrLoadLightByName(scene, index->name);
+	else if(index->indexType == ELF_SPRITE) elfGetOrLoadSpriteByName(scene, index->name);
+	else if(index->indexType == ELF_PARTICLES) elfGetOrLoadParticlesByName(scene, index->name);
+	else if(index->indexType == ELF_SCENE && !*sceneRead)
 	{
-		if(index->indexType == ELF_CAMERA) camera = elfGetOrLoadCameraByName(scene, index->name);
-		else if(index->indexType == ELF_ENTITY) entity = elfGetOrLoadEntityByName(scene, index->name);
-		else if(index->indexType == ELF_LIGHT) light = elfGetOrLoadLightByName(scene, index->name);
-		else if(index->indexType == ELF_SPRITE) sprite = elfGetOrLoadSpriteByName(scene, index->name);
-		else if(index->indexType == ELF_PARTICLES) particles = elfGetOrLoadParticlesByName(scene, index->name);
-		else if(index->indexType == ELF_SCENE && !sceneRead)
+		file = elfGetPakFile(scene->pak);
+		if(!file) return;
+
+		*sceneRead = ELF_TRUE;
+		fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
+
+		fread((char*)&magic, sizeof(int), 1, file);
+		if(magic != ELF_SCENE_MAGIC)
 		{
-			file = fopen(elfGetPakFilePath(pak), "rb");
-			if(file)
-			{
-				sceneRead = ELF_TRUE;
-				fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
+			printf("warning: scene header section of \"%s\" is invalid\n", elfGetPakFilePath(scene->pak));
+			return;
+		}
 
-				fread((char*)&magic, sizeof(int), 1, file);
-				if(magic != ELF_SCENE_MAGIC)
-				{
-					printf("warning: scene header section of \"%s\" is invalid\n", elfGetPakFilePath(pak));
-					continue;
-				}
+		fread(rname, sizeof(char), ELF_NAME_LENGTH, file);
+		if(!name || strlen(name) < 1)
+		{
+			if(scene->name) elfDestroyString(scene->name);
+			scene->name = elfCreateString(rname);
+		}
 
-				fread(rname, sizeof(char), ELF_NAME_LENGTH, file);
-				if(!name || strlen(name) < 1)
-				{
-					if(scene->name) elfDestroyString(scene->name);
-					scene->name = elfCreateString(rname);
-				}
+		fread((char*)ambientColor, sizeof(float), 4, file);
 
-				fread((char*)ambientColor, sizeof(float), 4, file);
+		elfSetSceneAmbientColor(scene, ambientColor[0], ambientColor[1], ambientColor[2], ambientColor[3]);
+	}
+}
 
-				elfSetSceneAmbientColor(scene, ambientColor[0], ambientColor[1], ambientColor[2], ambientColor[3]);
+elfScene* elfCreateSceneFromPak(const char* name, elfPak* pak)
+{
+	elfScene* scene;
+	elfPakIndex* index;
+	unsigned char sceneRead;
 
-				fclose(file);
-			}
-		}
+	scene = elfBeginSceneFromPak(name, pak);
+
+	sceneRead = ELF_FALSE;
+	for(index = (elfPakIndex*)elfBeginList(pak->indexes); index;
+		index = (elfPakIndex*)elfGetListNext(pak->indexes))
+	{
+		elfLoadSceneIndexFromPak(scene, index, name, &sceneRead);
 		elfSeekList(pak->indexes, (elfObject*)index);
 	}
 
@@ -1558,6 +1975,10 @@ void elfWriteArmatureToFile(elfArmature* armature, FILE* file)
 {
 	int magic;
 	elfBone* bone;
+	float offsetPos[3];
+	float offsetQua[4];
+	float pos[3];
+	float qua[4];
 	int i, j;
 
 	magic = ELF_ARMATURE_MAGIC;
@@ -1579,10 +2000,24 @@ void elfWriteArmatureToFile(elfArmature* armature, FILE* file)
 		fwrite((char*)&bone->pos.x, sizeof(float), 3, file);
 		fwrite((char*)&bone->qua.x, sizeof(float), 4, file);
 
+		// armatures that weren't loaded from a pak only have the compressed track to rebuild the frames from
 		for(j = 0; j < armature->frameCount; j++)
 		{
-			fwrite((char*)&bone->frames[j].pos.x, sizeof(float), 3, file);
-			fwrite((char*)&bone->frames[j].qua.x, sizeof(float), 4, file);
+			if(bone->frames)
+			{
+				fwrite((char*)&bone->frames[j].pos.x, sizeof(float), 3, file);
+				fwrite((char*)&bone->frames[j].qua.x, sizeof(float), 4, file);
+				continue;
+			}
+
+			elfSampleBoneTrack(bone, armature->frameCount, (float)(j+1), offsetPos, offsetQua);
+			pos[0] = bone->pos.x+offsetPos[0];
+			pos[1] = bone->pos.y+offsetPos[1];
+			pos[2] = bone->pos.z+offsetPos[2];
+			gfxMulQuaQua(offsetQua, &bone->qua.x, qua);
+
+			fwrite((char*)pos, sizeof(float), 3, file);
+			fwrite((char*)qua, sizeof(float), 4, file);
 		}
 	}
 }
@@ -1696,6 +2131,7 @@ void elfWriteModelToFile(elfModel* model, FILE* file)
 	unsigned char junk;
 	int i = 0;
 	short int boneids[4];
+	int* skinBoneids;
 
 	magic = ELF_MODEL_MAGIC;
 	fwrite((char*)&magic, sizeof(int), 1, file);
@@ -1739,14 +2175,16 @@ void elfWriteModelToFile(elfModel* model, FILE* file)
 	// read weights and bone ids
 	if(isWeightsAndBoneids > 0)
 	{
-		fwrite((char*)model->weights, sizeof(float), 4*model->verticeCount, file);
+		fwrite((char*)gfxGetVertexDataBuffer(model->weights), sizeof(float), 4*model->verticeCount, file);
+
+		skinBoneids = (int*)gfxGetVertexDataBuffer(model->boneids);
 
 		for(i = 0; i < model->verticeCount; i++)
 		{
-			boneids[0] = model->boneids[i*4];
-			boneids[1] = model->boneids[i*4+1];
-			boneids[2] = model->boneids[i*4+2];
-			boneids[3] = model->boneids[i*4+3];
+			boneids[0] = skinBoneids[i*4];
+			boneids[1] = skinBoneids[i*4+1];
+			boneids[2] = skinBoneids[i*4+2];
+			boneids[3] = skinBoneids[i*4+3];
 
 			fwrite((char*)boneids, sizeof(short int), 4, file);
 		}
@@ -1854,7 +2292,7 @@ void elfWriteTextureToFile(elfTexture* texture, FILE* file)
 
 	elfWriteNameToFile(texture->name, file);
 
-	type = 1;
+	type = texture->dataType;
 	fwrite((char*)&type, sizeof(unsigned char), 1, file);
 
 	fwrite((char*)&texture->dataSize, sizeof(int), 1, file);
@@ -1888,6 +2326,8 @@ void elfWriteResourceIndexToFile(elfResource* resource, unsigned int* offset, FI
 		case ELF_SPRITE:* offset += elfGetSpriteSizeBytes((elfSprite*)resource); break;
 		case ELF_ARMATURE:* offset += elfGetArmatureSizeBytes((elfArmature*)resource); break;
 	}
+
+	*offset = elfAlignPakOffset(*offset);
 }
 
 void elfWriteResourceIndexesToFile(elfList* resources, unsigned int* offset, FILE* file)
@@ -1922,6 +2362,9 @@ void elfWriteResourcesToFile(elfList* resources, FILE* file)
 			case ELF_SPRITE: elfWriteSpriteToFile((elfSprite*)res, file); break;
 			case ELF_ARMATURE: elfWriteArmatureToFile((elfArmature*)res, file); break;
 		}
+
+		// resources start on 4 byte boundaries so arrays and texture blocks in a mapped pak are aligned
+		elfAlignPakFile(file);
 	}
 }
 
@@ -1931,6 +2374,8 @@ void elfAddTextureForSaving(elfList* textures, elfTexture* texture)
 	{
 		if(elfLoadTextureData(texture))
 		{
+			if(eng->config->saveTextureCompress) elfCompressTextureData(texture);
+
 			elfSetResourceUniqueName(textures, (elfResource*)texture);
 			elfAppendListObject(textures, (elfObject*)texture);
 		}
@@ -1947,6 +2392,8 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 	int ival;
 	
 	FILE* file;
+	char* tempPath;
+	unsigned char result;
 
 	elfList* scenes;
 	elfList* scripts;
@@ -1964,8 +2411,10 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 	elfCamera* cam;
 	elfEntity* ent;
 	elfLight* lig;
+	elfArmature* arm;
 	elfParticles* par;
 	elfSprite* spr;
+	int i;
 
 	scenes = elfCreateList();
 	scripts = elfCreateList();
@@ -2006,9 +2455,9 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 		elfAppendListObject(cameras, (elfObject*)cam);
 	}
 
-	for(ent = (elfEntity*)elfBeginList(scene->entities); ent;
-		ent = (elfEntity*)elfGetListNext(scene->entities))
+	for(i = 0; i < scene->entities->length; i++)
 	{
+		ent = (elfEntity*)scene->entities->objs[i];
 		if(ent->script && !elfGetResourceById(scripts, ent->script->id))
 		{
 			elfSetResourceUniqueName(scripts, (elfResource*)ent->script);
@@ -2023,6 +2472,7 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 
 		if(ent->armature && !elfGetResourceById(armatures, ent->armature->id))
 		{
+			elfLoadArmatureFrames(ent->armature);
 			elfSetResourceUniqueName(armatures, (elfResource*)ent->armature);
 			elfAppendListObject(armatures, (elfObject*)ent->armature);
 		}
@@ -2047,9 +2497,9 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 		elfAppendListObject(entities, (elfObject*)ent);
 	}
 
-	for(lig = (elfLight*)elfBeginList(scene->lights); lig;
-		lig = (elfLight*)elfGetListNext(scene->lights))
+	for(i = 0; i < scene->lights->length; i++)
 	{
+		lig = (elfLight*)scene->lights->objs[i];
 		if(lig->script && !elfGetResourceById(scripts, lig->script->id))
 		{
 			elfSetResourceUniqueName(scripts, (elfResource*)lig->script);
@@ -2069,14 +2519,7 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 			elfAppendListObject(scripts, (elfObject*)par->script);
 		}
 
-		if(par->texture && !elfGetResourceById(textures, par->texture->id))
-		{
-			if(elfLoadTextureData(par->texture))
-			{
-				elfSetResourceUniqueName(textures, (elfResource*)par->texture);
-				elfAppendListObject(textures, (elfObject*)par->texture);
-			}
-		}
+		elfAddTextureForSaving(textures, par->texture);
 
 		if(par->model && !elfGetResourceById(models, par->model->id))
 		{
@@ -2094,9 +2537,9 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 		elfAppendListObject(particles, (elfObject*)par);
 	}
 
-	for(spr = (elfSprite*)elfBeginList(scene->sprites); spr;
-		spr = (elfSprite*)elfGetListNext(scene->sprites))
+	for(i = 0; i < scene->sprites->length; i++)
 	{
+		spr = (elfSprite*)scene->sprites->objs[i];
 		if(spr->script && !elfGetResourceById(scripts, spr->script->id))
 		{
 			elfSetResourceUniqueName(scripts, (elfResource*)spr->script);
@@ -2121,10 +2564,18 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 		elfAppendListObject(sprites, (elfObject*)spr);
 	}
 
-	file = fopen(filePath, "wb");
+	// write next to the target and rename it over when done, truncating the file in place
+	// would pull the pages out from under a pak that still has it mapped
+	tempPath = elfMergeStrings(filePath, ".tmp");
+
+	file = fopen(tempPath, "wb");
 	if(!file)
 	{
-		elfSetError(ELF_CANT_OPEN_FILE, "error: can't open file \"%s\" for writing\n", filePath);
+		elfSetError(ELF_CANT_OPEN_FILE, "error: can't open file \"%s\" for writing\n", tempPath);
+		elfDestroyString(tempPath);
+
+		for(arm = (elfArmature*)elfBeginList(armatures); arm;
+			arm = (elfArmature*)elfGetListNext(armatures)) elfUnloadArmatureFrames(arm);
 
 		elfDecRef((elfObject*)scenes);
 		elfDecRef((elfObject*)scripts);
@@ -2160,6 +2611,7 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 	offset += sizeof(int);	// magic
 	offset += sizeof(int);	// version
 	offset += sizeof(int);	// number of indexes
+	offset = elfAlignPakOffset(offset);
 
 	ival = 179532100;
 
@@ -2195,6 +2647,8 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 	elfWriteResourceIndexesToFile(particles, &offset, file);
 	elfWriteResourceIndexesToFile(sprites, &offset, file);
 
+	elfAlignPakFile(file);
+
 	elfWriteResourcesToFile(scenes, file);
 	elfWriteResourcesToFile(scripts, file);
 	elfWriteResourcesToFile(textures, file);
@@ -2209,6 +2663,25 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 
 	fclose(file);
 
+	for(arm = (elfArmature*)elfBeginList(armatures); arm;
+		arm = (elfArmature*)elfGetListNext(armatures)) elfUnloadArmatureFrames(arm);
+
+#ifdef ELF_WINDOWS
+	remove(filePath);
+#endif
+	if(rename(tempPath, filePath))
+	{
+		elfSetError(ELF_CANT_OPEN_FILE, "error: can't replace \"%s\"\n", filePath);
+		remove(tempPath);
+		result = ELF_FALSE;
+	}
+	else
+	{
+		result = ELF_TRUE;
+	}
+
+	elfDestroyString(tempPath);
+
 	elfDecRef((elfObject*)scenes);
 	elfDecRef((elfObject*)scripts);
 	elfDecRef((elfObject*)textures);
@@ -2221,6 +2694,6 @@ unsigned char elfSaveSceneToPak(elfScene* scene, const char* filePath)
 	elfDecRef((elfObject*)particles);
 	elfDecRef((elfObject*)sprites);
 
-	return ELF_TRUE;
+	return result;
 }
 
@@ -1,25 +1,64 @@
 
-elfParticle* elfCreateParticle()
+void elfInitParticlePool(elfParticlePool* pool, int size)
 {
-	elfParticle* particle;
+	if(pool->data) free(pool->data);
 
-	particle = (elfParticle*)malloc(sizeof(elfParticle));
-	memset(particle, 0x0, sizeof(elfParticle));
-	particle->objType = ELF_PARTICLE;
-	particle->objDestr = elfDestroyParticle;
+	// one block, every attribute gets its own contiguous run of floats
+	pool->data = (float*)malloc(sizeof(float)*16*size);
+	memset(pool->data, 0x0, sizeof(float)*16*size);
 
-	elfIncObj(ELF_PARTICLE);
+	pool->positionX = &pool->data[0];
+	pool->positionY = &pool->data[size];
+	pool->positionZ = &pool->data[size*2];
+	pool->velocityX = &pool->data[size*3];
+	pool->velocityY = &pool->data[size*4];
+	pool->velocityZ = &pool->data[size*5];
+	pool->colorR = &pool->data[size*6];
+	pool->colorG = &pool->data[size*7];
+	pool->colorB = &pool->data[size*8];
+	pool->colorA = &pool->data[size*9];
+	pool->size = &pool->data[size*10];
+	pool->sizeGrowth = &pool->data[size*11];
+	pool->rotation = &pool->data[size*12];
+	pool->rotationGrowth = &pool->data[size*13];
+	pool->lifeSpan = &pool->data[size*14];
+	pool->fadeSpeed = &pool->data[size*15];
 
-	return particle;
+	pool->count = 0;
+	pool->simCount = 0;
+	pool->capacity = size;
 }
 
-void elfDestroyParticle(void* data)
+void elfDestroyParticlePool(elfParticlePool* pool)
 {
-	elfParticle* particle = (elfParticle*)data;
+	if(pool->data) free(pool->data);
 
-	free(particle);
+	memset(pool, 0x0, sizeof(elfParticlePool));
+}
+
+void elfRemoveParticle(elfParticlePool* pool, int idx)
+{
+	int last;
+
+	last = --pool->count;
+	if(idx == last) return;
 
-	elfDecObj(ELF_PARTICLE);
+	pool->positionX[idx] = pool->positionX[last];
+	pool->positionY[idx] = pool->positionY[last];
+	pool->positionZ[idx] = pool->positionZ[last];
+	pool->velocityX[idx] = pool->velocityX[last];
+	pool->velocityY[idx] = pool->velocityY[last];
+	pool->velocityZ[idx] = pool->velocityZ[last];
+	pool->colorR[idx] = pool->colorR[last];
+	pool->colorG[idx] = pool->colorG[last];
+	pool->colorB[idx] = pool->colorB[last];
+	pool->colorA[idx] = pool->colorA[last];
+	pool->size[idx] = pool->size[last];
+	pool->sizeGrowth[idx] = pool->sizeGrowth[last];
+	pool->rotation[idx] = pool->rotation[last];
+	pool->rotationGrowth[idx] = pool->rotationGrowth[last];
+	pool->lifeSpan[idx] = pool->lifeSpan[last];
+	pool->fadeSpeed[idx] = pool->fadeSpeed[last];
 }
 
 ELF_API elfParticles* ELF_APIENTRY elfCreateParticles(const char* name, int maxCount)
@@ -39,8 +78,7 @@ ELF_API elfParticles* ELF_APIENTRY elfCreateParticles(const char* name, int maxC
 	elfInitActor((elfActor*)particles, ELF_FALSE);
 
 	particles->maxCount = maxCount;
-	particles->particles = elfCreateList();
-	elfIncRef((elfObject*)particles->particles);
+	elfInitParticlePool(&particles->pool, maxCount);
 
 	particles->drawMode = ELF_ADD;
 	particles->spawnCount = 50;
@@ -139,59 +177,82 @@ ELF_API elfParticles* ELF_APIENTRY elfCreateParticles(const char* name, int maxC
 	return particles;
 }
 
-void elfInitNewParticle(elfParticles* particles, elfParticle* particle)
+void elfInitNewParticle(elfParticles* particles, int idx)
 {
 	static int num;
 	static float* vertices;
 	static elfVec4f orient;
 	static elfVec3f localPos;
 	static elfVec3f result;
+	static elfVec3f normal;
+	elfParticlePool* pool;
+	elfVec3f position;
+	elfModel* model;
+
+	pool = &particles->pool;
 
-	particle->lifeSpan = elfRandomFloatRange(particles->lifeSpanMin, particles->lifeSpanMax);
-	particle->fadeSpeed = elfRandomFloatRange(particles->fadeSpeedMin, particles->fadeSpeedMax);
-	particle->size = elfRandomFloatRange(particles->sizeMin, particles->sizeMax);
-	particle->sizeGrowth = elfRandomFloatRange(particles->sizeGrowthMin, particles->sizeGrowthMax);
-	particle->rotation = elfRandomFloatRange(particles->rotationMin, particles->rotationMax);
-	particle->rotationGrowth = elfRandomFloatRange(particles->rotationGrowthMin, particles->rotationGrowthMax);
+	pool->lifeSpan[idx] = elfRandomFloatRange(particles->lifeSpanMin, particles->lifeSpanMax);
+	pool->fadeSpeed[idx] = elfRandomFloatRange(particles->fadeSpeedMin, particles->fadeSpeedMax);
+	pool->size[idx] = elfRandomFloatRange(particles->sizeMin, particles->sizeMax);
+	pool->sizeGrowth[idx] = elfRandomFloatRange(particles->sizeGrowthMin, particles->sizeGrowthMax);
+	pool->rotation[idx] = elfRandomFloatRange(particles->rotationMin, particles->rotationMax);
+	pool->rotationGrowth[idx] = elfRandomFloatRange(particles->rotationGrowthMin, particles->rotationGrowthMax);
 	if(particles->model && elfGetModelVertexCount(particles->model) > 0)
 	{
-		elfGetActorPosition_((elfActor*)particles, &particle->position.x);
+		elfGetActorPosition_((elfActor*)particles, &position.x);
 		num = elfRandomIntRange(0, elfGetModelVertexCount(particles->model));
 		vertices = elfGetModelVertices(particles->model);
-		particle->position.x += vertices[3*num];
-		particle->position.y += vertices[3*num+1];
-		particle->position.z += vertices[3*num+2];
+		position.x += vertices[3*num];
+		position.y += vertices[3*num+1];
+		position.z += vertices[3*num+2];
 	}
 	else if(particles->entity && particles->entity->model &&
 		elfGetModelVertexCount(particles->entity->model) > 0)
 	{
-		elfGetActorPosition_((elfActor*)particles->entity, &particle->position.x);
+		elfGetActorPosition_((elfActor*)particles->entity, &position.x);
 		num = elfRandomIntRange(0, elfGetModelVertexCount(particles->entity->model));
-		if(!particles->entity->vertices)  vertices = (float*)gfxGetVertexDataBuffer(particles->entity->model->vertices);
-		else vertices = (float*)gfxGetVertexDataBuffer(particles->entity->vertices);
-		localPos.x = vertices[3*num];
-		localPos.y = vertices[3*num+1];
-		localPos.z = vertices[3*num+2];
+		model = particles->entity->model;
+		if(particles->entity->vertices)
+		{
+			vertices = (float*)gfxGetVertexDataBuffer(particles->entity->vertices);
+			memcpy(&localPos.x, &vertices[3*num], sizeof(float)*3);
+		}
+		else if(particles->entity->armature && particles->entity->palette && model->boneids)
+		{
+			// skinned by the shaders, there are no skinned buffers so the emitting vertex is skinned here
+			gfxSkinVertices(particles->entity->palette, particles->entity->paletteSize,
+				&((int*)gfxGetVertexDataBuffer(model->boneids))[4*num], &((float*)gfxGetVertexDataBuffer(model->weights))[4*num],
+				&((float*)gfxGetVertexDataBuffer(model->vertices))[3*num], &((float*)gfxGetVertexDataBuffer(model->normals))[3*num],
+				1, &localPos.x, &normal.x);
+		}
+		else
+		{
+			vertices = (float*)gfxGetVertexDataBuffer(model->vertices);
+			memcpy(&localPos.x, &vertices[3*num], sizeof(float)*3);
+		}
 		elfGetActorOrientation_((elfActor*)particles->entity, &orient.x);
 		gfxMulQuaVec(&orient.x, &localPos.x, &result.x);
-		particle->position.x += result.x;
-		particle->position.y += result.y;
-		particle->position.z += result.z;
+		position.x += result.x;
+		position.y += result.y;
+		position.z += result.z;
 	}
 	else
 	{
-		elfGetActorPosition_((elfActor*)particles, &particle->position.x);
-		particle->position.x += elfRandomFloatRange(particles->positionMin.x, particles->positionMax.x);
-		particle->position.y += elfRandomFloatRange(particles->positionMin.y, particles->positionMax.y);
-		particle->position.z += elfRandomFloatRange(particles->positionMin.z, particles->positionMax.z);
+		elfGetActorPosition_((elfActor*)particles, &position.x);
+		position.x += elfRandomFloatRange(particles->positionMin.x, particles->positionMax.x);
+		position.y += elfRandomFloatRange(particles->positionMin.y, particles->positionMax.y);
+		position.z += elfRandomFloatRange(particles->positionMin.z, particles->positionMax.z);
 	}
-	particle->velocity.x = elfRandomFloatRange(particles->velocityMin.x, particles->velocityMax.x);
-	particle->velocity.y = elfRandomFloatRange(particles->velocityMin.y, particles->velocityMax.y);
-	particle->velocity.z = elfRandomFloatRange(particles->velocityMin.z, particles->velocityMax.z);
-	particle->color.r = elfRandomFloatRange(particles->colorMin.r, particles->colorMax.r);
-	particle->color.g = elfRandomFloatRange(particles->colorMin.g, particles->colorMax.g);
-	particle->color.b = elfRandomFloatRange(particles->colorMin.b, particles->colorMax.b);
-	particle->color.a = elfRandomFloatRange(particles->colorMin.a, particles->colorMax.a);
+	pool->positionX[idx] = position.x;
+	pool->positionY[idx] = position.y;
+	pool->positionZ[idx] = position.z;
+	pool->velocityX[idx] = elfRandomFloatRange(particles->velocityMin.x, particles->velocityMax.x);
+	pool->velocityY[idx] = elfRandomFloatRange(particles->velocityMin.y, particles->velocityMax.y);
+	pool->velocityZ[idx] = elfRandomFloatRange(particles->velocityMin.z, particles->velocityMax.z);
+	pool->colorR[idx] = elfRandomFloatRange(particles->colorMin.r, particles->colorMax.r);
+	pool->colorG[idx] = elfRandomFloatRange(particles->colorMin.g, particles->colorMax.g);
+	pool->colorB[idx] = elfRandomFloatRange(particles->colorMin.b, particles->colorMax.b);
+	pool->colorA[idx] = elfRandomFloatRange(particles->colorMin.a, particles->colorMax.a);
 }
 
 void elfCalcParticlesAabb(elfParticles* particles)
@@ -269,13 +330,16 @@ void elfParticlesPostDraw(elfParticles* particles)
 
 void elfUpdateParticles(elfParticles* particles, float sync)
 {
-	elfParticle* particle;
+	elfParticlePool* pool;
 	int spawnCount;
 	int i;
 
+	pool = &particles->pool;
+
 	elfUpdateActor((elfActor*)particles);
 
-	// update, remove and spawn particles
+	// remove and spawn particles, moving the rest is left to elfSimulateParticles
+	particles->sync = sync;
 	particles->curTime += sync;
 	if(particles->spawnCount == 0)
 	{
@@ -285,59 +349,63 @@ void elfUpdateParticles(elfParticles* particles, float sync)
 	else
 	{
 		spawnCount = (int)(particles->curTime/particles->spawnDelay);
-		if(elfGetListLength(particles->particles)+spawnCount > particles->maxCount)
+		if(pool->count+spawnCount > particles->maxCount)
 		{
-			spawnCount -= (elfGetListLength(particles->particles)+spawnCount)-particles->maxCount;
+			spawnCount -= (pool->count+spawnCount)-particles->maxCount;
 			particles->curTime -= sync;
 		}
 		if(spawnCount > 0) particles->curTime -= particles->spawnDelay*spawnCount;
 	}
 
-	for(particle = (elfParticle*)elfBeginList(particles->particles); particle;
-		particle = (elfParticle*)elfGetListNext(particles->particles))
+	for(i = 0; i < pool->count; i++)
 	{
-		if(particle->lifeSpan < 0.0f || particle->color.a < 0.0f)
+		if(pool->lifeSpan[i] < 0.0f || pool->colorA[i] < 0.0f)
 		{
-			if(spawnCount > 0 && particles->spawn)
-			{
-				elfInitNewParticle(particles, particle);
-				spawnCount--;
-			}
-			else
-			{
-				elfRemoveListObject(particles->particles, (elfObject*)particle);
-			}
-			continue;
+			// the last particle takes the free slot and has to be checked too
+			elfRemoveParticle(pool, i);
+			i--;
 		}
-		particle->size += particle->sizeGrowth*sync;
-		particle->rotation += particle->rotationGrowth*sync;
-		particle->position.x += particle->velocity.x*sync;
-		particle->position.y += particle->velocity.y*sync;
-		particle->position.z += particle->velocity.z*sync;
-		particle->lifeSpan -= sync;
-		particle->velocity.x += particles->gravity.x*sync;
-		particle->velocity.y += particles->gravity.y*sync;
-		particle->velocity.z += particles->gravity.z*sync;
-		particle->color.a -= particle->fadeSpeed*sync;
 	}
 
-	// spawn particles
+	// particles spawned this update start moving on the next one
+	pool->simCount = pool->count;
+
 	if(particles->spawn)
 	{
-		for(i = 0; i < spawnCount; i++)
+		for(i = 0; i < spawnCount && pool->count < pool->capacity; i++)
 		{
-			particle = elfCreateParticle();
-
-			elfInitNewParticle(particles, particle);
-
-			elfAppendListObject(particles->particles, (elfObject*)particle);
+			elfInitNewParticle(particles, pool->count++);
 		}
 	}
 }
 
+void elfSimulateParticles(void* data)
+{
+	elfParticles* particles = (elfParticles*)data;
+	elfParticlePool* pool;
+	float sync;
+	int count;
+
+	pool = &particles->pool;
+	count = pool->simCount;
+	sync = particles->sync;
+
+	// every attribute is a contiguous run of floats, so each step is a single pass over an array
+	gfxMulAddArray(pool->size, pool->sizeGrowth, sync, count);
+	gfxMulAddArray(pool->rotation, pool->rotationGrowth, sync, count);
+	gfxMulAddArray(pool->positionX, pool->velocityX, sync, count);
+	gfxMulAddArray(pool->positionY, pool->velocityY, sync, count);
+	gfxMulAddArray(pool->positionZ, pool->velocityZ, sync, count);
+	gfxAddArray(pool->lifeSpan, -sync, count);
+	gfxAddArray(pool->velocityX, particles->gravity.x*sync, count);
+	gfxAddArray(pool->velocityY, particles->gravity.y*sync, count);
+	gfxAddArray(pool->velocityZ, particles->gravity.z*sync, count);
+	gfxMulAddArray(pool->colorA, pool->fadeSpeed, -sync, count);
+}
+
 void elfDrawParticles(elfParticles* particles, elfCamera* camera, gfxShaderParams* shaderParams)
 {
-	elfParticle* particle;
+	elfParticlePool* pool;
 	int i, j;
 	float offset;
 	float pos[3];
@@ -359,6 +427,8 @@ void elfDrawParticles(elfParticles* particles, elfCamera* camera, gfxShaderParam
 	float* vertexBuffer;
 	float* colorBuffer;
 
+	pool = &particles->pool;
+
 	vertexBuffer = (float*)gfxGetVertexDataBuffer(particles->vertices);
 	colorBuffer = (float*)gfxGetVertexDataBuffer(particles->colors);
 
@@ -373,17 +443,16 @@ void elfDrawParticles(elfParticles* particles, elfCamera* camera, gfxShaderParam
 	if(elfAboutZero(particles->rotationMin) && elfAboutZero(particles->rotationMax) &&
 		elfAboutZero(particles->rotationGrowthMin) && elfAboutZero(particles->rotationGrowthMax))
 	{
-		for(i = 0, j = 0, particle = (elfParticle*)elfBeginList(particles->particles); particle;
-			particle = (elfParticle*)elfGetListNext(particles->particles), i++)
+		for(i = 0; i < pool->count; i++)
 		{
-			particleOffset[0] = invCameraPos[0]+particle->position.x;
-			particleOffset[1] = invCameraPos[1]+particle->position.y;
-			particleOffset[2] = invCameraPos[2]+particle->position.z;
+			particleOffset[0] = invCameraPos[0]+pool->positionX[i];
+			particleOffset[1] = invCameraPos[1]+pool->positionY[i];
+			particleOffset[2] = invCameraPos[2]+pool->positionZ[i];
 
 			gfxMulQuaVec(invCameraOrient, particleOffset, pos);
 
 			j = i*18;
-			offset = particle->size*0.5f;
+			offset = pool->size[i]*0.5f;
 
 			vertexBuffer[j] = pos[0]-offset;
 			vertexBuffer[j+1] = pos[1]+offset;
@@ -406,7 +475,10 @@ void elfDrawParticles(elfParticles* particles, elfCamera* camera, gfxShaderParam
 			vertexBuffer[j+17] = pos[2];
 
 			j = i*24;
-			realColor = particle->color;
+			realColor.r = pool->colorR[i];
+			realColor.g = pool->colorG[i];
+			realColor.b = pool->colorB[i];
+			realColor.a = pool->colorA[i];
 			if(particles->drawMode == ELF_ADD)
 			{
 				realColor.r *= realColor.a;
@@ -434,36 +506,34 @@ void elfDrawParticles(elfParticles* particles, elfCamera* camera, gfxShaderParam
 			colorBuffer[j+16] = realColor.r;
 			colorBuffer[j+17] = realColor.g;
 			colorBuffer[j+18] = realColor.b;
-			colorBuffer[j+19] = particle->color.a;
+			colorBuffer[j+19] = pool->colorA[i];
 			colorBuffer[j+20] = realColor.r;
 			colorBuffer[j+21] = realColor.g;
 			colorBuffer[j+22] = realColor.b;
-			colorBuffer[j+23] = particle->color.a;
+			colorBuffer[j+23] = pool->colorA[i];
 		}
 	}
 	else
 	{
-		for(i = 0, j = 0, particle = (elfParticle*)elfBeginList(particles->particles); particle;
-			particle = (elfParticle*)elfGetListNext(particles->particles), i++)
+		for(i = 0; i < pool->count; i++)
 		{
-
-			particleOffset[0] = invCameraPos[0]+particle->position.x;
-			particleOffset[1] = invCameraPos[1]+particle->position.y;
-			particleOffset[2] = invCameraPos[2]+particle->position.z;
+			particleOffset[0] = invCameraPos[0]+pool->positionX[i];
+			particleOffset[1] = invCameraPos[1]+pool->positionY[i];
+			particleOffset[2] = invCameraPos[2]+pool->positionZ[i];
 
 			gfxMulQuaVec(invCameraOrient, particleOffset, pos);
 
 			j = i*18;
-			offset = particle->size*0.5f;
+			offset = pool->size[i]*0.5f;
 			radius = offset/0.707107f;
-			sinX1 = sin(GFX_PI_DIV_180*(45.0f+particle->rotation));
-			cosY1 = cos(GFX_PI_DIV_180*(45.0f+particle->rotation));
-			sinX2 = sin(GFX_PI_DIV_180*(135.0f+particle->rotation));
-			cosY2 = cos(GFX_PI_DIV_180*(135.0f+particle->rotation));
-			sinX3 = sin(GFX_PI_DIV_180*(225.0f+particle->rotation));
-			cosY3 = cos(GFX_PI_DIV_180*(225.0f+particle->rotation));
-			sinX4 = sin(GFX_PI_DIV_180*(315.0f+particle->rotation));
-			cosY4 = cos(GFX_PI_DIV_180*(315.0f+particle->rotation));
+			sinX1 = sin(GFX_PI_DIV_180*(45.0f+pool->rotation[i]));
+			cosY1 = cos(GFX_PI_DIV_180*(45.0f+pool->rotation[i]));
+			sinX2 = sin(GFX_PI_DIV_180*(135.0f+pool->rotation[i]));
+			cosY2 = cos(GFX_PI_DIV_180*(135.0f+pool->rotation[i]));
+			sinX3 = sin(GFX_PI_DIV_180*(225.0f+pool->rotation[i]));
+			cosY3 = cos(GFX_PI_DIV_180*(225.0f+pool->rotation[i]));
+			sinX4 = sin(GFX_PI_DIV_180*(315.0f+pool->rotation[i]));
+			cosY4 = cos(GFX_PI_DIV_180*(315.0f+pool->rotation[i]));
 
 			vertexBuffer[j] = pos[0]+radius*sinX4;
 			vertexBuffer[j+1] = pos[1]+radius*cosY4;
@@ -486,7 +556,10 @@ void elfDrawParticles(elfParticles* particles, elfCamera* camera, gfxShaderParam
 			vertexBuffer[j+17] = pos[2];
 
 			j = i*24;
-			realColor = particle->color;
+			realColor.r = pool->colorR[i];
+			realColor.g = pool->colorG[i];
+			realColor.b = pool->colorB[i];
+			realColor.a = pool->colorA[i];
 			if(particles->drawMode == ELF_ADD)
 			{
 				realColor.r *= realColor.a;
@@ -514,15 +587,15 @@ void elfDrawParticles(elfParticles* particles, elfCamera* camera, gfxShaderParam
 			colorBuffer[j+16] = realColor.r;
 			colorBuffer[j+17] = realColor.g;
 			colorBuffer[j+18] = realColor.b;
-			colorBuffer[j+19] = particle->color.a;
+			colorBuffer[j+19] = pool->colorA[i];
 			colorBuffer[j+20] = realColor.r;
 			colorBuffer[j+21] = realColor.g;
 			colorBuffer[j+22] = realColor.b;
-			colorBuffer[j+23] = particle->color.a;
+			colorBuffer[j+23] = pool->colorA[i];
 		}
 	}
 
-	if(elfGetListLength(particles->particles) > 0)
+	if(pool->count > 0)
 	{
 		shaderParams->renderParams.blendMode = particles->drawMode;
 		shaderParams->renderParams.vertexColor = GFX_TRUE;
@@ -532,7 +605,7 @@ void elfDrawParticles(elfParticles* particles, elfCamera* camera, gfxShaderParam
 		shaderParams->textureParams->type = GFX_COLOR_MAP;
 		gfxSetShaderParams(shaderParams);
 
-		gfxDrawVertexArray(particles->vertexArray, 6*elfGetListLength(particles->particles), GFX_TRIANGLES);
+		gfxDrawVertexArray(particles->vertexArray, 6*pool->count, GFX_TRIANGLES);
 	}
 }
 
@@ -613,7 +686,7 @@ void elfDestroyParticles(void* data)
 
 	elfCleanActor((elfActor*)particles);
 
-	elfDecRef((elfObject*)particles->particles);
+	elfDestroyParticlePool(&particles->pool);
 	if(particles->texture) elfDecRef((elfObject*)particles->texture);
 	if(particles->model) elfDecRef((elfObject*)particles->model);
 	if(particles->entity) elfDecRef((elfObject*)particles->entity);
@@ -648,9 +721,7 @@ ELF_API void ELF_APIENTRY elfSetParticlesMaxCount(elfParticles* particles, int m
 
 	particles->maxCount = maxCount;
 
-	elfDecRef((elfObject*)particles->particles);
-	particles->particles = elfCreateList();
-	elfIncRef((elfObject*)particles->particles);
+	elfInitParticlePool(&particles->pool, maxCount);
 
 	gfxDecRef((gfxObject*)particles->vertices);
 	gfxDecRef((gfxObject*)particles->texCoords);
@@ -901,7 +972,7 @@ ELF_API int ELF_APIENTRY elfGetParticlesMaxCount(elfParticles* particles)
 
 ELF_API int ELF_APIENTRY elfGetParticlesCount(elfParticles* particles)
 {
-	return elfGetListLength(particles->particles);
+	return particles->pool.count;
 }
 
 ELF_API int ELF_APIENTRY elfGetParticlesDrawMode(elfParticles* particles)
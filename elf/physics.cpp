@@ -143,7 +143,7 @@ void elfDestroyPhysicsWorld(void* data)
 	elfDecObj(ELF_PHYSICS_WORLD);
 }
 
-void elfUpdatePhysicsWorld(elfPhysicsWorld* world, float time)
+void elfUpdatePhysicsWorld(elfPhysicsWorld* world, float time, unsigned char fixed)
 {
 	int manifoldCount;
 	int contactCount;
@@ -155,7 +155,10 @@ void elfUpdatePhysicsWorld(elfPhysicsWorld* world, float time)
 	elfCollision* col1;
 	int i, j;
 
-	world->world->stepSimulation(time, 4);
+	// a fixed engine step is simulated as exactly one bullet substep of the same length,
+	// so bullet's own accumulator never carries time over between ticks
+	if(fixed) world->world->stepSimulation(time, 1, time);
+	else world->world->stepSimulation(time, 4);
 
 	manifoldCount = world->dispatcher->getNumManifolds();
 	contactCount = 0;
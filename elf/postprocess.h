@@ -368,7 +368,7 @@ void elfRunPostProcess(elfPostProcess* postProcess, elfScene* scene)
 	elfEntity* ent;
 	elfSprite* spr;
 	elfLight* light;
-	int i;
+	int i, j;
 	elfVec3f lightPos;
 	elfVec3f lightScreenPos;
 	elfVec3f camPos;
@@ -601,9 +601,9 @@ void elfRunPostProcess(elfPostProcess* postProcess, elfScene* scene)
 
 	if(postProcess->lightShafts && scene->curCamera)
 	{
-		for(light = (elfLight*)elfBeginList(scene->lights); light;
-			light = (elfLight*)elfGetListNext(scene->lights))
+		for(j = 0; j < scene->lights->length; j++)
 		{
+			light = (elfLight*)scene->lights->objs[j];
 			lightPos = elfGetActorPosition((elfActor*)light);
 			if(light->shaft && elfSphereInsideFrustum(scene->curCamera, &lightPos.x, light->shaftSize))
 			{
@@ -621,17 +621,15 @@ void elfRunPostProcess(elfPostProcess* postProcess, elfScene* scene)
 					scene->shaderParams.renderParams.colorWrite = ELF_FALSE;
 					scene->shaderParams.renderParams.alphaWrite = ELF_FALSE;
 
-					for(i = 0, ent = (elfEntity*)elfBeginList(scene->entityQueue);
-						i < scene->entityQueueCount && ent != NULL;
-						i++, ent = (elfEntity*)elfGetListNext(scene->entityQueue))
+					for(i = 0; i < scene->entityQueue->length; i++)
 					{
+						ent = (elfEntity*)scene->entityQueue->objs[i];
 						elfDrawEntity(ent, ELF_DRAW_DEPTH, &scene->shaderParams);
 					}
 
-					for(i = 0, spr = (elfSprite*)elfBeginList(scene->spriteQueue);
-						i < scene->spriteQueueCount && spr != NULL;
-						i++, spr = (elfSprite*)elfGetListNext(scene->spriteQueue))
+					for(i = 0; i < scene->spriteQueue->length; i++)
 					{
+						spr = (elfSprite*)scene->spriteQueue->objs[i];
 						elfDrawSprite(spr, ELF_DRAW_DEPTH, &scene->shaderParams);
 					}
 
@@ -0,0 +1,280 @@
+
+elfProfiler* elfCreateProfiler()
+{
+	elfProfiler* profiler;
+
+	profiler = (elfProfiler*)malloc(sizeof(elfProfiler));
+	memset(profiler, 0x0, sizeof(elfProfiler));
+	profiler->objType = ELF_PROFILER;
+	profiler->objDestr = elfDestroyProfiler;
+
+	elfIncObj(ELF_PROFILER);
+
+	return profiler;
+}
+
+void elfDestroyProfiler(void* data)
+{
+	elfProfiler* profiler = (elfProfiler*)data;
+
+	free(profiler);
+
+	elfDecObj(ELF_PROFILER);
+}
+
+void elfBeginProfileFrame(elfProfiler* profiler)
+{
+	elfProfileFrame* frame;
+
+	profiler->recording = profiler->enabled;
+	if(!profiler->recording) return;
+
+	frame = &profiler->frames[profiler->frameIndex];
+	memset(frame, 0x0, sizeof(elfProfileFrame));
+	frame->start = elfGetTime();
+
+	profiler->depth = 0;
+}
+
+void elfEndProfileFrame(elfProfiler* profiler)
+{
+	elfProfileFrame* frame;
+
+	if(!profiler->recording) return;
+
+	// scopes left open by an early return end with the frame
+	while(profiler->depth > 0) elfEndProfileScope();
+
+	frame = &profiler->frames[profiler->frameIndex];
+	frame->end = elfGetTime();
+
+	frame->drawCalls = gfxGetDrawCalls();
+	frame->shaderSwitches = gfxGetShaderSwitches();
+	frame->textureSwitches = gfxGetTextureSwitches();
+	frame->blendSwitches = gfxGetBlendSwitches();
+	frame->uploads = gfxGetUploads();
+
+	profiler->frameIndex = (profiler->frameIndex+1)%ELF_PROFILE_FRAMES;
+	if(profiler->frameCount < ELF_PROFILE_FRAMES) profiler->frameCount++;
+
+	profiler->recording = ELF_FALSE;
+}
+
+void elfBeginProfileScope(const char* name)
+{
+	elfProfiler* profiler = eng->profiler;
+	elfProfileFrame* frame;
+	elfProfileScope* scope;
+	int i;
+
+	if(!profiler->recording) return;
+
+	frame = &profiler->frames[profiler->frameIndex];
+
+	// past the limits the scope is only counted, so the matching end still pops the right entry
+	if(profiler->depth >= ELF_MAX_PROFILE_DEPTH || frame->scopeCount >= ELF_MAX_PROFILE_SCOPES)
+	{
+		if(profiler->depth < ELF_MAX_PROFILE_DEPTH) profiler->stack[profiler->depth] = -1;
+		profiler->depth++;
+		return;
+	}
+
+	scope = &frame->scopes[frame->scopeCount];
+
+	// the name is copied since actor names may go away before the trace is saved
+	for(i = 0; name && name[i] != '\0' && i < (int)sizeof(scope->name)-1; i++)
+		scope->name[i] = (name[i] == '"' || name[i] == '\\' || name[i] < ' ') ? '_' : name[i];
+	scope->name[i] = '\0';
+
+	scope->depth = profiler->depth;
+	scope->start = elfGetTime();
+	scope->end = scope->start;
+
+	profiler->stack[profiler->depth] = frame->scopeCount;
+	profiler->depth++;
+	frame->scopeCount++;
+}
+
+void elfEndProfileScope()
+{
+	elfProfiler* profiler = eng->profiler;
+	elfProfileFrame* frame;
+	int idx;
+
+	if(!profiler->recording || profiler->depth < 1) return;
+
+	profiler->depth--;
+	if(profiler->depth >= ELF_MAX_PROFILE_DEPTH) return;
+
+	idx = profiler->stack[profiler->depth];
+	if(idx < 0) return;
+
+	frame = &profiler->frames[profiler->frameIndex];
+	frame->scopes[idx].end = elfGetTime();
+}
+
+elfProfileFrame* elfGetLastProfileFrame()
+{
+	if(!eng->profiler->frameCount) return NULL;
+	return &eng->profiler->frames[(eng->profiler->frameIndex+ELF_PROFILE_FRAMES-1)%ELF_PROFILE_FRAMES];
+}
+
+ELF_API void ELF_APIENTRY elfSetProfiling(unsigned char enabled)
+{
+	eng->profiler->enabled = !enabled == ELF_FALSE;
+	if(!eng->profiler->enabled) eng->profiler->recording = ELF_FALSE;
+}
+
+ELF_API unsigned char ELF_APIENTRY elfIsProfiling()
+{
+	return eng->profiler->enabled;
+}
+
+ELF_API void ELF_APIENTRY elfClearProfile()
+{
+	eng->profiler->frameIndex = 0;
+	eng->profiler->frameCount = 0;
+	eng->profiler->recording = ELF_FALSE;
+}
+
+ELF_API int ELF_APIENTRY elfGetProfileFrameCount()
+{
+	return eng->profiler->frameCount;
+}
+
+ELF_API float ELF_APIENTRY elfGetProfileFrameTime()
+{
+	elfProfileFrame* frame;
+
+	if(!(frame = elfGetLastProfileFrame())) return 0.0f;
+
+	return (float)((frame->end-frame->start)*1000.0);
+}
+
+ELF_API int ELF_APIENTRY elfGetProfileScopeCount()
+{
+	elfProfileFrame* frame;
+
+	if(!(frame = elfGetLastProfileFrame())) return 0;
+
+	return frame->scopeCount;
+}
+
+ELF_API const char* ELF_APIENTRY elfGetProfileScopeName(int idx)
+{
+	elfProfileFrame* frame;
+
+	if(!(frame = elfGetLastProfileFrame()) || idx < 0 || idx >= frame->scopeCount) return "";
+
+	return frame->scopes[idx].name;
+}
+
+ELF_API float ELF_APIENTRY elfGetProfileScopeTime(int idx)
+{
+	elfProfileFrame* frame;
+
+	if(!(frame = elfGetLastProfileFrame()) || idx < 0 || idx >= frame->scopeCount) return 0.0f;
+
+	return (float)((frame->scopes[idx].end-frame->scopes[idx].start)*1000.0);
+}
+
+ELF_API int ELF_APIENTRY elfGetProfileScopeDepth(int idx)
+{
+	elfProfileFrame* frame;
+
+	if(!(frame = elfGetLastProfileFrame()) || idx < 0 || idx >= frame->scopeCount) return 0;
+
+	return frame->scopes[idx].depth;
+}
+
+ELF_API float ELF_APIENTRY elfGetProfileTime(const char* name)
+{
+	elfProfileFrame* frame;
+	double time;
+	int i;
+
+	// scopes that run several times in a frame, like the fixed steps or the lights, are summed up
+	if(!(frame = elfGetLastProfileFrame()) || !name) return 0.0f;
+
+	time = 0.0;
+	for(i = 0; i < frame->scopeCount; i++)
+	{
+		if(!strcmp(frame->scopes[i].name, name)) time += frame->scopes[i].end-frame->scopes[i].start;
+	}
+
+	return (float)(time*1000.0);
+}
+
+ELF_API int ELF_APIENTRY elfGetProfileDrawCalls()
+{
+	elfProfileFrame* frame;
+
+	if(!(frame = elfGetLastProfileFrame())) return 0;
+
+	return frame->drawCalls;
+}
+
+ELF_API int ELF_APIENTRY elfGetProfileStateChanges()
+{
+	elfProfileFrame* frame;
+
+	if(!(frame = elfGetLastProfileFrame())) return 0;
+
+	return frame->shaderSwitches+frame->textureSwitches+frame->blendSwitches;
+}
+
+ELF_API int ELF_APIENTRY elfGetProfileUploads()
+{
+	elfProfileFrame* frame;
+
+	if(!(frame = elfGetLastProfileFrame())) return 0;
+
+	return frame->uploads;
+}
+
+ELF_API unsigned char ELF_APIENTRY elfSaveProfileTrace(const char* filePath)
+{
+	elfProfileFrame* frame;
+	elfProfileScope* scope;
+	FILE* file;
+	unsigned char first;
+	int i, j;
+
+	file = fopen(filePath, "w");
+	if(!file)
+	{
+		elfSetError(ELF_CANT_OPEN_FILE, "error: can't open file \"%s\" for writing\n", filePath);
+		return ELF_FALSE;
+	}
+
+	// chrome://tracing format, timestamps and durations are in microseconds
+	fprintf(file, "{\"traceEvents\":[\n");
+
+	first = ELF_TRUE;
+	for(i = 0; i < eng->profiler->frameCount; i++)
+	{
+		frame = &eng->profiler->frames[(eng->profiler->frameIndex+ELF_PROFILE_FRAMES-eng->profiler->frameCount+i)%ELF_PROFILE_FRAMES];
+
+		fprintf(file, "%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+			first ? "" : ",\n", frame->start*1000000.0, (frame->end-frame->start)*1000000.0);
+		first = ELF_FALSE;
+
+		for(j = 0; j < frame->scopeCount; j++)
+		{
+			scope = &frame->scopes[j];
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+				scope->name, scope->start*1000000.0, (scope->end-scope->start)*1000000.0);
+		}
+
+		fprintf(file, ",\n{\"name\":\"gfx\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"drawCalls\":%d,\"shaderSwitches\":%d,\"textureSwitches\":%d,\"blendSwitches\":%d,\"uploads\":%d}}",
+			frame->start*1000000.0, frame->drawCalls, frame->shaderSwitches,
+			frame->textureSwitches, frame->blendSwitches, frame->uploads);
+	}
+
+	fprintf(file, "\n]}\n");
+
+	fclose(file);
+
+	return ELF_TRUE;
+}
+
@@ -254,6 +254,7 @@ elfRenderStation* elfCreateRenderStation()
 void elfDestroyRenderStation(void* data)
 {
 	elfRenderStation* rs = (elfRenderStation*)data;
+	int i;
 
 	gfxDecRef((gfxObject*)rs->shadowMap);
 	gfxDecRef((gfxObject*)rs->shadowTarget);
@@ -280,6 +281,8 @@ void elfDestroyRenderStation(void* data)
 	gfxDecRef((gfxObject*)rs->gradientColorData);
 	gfxDecRef((gfxObject*)rs->gradientVertexArray);
 
+	for(i = 0; i < ELF_MAX_TEXT_BATCHES; i++) elfDestroyTextBatch(&rs->textBatches[i]);
+
 	elfDecObj(ELF_RENDER_STATION);
 
 	free(rs);
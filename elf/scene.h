@@ -9,6 +9,22 @@ const char* composeFogVert =
 "\tgl_Position = elf_ProjectionMatrix*(elf_ModelviewMatrix*vec4(elf_VertexAttr, 1.0))\n;"
 "}\n";
 
+const char* composeFogSkinVert =
+"attribute vec3 elf_VertexAttr;\n"
+"attribute vec4 elf_WeightsAttr;\n"
+"attribute vec4 elf_BoneIdsAttr;\n"
+"uniform mat4 elf_BonePalette[%d];\n"
+"uniform mat4 elf_ModelviewMatrix;\n"
+"uniform mat4 elf_ProjectionMatrix;\n"
+"void main()\n"
+"{\n"
+"\tmat4 skinMatrix = elf_BonePalette[int(elf_BoneIdsAttr.x)]*elf_WeightsAttr.x;\n"
+"\tskinMatrix += elf_BonePalette[int(elf_BoneIdsAttr.y)]*elf_WeightsAttr.y;\n"
+"\tskinMatrix += elf_BonePalette[int(elf_BoneIdsAttr.z)]*elf_WeightsAttr.z;\n"
+"\tskinMatrix += elf_BonePalette[int(elf_BoneIdsAttr.w)]*elf_WeightsAttr.w;\n"
+"\tgl_Position = elf_ProjectionMatrix*(elf_ModelviewMatrix*vec4((skinMatrix*vec4(elf_VertexAttr, 1.0)).xyz, 1.0));\n"
+"}\n";
+
 const char* composeFogFrag =
 "uniform float elf_FogStart;\n"
 "uniform float elf_FogEnd;\n"
@@ -21,6 +37,7 @@ const char* composeFogFrag =
 ELF_API elfScene* ELF_APIENTRY elfCreateScene(const char* name)
 {
 	elfScene* scene;
+	char skinVert[1024];
 
 	scene = (elfScene*)malloc(sizeof(elfScene));
 	memset(scene, 0x0, sizeof(elfScene));
@@ -32,13 +49,14 @@ ELF_API elfScene* ELF_APIENTRY elfCreateScene(const char* name)
 	scene->textures = elfCreateList();
 	scene->materials = elfCreateList();
 	scene->cameras = elfCreateList();
-	scene->entities = elfCreateList();
-	scene->lights = elfCreateList();
+	scene->entities = elfCreateArray(ELF_TRUE);
+	scene->lights = elfCreateArray(ELF_TRUE);
 	scene->armatures = elfCreateList();
 	scene->particles = elfCreateList();
-	scene->sprites = elfCreateList();
-	scene->entityQueue = elfCreateList();
-	scene->spriteQueue = elfCreateList();
+	scene->sprites = elfCreateArray(ELF_TRUE);
+	scene->entityQueue = elfCreateArray(ELF_FALSE);
+	scene->spriteQueue = elfCreateArray(ELF_FALSE);
+	scene->skinQueue = elfCreateArray(ELF_FALSE);
 
 	elfIncRef((elfObject*)scene->models);
 	elfIncRef((elfObject*)scene->scripts);
@@ -52,6 +70,7 @@ ELF_API elfScene* ELF_APIENTRY elfCreateScene(const char* name)
 	elfIncRef((elfObject*)scene->sprites);
 	elfIncRef((elfObject*)scene->entityQueue);
 	elfIncRef((elfObject*)scene->spriteQueue);
+	elfIncRef((elfObject*)scene->skinQueue);
 
 	gfxSetShaderParamsDefault(&scene->shaderParams);
 
@@ -65,6 +84,12 @@ ELF_API elfScene* ELF_APIENTRY elfCreateScene(const char* name)
 
 	scene->composeFogShdr = gfxCreateShaderProgram(composeFogVert, composeFogFrag);
 
+	if(gfxGetMaxBones() > 0)
+	{
+		sprintf(skinVert, composeFogSkinVert, gfxGetMaxBones());
+		scene->composeFogSkinShdr = gfxCreateShaderProgram(skinVert, composeFogFrag);
+	}
+
 	scene->id = ++res->sceneIdCounter;
 
 	elfIncObj(ELF_SCENE);
@@ -400,10 +425,14 @@ void elfUpdateScene(elfScene* scene, float sync)
 	float vecY[3] = {0.0f, 1.0f, -1.0f};
 	float frontUpVec[6];
 
+	elfBeginProfileScope("update scene");
+
 	if(sync > 0.0f)
 	{
-		if(scene->physics) elfUpdatePhysicsWorld(scene->world, sync);
-		elfUpdatePhysicsWorld(scene->dworld, sync);
+		elfBeginProfileScope("physics");
+		if(scene->physics) elfUpdatePhysicsWorld(scene->world, sync, !elfAboutZero(eng->config->stepRate));
+		elfUpdatePhysicsWorld(scene->dworld, sync, !elfAboutZero(eng->config->stepRate));
+		elfEndProfileScope();
 	}
 
 	if(scene->curCamera)
@@ -423,14 +452,16 @@ void elfUpdateScene(elfScene* scene, float sync)
 		elfUpdateCamera(cam);
 	}
 
-	for(ent = (elfEntity*)elfBeginList(scene->entities); ent != NULL;
-		ent = (elfEntity*)elfGetListNext(scene->entities))
+	// scripts may remove any actor while they run, the array passes keep the ones still to come
+	// in front of the cursor and the removed current one alive until they move past it
+	for(ent = (elfEntity*)elfBeginArray(scene->entities); ent != NULL;
+		ent = (elfEntity*)elfGetArrayNext(scene->entities))
 	{
 		elfUpdateEntity(ent);
 	}
 
-	for(light = (elfLight*)elfBeginList(scene->lights); light != NULL;
-		light = (elfLight*)elfGetListNext(scene->lights))
+	for(light = (elfLight*)elfBeginArray(scene->lights); light != NULL;
+		light = (elfLight*)elfGetArrayNext(scene->lights))
 	{
 		elfUpdateLight(light);
 	}
@@ -441,11 +472,22 @@ void elfUpdateScene(elfScene* scene, float sync)
 		elfUpdateParticles(par, sync);
 	}
 
-	for(spr = (elfSprite*)elfBeginList(scene->sprites); spr != NULL;
-		spr = (elfSprite*)elfGetListNext(scene->sprites))
+	// the emitters only touch their own particles once spawning is done, so they are simulated in parallel
+	for(par = (elfParticles*)elfBeginList(scene->particles); par != NULL;
+		par = (elfParticles*)elfGetListNext(scene->particles))
+	{
+		elfAddJob(eng->jobs, elfSimulateParticles, par);
+	}
+
+	elfWaitJobs(eng->jobs);
+
+	for(spr = (elfSprite*)elfBeginArray(scene->sprites); spr != NULL;
+		spr = (elfSprite*)elfGetArrayNext(scene->sprites))
 	{
 		elfUpdateSprite(spr);
 	}
+
+	elfEndProfileScope();
 }
 
 void elfScenePreDraw(elfScene* scene)
@@ -455,6 +497,9 @@ void elfScenePreDraw(elfScene* scene)
 	elfLight* light;
 	elfSprite* spr;
 	elfParticles* par;
+	int i;
+
+	elfBeginProfileScope("pre draw");
 
 	for(cam = (elfCamera*)elfBeginList(scene->cameras); cam != NULL;
 		cam = (elfCamera*)elfGetListNext(scene->cameras))
@@ -462,21 +507,26 @@ void elfScenePreDraw(elfScene* scene)
 		elfCameraPreDraw(cam);
 	}
 
-	for(ent = (elfEntity*)elfBeginList(scene->entities); ent != NULL;
-		ent = (elfEntity*)elfGetListNext(scene->entities))
+	for(i = 0; i < scene->entities->length; i++)
 	{
+		ent = (elfEntity*)scene->entities->objs[i];
 		elfEntityPreDraw(ent);
+		if(ent->skinPending)
+		{
+			elfAppendArrayObject(scene->skinQueue, (elfObject*)ent);
+			elfAddJob(eng->jobs, elfSkinEntity, ent);
+		}
 	}
 
-	for(light = (elfLight*)elfBeginList(scene->lights); light != NULL;
-		light = (elfLight*)elfGetListNext(scene->lights))
+	for(i = 0; i < scene->lights->length; i++)
 	{
+		light = (elfLight*)scene->lights->objs[i];
 		elfLightPreDraw(light);
 	}
 
-	for(spr = (elfSprite*)elfBeginList(scene->sprites); spr != NULL;
-		spr = (elfSprite*)elfGetListNext(scene->sprites))
+	for(i = 0; i < scene->sprites->length; i++)
 	{
+		spr = (elfSprite*)scene->sprites->objs[i];
 		elfSpritePreDraw(spr, scene->curCamera);
 	}
 
@@ -485,6 +535,19 @@ void elfScenePreDraw(elfScene* scene)
 	{
 		elfParticlesPreDraw(par);
 	}
+
+	// the skinned vertices can only be uploaded from the main thread
+	elfWaitJobs(eng->jobs);
+
+	for(i = 0; i < scene->skinQueue->length; i++)
+	{
+		ent = (elfEntity*)scene->skinQueue->objs[i];
+		elfFinishEntitySkinning(ent);
+	}
+
+	elfClearArray(scene->skinQueue);
+
+	elfEndProfileScope();
 }
 
 void elfScenePostDraw(elfScene* scene)
@@ -494,6 +557,7 @@ void elfScenePostDraw(elfScene* scene)
 	elfLight* light;
 	elfSprite* spr;
 	elfParticles* par;
+	int i;
 
 	for(cam = (elfCamera*)elfBeginList(scene->cameras); cam != NULL;
 		cam = (elfCamera*)elfGetListNext(scene->cameras))
@@ -501,21 +565,21 @@ void elfScenePostDraw(elfScene* scene)
 		elfCameraPostDraw(cam);
 	}
 
-	for(ent = (elfEntity*)elfBeginList(scene->entities); ent != NULL;
-		ent = (elfEntity*)elfGetListNext(scene->entities))
+	for(i = 0; i < scene->entities->length; i++)
 	{
+		ent = (elfEntity*)scene->entities->objs[i];
 		elfEntityPostDraw(ent);
 	}
 
-	for(light = (elfLight*)elfBeginList(scene->lights); light != NULL;
-		light = (elfLight*)elfGetListNext(scene->lights))
+	for(i = 0; i < scene->lights->length; i++)
 	{
+		light = (elfLight*)scene->lights->objs[i];
 		elfLightPostDraw(light);
 	}
 
-	for(spr = (elfSprite*)elfBeginList(scene->sprites); spr != NULL;
-		spr = (elfSprite*)elfGetListNext(scene->sprites))
+	for(i = 0; i < scene->sprites->length; i++)
 	{
+		spr = (elfSprite*)scene->sprites->objs[i];
 		elfSpritePostDraw(spr);
 	}
 
@@ -526,28 +590,122 @@ void elfScenePostDraw(elfScene* scene)
 	}
 }
 
+void elfStoreSceneStep(elfScene* scene)
+{
+	elfCamera* cam;
+	elfParticles* par;
+	int i;
+
+	for(cam = (elfCamera*)elfBeginList(scene->cameras); cam != NULL;
+		cam = (elfCamera*)elfGetListNext(scene->cameras))
+	{
+		elfStoreActorStep((elfActor*)cam);
+	}
+
+	for(i = 0; i < scene->entities->length; i++)
+		elfStoreActorStep((elfActor*)scene->entities->objs[i]);
+
+	for(i = 0; i < scene->lights->length; i++)
+		elfStoreActorStep((elfActor*)scene->lights->objs[i]);
+
+	for(i = 0; i < scene->sprites->length; i++)
+		elfStoreActorStep((elfActor*)scene->sprites->objs[i]);
+
+	for(par = (elfParticles*)elfBeginList(scene->particles); par != NULL;
+		par = (elfParticles*)elfGetListNext(scene->particles))
+	{
+		elfStoreActorStep((elfActor*)par);
+	}
+}
+
+void elfInterpolateScene(elfScene* scene, float alpha)
+{
+	elfCamera* cam;
+	elfParticles* par;
+	int i;
+
+	for(cam = (elfCamera*)elfBeginList(scene->cameras); cam != NULL;
+		cam = (elfCamera*)elfGetListNext(scene->cameras))
+	{
+		elfInterpolateActor((elfActor*)cam, alpha);
+	}
+
+	for(i = 0; i < scene->entities->length; i++)
+		elfInterpolateActor((elfActor*)scene->entities->objs[i], alpha);
+
+	for(i = 0; i < scene->lights->length; i++)
+		elfInterpolateActor((elfActor*)scene->lights->objs[i], alpha);
+
+	for(i = 0; i < scene->sprites->length; i++)
+		elfInterpolateActor((elfActor*)scene->sprites->objs[i], alpha);
+
+	for(par = (elfParticles*)elfBeginList(scene->particles); par != NULL;
+		par = (elfParticles*)elfGetListNext(scene->particles))
+	{
+		elfInterpolateActor((elfActor*)par, alpha);
+	}
+}
+
+void elfRestoreSceneStep(elfScene* scene)
+{
+	elfCamera* cam;
+	elfParticles* par;
+	int i;
+
+	for(cam = (elfCamera*)elfBeginList(scene->cameras); cam != NULL;
+		cam = (elfCamera*)elfGetListNext(scene->cameras))
+	{
+		elfRestoreActorStep((elfActor*)cam);
+	}
+
+	for(i = 0; i < scene->entities->length; i++)
+		elfRestoreActorStep((elfActor*)scene->entities->objs[i]);
+
+	for(i = 0; i < scene->lights->length; i++)
+		elfRestoreActorStep((elfActor*)scene->lights->objs[i]);
+
+	for(i = 0; i < scene->sprites->length; i++)
+		elfRestoreActorStep((elfActor*)scene->sprites->objs[i]);
+
+	for(par = (elfParticles*)elfBeginList(scene->particles); par != NULL;
+		par = (elfParticles*)elfGetListNext(scene->particles))
+	{
+		elfRestoreActorStep((elfActor*)par);
+	}
+}
+
 void elfDestroyScene(void* data)
 {
 	elfScene* scene = (elfScene*)data;
 
 	elfActor* actor;
+	elfPakIndex* index;
+	int i;
 
 	if(scene->name) elfDestroyString(scene->name);
 	if(scene->filePath) elfDestroyString(scene->filePath);
 
 	if(scene->entityQueue) elfDecRef((elfObject*)scene->entityQueue);
 	if(scene->spriteQueue) elfDecRef((elfObject*)scene->spriteQueue);
+	if(scene->skinQueue) elfDecRef((elfObject*)scene->skinQueue);
+	if(scene->renderQueue) free(scene->renderQueue);
+	if(scene->instances) free(scene->instances);
+	if(scene->instanceMatrices) free(scene->instanceMatrices);
+
+	elfDestroyCullBatch(&scene->entityBatch);
+	elfDestroyCullBatch(&scene->queueBatch);
+	elfDestroyBvh(&scene->bvh);
 
 	for(actor = (elfActor*)elfBeginList(scene->cameras); actor;
 		actor = (elfActor*)elfGetListNext(scene->cameras)) elfRemoveActor(actor);
-	for(actor = (elfActor*)elfBeginList(scene->entities); actor;
-		actor = (elfActor*)elfGetListNext(scene->entities)) elfRemoveActor(actor);
-	for(actor = (elfActor*)elfBeginList(scene->lights); actor;
-		actor = (elfActor*)elfGetListNext(scene->lights)) elfRemoveActor(actor);
+	for(i = 0; i < scene->entities->length; i++)
+		elfRemoveActor((elfActor*)scene->entities->objs[i]);
+	for(i = 0; i < scene->lights->length; i++)
+		elfRemoveActor((elfActor*)scene->lights->objs[i]);
 	for(actor = (elfActor*)elfBeginList(scene->particles); actor;
 		actor = (elfActor*)elfGetListNext(scene->particles)) elfRemoveActor(actor);
-	for(actor = (elfActor*)elfBeginList(scene->sprites); actor;
-		actor = (elfActor*)elfGetListNext(scene->sprites)) elfRemoveActor(actor);
+	for(i = 0; i < scene->sprites->length; i++)
+		elfRemoveActor((elfActor*)scene->sprites->objs[i]);
 
 	if(scene->models) elfDecRef((elfObject*)scene->models);
 	if(scene->scripts) elfDecRef((elfObject*)scene->scripts);
@@ -563,9 +721,20 @@ void elfDestroyScene(void* data)
 	elfDestroyPhysicsWorld(scene->world);
 	elfDestroyPhysicsWorld(scene->dworld);
 
-	if(scene->pak) elfDecRef((elfObject*)scene->pak);
+	if(scene->pak)
+	{
+		// whoever still holds the pak must not find this scene's objects on its indexes
+		for(index = (elfPakIndex*)elfBeginList(scene->pak->indexes); index;
+			index = (elfPakIndex*)elfGetListNext(scene->pak->indexes))
+		{
+			index->object = NULL;
+		}
+
+		elfDecRef((elfObject*)scene->pak);
+	}
 
 	if(scene->composeFogShdr) gfxDestroyShaderProgram(scene->composeFogShdr);
+	if(scene->composeFogSkinShdr) gfxDestroyShaderProgram(scene->composeFogSkinShdr);
 
 	elfDecObj(ELF_SCENE);
 
@@ -624,6 +793,17 @@ ELF_API unsigned char ELF_APIENTRY elfGetSceneOcclusionCulling(elfScene* scene)
 	return scene->occlusionCulling;
 }
 
+ELF_API void ELF_APIENTRY elfSetSceneSpatialIndex(elfScene* scene, unsigned char spatialIndex)
+{
+	scene->spatialIndex = !spatialIndex == ELF_FALSE;
+	scene->bvh.dirty = ELF_TRUE;
+}
+
+ELF_API unsigned char ELF_APIENTRY elfGetSceneSpatialIndex(elfScene* scene)
+{
+	return scene->spatialIndex;
+}
+
 ELF_API void ELF_APIENTRY elfSetSceneGravity(elfScene* scene, float x, float y, float z)
 {
 	elfSetPhysicsWorldGravity(scene->world, x, y, z);
@@ -699,12 +879,12 @@ ELF_API int ELF_APIENTRY elfGetSceneCameraCount(elfScene* scene)
 
 ELF_API int ELF_APIENTRY elfGetSceneEntityCount(elfScene* scene)
 {
-	return elfGetListLength(scene->entities);
+	return scene->entities->length;
 }
 
 ELF_API int ELF_APIENTRY elfGetSceneLightCount(elfScene* scene)
 {
-	return elfGetListLength(scene->lights);
+	return scene->lights->length;
 }
 
 ELF_API int ELF_APIENTRY elfGetSceneArmatureCount(elfScene* scene)
@@ -719,7 +899,7 @@ ELF_API int ELF_APIENTRY elfGetSceneParticlesCount(elfScene* scene)
 
 ELF_API int ELF_APIENTRY elfGetSceneSpriteCount(elfScene* scene)
 {
-	return elfGetListLength(scene->sprites);
+	return scene->sprites->length;
 }
 
 void elfSetActorScene(elfScene* scene, elfActor* actor)
@@ -752,14 +932,15 @@ ELF_API void ELF_APIENTRY elfAddSceneEntity(elfScene* scene, elfEntity* entity)
 {
 	if(!entity) return;
 	elfSetActorScene(scene, (elfActor*)entity);
-	elfAppendListObject(scene->entities, (elfObject*)entity);
+	elfAppendArrayObject(scene->entities, (elfObject*)entity);
+	elfInsertBvhEntity(&scene->bvh, entity);
 }
 
 ELF_API void ELF_APIENTRY elfAddSceneLight(elfScene* scene, elfLight* light)
 {
 	if(!light) return;
 	elfSetActorScene(scene, (elfActor*)light);
-	elfAppendListObject(scene->lights, (elfObject*)light);
+	elfAppendArrayObject(scene->lights, (elfObject*)light);
 }
 
 ELF_API void ELF_APIENTRY elfAddSceneParticles(elfScene* scene, elfParticles* particles)
@@ -773,7 +954,7 @@ ELF_API void ELF_APIENTRY elfAddSceneSprite(elfScene* scene, elfSprite* sprite)
 {
 	if(!sprite) return;
 	elfSetActorScene(scene, (elfActor*)sprite);
-	elfAppendListObject(scene->sprites, (elfObject*)sprite);
+	elfAppendArrayObject(scene->sprites, (elfObject*)sprite);
 }
 
 ELF_API void ELF_APIENTRY elfSetSceneActiveCamera(elfScene* scene, elfCamera* camera)
@@ -806,6 +987,42 @@ ELF_API elfList* ELF_APIENTRY elfGetDebugSceneRayCastResults(elfScene* scene, fl
 	return elfGetRayCastResults(scene->dworld, x, y, z, dx, dy, dz);
 }
 
+ELF_API elfEntity* ELF_APIENTRY elfGetSceneRayCastEntity(elfScene* scene, float x, float y, float z, float dx, float dy, float dz)
+{
+	elfEntity* ent;
+	elfEntity* result;
+	float start[3];
+	float dir[3];
+	float closest;
+	float t;
+	int i;
+
+	start[0] = x; start[1] = y; start[2] = z;
+	dir[0] = dx-x; dir[1] = dy-y; dir[2] = dz-z;
+
+	if(scene->spatialIndex)
+	{
+		elfUpdateBvh(&scene->bvh, scene->entities);
+		return elfRayCastBvh(&scene->bvh, start, dir);
+	}
+
+	result = NULL;
+	closest = 2.0f;
+
+	for(i = 0; i < scene->entities->length; i++)
+	{
+		ent = (elfEntity*)scene->entities->objs[i];
+		if(!ent->model) continue;
+		if(gfxRayBoxIntersect(start, dir, &ent->cullAabbMin.x, &ent->cullAabbMax.x, &t) && t < closest)
+		{
+			closest = t;
+			result = ent;
+		}
+	}
+
+	return result;
+}
+
 ELF_API elfCamera* ELF_APIENTRY elfGetSceneCameraByIndex(elfScene* scene, int idx)
 {
 	return (elfCamera*)elfGetListObject(scene->cameras, idx);
@@ -813,12 +1030,12 @@ ELF_API elfCamera* ELF_APIENTRY elfGetSceneCameraByIndex(elfScene* scene, int id
 
 ELF_API elfEntity* ELF_APIENTRY elfGetSceneEntityByIndex(elfScene* scene, int idx)
 {
-	return (elfEntity*)elfGetListObject(scene->entities, idx);
+	return (elfEntity*)elfGetArrayObject(scene->entities, idx);
 }
 
 ELF_API elfLight* ELF_APIENTRY elfGetSceneLightByIndex(elfScene* scene, int idx)
 {
-	return (elfLight*)elfGetListObject(scene->lights, idx);
+	return (elfLight*)elfGetArrayObject(scene->lights, idx);
 }
 
 ELF_API elfArmature* ELF_APIENTRY elfGetSceneArmatureByIndex(elfScene* scene, int idx)
@@ -833,7 +1050,7 @@ ELF_API elfParticles* ELF_APIENTRY elfGetSceneParticlesByIndex(elfScene* scene,
 
 ELF_API elfSprite* ELF_APIENTRY elfGetSceneSpriteByIndex(elfScene* scene, int idx)
 {
-	return (elfSprite*)elfGetListObject(scene->sprites, idx);
+	return (elfSprite*)elfGetArrayObject(scene->sprites, idx);
 }
 
 ELF_API elfTexture* ELF_APIENTRY elfGetSceneTexture(elfScene* scene, const char* name)
@@ -922,10 +1139,11 @@ ELF_API elfCamera* ELF_APIENTRY elfGetSceneCamera(elfScene* scene, const char* n
 ELF_API elfEntity* ELF_APIENTRY elfGetSceneEntity(elfScene* scene, const char* name)
 {
 	elfEntity* entity;
+	int i;
 
-	for(entity = (elfEntity*)elfBeginList(scene->entities); entity;
-		entity = (elfEntity*)elfGetListNext(scene->entities))
+	for(i = 0; i < scene->entities->length; i++)
 	{
+		entity = (elfEntity*)scene->entities->objs[i];
 		if(!strcmp(entity->name, name)) return entity;
 	}
 
@@ -935,10 +1153,11 @@ ELF_API elfEntity* ELF_APIENTRY elfGetSceneEntity(elfScene* scene, const char* n
 ELF_API elfLight* ELF_APIENTRY elfGetSceneLight(elfScene* scene, const char* name)
 {
 	elfLight* light;
+	int i;
 
-	for(light = (elfLight*)elfBeginList(scene->lights); light;
-		light = (elfLight*)elfGetListNext(scene->lights))
+	for(i = 0; i < scene->lights->length; i++)
 	{
+		light = (elfLight*)scene->lights->objs[i];
 		if(!strcmp(light->name, name)) return light;
 	}
 
@@ -974,45 +1193,83 @@ ELF_API elfParticles* ELF_APIENTRY elfGetSceneParticles(elfScene* scene, const c
 ELF_API elfSprite* ELF_APIENTRY elfGetSceneSprite(elfScene* scene, const char* name)
 {
 	elfSprite* sprite;
+	int i;
 
-	for(sprite = (elfSprite*)elfBeginList(scene->sprites); sprite;
-		sprite = (elfSprite*)elfGetListNext(scene->sprites))
+	for(i = 0; i < scene->sprites->length; i++)
 	{
+		sprite = (elfSprite*)scene->sprites->objs[i];
 		if(!strcmp(sprite->name, name)) return sprite;
 	}
 
 	return NULL;
 }
 
+elfObject* elfGetScenePakObject(elfScene* scene, elfPakIndex* index)
+{
+	elfObject* obj;
+
+	obj = index->object;
+	if(!obj) return NULL;
+
+	// resources stay in the scene until it goes, actors may have been removed and destroyed since,
+	// so they only count while the scene still holds them
+	switch(index->indexType)
+	{
+		case ELF_CAMERA: if(!elfIsListObject(scene->cameras, obj)) return NULL; break;
+		case ELF_ENTITY: if(elfGetArrayObjectIndex(scene->entities, obj) < 0) return NULL; break;
+		case ELF_LIGHT: if(elfGetArrayObjectIndex(scene->lights, obj) < 0) return NULL; break;
+		case ELF_PARTICLES: if(!elfIsListObject(scene->particles, obj)) return NULL; break;
+		case ELF_SPRITE: if(elfGetArrayObjectIndex(scene->sprites, obj) < 0) return NULL; break;
+	}
+
+	// renamed since, the old name loads the index again like it did before
+	if(strcmp(((elfResource*)obj)->name, index->name)) return NULL;
+
+	return obj;
+}
+
 elfTexture* elfGetOrLoadTextureByName(elfScene* scene, const char* name)
 {
 	elfTexture* texture;
 	elfPakIndex* index;
 	FILE* file;
+	long pos;
 
-	for(texture = (elfTexture*)elfBeginList(scene->textures); texture;
-		texture = (elfTexture*)elfGetListNext(scene->textures))
+	// the pak index is hashed, so it goes first and remembers what each index was loaded into.
+	// only names the pak doesn't have are looked for in the scene
+	index = scene->pak ? elfGetPakIndexByName(scene->pak, name, ELF_TEXTURE) : NULL;
+	if(!index)
 	{
-		if(!strcmp(texture->name, name)) return texture;
+		for(texture = (elfTexture*)elfBeginList(scene->textures); texture;
+			texture = (elfTexture*)elfGetListNext(scene->textures))
+		{
+			if(!strcmp(texture->name, name)) return texture;
+		}
+
+		return NULL;
 	}
 
-	if(scene->pak)
+	texture = (elfTexture*)elfGetScenePakObject(scene, index);
+	if(texture) return texture;
+
+	// loaders recurse into each other through the shared handle, so put the read position back afterwards
+	file = elfGetPakFile(scene->pak);
+	pos = ftell(file);
+
+	texture = NULL;
+	if(!fseek(file, elfGetPakIndexOffset(index), SEEK_SET))
 	{
-		index = elfGetPakIndexByName(scene->pak, name, ELF_TEXTURE);
-		if(index)
+		texture = elfCreateTextureFromPak(file, name, scene);
+		if(texture)
 		{
-			file = fopen(scene->pak->filePath, "rb");
-			fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-			if(feof(file)) return NULL;
-
-			texture = elfCreateTextureFromPak(file, name, scene);
-			if(texture) elfAppendListObject(scene->textures, (elfObject*)texture);
-			fclose(file);
-			return texture;
+			elfAppendListObject(scene->textures, (elfObject*)texture);
+			index->object = (elfObject*)texture;
 		}
 	}
 
-	return NULL;
+	fseek(file, pos, SEEK_SET);
+
+	return texture;
 }
 
 elfModel* elfGetOrLoadModelByName(elfScene* scene, const char* name)
@@ -1020,30 +1277,40 @@ elfModel* elfGetOrLoadModelByName(elfScene* scene, const char* name)
 	elfModel* model;
 	elfPakIndex* index;
 	FILE* file;
+	long pos;
 
-	for(model = (elfModel*)elfBeginList(scene->models); model;
-		model = (elfModel*)elfGetListNext(scene->models))
+	index = scene->pak ? elfGetPakIndexByName(scene->pak, name, ELF_MODEL) : NULL;
+	if(!index)
 	{
-		if(!strcmp(model->name, name)) return model;
+		for(model = (elfModel*)elfBeginList(scene->models); model;
+			model = (elfModel*)elfGetListNext(scene->models))
+		{
+			if(!strcmp(model->name, name)) return model;
+		}
+
+		return NULL;
 	}
 
-	if(scene->pak)
+	model = (elfModel*)elfGetScenePakObject(scene, index);
+	if(model) return model;
+
+	file = elfGetPakFile(scene->pak);
+	pos = ftell(file);
+
+	model = NULL;
+	if(!fseek(file, elfGetPakIndexOffset(index), SEEK_SET))
 	{
-		index = elfGetPakIndexByName(scene->pak, name, ELF_MODEL);
-		if(index)
+		model = elfCreateModelFromPak(file, name, scene);
+		if(model)
 		{
-			file = fopen(scene->pak->filePath, "rb");
-			fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-			if(feof(file)) return NULL;
-
-			model = elfCreateModelFromPak(file, name, scene);
-			if(model) elfAppendListObject(scene->models, (elfObject*)model);
-			fclose(file);
-			return model;
+			elfAppendListObject(scene->models, (elfObject*)model);
+			index->object = (elfObject*)model;
 		}
 	}
 
-	return NULL;
+	fseek(file, pos, SEEK_SET);
+
+	return model;
 }
 
 elfScript* elfGetOrLoadScriptByName(elfScene* scene, const char* name)
@@ -1051,30 +1318,40 @@ elfScript* elfGetOrLoadScriptByName(elfScene* scene, const char* name)
 	elfScript* script;
 	elfPakIndex* index;
 	FILE* file;
+	long pos;
 
-	for(script = (elfScript*)elfBeginList(scene->scripts); script;
-		script = (elfScript*)elfGetListNext(scene->scripts))
+	index = scene->pak ? elfGetPakIndexByName(scene->pak, name, ELF_SCRIPT) : NULL;
+	if(!index)
 	{
-		if(!strcmp(script->name, name)) return script;
+		for(script = (elfScript*)elfBeginList(scene->scripts); script;
+			script = (elfScript*)elfGetListNext(scene->scripts))
+		{
+			if(!strcmp(script->name, name)) return script;
+		}
+
+		return NULL;
 	}
 
-	if(scene->pak)
+	script = (elfScript*)elfGetScenePakObject(scene, index);
+	if(script) return script;
+
+	file = elfGetPakFile(scene->pak);
+	pos = ftell(file);
+
+	script = NULL;
+	if(!fseek(file, elfGetPakIndexOffset(index), SEEK_SET))
 	{
-		index = elfGetPakIndexByName(scene->pak, name, ELF_SCRIPT);
-		if(index)
+		script = elfCreateScriptFromPak(file, name, scene);
+		if(script)
 		{
-			file = fopen(scene->pak->filePath, "rb");
-			fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-			if(feof(file)) return NULL;
-
-			script = elfCreateScriptFromPak(file, name, scene);
-			if(script) elfAppendListObject(scene->scripts, (elfObject*)script);
-			fclose(file);
-			return script;
+			elfAppendListObject(scene->scripts, (elfObject*)script);
+			index->object = (elfObject*)script;
 		}
 	}
 
-	return NULL;
+	fseek(file, pos, SEEK_SET);
+
+	return script;
 }
 
 elfMaterial* elfGetOrLoadMaterialByName(elfScene* scene, const char* name)
@@ -1082,30 +1359,40 @@ elfMaterial* elfGetOrLoadMaterialByName(elfScene* scene, const char* name)
 	elfMaterial* material;
 	elfPakIndex* index;
 	FILE* file;
+	long pos;
 
-	for(material = (elfMaterial*)elfBeginList(scene->materials); material;
-		material = (elfMaterial*)elfGetListNext(scene->materials))
+	index = scene->pak ? elfGetPakIndexByName(scene->pak, name, ELF_MATERIAL) : NULL;
+	if(!index)
 	{
-		if(!strcmp(material->name, name)) return material;
+		for(material = (elfMaterial*)elfBeginList(scene->materials); material;
+			material = (elfMaterial*)elfGetListNext(scene->materials))
+		{
+			if(!strcmp(material->name, name)) return material;
+		}
+
+		return NULL;
 	}
 
-	if(scene->pak)
+	material = (elfMaterial*)elfGetScenePakObject(scene, index);
+	if(material) return material;
+
+	file = elfGetPakFile(scene->pak);
+	pos = ftell(file);
+
+	material = NULL;
+	if(!fseek(file, elfGetPakIndexOffset(index), SEEK_SET))
 	{
-		index = elfGetPakIndexByName(scene->pak, name, ELF_MATERIAL);
-		if(index)
+		material = elfCreateMaterialFromPak(file, name, scene);
+		if(material)
 		{
-			file = fopen(scene->pak->filePath, "rb");
-			fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-			if(feof(file)) return NULL;
-
-			material = elfCreateMaterialFromPak(file, name, scene);
-			if(material) elfAppendListObject(scene->materials, (elfObject*)material);
-			fclose(file);
-			return material;
+			elfAppendListObject(scene->materials, (elfObject*)material);
+			index->object = (elfObject*)material;
 		}
 	}
 
-	return NULL;
+	fseek(file, pos, SEEK_SET);
+
+	return material;
 }
 
 elfCamera* elfGetOrLoadCameraByName(elfScene* scene, const char* name)
@@ -1113,29 +1400,40 @@ elfCamera* elfGetOrLoadCameraByName(elfScene* scene, const char* name)
 	elfCamera* camera;
 	elfPakIndex* index;
 	FILE* file;
+	long pos;
 
-	for(camera = (elfCamera*)elfBeginList(scene->cameras); camera;
-		camera = (elfCamera*)elfGetListNext(scene->cameras))
+	index = scene->pak ? elfGetPakIndexByName(scene->pak, name, ELF_CAMERA) : NULL;
+	if(!index)
 	{
-		if(!strcmp(camera->name, name)) return camera;
+		for(camera = (elfCamera*)elfBeginList(scene->cameras); camera;
+			camera = (elfCamera*)elfGetListNext(scene->cameras))
+		{
+			if(!strcmp(camera->name, name)) return camera;
+		}
+
+		return NULL;
 	}
 
-	if(scene->pak)
+	camera = (elfCamera*)elfGetScenePakObject(scene, index);
+	if(camera) return camera;
+
+	file = elfGetPakFile(scene->pak);
+	pos = ftell(file);
+
+	camera = NULL;
+	if(!fseek(file, elfGetPakIndexOffset(index), SEEK_SET))
 	{
-		index = elfGetPakIndexByName(scene->pak, name, ELF_CAMERA);
-		if(index)
+		camera = elfCreateCameraFromPak(file, name, scene);
+		if(camera)
 		{
-			file = fopen(scene->pak->filePath, "rb");
-			fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-			if(feof(file)) return NULL;
-			camera = elfCreateCameraFromPak(file, name, scene);
-			if(camera) elfAddSceneCamera(scene, camera);
-			fclose(file);
-			return camera;
+			elfAddSceneCamera(scene, camera);
+			index->object = (elfObject*)camera;
 		}
 	}
 
-	return NULL;
+	fseek(file, pos, SEEK_SET);
+
+	return camera;
 }
 
 elfEntity* elfGetOrLoadEntityByName(elfScene* scene, const char* name)
@@ -1143,30 +1441,41 @@ elfEntity* elfGetOrLoadEntityByName(elfScene* scene, const char* name)
 	elfEntity* entity;
 	elfPakIndex* index;
 	FILE* file;
+	long pos;
+	int i;
 
-	for(entity = (elfEntity*)elfBeginList(scene->entities); entity;
-		entity = (elfEntity*)elfGetListNext(scene->entities))
+	index = scene->pak ? elfGetPakIndexByName(scene->pak, name, ELF_ENTITY) : NULL;
+	if(!index)
 	{
-		if(!strcmp(entity->name, name)) return entity;
+		for(i = 0; i < scene->entities->length; i++)
+		{
+			entity = (elfEntity*)scene->entities->objs[i];
+			if(!strcmp(entity->name, name)) return entity;
+		}
+
+		return NULL;
 	}
 
-	if(scene->pak)
+	entity = (elfEntity*)elfGetScenePakObject(scene, index);
+	if(entity) return entity;
+
+	file = elfGetPakFile(scene->pak);
+	pos = ftell(file);
+
+	entity = NULL;
+	if(!fseek(file, elfGetPakIndexOffset(index), SEEK_SET))
 	{
-		index = elfGetPakIndexByName(scene->pak, name, ELF_ENTITY);
-		if(index)
+		entity = elfCreateEntityFromPak(file, name, scene);
+		if(entity)
 		{
-			file = fopen(scene->pak->filePath, "rb");
-			fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-			if(feof(file)) return NULL;
-
-			entity = elfCreateEntityFromPak(file, name, scene);
-			if(entity) elfAddSceneEntity(scene, entity);
-			fclose(file);
-			return entity;
+			elfAddSceneEntity(scene, entity);
+			index->object = (elfObject*)entity;
 		}
 	}
 
-	return NULL;
+	fseek(file, pos, SEEK_SET);
+
+	return entity;
 }
 
 elfLight* elfGetOrLoadLightByName(elfScene* scene, const char* name)
@@ -1174,30 +1483,41 @@ elfLight* elfGetOrLoadLightByName(elfScene* scene, const char* name)
 	elfLight* light;
 	elfPakIndex* index;
 	FILE* file;
+	long pos;
+	int i;
 
-	for(light = (elfLight*)elfBeginList(scene->lights); light;
-		light = (elfLight*)elfGetListNext(scene->lights))
+	index = scene->pak ? elfGetPakIndexByName(scene->pak, name, ELF_LIGHT) : NULL;
+	if(!index)
 	{
-		if(!strcmp(light->name, name)) return light;
+		for(i = 0; i < scene->lights->length; i++)
+		{
+			light = (elfLight*)scene->lights->objs[i];
+			if(!strcmp(light->name, name)) return light;
+		}
+
+		return NULL;
 	}
 
-	if(scene->pak)
+	light = (elfLight*)elfGetScenePakObject(scene, index);
+	if(light) return light;
+
+	file = elfGetPakFile(scene->pak);
+	pos = ftell(file);
+
+	light = NULL;
+	if(!fseek(file, elfGetPakIndexOffset(index), SEEK_SET))
 	{
-		index = elfGetPakIndexByName(scene->pak, name, ELF_LIGHT);
-		if(index)
+		light = elfCreateLightFromPak(file, name, scene);
+		if(light)
 		{
-			file = fopen(scene->pak->filePath, "rb");
-			fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-			if(feof(file)) return NULL;
-
-			light = elfCreateLightFromPak(file, name, scene);
-			if(light) elfAddSceneLight(scene, light);
-			fclose(file);
-			return light;
+			elfAddSceneLight(scene, light);
+			index->object = (elfObject*)light;
 		}
 	}
 
-	return NULL;
+	fseek(file, pos, SEEK_SET);
+
+	return light;
 }
 
 elfArmature* elfGetOrLoadArmatureByName(elfScene* scene, const char* name)
@@ -1205,30 +1525,40 @@ elfArmature* elfGetOrLoadArmatureByName(elfScene* scene, const char* name)
 	elfArmature* armature;
 	elfPakIndex* index;
 	FILE* file;
+	long pos;
 
-	for(armature = (elfArmature*)elfBeginList(scene->armatures); armature;
-		armature = (elfArmature*)elfGetListNext(scene->armatures))
+	index = scene->pak ? elfGetPakIndexByName(scene->pak, name, ELF_ARMATURE) : NULL;
+	if(!index)
 	{
-		if(!strcmp(armature->name, name)) return armature;
+		for(armature = (elfArmature*)elfBeginList(scene->armatures); armature;
+			armature = (elfArmature*)elfGetListNext(scene->armatures))
+		{
+			if(!strcmp(armature->name, name)) return armature;
+		}
+
+		return NULL;
 	}
 
-	if(scene->pak)
+	armature = (elfArmature*)elfGetScenePakObject(scene, index);
+	if(armature) return armature;
+
+	file = elfGetPakFile(scene->pak);
+	pos = ftell(file);
+
+	armature = NULL;
+	if(!fseek(file, elfGetPakIndexOffset(index), SEEK_SET))
 	{
-		index = elfGetPakIndexByName(scene->pak, name, ELF_ARMATURE);
-		if(index)
+		armature = elfCreateArmatureFromPak(file, name, scene);
+		if(armature)
 		{
-			file = fopen(scene->pak->filePath, "rb");
-			fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-			if(feof(file)) return NULL;
-
-			armature = elfCreateArmatureFromPak(file, name, scene);
 			elfAppendListObject(scene->armatures, (elfObject*)armature);
-			fclose(file);
-			return armature;
+			index->object = (elfObject*)armature;
 		}
 	}
 
-	return NULL;
+	fseek(file, pos, SEEK_SET);
+
+	return armature;
 }
 
 elfParticles* elfGetOrLoadParticlesByName(elfScene* scene, const char* name)
@@ -1236,30 +1566,40 @@ elfParticles* elfGetOrLoadParticlesByName(elfScene* scene, const char* name)
 	elfParticles* particles;
 	elfPakIndex* index;
 	FILE* file;
+	long pos;
 
-	for(particles = (elfParticles*)elfBeginList(scene->particles); particles;
-		particles = (elfParticles*)elfGetListNext(scene->particles))
+	index = scene->pak ? elfGetPakIndexByName(scene->pak, name, ELF_PARTICLES) : NULL;
+	if(!index)
 	{
-		if(!strcmp(particles->name, name)) return particles;
+		for(particles = (elfParticles*)elfBeginList(scene->particles); particles;
+			particles = (elfParticles*)elfGetListNext(scene->particles))
+		{
+			if(!strcmp(particles->name, name)) return particles;
+		}
+
+		return NULL;
 	}
 
-	if(scene->pak)
+	particles = (elfParticles*)elfGetScenePakObject(scene, index);
+	if(particles) return particles;
+
+	file = elfGetPakFile(scene->pak);
+	pos = ftell(file);
+
+	particles = NULL;
+	if(!fseek(file, elfGetPakIndexOffset(index), SEEK_SET))
 	{
-		index = elfGetPakIndexByName(scene->pak, name, ELF_PARTICLES);
-		if(index)
+		particles = elfCreateParticlesFromPak(file, name, scene);
+		if(particles)
 		{
-			file = fopen(scene->pak->filePath, "rb");
-			fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-			if(feof(file)) return NULL;
-
-			particles = elfCreateParticlesFromPak(file, name, scene);
-			if(particles) elfAddSceneParticles(scene, particles);
-			fclose(file);
-			return particles;
+			elfAddSceneParticles(scene, particles);
+			index->object = (elfObject*)particles;
 		}
 	}
 
-	return NULL;
+	fseek(file, pos, SEEK_SET);
+
+	return particles;
 }
 
 elfSprite* elfGetOrLoadSpriteByName(elfScene* scene, const char* name)
@@ -1267,30 +1607,41 @@ elfSprite* elfGetOrLoadSpriteByName(elfScene* scene, const char* name)
 	elfSprite* sprite;
 	elfPakIndex* index;
 	FILE* file;
+	long pos;
+	int i;
 
-	for(sprite = (elfSprite*)elfBeginList(scene->sprites); sprite;
-		sprite = (elfSprite*)elfGetListNext(scene->sprites))
+	index = scene->pak ? elfGetPakIndexByName(scene->pak, name, ELF_SPRITE) : NULL;
+	if(!index)
 	{
-		if(!strcmp(sprite->name, name)) return sprite;
+		for(i = 0; i < scene->sprites->length; i++)
+		{
+			sprite = (elfSprite*)scene->sprites->objs[i];
+			if(!strcmp(sprite->name, name)) return sprite;
+		}
+
+		return NULL;
 	}
 
-	if(scene->pak)
+	sprite = (elfSprite*)elfGetScenePakObject(scene, index);
+	if(sprite) return sprite;
+
+	file = elfGetPakFile(scene->pak);
+	pos = ftell(file);
+
+	sprite = NULL;
+	if(!fseek(file, elfGetPakIndexOffset(index), SEEK_SET))
 	{
-		index = elfGetPakIndexByName(scene->pak, name, ELF_SPRITE);
-		if(index)
+		sprite = elfCreateSpriteFromPak(file, name, scene);
+		if(sprite)
 		{
-			file = fopen(scene->pak->filePath, "rb");
-			fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-			if(feof(file)) return NULL;
-
-			sprite = elfCreateSpriteFromPak(file, name, scene);
-			if(sprite) elfAddSceneSprite(scene, sprite);
-			fclose(file);
-			return sprite;
+			elfAddSceneSprite(scene, sprite);
+			index->object = (elfObject*)sprite;
 		}
 	}
 
-	return NULL;
+	fseek(file, pos, SEEK_SET);
+
+	return sprite;
 }
 
 elfActor* elfGetOrLoadActorByName(elfScene* scene, const char* name)
@@ -1359,14 +1710,16 @@ ELF_API unsigned char ELF_APIENTRY elfRemoveSceneCamera(elfScene* scene, const c
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneEntity(elfScene* scene, const char* name)
 {
 	elfEntity* ent;
+	int i;
 
-	for(ent = (elfEntity*)elfBeginList(scene->entities); ent != NULL;
-		ent = (elfEntity*)elfGetListNext(scene->entities))
+	for(i = 0; i < scene->entities->length; i++)
 	{
+		ent = (elfEntity*)scene->entities->objs[i];
 		if(!strcmp(ent->name, name))
 		{
+			elfRemoveBvhEntity(&scene->bvh, ent);
 			elfRemoveActor((elfActor*)ent);
-			elfRemoveListObject(scene->entities, (elfObject*)ent);
+			elfRemoveArrayObject(scene->entities, (elfObject*)ent);
 			return ELF_TRUE;
 		}
 	}
@@ -1377,14 +1730,15 @@ ELF_API unsigned char ELF_APIENTRY elfRemoveSceneEntity(elfScene* scene, const c
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneLight(elfScene* scene, const char* name)
 {
 	elfLight* lig;
+	int i;
 
-	for(lig = (elfLight*)elfBeginList(scene->lights); lig != NULL;
-		lig = (elfLight*)elfGetListNext(scene->lights))
+	for(i = 0; i < scene->lights->length; i++)
 	{
+		lig = (elfLight*)scene->lights->objs[i];
 		if(!strcmp(lig->name, name))
 		{
 			elfRemoveActor((elfActor*)lig);
-			elfRemoveListObject(scene->lights, (elfObject*)lig);
+			elfRemoveArrayObject(scene->lights, (elfObject*)lig);
 			return ELF_TRUE;
 		}
 	}
@@ -1413,14 +1767,15 @@ ELF_API unsigned char ELF_APIENTRY elfRemoveSceneParticles(elfScene* scene, cons
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneSprite(elfScene* scene, const char* name)
 {
 	elfSprite* spr;
+	int i;
 
-	for(spr = (elfSprite*)elfBeginList(scene->sprites); spr != NULL;
-		spr = (elfSprite*)elfGetListNext(scene->sprites))
+	for(i = 0; i < scene->sprites->length; i++)
 	{
+		spr = (elfSprite*)scene->sprites->objs[i];
 		if(!strcmp(spr->name, name))
 		{
 			elfRemoveActor((elfActor*)spr);
-			elfRemoveListObject(scene->sprites, (elfObject*)spr);
+			elfRemoveArrayObject(scene->sprites, (elfObject*)spr);
 			return ELF_TRUE;
 		}
 	}
@@ -1456,43 +1811,24 @@ ELF_API unsigned char ELF_APIENTRY elfRemoveSceneCameraByIndex(elfScene* scene,
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneEntityByIndex(elfScene* scene, int idx)
 {
 	elfEntity* ent;
-	int i;
 
-	if(idx < 0 || idx > elfGetListLength(scene->entities)-1) return ELF_FALSE;
+	if(idx < 0 || idx > scene->entities->length-1) return ELF_FALSE;
 
-	for(i = 0, ent = (elfEntity*)elfBeginList(scene->entities); ent != NULL;
-		ent = (elfEntity*)elfGetListNext(scene->entities), i++)
-	{
-		if(i == idx)
-		{
-			elfRemoveActor((elfActor*)ent);
-			elfRemoveListObject(scene->entities, (elfObject*)ent);
-			return ELF_TRUE;
-		}
-	}
-
-	return ELF_FALSE;
+	ent = (elfEntity*)scene->entities->objs[idx];
+	elfRemoveBvhEntity(&scene->bvh, ent);
+	elfRemoveActor((elfActor*)ent);
+	return elfRemoveArrayObjectByIndex(scene->entities, idx);
 }
 
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneLightByIndex(elfScene* scene, int idx)
 {
 	elfLight* lig;
-	int i;
 
-	if(idx < 0 || idx > elfGetListLength(scene->lights)-1) return ELF_FALSE;
+	if(idx < 0 || idx > scene->lights->length-1) return ELF_FALSE;
 
-	for(i = 0, lig = (elfLight*)elfBeginList(scene->lights); lig != NULL;
-		lig = (elfLight*)elfGetListNext(scene->lights), i++)
-	{
-		if(i == idx)
-		{
-			elfRemoveActor((elfActor*)lig);
-			elfRemoveListObject(scene->lights, (elfObject*)lig);
-			return ELF_TRUE;
-		}
-	}
-
-	return ELF_FALSE;
+	lig = (elfLight*)scene->lights->objs[idx];
+	elfRemoveActor((elfActor*)lig);
+	return elfRemoveArrayObjectByIndex(scene->lights, idx);
 }
 
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneParticlesByIndex(elfScene* scene, int idx)
@@ -1519,22 +1855,12 @@ ELF_API unsigned char ELF_APIENTRY elfRemoveSceneParticlesByIndex(elfScene* scen
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneSpriteByIndex(elfScene* scene, int idx)
 {
 	elfSprite* spr;
-	int i;
 
-	if(idx < 0 || idx > elfGetListLength(scene->sprites)-1) return ELF_FALSE;
-
-	for(i = 0, spr = (elfSprite*)elfBeginList(scene->sprites); spr != NULL;
-		spr = (elfSprite*)elfGetListNext(scene->sprites), i++)
-	{
-		if(i == idx)
-		{
-			elfRemoveActor((elfActor*)spr);
-			elfRemoveListObject(scene->sprites, (elfObject*)spr);
-			return ELF_TRUE;
-		}
-	}
+	if(idx < 0 || idx > scene->sprites->length-1) return ELF_FALSE;
 
-	return ELF_FALSE;
+	spr = (elfSprite*)scene->sprites->objs[idx];
+	elfRemoveActor((elfActor*)spr);
+	return elfRemoveArrayObjectByIndex(scene->sprites, idx);
 }
 
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneCameraByObject(elfScene* scene, elfCamera* camera)
@@ -1546,14 +1872,15 @@ ELF_API unsigned char ELF_APIENTRY elfRemoveSceneCameraByObject(elfScene* scene,
 
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneEntityByObject(elfScene* scene, elfEntity* entity)
 {
+	if(elfGetArrayObjectIndex(scene->entities, (elfObject*)entity) > -1) elfRemoveBvhEntity(&scene->bvh, entity);
 	elfRemoveActor((elfActor*)entity);
-	return elfRemoveListObject(scene->entities, (elfObject*)entity);
+	return elfRemoveArrayObject(scene->entities, (elfObject*)entity);
 }
 
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneLightByObject(elfScene* scene, elfLight* light)
 {
 	elfRemoveActor((elfActor*)light);
-	return elfRemoveListObject(scene->lights, (elfObject*)light);
+	return elfRemoveArrayObject(scene->lights, (elfObject*)light);
 }
 
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneParticlesByObject(elfScene* scene, elfParticles* particles)
@@ -1565,7 +1892,7 @@ ELF_API unsigned char ELF_APIENTRY elfRemoveSceneParticlesByObject(elfScene* sce
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneSpriteByObject(elfScene* scene, elfSprite* sprite)
 {
 	elfRemoveActor((elfActor*)sprite);
-	return elfRemoveListObject(scene->sprites, (elfObject*)sprite);
+	return elfRemoveArrayObject(scene->sprites, (elfObject*)sprite);
 }
 
 ELF_API unsigned char ELF_APIENTRY elfRemoveSceneActorByObject(elfScene* scene, elfActor* actor)
@@ -1586,6 +1913,203 @@ ELF_API unsigned char ELF_APIENTRY elfRemoveSceneActorByObject(elfScene* scene,
 	return ELF_FALSE;
 }
 
+void elfBeginSceneCulling(elfScene* scene)
+{
+	elfEntity* ent;
+	int i;
+
+	for(i = 0; i < scene->entityQueue->length; i++)
+	{
+		((elfEntity*)scene->entityQueue->objs[i])->culled = ELF_TRUE;
+	}
+	elfClearArray(scene->entityQueue);
+
+	if(scene->spatialIndex)
+	{
+		elfUpdateBvh(&scene->bvh, scene->entities);
+		return;
+	}
+
+	elfBeginCullBatch(&scene->entityBatch);
+
+	for(i = 0; i < scene->entities->length; i++)
+	{
+		ent = (elfEntity*)scene->entities->objs[i];
+		if(!ent->model || !ent->visible) continue;
+		elfAddCullBatchEntity(&scene->entityBatch, ent);
+	}
+}
+
+void elfCullSceneEntities(elfScene* scene, elfCamera* camera)
+{
+	if(scene->spatialIndex) elfCullBvhCamera(&scene->bvh, camera, &scene->entityBatch);
+	else elfCullBatchCamera(&scene->entityBatch, camera);
+}
+
+void elfQueueSceneEntity(elfScene* scene, elfEntity* entity)
+{
+	if(scene->renderQueueLength == scene->renderQueueSize)
+	{
+		scene->renderQueueSize = scene->renderQueueSize ? scene->renderQueueSize*2 : 256;
+		scene->renderQueue = (elfRenderItem*)realloc(scene->renderQueue, sizeof(elfRenderItem)*scene->renderQueueSize);
+	}
+
+	scene->renderQueue[scene->renderQueueLength].entity = entity;
+	scene->renderQueueLength++;
+}
+
+unsigned int elfHashRenderKeyResource(unsigned int hash, elfResource* resource)
+{
+	// resource ids instead of addresses, they fit the hash on every platform and sort the same way every run
+	return hash*31+(resource ? (unsigned int)resource->id : 0);
+}
+
+unsigned long long elfGetEntityRenderKey(elfEntity* entity, int mode, gfxShaderParams* shaderParams)
+{
+	elfMaterial* material;
+	elfObject* obj;
+	unsigned long long key;
+	unsigned int shader;
+	unsigned int textures;
+	unsigned int group;
+	unsigned int depth;
+	float* mat;
+	float z;
+
+	// from the top: pass (2 bits), translucent (1), then for opaque draws shader permutation (12),
+	// texture set (16), model and materials (17) and front to back depth (16). entities with a
+	// translucent material move the depth up under the translucent bit and invert it so they
+	// go after the opaque ones and back to front
+	material = (elfMaterial*)elfBeginList(entity->materials);
+
+	shader = 0;
+	textures = 0;
+	if(material)
+	{
+		if(material->diffuseMap) shader |= 0x001;
+		if(material->normalMap) shader |= 0x002;
+		if(material->heightMap) shader |= 0x004;
+		if(material->specularMap) shader |= 0x008;
+		if(material->lightMap) shader |= 0x010;
+		if(material->cubeMap) shader |= 0x020;
+		if(material->lighting) shader |= 0x040;
+		if(material->alphaTest) shader |= 0x080;
+
+		textures = elfHashRenderKeyResource(0, (elfResource*)material->diffuseMap);
+		textures = elfHashRenderKeyResource(textures, (elfResource*)material->normalMap);
+		textures = elfHashRenderKeyResource(textures, (elfResource*)material->heightMap);
+		textures = elfHashRenderKeyResource(textures, (elfResource*)material->specularMap);
+		textures = elfHashRenderKeyResource(textures, (elfResource*)material->lightMap);
+		textures = elfHashRenderKeyResource(textures, (elfResource*)material->cubeMap);
+		textures = (textures^(textures>>16))&0xFFFF;
+	}
+	if(entity->armature) shader |= 0x100;
+
+	group = elfHashRenderKeyResource(0, (elfResource*)entity->model);
+	for(obj = elfBeginList(entity->materials); obj; obj = elfGetListNext(entity->materials))
+		group = elfHashRenderKeyResource(group, (elfResource*)obj);
+	group = (group^(group>>15))&0x1FFFF;
+
+	mat = shaderParams->cameraMatrix;
+	z = -(mat[2]*entity->position.x+mat[6]*entity->position.y+mat[10]*entity->position.z+mat[14]);
+	if(z < 0.0f || shaderParams->clipEnd <= 0.0f) depth = 0;
+	else if(z >= shaderParams->clipEnd) depth = 0xFFFF;
+	else depth = (unsigned int)(z/shaderParams->clipEnd*65535.0f);
+
+	key = (unsigned long long)(mode&0x3)<<62;
+	if(elfIsEntityTranslucent(entity))
+	{
+		key |= (unsigned long long)1<<61;
+		key |= (unsigned long long)(0xFFFF-depth)<<45;
+		key |= (unsigned long long)(shader&0xFFF)<<33;
+		key |= (unsigned long long)textures<<17;
+		key |= (unsigned long long)group;
+	}
+	else
+	{
+		key |= (unsigned long long)(shader&0xFFF)<<49;
+		key |= (unsigned long long)textures<<33;
+		key |= (unsigned long long)group<<16;
+		key |= (unsigned long long)depth;
+	}
+
+	return key;
+}
+
+int elfCompareRenderItems(const void* a, const void* b)
+{
+	const elfRenderItem* itemA = (const elfRenderItem*)a;
+	const elfRenderItem* itemB = (const elfRenderItem*)b;
+
+	if(itemA->key != itemB->key) return itemA->key < itemB->key ? -1 : 1;
+	return 0;
+}
+
+unsigned char elfIsEntityDrawStateEqual(elfEntity* entA, elfEntity* entB)
+{
+	elfObject* matA;
+	elfObject* matB;
+
+	if(entA->model != entB->model) return ELF_FALSE;
+	if(elfGetListLength(entA->materials) != elfGetListLength(entB->materials)) return ELF_FALSE;
+
+	for(matA = elfBeginList(entA->materials), matB = elfBeginList(entB->materials); matA && matB;
+		matA = elfGetListNext(entA->materials), matB = elfGetListNext(entB->materials))
+	{
+		if(matA != matB) return ELF_FALSE;
+	}
+
+	return ELF_TRUE;
+}
+
+void elfDrawSceneQueue(elfScene* scene, int mode, gfxShaderParams* shaderParams)
+{
+	elfRenderItem* queue;
+	elfEntity* ent;
+	int count;
+	int i, j;
+
+	queue = scene->renderQueue;
+	count = scene->renderQueueLength;
+
+	for(i = 0; i < count; i++)
+		queue[i].key = elfGetEntityRenderKey(queue[i].entity, mode, shaderParams);
+
+	if(count > 1) qsort(queue, count, sizeof(elfRenderItem), elfCompareRenderItems);
+
+	if(count > scene->instanceMatrixSize)
+	{
+		if(scene->instances) free(scene->instances);
+		if(scene->instanceMatrices) free(scene->instanceMatrices);
+		scene->instanceMatrixSize = count;
+		scene->instances = (elfEntity**)malloc(sizeof(elfEntity*)*scene->instanceMatrixSize);
+		scene->instanceMatrices = (float*)malloc(sizeof(float)*16*scene->instanceMatrixSize);
+	}
+
+	// the model and materials sit above the depth in the key, so entities that can share
+	// a draw are next to each other unless a hash collision puts another one between them
+	for(i = 0; i < count; i = j)
+	{
+		ent = queue[i].entity;
+		scene->instances[0] = ent;
+
+		j = i+1;
+		if(elfIsEntityInstanceable(ent))
+		{
+			for(; j < count && elfIsEntityInstanceable(queue[j].entity) &&
+				elfIsEntityDrawStateEqual(ent, queue[j].entity); j++)
+			{
+				scene->instances[j-i] = queue[j].entity;
+			}
+		}
+
+		if(j-i < 2) elfDrawEntity(ent, mode, shaderParams);
+		else elfDrawEntityInstances(scene->instances, j-i, scene->instanceMatrices, mode, shaderParams);
+	}
+
+	scene->renderQueueLength = 0;
+}
+
 void elfDrawScene(elfScene* scene)
 {
 	elfLight* light;
@@ -1599,7 +2123,7 @@ void elfDrawScene(elfScene* scene)
 	float tempMat1[16];
 	float tempMat2[16];
 	gfxRenderTarget* renderTarget;
-	int i;
+	int i, j;
 	elfVec3f lpos;
 	elfVec3f spos;
 	elfVec3f dvec;
@@ -1610,8 +2134,13 @@ void elfDrawScene(elfScene* scene)
 
 	renderTarget = gfxGetCurRenderTarget();
 
+	elfBeginProfileScope("depth");
+
 	if(scene->occlusionCulling)
 	{
+		// query results are read when they are back, the counter orders them per entity
+		scene->occlusionFrame++;
+
 		// draw occluders to depth buffer
 		gfxSetShaderParamsDefault(&scene->shaderParams);
 		elfSetCamera(scene->curCamera, &scene->shaderParams);
@@ -1619,55 +2148,29 @@ void elfDrawScene(elfScene* scene)
 		scene->shaderParams.renderParams.alphaWrite = ELF_FALSE;
 
 		found = ELF_FALSE;
-		scene->entityQueueCount = 0;
-		elfBeginList(scene->entityQueue);
+		elfBeginSceneCulling(scene);
+		elfCullSceneEntities(scene, scene->curCamera);
 
-		for(ent = (elfEntity*)elfBeginList(scene->entities); ent != NULL;
-			ent = (elfEntity*)elfGetListNext(scene->entities))
+		for(i = 0; i < scene->entityBatch.visibleCount; i++)
 		{
-			if(!elfCullEntity(ent, scene->curCamera))
-			{
-				if(scene->entityQueueCount < elfGetListLength(scene->entityQueue))
-				{
-					elfSetListCurPtr(scene->entityQueue, (elfObject*)ent);
-					elfGetListNext(scene->entityQueue);
-				}
-				else
-				{
-					elfAppendListObject(scene->entityQueue, (elfObject*)ent);
-				}
-				scene->entityQueueCount++;
-				if(ent->occluder)
-				{
-					elfDrawEntity(ent, ELF_DRAW_DEPTH, &scene->shaderParams);
-					found = ELF_TRUE;
-				}
-				ent->culled = ELF_FALSE;
-			}
-			else
+			ent = scene->entityBatch.entities[scene->entityBatch.visible[i]];
+			elfAppendArrayObject(scene->entityQueue, (elfObject*)ent);
+			if(ent->occluder)
 			{
-				ent->culled = ELF_TRUE;
+				elfDrawEntity(ent, ELF_DRAW_DEPTH, &scene->shaderParams);
+				found = ELF_TRUE;
 			}
+			ent->culled = ELF_FALSE;
 		}
 
-		scene->spriteQueueCount = 0;
-		elfBeginList(scene->spriteQueue);
+		elfClearArray(scene->spriteQueue);
 
-		for(spr = (elfSprite*)elfBeginList(scene->sprites); spr != NULL;
-			spr = (elfSprite*)elfGetListNext(scene->sprites))
+		for(i = 0; i < scene->sprites->length; i++)
 		{
+			spr = (elfSprite*)scene->sprites->objs[i];
 			if(!elfCullSprite(spr, scene->curCamera))
 			{
-				if(scene->spriteQueueCount < elfGetListLength(scene->spriteQueue))
-				{
-					elfSetListCurPtr(scene->spriteQueue, (elfObject*)spr);
-					elfGetListNext(scene->spriteQueue);
-				}
-				else
-				{
-					elfAppendListObject(scene->spriteQueue, (elfObject*)spr);
-				}
-				scene->spriteQueueCount++;
+				elfAppendArrayObject(scene->spriteQueue, (elfObject*)spr);
 				if(spr->occluder)
 				{
 					found = ELF_TRUE;
@@ -1692,42 +2195,50 @@ void elfDrawScene(elfScene* scene)
 			scene->shaderParams.renderParams.alphaWrite = GFX_FALSE;
 			scene->shaderParams.renderParams.cullFace = GFX_FALSE;
 
-			for(i = 0, ent = (elfEntity*)elfBeginList(scene->entityQueue);
-				i < scene->entityQueueCount && ent != NULL;
-				i++, ent = (elfEntity*)elfGetListNext(scene->entityQueue))
+			elfBeginProfileScope("occlusion queries");
+
+			for(i = 0; i < scene->entityQueue->length; i++)
 			{
-				gfxBeginQuery(ent->query);
-				elfDrawEntityBoundingBox(ent, &scene->shaderParams);
-				gfxEndQuery(ent->query);
+				ent = (elfEntity*)scene->entityQueue->objs[i];
+				if(ent->occluder) continue;
+				elfBeginEntityQuery(ent, scene->occlusionFrame, &scene->shaderParams);
 			}
 
+			elfEndProfileScope();
+
 			// draw depth buffer
 			gfxSetShaderParamsDefault(&scene->shaderParams);
 			elfSetCamera(scene->curCamera, &scene->shaderParams);
 			scene->shaderParams.renderParams.colorWrite = ELF_FALSE;
 			scene->shaderParams.renderParams.alphaWrite = ELF_FALSE;
 
-			for(i = 0, ent = (elfEntity*)elfBeginList(scene->entityQueue);
-				i < scene->entityQueueCount && ent != NULL;
-				i++, ent = (elfEntity*)elfGetListNext(scene->entityQueue))
+			// visibility comes from the previous frame's queries, this only waits if the driver does
+			elfBeginProfileScope("occlusion results");
+
+			for(i = 0; i < scene->entityQueue->length; i++)
 			{
+				ent = (elfEntity*)scene->entityQueue->objs[i];
 				if(ent->occluder) continue;
 
-				if(gfxGetQueryResult(ent->query) < 1)
+				if(elfIsEntityOccluded(ent, scene->occlusionFrame))
 				{
-					elfRemoveListObject(scene->entityQueue, (elfObject*)ent);
-					scene->entityQueueCount--; i--;
+					ent->culled = ELF_TRUE;
+					elfRemoveArrayObjectByIndex(scene->entityQueue, i);
+					i--;
 				}
 				else
 				{
-					elfDrawEntity(ent, ELF_DRAW_DEPTH, &scene->shaderParams);
+					elfQueueSceneEntity(scene, ent);
 				}
 			}
 
-			for(i = 0, spr = (elfSprite*)elfBeginList(scene->spriteQueue);
-				i < scene->spriteQueueCount && spr != NULL;
-				i++, spr = (elfSprite*)elfGetListNext(scene->spriteQueue))
+			elfEndProfileScope();
+
+			elfDrawSceneQueue(scene, ELF_DRAW_DEPTH, &scene->shaderParams);
+
+			for(i = 0; i < scene->spriteQueue->length; i++)
 			{
+				spr = (elfSprite*)scene->spriteQueue->objs[i];
 				if(spr->occluder) continue;
 
 				elfDrawSprite(spr, ELF_DRAW_DEPTH, &scene->shaderParams);
@@ -1741,17 +2252,17 @@ void elfDrawScene(elfScene* scene)
 			scene->shaderParams.renderParams.colorWrite = ELF_FALSE;
 			scene->shaderParams.renderParams.alphaWrite = ELF_FALSE;
 
-			for(i = 0, ent = (elfEntity*)elfBeginList(scene->entityQueue);
-				i < scene->entityQueueCount && ent != NULL;
-				i++, ent = (elfEntity*)elfGetListNext(scene->entityQueue))
+			for(i = 0; i < scene->entityQueue->length; i++)
 			{
-				elfDrawEntity(ent, ELF_DRAW_DEPTH, &scene->shaderParams);
+				ent = (elfEntity*)scene->entityQueue->objs[i];
+				elfQueueSceneEntity(scene, ent);
 			}
 
-			for(i = 0, spr = (elfSprite*)elfBeginList(scene->spriteQueue);
-				i < scene->spriteQueueCount && spr != NULL;
-				i++, spr = (elfSprite*)elfGetListNext(scene->spriteQueue))
+			elfDrawSceneQueue(scene, ELF_DRAW_DEPTH, &scene->shaderParams);
+
+			for(i = 0; i < scene->spriteQueue->length; i++)
 			{
+				spr = (elfSprite*)scene->spriteQueue->objs[i];
 				elfDrawSprite(spr, ELF_DRAW_DEPTH, &scene->shaderParams);
 			}
 		}
@@ -1764,51 +2275,27 @@ void elfDrawScene(elfScene* scene)
 		scene->shaderParams.renderParams.colorWrite = ELF_FALSE;
 		scene->shaderParams.renderParams.alphaWrite = ELF_FALSE;
 
-		scene->entityQueueCount = 0;
-		elfBeginList(scene->entityQueue);
+		elfBeginSceneCulling(scene);
+		elfCullSceneEntities(scene, scene->curCamera);
 
-		for(ent = (elfEntity*)elfBeginList(scene->entities); ent != NULL;
-			ent = (elfEntity*)elfGetListNext(scene->entities))
+		for(i = 0; i < scene->entityBatch.visibleCount; i++)
 		{
-			if(!elfCullEntity(ent, scene->curCamera))
-			{
-				if(scene->entityQueueCount < elfGetListLength(scene->entityQueue))
-				{
-					elfSetListCurPtr(scene->entityQueue, (elfObject*)ent);
-					elfGetListNext(scene->entityQueue);
-				}
-				else
-				{
-					elfAppendListObject(scene->entityQueue, (elfObject*)ent);
-				}
-				scene->entityQueueCount++;
-				elfDrawEntity(ent, ELF_DRAW_DEPTH, &scene->shaderParams);
-				ent->culled = ELF_FALSE;
-			}
-			else
-			{
-				ent->culled = ELF_TRUE;
-			}
+			ent = scene->entityBatch.entities[scene->entityBatch.visible[i]];
+			elfAppendArrayObject(scene->entityQueue, (elfObject*)ent);
+			elfQueueSceneEntity(scene, ent);
+			ent->culled = ELF_FALSE;
 		}
 
-		scene->spriteQueueCount = 0;
-		elfBeginList(scene->spriteQueue);
+		elfDrawSceneQueue(scene, ELF_DRAW_DEPTH, &scene->shaderParams);
 
-		for(spr = (elfSprite*)elfBeginList(scene->sprites); spr != NULL;
-			spr = (elfSprite*)elfGetListNext(scene->sprites))
+		elfClearArray(scene->spriteQueue);
+
+		for(i = 0; i < scene->sprites->length; i++)
 		{
+			spr = (elfSprite*)scene->sprites->objs[i];
 			if(!elfCullSprite(spr, scene->curCamera))
 			{
-				if(scene->spriteQueueCount < elfGetListLength(scene->spriteQueue))
-				{
-					elfSetListCurPtr(scene->spriteQueue, (elfObject*)spr);
-					elfGetListNext(scene->spriteQueue);
-				}
-				else
-				{
-					elfAppendListObject(scene->spriteQueue, (elfObject*)spr);
-				}
-				scene->spriteQueueCount++;
+				elfAppendArrayObject(scene->spriteQueue, (elfObject*)spr);
 				elfDrawSprite(spr, ELF_DRAW_DEPTH, &scene->shaderParams);
 				spr->culled = ELF_FALSE;
 			}
@@ -1819,11 +2306,22 @@ void elfDrawScene(elfScene* scene)
 		}
 	}
 
+	elfEndProfileScope();
+
+	// the queue is final at this point, pack it for the spot light culling
+	elfBeginCullBatch(&scene->queueBatch);
+	for(i = 0; i < scene->entityQueue->length; i++)
+	{
+		elfAddCullBatchEntity(&scene->queueBatch, (elfEntity*)scene->entityQueue->objs[i]);
+	}
+
 	// draw ambient pass
 	if(!elfAboutZero(scene->ambientColor.r) ||
 		!elfAboutZero(scene->ambientColor.g) ||
 		!elfAboutZero(scene->ambientColor.b) )
 	{
+		elfBeginProfileScope("ambient");
+
 		gfxSetShaderParamsDefault(&scene->shaderParams);
 		elfSetCamera(scene->curCamera, &scene->shaderParams);
 
@@ -1831,22 +2329,26 @@ void elfDrawScene(elfScene* scene)
 		scene->shaderParams.renderParams.depthFunc = GFX_EQUAL;
 		scene->shaderParams.renderParams.blendMode = GFX_ADD;
 
-		for(i = 0, ent = (elfEntity*)elfBeginList(scene->entityQueue);
-			i < scene->entityQueueCount && ent != NULL;
-			i++, ent = (elfEntity*)elfGetListNext(scene->entityQueue))
+		for(i = 0; i < scene->entityQueue->length; i++)
 		{
-			elfDrawEntity(ent, ELF_DRAW_AMBIENT, &scene->shaderParams);
+			ent = (elfEntity*)scene->entityQueue->objs[i];
+			elfQueueSceneEntity(scene, ent);
 		}
 
-		for(i = 0, spr = (elfSprite*)elfBeginList(scene->spriteQueue);
-			i < scene->spriteQueueCount && spr != NULL;
-			i++, spr = (elfSprite*)elfGetListNext(scene->spriteQueue))
+		elfDrawSceneQueue(scene, ELF_DRAW_AMBIENT, &scene->shaderParams);
+
+		for(i = 0; i < scene->spriteQueue->length; i++)
 		{
+			spr = (elfSprite*)scene->spriteQueue->objs[i];
 			elfDrawSprite(spr, ELF_DRAW_AMBIENT, &scene->shaderParams);
 		}
+
+		elfEndProfileScope();
 	}
 
 	// draw non lighted stuff
+	elfBeginProfileScope("unlit");
+
 	gfxSetShaderParamsDefault(&scene->shaderParams);
 	elfSetCamera(scene->curCamera, &scene->shaderParams);
 
@@ -1854,24 +2356,26 @@ void elfDrawScene(elfScene* scene)
 	scene->shaderParams.renderParams.depthFunc = GFX_EQUAL;
 	scene->shaderParams.renderParams.blendMode = GFX_ADD;
 
-	for(i = 0, ent = (elfEntity*)elfBeginList(scene->entityQueue);
-		i < scene->entityQueueCount && ent != NULL;
-		i++, ent = (elfEntity*)elfGetListNext(scene->entityQueue))
+	for(i = 0; i < scene->entityQueue->length; i++)
 	{
-		elfDrawEntity(ent, ELF_DRAW_WITHOUT_LIGHTING, &scene->shaderParams);
+		ent = (elfEntity*)scene->entityQueue->objs[i];
+		elfQueueSceneEntity(scene, ent);
 	}
 
-	for(i = 0, spr = (elfSprite*)elfBeginList(scene->spriteQueue);
-		i < scene->spriteQueueCount && spr != NULL;
-		i++, spr = (elfSprite*)elfGetListNext(scene->spriteQueue))
+	elfDrawSceneQueue(scene, ELF_DRAW_WITHOUT_LIGHTING, &scene->shaderParams);
+
+	for(i = 0; i < scene->spriteQueue->length; i++)
 	{
+		spr = (elfSprite*)scene->spriteQueue->objs[i];
 		elfDrawSprite(spr, ELF_DRAW_WITHOUT_LIGHTING, &scene->shaderParams);
 	}
 
+	elfEndProfileScope();
+
 	// render lighting
-	for(light = (elfLight*)elfBeginList(scene->lights); light != NULL;
-		light = (elfLight*)elfGetListNext(scene->lights))
+	for(j = 0; j < scene->lights->length; j++)
 	{
+		light = (elfLight*)scene->lights->objs[j];
 		if(!light->visible) continue;
 
 		if(light->lightType == ELF_SPOT_LIGHT)
@@ -1881,22 +2385,11 @@ void elfDrawScene(elfScene* scene)
 			elfSetCamera(light->shadowCamera, &scene->shaderParams);
 
 			// check are there any entities visible for the spot, if there aren't don't bother continuing, just skip to the next light
-			found = ELF_FALSE;
-			for(i = 0, ent = (elfEntity*)elfBeginList(scene->entityQueue);
-				i < scene->entityQueueCount && ent != NULL;
-				i++, ent = (elfEntity*)elfGetListNext(scene->entityQueue))
-			{
-				if(!elfCullEntity(ent, light->shadowCamera))
-				{
-					found = ELF_TRUE;
-					break;
-				}
-			}
+			found = elfCullBatchCamera(&scene->queueBatch, light->shadowCamera) > 0;
 
-			for(i = 0, spr = (elfSprite*)elfBeginList(scene->spriteQueue);
-				i < scene->spriteQueueCount && spr != NULL;
-				i++, spr = (elfSprite*)elfGetListNext(scene->spriteQueue))
+			for(i = 0; i < scene->spriteQueue->length && !found; i++)
 			{
+				spr = (elfSprite*)scene->spriteQueue->objs[i];
 				if(!elfCullSprite(spr, light->shadowCamera))
 				{
 					found = ELF_TRUE;
@@ -1907,9 +2400,13 @@ void elfDrawScene(elfScene* scene)
 			if(!found) continue;
 		}
 
+		elfBeginProfileScope(light->name ? light->name : "light");
+
 		// render shadow map if needed
 		if(light->lightType == ELF_SPOT_LIGHT && light->shadows && gfxGetVersion() >= 200)
 		{
+			elfBeginProfileScope("shadow map");
+
 			gfxSetShaderParamsDefault(&scene->shaderParams);
 			scene->shaderParams.renderParams.colorWrite = GFX_FALSE;
 			scene->shaderParams.renderParams.alphaWrite = GFX_FALSE;
@@ -1921,18 +2418,18 @@ void elfDrawScene(elfScene* scene)
 			gfxSetRenderTarget(rnd->shadowTarget);
 			gfxClearDepthBuffer(1.0f);
 
-			for(ent = (elfEntity*)elfBeginList(scene->entities); ent != NULL;
-				ent = (elfEntity*)elfGetListNext(scene->entities))
+			elfCullSceneEntities(scene, light->shadowCamera);
+			for(i = 0; i < scene->entityBatch.visibleCount; i++)
 			{
-				if(!elfCullEntity(ent, light->shadowCamera))
-				{
-					elfDrawEntity(ent, ELF_DRAW_DEPTH, &scene->shaderParams);
-				}
+				ent = scene->entityBatch.entities[scene->entityBatch.visible[i]];
+				elfQueueSceneEntity(scene, ent);
 			}
 
-			for(spr = (elfSprite*)elfBeginList(scene->sprites); spr != NULL;
-				spr = (elfSprite*)elfGetListNext(scene->sprites))
+			elfDrawSceneQueue(scene, ELF_DRAW_DEPTH, &scene->shaderParams);
+
+			for(i = 0; i < scene->sprites->length; i++)
 			{
+				spr = (elfSprite*)scene->sprites->objs[i];
 				if(!elfCullSprite(spr, light->shadowCamera))
 				{
 					elfDrawSprite(spr, ELF_DRAW_DEPTH, &scene->shaderParams);
@@ -1946,6 +2443,8 @@ void elfDrawScene(elfScene* scene)
 
 			if(renderTarget) gfxSetRenderTarget(renderTarget);
 			else gfxDisableRenderTarget();
+
+			elfEndProfileScope();
 		}
 
 		// render lighting
@@ -1988,34 +2487,39 @@ void elfDrawScene(elfScene* scene)
 
 		// get the light position for culling point light entities
 		lpos = elfGetActorPosition((elfActor*)light);
-		for(i = 0, ent = (elfEntity*)elfBeginList(scene->entityQueue);
-			i < scene->entityQueueCount && ent != NULL;
-			i++, ent = (elfEntity*)elfGetListNext(scene->entityQueue))
+		if(light->lightType == ELF_SPOT_LIGHT)
 		{
-			if(light->lightType == ELF_SPOT_LIGHT)
+			// queueBatch still holds the shadow camera results from the visibility check above
+			for(i = 0; i < scene->queueBatch.visibleCount; i++)
 			{
-				if(!elfCullEntity(ent, light->shadowCamera))
-				{
-					elfDrawEntity(ent, ELF_DRAW_WITH_LIGHTING, &scene->shaderParams);
-				}
+				ent = scene->queueBatch.entities[scene->queueBatch.visible[i]];
+				elfQueueSceneEntity(scene, ent);
 			}
-			else if(light->lightType == ELF_POINT_LIGHT)
+		}
+		else
+		{
+			for(i = 0; i < scene->entityQueue->length; i++)
 			{
-				if(gfxBoxSphereIntersect(&ent->cullAabbMin.x, &ent->cullAabbMax.x, &lpos.x, light->range+light->fadeRange))
+				ent = (elfEntity*)scene->entityQueue->objs[i];
+				if(light->lightType == ELF_POINT_LIGHT)
 				{
-					elfDrawEntity(ent, ELF_DRAW_WITH_LIGHTING, &scene->shaderParams);
+					if(gfxBoxSphereIntersect(&ent->cullAabbMin.x, &ent->cullAabbMax.x, &lpos.x, light->range+light->fadeRange))
+					{
+						elfQueueSceneEntity(scene, ent);
+					}
+				}
+				else
+				{
+					elfQueueSceneEntity(scene, ent);
 				}
-			}
-			else
-			{
-				elfDrawEntity(ent, ELF_DRAW_WITH_LIGHTING, &scene->shaderParams);
 			}
 		}
 
-		for(i = 0, spr = (elfSprite*)elfBeginList(scene->spriteQueue);
-			i < scene->spriteQueueCount && spr != NULL;
-			i++, spr = (elfSprite*)elfGetListNext(scene->spriteQueue))
+		elfDrawSceneQueue(scene, ELF_DRAW_WITH_LIGHTING, &scene->shaderParams);
+
+		for(i = 0; i < scene->spriteQueue->length; i++)
 		{
+			spr = (elfSprite*)scene->spriteQueue->objs[i];
 			spos = elfGetActorPosition((elfActor*)spr);
 			if(light->lightType == ELF_SPOT_LIGHT)
 			{
@@ -2040,10 +2544,14 @@ void elfDrawScene(elfScene* scene)
 				elfDrawSprite(spr, ELF_DRAW_WITH_LIGHTING, &scene->shaderParams);
 			}
 		}
+
+		elfEndProfileScope();
 	}
 
 	if(scene->fog && gfxGetVersion() >= 200)
 	{
+		elfBeginProfileScope("fog");
+
 		gfxSetShaderParamsDefault(&scene->shaderParams);
 		scene->shaderParams.renderParams.depthWrite = GFX_FALSE;
 		scene->shaderParams.renderParams.depthFunc = GFX_EQUAL;
@@ -2060,22 +2568,32 @@ void elfDrawScene(elfScene* scene)
 
 		elfSetCamera(scene->curCamera, &scene->shaderParams);
 
-		for(i = 0, ent = (elfEntity*)elfBeginList(scene->entityQueue);
-			i < scene->entityQueueCount && ent != NULL;
-			i++, ent = (elfEntity*)elfGetListNext(scene->entityQueue))
+		for(i = 0; i < scene->entityQueue->length; i++)
 		{
+			ent = (elfEntity*)scene->entityQueue->objs[i];
+
+			// the overlay has to land on the skinned surface for the equal depth test to pass
+			if(ent->armature && ent->palette && !ent->vertices && scene->composeFogSkinShdr)
+				scene->shaderParams.shaderProgram = scene->composeFogSkinShdr;
+			else scene->shaderParams.shaderProgram = scene->composeFogShdr;
+
 			elfDrawEntity(ent, ELF_DRAW_AMBIENT, &scene->shaderParams);
 		}
 
-		for(i = 0, spr = (elfSprite*)elfBeginList(scene->spriteQueue);
-			i < scene->spriteQueueCount && spr != NULL;
-			i++, spr = (elfSprite*)elfGetListNext(scene->spriteQueue))
+		scene->shaderParams.shaderProgram = scene->composeFogShdr;
+
+		for(i = 0; i < scene->spriteQueue->length; i++)
 		{
+			spr = (elfSprite*)scene->spriteQueue->objs[i];
 			elfDrawSprite(spr, ELF_DRAW_AMBIENT, &scene->shaderParams);
 		}
+
+		elfEndProfileScope();
 	}
 
 	// render particles
+	elfBeginProfileScope("particles");
+
 	gfxSetShaderParamsDefault(&scene->shaderParams);
 	scene->shaderParams.renderParams.depthWrite = GFX_FALSE;
 	scene->shaderParams.renderParams.depthFunc = GFX_LEQUAL;
@@ -2099,23 +2617,12 @@ void elfDrawScene(elfScene* scene)
 		}
 	}
 
+	elfEndProfileScope();
+
 	// reset state just to be sure...
 	gfxSetShaderParamsDefault(&scene->shaderParams);
 	gfxSetShaderParams(&scene->shaderParams);
 
-	// keep the query lists compact
-
-	if(elfGetListLength(scene->entityQueue) > scene->entityQueueCount)
-	{
-		ent = (elfEntity*)elfRBeginList(scene->entityQueue);
-		if(ent) elfRemoveListObject(scene->entityQueue, (elfObject*)ent);
-	}
-
-	if(elfGetListLength(scene->spriteQueue) > scene->spriteQueueCount)
-	{
-		spr = (elfSprite*)elfRBeginList(scene->spriteQueue);
-		if(spr) elfRemoveListObject(scene->spriteQueue, (elfObject*)spr);
-	}
 }
 
 /*void elfDrawScene(elfScene* scene)
@@ -2665,6 +3172,7 @@ void elfDrawSceneDebug(elfScene* scene)
 	elfCamera* cam;
 	elfParticles* par;
 	elfSprite* spr;
+	int i;
 
 	if(!scene->curCamera) return;
 
@@ -2674,9 +3182,9 @@ void elfDrawSceneDebug(elfScene* scene)
 	scene->shaderParams.renderParams.blendMode = GFX_ADD;
 	elfSetCamera(scene->curCamera, &scene->shaderParams);
 
-	for(ent = (elfEntity*)elfBeginList(scene->entities); ent != NULL;
-		ent = (elfEntity*)elfGetListNext(scene->entities))
+	for(i = 0; i < scene->entities->length; i++)
 	{
+		ent = (elfEntity*)scene->entities->objs[i];
 		elfDrawEntityDebug(ent, &scene->shaderParams);
 	}
 
@@ -2696,9 +3204,9 @@ void elfDrawSceneDebug(elfScene* scene)
 	scene->shaderParams.renderParams.depthTest = GFX_FALSE;
 	elfSetCamera(scene->curCamera, &scene->shaderParams);
 
-	for(spr = (elfSprite*)elfBeginList(scene->sprites); spr != NULL;
-		spr = (elfSprite*)elfGetListNext(scene->sprites))
+	for(i = 0; i < scene->sprites->length; i++)
 	{
+		spr = (elfSprite*)scene->sprites->objs[i];
 		elfDrawSpriteDebug(spr, &scene->shaderParams);
 	}
 
@@ -2707,9 +3215,9 @@ void elfDrawSceneDebug(elfScene* scene)
 	scene->shaderParams.renderParams.depthTest = GFX_FALSE;
 	elfSetCamera(scene->curCamera, &scene->shaderParams);
 
-	for(lig = (elfLight*)elfBeginList(scene->lights); lig != NULL;
-		lig = (elfLight*)elfGetListNext(scene->lights))
+	for(i = 0; i < scene->lights->length; i++)
 	{
+		lig = (elfLight*)scene->lights->objs[i];
 		elfDrawLightDebug(lig, &scene->shaderParams);
 	}
 
@@ -2739,6 +3247,7 @@ ELF_API elfList* ELF_APIENTRY elfGetSceneScripts(elfScene* scene)
 	elfLight* lig;
 	elfParticles* par;
 	elfSprite* spr;
+	int i;
 
 	scripts = elfCreateList();
 
@@ -2751,18 +3260,18 @@ ELF_API elfList* ELF_APIENTRY elfGetSceneScripts(elfScene* scene)
 		}
 	}
 
-	for(ent = (elfEntity*)elfBeginList(scene->entities); ent;
-		ent = (elfEntity*)elfGetListNext(scene->entities))
+	for(i = 0; i < scene->entities->length; i++)
 	{
+		ent = (elfEntity*)scene->entities->objs[i];
 		if(ent->script && !elfGetResourceById(scripts, ent->script->id))
 		{
 			elfAppendListObject(scripts, (elfObject*)ent->script);
 		}
 	}
 
-	for(lig = (elfLight*)elfBeginList(scene->lights); lig;
-		lig = (elfLight*)elfGetListNext(scene->lights))
+	for(i = 0; i < scene->lights->length; i++)
 	{
+		lig = (elfLight*)scene->lights->objs[i];
 		if(lig->script && !elfGetResourceById(scripts, lig->script->id))
 		{
 			elfAppendListObject(scripts, (elfObject*)lig->script);
@@ -2778,9 +3287,9 @@ ELF_API elfList* ELF_APIENTRY elfGetSceneScripts(elfScene* scene)
 		}
 	}
 
-	for(spr = (elfSprite*)elfBeginList(scene->sprites); spr;
-		spr = (elfSprite*)elfGetListNext(scene->sprites))
+	for(i = 0; i < scene->sprites->length; i++)
 	{
+		spr = (elfSprite*)scene->sprites->objs[i];
 		if(spr->script && !elfGetResourceById(scripts, spr->script->id))
 		{
 			elfAppendListObject(scripts, (elfObject*)spr->script);
@@ -2798,12 +3307,13 @@ ELF_API elfList* ELF_APIENTRY elfGetSceneTextures(elfScene* scene)
 	elfEntity* ent;
 	elfParticles* par;
 	elfSprite* spr;
+	int i;
 
 	textures = elfCreateList();
 
-	for(ent = (elfEntity*)elfBeginList(scene->entities); ent;
-		ent = (elfEntity*)elfGetListNext(scene->entities))
+	for(i = 0; i < scene->entities->length; i++)
 	{
+		ent = (elfEntity*)scene->entities->objs[i];
 		for(mat = (elfMaterial*)elfBeginList(ent->materials); mat;
 			mat = (elfMaterial*)elfGetListNext(ent->materials))
 		{
@@ -2827,9 +3337,9 @@ ELF_API elfList* ELF_APIENTRY elfGetSceneTextures(elfScene* scene)
 			elfAppendListObject(textures, (elfObject*)par->texture);
 	}
 
-	for(spr = (elfSprite*)elfBeginList(scene->sprites); spr;
-		spr = (elfSprite*)elfGetListNext(scene->sprites))
+	for(i = 0; i < scene->sprites->length; i++)
 	{
+		spr = (elfSprite*)scene->sprites->objs[i];
 		mat = spr->material;
 		if(!mat) continue;
 
@@ -2855,12 +3365,13 @@ ELF_API elfList* ELF_APIENTRY elfGetSceneMaterials(elfScene* scene)
 	elfMaterial* mat;
 	elfEntity* ent;
 	elfSprite* spr;
+	int i;
 
 	materials = elfCreateList();
 
-	for(ent = (elfEntity*)elfBeginList(scene->entities); ent;
-		ent = (elfEntity*)elfGetListNext(scene->entities))
+	for(i = 0; i < scene->entities->length; i++)
 	{
+		ent = (elfEntity*)scene->entities->objs[i];
 		for(mat = (elfMaterial*)elfBeginList(ent->materials); mat;
 			mat = (elfMaterial*)elfGetListNext(ent->materials))
 		{
@@ -2871,9 +3382,9 @@ ELF_API elfList* ELF_APIENTRY elfGetSceneMaterials(elfScene* scene)
 		}
 	}
 
-	for(spr = (elfSprite*)elfBeginList(scene->sprites); spr;
-		spr = (elfSprite*)elfGetListNext(scene->sprites))
+	for(i = 0; i < scene->sprites->length; i++)
 	{
+		spr = (elfSprite*)scene->sprites->objs[i];
 		if(spr->material && !elfGetResourceById(materials, spr->material->id))
 		{
 			elfAppendListObject(materials, (elfObject*)spr->material);
@@ -2891,12 +3402,13 @@ ELF_API elfList* ELF_APIENTRY elfGetSceneModels(elfScene* scene)
 
 	elfEntity* ent;
 	elfParticles* par;
+	int i;
 
 	models = elfCreateList();
 
-	for(ent = (elfEntity*)elfBeginList(scene->entities); ent;
-		ent = (elfEntity*)elfGetListNext(scene->entities))
+	for(i = 0; i < scene->entities->length; i++)
 	{
+		ent = (elfEntity*)scene->entities->objs[i];
 		if(ent->model && !elfGetResourceById(models, ent->model->id))
 		{
 			elfAppendListObject(models, (elfObject*)ent->model);
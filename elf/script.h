@@ -58,6 +58,8 @@ void elfDestroyScript(void* data)
 {
 	elfScript* script = (elfScript*)data;
 
+	elfReleaseScriptChunk(script);
+
 	if(script->name) elfDestroyString(script->name);
 	if(script->filePath) elfDestroyString(script->filePath);
 	if(script->text) elfDestroyString(script->text);
@@ -85,6 +87,8 @@ ELF_API const char* ELF_APIENTRY elfGetScriptFilePath(elfScript* script)
 
 ELF_API void ELF_APIENTRY elfSetScriptText(elfScript* script, const char* text)
 {
+	elfReleaseScriptChunk(script);
+
 	if(script->text) elfDestroyString(script->text);
 	script->text = NULL;
 	if(text) script->text = elfCreateString(text);
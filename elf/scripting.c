@@ -12,10 +12,13 @@
 #include "types.h"
 
 int luaopen_elf(lua_State* L);
+void lua_create_elfObject(lua_State* L, elfObject* obj);
 
 struct elfScripting {
 	ELF_OBJECT_HEADER;
 	struct lua_State* L;
+	float gcTime;
+	int memory;
 };
 
 elfScripting* scr = NULL;
@@ -73,7 +76,32 @@ unsigned char elfInitScripting()
 
 void elfUpdateScripting()
 {
-	if(scr) lua_gc(scr->L, LUA_GCCOLLECT, 0);
+	double start;
+	double budget;
+
+	if(!scr) return;
+
+	start = elfGetTime();
+
+	switch(elfGetScriptGcMode())
+	{
+		case ELF_SCRIPT_GC_FULL:
+			lua_gc(scr->L, LUA_GCCOLLECT, 0);
+			break;
+		case ELF_SCRIPT_GC_STEP:
+			// lua keeps its own allocation driven steps running, this only
+			// spends the spare per frame budget on advancing the cycle
+			budget = (double)elfGetScriptGcBudget()/1000000.0;
+			while(elfGetTime()-start < budget)
+			{
+				if(lua_gc(scr->L, LUA_GCSTEP, 0)) break;
+			}
+			break;
+		default: break;
+	}
+
+	scr->gcTime = (float)(elfGetTime()-start);
+	scr->memory = lua_gc(scr->L, LUA_GCCOUNT, 0)*1024+lua_gc(scr->L, LUA_GCCOUNTB, 0);
 }
 
 void elfDeinitScripting()
@@ -100,16 +128,61 @@ ELF_API unsigned char ELF_APIENTRY elfRunString(const char* str)
 	return ELF_TRUE;
 }
 
+unsigned char elfCompileScript(elfScript* script)
+{
+	char* text;
+	int err;
+
+	if(!scr || !script->text || script->error) return ELF_FALSE;
+	if(script->chunk) return ELF_TRUE;
+
+	// the calling actor is handed to the chunk as its vararg, so "me" is a
+	// chunk local instead of a global set through a compiled string.
+	// prefix stays on the first line to keep the error line numbers intact
+	text = elfMergeStrings("local me = ...; ", script->text);
+
+	err = luaL_loadbuffer(scr->L, text, strlen(text), script->text);
+	elfDestroyString(text);
+
+	if(err)
+	{
+		elfSetError(ELF_CANT_RUN_SCRIPT, "error: can't compile script \"%s\"\n%s\n", script->name, lua_tostring(scr->L, -1));
+		lua_pop(scr->L, 1);
+
+		script->error = ELF_TRUE;
+		return ELF_FALSE;
+	}
+
+	script->chunk = luaL_ref(scr->L, LUA_REGISTRYINDEX);
+
+	return ELF_TRUE;
+}
+
+void elfReleaseScriptChunk(elfScript* script)
+{
+	if(scr && script->chunk) luaL_unref(scr->L, LUA_REGISTRYINDEX, script->chunk);
+	script->chunk = 0;
+}
+
 ELF_API unsigned char ELF_APIENTRY elfRunScript(elfScript* script)
 {
+	elfObject* actor;
 	int err;
 	
 	if(!scr || !script->text || script->error) return ELF_FALSE;
 
-	err = luaL_dostring(scr->L, script->text);
+	if(!script->chunk && !elfCompileScript(script)) return ELF_FALSE;
+
+	lua_rawgeti(scr->L, LUA_REGISTRYINDEX, script->chunk);
+	actor = elfGetActor();
+	if(actor) lua_create_elfObject(scr->L, actor);
+	else lua_pushnil(scr->L);
+
+	err = lua_pcall(scr->L, 1, 0, 0);
 	if(err)
 	{
 		elfSetError(ELF_CANT_RUN_SCRIPT, "error: can't run script \"%s\"\n%s\n", script->name, lua_tostring(scr->L, -1));
+		lua_pop(scr->L, 1);
 
 		script->error = ELF_TRUE;
 		return ELF_FALSE;
@@ -118,3 +191,15 @@ ELF_API unsigned char ELF_APIENTRY elfRunScript(elfScript* script)
 	return ELF_TRUE;
 }
 
+ELF_API float ELF_APIENTRY elfGetScriptGcTime()
+{
+	if(!scr) return 0.0f;
+	return scr->gcTime;
+}
+
+ELF_API int ELF_APIENTRY elfGetScriptMemory()
+{
+	if(!scr) return 0;
+	return scr->memory;
+}
+
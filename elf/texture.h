@@ -251,6 +251,7 @@ void elfDestroyTexture(void* data)
 
 	if(texture->texture) gfxDestroyTexture(texture->texture);
 	if(texture->data) free(texture->data);
+	if(texture->pak) elfDecRef((elfObject*)texture->pak);
 
 	elfDecObj(ELF_TEXTURE);
 
@@ -321,51 +322,57 @@ unsigned char elfLoadTextureData(elfTexture* texture)
 
 	if(!strcmp(fileType, ".pak"))
 	{
-		pak = elfCreatePakFromFile(texture->filePath);
+		// textures loaded from a pak keep it open, only reparse the index for ones that don't
+		pak = texture->pak;
+		if(!pak) pak = elfCreatePakFromFile(texture->filePath);
 		if(!pak) return ELF_FALSE;
 
+		elfIncRef((elfObject*)pak);
+
 		index = elfGetPakIndexByName(pak, texture->name, ELF_TEXTURE);
 		if(!index)
 		{
 			elfSetError(ELF_INVALID_FILE, "error: couldn't fine index for \"%s//%s\"\n", texture->filePath, texture->name);
-			elfDestroyPak(pak);
+			elfDecRef((elfObject*)pak);
 			return ELF_FALSE;
 		}
 
-		file = fopen(pak->filePath, "rb");
+		file = elfGetPakFile(pak);
 		fseek(file, elfGetPakIndexOffset(index), SEEK_SET);
-		if(feof(file)) return ELF_FALSE;
+		if(feof(file))
+		{
+			elfDecRef((elfObject*)pak);
+			return ELF_FALSE;
+		}
 
 		fread((char*)&magic, sizeof(int), 1, file);
 
 		if(magic != 179532108)
 		{
 			elfSetError(ELF_INVALID_FILE, "error: invalid texture \"%s//%s\", wrong magic number\n", texture->filePath, texture->name);
-			elfDestroyPak(pak);
-			fclose(file);
+			elfDecRef((elfObject*)pak);
 			return ELF_FALSE;
 		}
 
 		fread(name, sizeof(char), ELF_NAME_LENGTH, file);
 		fread((char*)&type, sizeof(unsigned char), 1, file);
 
-		if(type == 1)
+		if(type == 1 || type == 2)
 		{
 			fread((char*)&texture->dataSize, sizeof(int), 1, file);
 	 
 			texture->data = (char*)malloc(texture->dataSize);
 			fread((char*)texture->data, 1, texture->dataSize, file);
+			texture->dataType = type;
 		}
 		else
 		{
 			elfSetError(ELF_UNKNOWN_FORMAT, "error: can't load texture \"%s//%s\", unknown format\n", texture->filePath, texture->name);
-			elfDestroyPak(pak);
-			fclose(file);
+			elfDecRef((elfObject*)pak);
 			return ELF_FALSE;
 		}
 
-		elfDestroyPak(pak);
-		fclose(file);
+		elfDecRef((elfObject*)pak);
 	}
 	else
 	{
@@ -382,6 +389,7 @@ unsigned char elfLoadTextureData(elfTexture* texture)
 
 		texture->data = malloc(texture->dataSize);
 		fread((char*)texture->data, 1, texture->dataSize, file);
+		texture->dataType = 1;
 
 		fclose(file);
 	}
@@ -389,10 +397,37 @@ unsigned char elfLoadTextureData(elfTexture* texture)
 	return ELF_TRUE;
 }
 
+void elfCompressTextureData(elfTexture* texture)
+{
+	unsigned char* pixels;
+	unsigned char* blocks;
+	int width;
+	int height;
+	unsigned char bpp;
+	int sizeBytes;
+
+	if(!texture->data || texture->dataType != 1) return;
+
+	pixels = elfDecodeTexture((char*)texture->data, texture->dataSize, &width, &height, &bpp);
+	if(!pixels) return;
+
+	// anything that isn't 8 bit rgb or rgba stays in its original encoding
+	blocks = elfCompressImageData(pixels, width, height, bpp, &sizeBytes);
+	free(pixels);
+
+	if(!blocks) return;
+
+	free(texture->data);
+	texture->data = blocks;
+	texture->dataSize = sizeBytes;
+	texture->dataType = 2;
+}
+
 void elfUnloadTextureData(elfTexture* texture)
 {
 	if(texture->data) free(texture->data);
 	texture->data = NULL;
 	texture->dataSize = 0;
+	texture->dataType = 0;
 }
 
@@ -36,6 +36,12 @@
 	elfVec3f anisFric; \
 	elfVec3f linFactor; \
 	elfVec3f angFactor; \
+	elfVec3f prevPosition; \
+	elfVec4f prevOrientation; \
+	elfVec3f stepPosition; \
+	elfVec4f stepOrientation; \
+	unsigned char stepStored; \
+	unsigned char interpolated; \
 	unsigned char moved; \
 	unsigned char selected
 
@@ -83,6 +89,38 @@ struct elfList {
 	int length;
 };
 
+struct elfArray {
+	ELF_OBJECT_HEADER;
+	elfObject** objs;
+	int length;
+	int size;
+	int* map;
+	int mapSize;
+	int cur;
+	elfObject* curObj;
+	unsigned char curRemoved;
+};
+
+struct elfJob {
+	void (*func)(void*);
+	void* data;
+};
+
+struct elfJobQueue {
+	ELF_OBJECT_HEADER;
+	int* threads;
+	int threadCount;
+	void* mutex;
+	void* workCond;
+	void* doneCond;
+	elfJob* jobs;
+	int jobCount;
+	int jobSize;
+	int next;
+	int pending;
+	unsigned char quit;
+};
+
 struct elfGeneral {
 	ELF_OBJECT_HEADER;
 	char* log;
@@ -103,6 +141,7 @@ struct elfConfig {
 	int multisamples;
 	unsigned char fullscreen;
 	unsigned char textureCompress;
+	unsigned char saveTextureCompress;
 	float textureAnisotropy;
 	int shadowMapSize;
 	char* start;
@@ -110,7 +149,17 @@ struct elfConfig {
 	float fpsLimit;
 	float tickRate;
 	float speed;
+	float stepRate;
+	int maxSteps;
+	unsigned char headless;
+	int benchmarkTicks;
 	unsigned char f10Exit;
+	int scriptGcMode;
+	int scriptGcBudget;
+	int threadCount;
+	unsigned char mapPaks;
+	float loadBudget;
+	float animationTolerance;
 };
 
 struct elfKeyEvent {
@@ -155,6 +204,8 @@ struct elfContext {
 	unsigned char prvMbuts[3];
 	elfJoystick joysticks[16];
 	elfList* events;
+	unsigned char headless;
+	double startTime;
 };
 
 struct elfEngine {
@@ -167,9 +218,16 @@ struct elfEngine {
 	int fps;
 	unsigned int frames;
 	float sync;
+	float stepTime;
+	float stepAlpha;
+	int steps;
 	elfTimer* fpsTimer;
 	elfTimer* fpsLimitTimer;
 	elfTimer* timeSyncTimer;
+	elfTimer* frameTimer;
+	float frameTimes[ELF_FRAME_TIME_SAMPLES];
+	int frameTimeCount;
+	int frameTimeIndex;
 
 	unsigned char freeRun;
 	unsigned char quit;
@@ -181,6 +239,22 @@ struct elfEngine {
 	elfScene* scene;
 	elfGui* gui;
 	elfObject* actor;
+
+	elfJobQueue* jobs;
+	elfSceneLoader* loader;
+	elfProfiler* profiler;
+};
+
+struct elfTextBatch {
+	gfxVertexData* vertices;
+	gfxVertexData* texCoords;
+	gfxVertexArray* vertexArray;
+	int size;
+	int count;
+	elfFont* font;
+	char* text;
+	int x, y;
+	unsigned int lastUse;
 };
 
 struct elfRenderStation {
@@ -212,6 +286,9 @@ struct elfRenderStation {
 	gfxVertexData* gradientVertexData;
 	gfxVertexData* gradientColorData;
 	gfxVertexArray* gradientVertexArray;
+
+	elfTextBatch textBatches[ELF_MAX_TEXT_BATCHES];
+	unsigned int textBatchUses;
 };
 
 struct elfResources {
@@ -255,11 +332,47 @@ struct elfFramePlayer {
 	void (*callback)(elfFramePlayer* );
 };
 
+typedef struct elfArmatureLayer {
+	elfFramePlayer* player;
+	float weight;
+	float prevFrame;
+} elfArmatureLayer;
+
 struct elfTimer {
 	ELF_OBJECT_HEADER;
 	double start;
 };
 
+struct elfProfileScope {
+	char name[32];
+	double start;
+	double end;
+	int depth;
+};
+
+struct elfProfileFrame {
+	double start;
+	double end;
+	elfProfileScope scopes[ELF_MAX_PROFILE_SCOPES];
+	int scopeCount;
+	int drawCalls;
+	int shaderSwitches;
+	int textureSwitches;
+	int blendSwitches;
+	int uploads;
+};
+
+struct elfProfiler {
+	ELF_OBJECT_HEADER;
+	unsigned char enabled;
+	unsigned char recording;
+	elfProfileFrame frames[ELF_PROFILE_FRAMES];
+	int frameIndex;
+	int frameCount;
+	int stack[ELF_MAX_PROFILE_DEPTH];
+	int depth;
+};
+
 struct elfImage {
 	ELF_OBJECT_HEADER;
 	int width;
@@ -272,9 +385,11 @@ struct elfTexture {
 	ELF_RESOURCE_HEADER;
 	char* filePath;
 	gfxTexture* texture;
+	elfPak* pak;
 
 	void* data;
 	int dataSize;
+	unsigned char dataType;
 };
 
 struct elfMaterial {
@@ -304,6 +419,7 @@ struct elfBezierPoint {
 	elfVec2f c1;
 	elfVec2f p;
 	elfVec2f c2;
+	elfBezierCurve* curve;
 };
 
 struct elfBezierCurve {
@@ -311,11 +427,17 @@ struct elfBezierCurve {
 	unsigned char curveType;
 	unsigned char interpolation;
 	elfList* points;
+	elfVec2f* keys;
+	int keyCount;
+	int keySize;
+	int cursor;
+	unsigned char dirty;
 };
 
 struct elfIpo {
 	ELF_OBJECT_HEADER;
 	elfList* curves;
+	elfBezierCurve* channels[ELF_QUA_W+1];
 	unsigned char loc;
 	unsigned char rot;
 	unsigned char scale;
@@ -391,12 +513,14 @@ struct elfModel {
 	gfxVertexData* texCoords;
 	gfxVertexData* tangents;
 	unsigned int* index;
-	float* weights;
-	int* boneids;
+	gfxVertexData* weights;
+	gfxVertexData* boneids;
+	int maxBoneId;
 	elfPhysicsTriMesh* triMesh;
 	elfModelArea* areas;
 	elfVec3f bbMin;
 	elfVec3f bbMax;
+	elfPakMapping* mapping;
 };
 
 struct elfEntity {
@@ -407,10 +531,14 @@ struct elfEntity {
 	elfArmature* armature;
 	gfxVertexData* vertices;
 	gfxVertexData* normals;
+	float* palette;
+	int paletteSize;
+	unsigned char skinPending;
 
 	elfList* materials;
 	elfFramePlayer* armaturePlayer;
-	float prevArmatureFrame;
+	elfArmatureLayer armatureLayers[ELF_MAX_ARMATURE_LAYERS];
+	unsigned char armatureBlendChanged;
 
 	elfVec3f position;
 	elfVec3f scale;
@@ -422,8 +550,12 @@ struct elfEntity {
 	elfVec3f cullAabbMin;
 	elfVec3f cullAabbMax;
 	float cullRadius;
+	int bvhNode;
 
-	gfxQuery* query;
+	gfxQuery* queries[2];
+	int queryFrames[2];
+	int testFrame;
+	unsigned char occluded;
 	unsigned char visible;
 	unsigned char occluder;
 	unsigned char culled;
@@ -449,12 +581,18 @@ struct elfLight {
 	float projectionMatrix[16];
 };
 
-typedef struct elfBoneFrame {
+struct elfBoneFrame {
 	elfVec3f pos;
 	elfVec4f qua;
 	elfVec3f offsetPos;
 	elfVec4f offsetQua;
-} elfBoneFrame;
+};
+
+struct elfBoneKey {
+	int frame;
+	elfVec3f offsetPos;
+	short offsetQua[4];
+};
 
 struct elfBone {
 	ELF_RESOURCE_HEADER;
@@ -465,6 +603,8 @@ struct elfBone {
 	elfVec4f curQua;
 	elfVec3f curOffsetPos;
 	elfVec4f curOffsetQua;
+	elfBoneKey* keys;
+	int keyCount;
 	elfBoneFrame* frames;
 	elfList* children;
 	elfArmature* armature;
@@ -482,17 +622,27 @@ struct elfArmature {
 	elfVec3f bbMax;
 };
 
-struct elfParticle {
-	ELF_OBJECT_HEADER;
-	float size;
-	float sizeGrowth;
-	float rotation;
-	float rotationGrowth;
-	elfColor color;
-	float lifeSpan;
-	float fadeSpeed;
-	elfVec3f position;
-	elfVec3f velocity;
+struct elfParticlePool {
+	float* data;
+	float* positionX;
+	float* positionY;
+	float* positionZ;
+	float* velocityX;
+	float* velocityY;
+	float* velocityZ;
+	float* colorR;
+	float* colorG;
+	float* colorB;
+	float* colorA;
+	float* size;
+	float* sizeGrowth;
+	float* rotation;
+	float* rotationGrowth;
+	float* lifeSpan;
+	float* fadeSpeed;
+	int count;
+	int simCount;
+	int capacity;
 };
 
 struct elfParticles {
@@ -500,7 +650,7 @@ struct elfParticles {
 
 	int maxCount;
 	unsigned char drawMode;
-	elfList* particles;
+	elfParticlePool pool;
 	elfTexture* texture;
 	elfModel* model;
 	elfEntity* entity;
@@ -513,6 +663,7 @@ struct elfParticles {
 	float spawnDelay;
 	unsigned char spawn;
 	float curTime;
+	float sync;
 	elfVec3f gravity;
 	float sizeMin;
 	float sizeMax;
@@ -556,6 +707,46 @@ struct elfSprite {
 	unsigned char culled;
 };
 
+struct elfRenderItem {
+	unsigned long long key;
+	elfEntity* entity;
+};
+
+struct elfCullBatch {
+	float* aabbs;
+	elfEntity** entities;
+	int* visible;
+	int count;
+	int size;
+	int visibleCount;
+};
+
+struct elfBvhNode {
+	elfVec3f min;
+	elfVec3f max;
+	int parent;
+	int left;
+	int right;
+	int first;
+	int count;
+	unsigned char refit;
+};
+
+struct elfBvh {
+	elfBvhNode* nodes;
+	int nodeCount;
+	int nodeSize;
+	int leafCount;
+	elfEntity** entities;
+	int entityCount;
+	int entitySize;
+	elfEntity** build;
+	int buildSize;
+	int changes;
+	unsigned char dirty;
+	unsigned char refit;
+};
+
 struct elfScene {
 	ELF_RESOURCE_HEADER;
 	char* filePath;
@@ -564,6 +755,7 @@ struct elfScene {
 	unsigned char runScripts;
 	unsigned char debugDraw;
 	unsigned char occlusionCulling;
+	unsigned char spatialIndex;
 
 	elfColor ambientColor;
 
@@ -577,17 +769,26 @@ struct elfScene {
 	elfList* materials;
 	elfList* models;
 	elfList* cameras;
-	elfList* entities;
-	elfList* lights;
+	elfArray* entities;
+	elfArray* lights;
 	elfList* armatures;
 	elfList* particles;
-	elfList* sprites;
-
-	elfList* entityQueue;
-	int entityQueueCount;
-
-	elfList* spriteQueue;
-	int spriteQueueCount;
+	elfArray* sprites;
+
+	elfArray* entityQueue;
+	elfArray* spriteQueue;
+	elfArray* skinQueue;
+	elfRenderItem* renderQueue;
+	int renderQueueLength;
+	int renderQueueSize;
+	elfEntity** instances;
+	float* instanceMatrices;
+	int instanceMatrixSize;
+
+	elfCullBatch entityBatch;
+	elfCullBatch queueBatch;
+	elfBvh bvh;
+	int occlusionFrame;
 
 	elfPhysicsWorld* world;
 	elfPhysicsWorld* dworld;
@@ -597,6 +798,7 @@ struct elfScene {
 	gfxShaderParams shaderParams;
 
 	gfxShaderProgram* composeFogShdr;
+	gfxShaderProgram* composeFogSkinShdr;
 
 	elfPak* pak;
 };
@@ -606,12 +808,27 @@ struct elfPakIndex {
 	unsigned char indexType;
 	char* name;
 	unsigned int offset;
+	unsigned int hash;
+	elfPakIndex* hashNext;
+	elfObject* object;
+};
+
+struct elfPakMapping {
+	ELF_OBJECT_HEADER;
+	char* data;
+	long size;
 };
 
 struct elfPak {
 	ELF_OBJECT_HEADER;
 	char* filePath;
 	elfList* indexes;
+	elfPakIndex** indexTable;
+	int indexTableSize;
+	FILE* file;
+	elfPakMapping* mapping;
+	char* data;
+	long dataSize;
 
 	int textureCount;
 	int materialCount;
@@ -624,6 +841,35 @@ struct elfPak {
 	int scriptCount;
 };
 
+struct elfTextureDecode {
+	elfSceneLoader* loader;
+	elfPakIndex* index;
+	unsigned char* data;
+	int width;
+	int height;
+	unsigned char bpp;
+	char* blocks;
+	int blocksSize;
+	unsigned char decoded;
+};
+
+struct elfSceneLoader {
+	ELF_OBJECT_HEADER;
+	char* filePath;
+	elfPak* pak;
+	elfScene* scene;
+	elfJobQueue* jobs;
+	void* mutex;
+	elfTextureDecode* decodes;
+	int decodeCount;
+	int uploaded;
+	elfPakIndex* next;
+	unsigned char sceneRead;
+	int steps;
+	int stepCount;
+	unsigned char done;
+};
+
 struct elfPostProcess {
 	ELF_OBJECT_HEADER;
 
@@ -680,12 +926,14 @@ struct elfScript {
 	ELF_RESOURCE_HEADER;
 	char* filePath;
 	char* text;
+	int chunk;
 	unsigned char error;
 };
 
 typedef struct elfCharacter {
 	char code;
-	gfxTexture* texture;
+	int x, y;
+	int width, height;
 	int offsetX, offsetY;
 } elfCharacter;
 
@@ -696,6 +944,8 @@ struct elfFont {
 	int size;
 	elfCharacter chars[128];
 	int offsetY;
+	gfxTexture* atlas;
+	int atlasWidth, atlasHeight;
 };
 
 struct elfArea {
@@ -711,6 +961,7 @@ struct elfLabel {
 	ELF_GUI_OBJECT_HEADER;
 	elfFont* font;
 	char* text;
+	elfTextBatch textBatch;
 };
 
 struct elfButton {
@@ -721,6 +972,7 @@ struct elfButton {
 	elfTexture* off;
 	elfTexture* over;
 	elfTexture* on;
+	elfTextBatch textBatch;
 };
 
 struct elfPicture {
@@ -739,6 +991,7 @@ struct elfTextField {
 	int drawPos;
 	int drawOffset;
 	char* text;
+	elfTextBatch textBatch;
 };
 
 struct elfSlider {
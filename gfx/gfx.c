@@ -7,6 +7,10 @@
 #include <malloc.h>
 #include <sys/types.h>
 
+#ifdef __SSE__
+	#include <xmmintrin.h>
+#endif
+
 #include <GL/glew.h>
 #ifdef ELF_MACOSX
 	#include <OpenGL/gl.h>
@@ -21,6 +25,69 @@ gfxDriver* driver = NULL;
 
 extern void elfLogWrite(const char* fmt, ...);
 
+// every entry point glew loads is called through GLEW_GET_FUN, so counting there covers
+// the shader, buffer, framebuffer and query calls
+#ifdef GLEW_GET_FUN
+	#undef GLEW_GET_FUN
+	#define GLEW_GET_FUN(x) (driver->glCalls++, x)
+#endif
+
+// the GL 1.1 functions are linked directly, so the ones the gfx modules below issue are
+// counted by name. a GL 1.1 call added to gfx needs a line here to show up in the count
+#define glAlphaFunc(a, b) (driver->glCalls++, glAlphaFunc(a, b))
+#define glBindTexture(a, b) (driver->glCalls++, glBindTexture(a, b))
+#define glBlendFunc(a, b) (driver->glCalls++, glBlendFunc(a, b))
+#define glClear(a) (driver->glCalls++, glClear(a))
+#define glClearColor(a, b, c, d) (driver->glCalls++, glClearColor(a, b, c, d))
+#define glClearDepth(a) (driver->glCalls++, glClearDepth(a))
+#define glColor4f(a, b, c, d) (driver->glCalls++, glColor4f(a, b, c, d))
+#define glColorMask(a, b, c, d) (driver->glCalls++, glColorMask(a, b, c, d))
+#define glColorPointer(a, b, c, d) (driver->glCalls++, glColorPointer(a, b, c, d))
+#define glCopyTexSubImage2D(a, b, c, d, e, f, g, h) (driver->glCalls++, glCopyTexSubImage2D(a, b, c, d, e, f, g, h))
+#define glCullFace(a) (driver->glCalls++, glCullFace(a))
+#define glDeleteTextures(a, b) (driver->glCalls++, glDeleteTextures(a, b))
+#define glDepthFunc(a) (driver->glCalls++, glDepthFunc(a))
+#define glDepthMask(a) (driver->glCalls++, glDepthMask(a))
+#define glDisable(a) (driver->glCalls++, glDisable(a))
+#define glDisableClientState(a) (driver->glCalls++, glDisableClientState(a))
+#define glDrawArrays(a, b, c) (driver->glCalls++, glDrawArrays(a, b, c))
+#define glDrawBuffer(a) (driver->glCalls++, glDrawBuffer(a))
+#define glDrawElements(a, b, c, d) (driver->glCalls++, glDrawElements(a, b, c, d))
+#define glEnable(a) (driver->glCalls++, glEnable(a))
+#define glEnableClientState(a) (driver->glCalls++, glEnableClientState(a))
+#define glFogf(a, b) (driver->glCalls++, glFogf(a, b))
+#define glFogfv(a, b) (driver->glCalls++, glFogfv(a, b))
+#define glFogi(a, b) (driver->glCalls++, glFogi(a, b))
+#define glFrontFace(a) (driver->glCalls++, glFrontFace(a))
+#define glGenTextures(a, b) (driver->glCalls++, glGenTextures(a, b))
+#define glGetError() (driver->glCalls++, glGetError())
+#define glGetFloatv(a, b) (driver->glCalls++, glGetFloatv(a, b))
+#define glGetIntegerv(a, b) (driver->glCalls++, glGetIntegerv(a, b))
+#define glGetString(a) (driver->glCalls++, glGetString(a))
+#define glIsEnabled(a) (driver->glCalls++, glIsEnabled(a))
+#define glLightf(a, b, c) (driver->glCalls++, glLightf(a, b, c))
+#define glLightfv(a, b, c) (driver->glCalls++, glLightfv(a, b, c))
+#define glLineWidth(a) (driver->glCalls++, glLineWidth(a))
+#define glLoadMatrixf(a) (driver->glCalls++, glLoadMatrixf(a))
+#define glMaterialf(a, b, c) (driver->glCalls++, glMaterialf(a, b, c))
+#define glMaterialfv(a, b, c) (driver->glCalls++, glMaterialfv(a, b, c))
+#define glMatrixMode(a) (driver->glCalls++, glMatrixMode(a))
+#define glNormalPointer(a, b, c) (driver->glCalls++, glNormalPointer(a, b, c))
+#define glPixelStorei(a, b) (driver->glCalls++, glPixelStorei(a, b))
+#define glPolygonMode(a, b) (driver->glCalls++, glPolygonMode(a, b))
+#define glPolygonOffset(a, b) (driver->glCalls++, glPolygonOffset(a, b))
+#define glReadBuffer(a) (driver->glCalls++, glReadBuffer(a))
+#define glReadPixels(a, b, c, d, e, f, g) (driver->glCalls++, glReadPixels(a, b, c, d, e, f, g))
+#define glShadeModel(a) (driver->glCalls++, glShadeModel(a))
+#define glTexCoordPointer(a, b, c, d) (driver->glCalls++, glTexCoordPointer(a, b, c, d))
+#define glTexGenfv(a, b, c) (driver->glCalls++, glTexGenfv(a, b, c))
+#define glTexGeni(a, b, c) (driver->glCalls++, glTexGeni(a, b, c))
+#define glTexImage2D(a, b, c, d, e, f, g, h, i) (driver->glCalls++, glTexImage2D(a, b, c, d, e, f, g, h, i))
+#define glTexParameterf(a, b, c) (driver->glCalls++, glTexParameterf(a, b, c))
+#define glTexParameteri(a, b, c) (driver->glCalls++, glTexParameteri(a, b, c))
+#define glVertexPointer(a, b, c, d) (driver->glCalls++, glVertexPointer(a, b, c, d))
+#define glViewport(a, b, c, d) (driver->glCalls++, glViewport(a, b, c, d))
+
 #include "gfxtypes.h"
 #include "gfxgeneral.h"
 #include "gfxmath.h"
@@ -34,8 +101,12 @@ extern void elfLogWrite(const char* fmt, ...);
 #include "gfxquery.h"
 #include "gfxgbuffer.h"
 
-unsigned char gfxInit()
+unsigned char gfxInit(unsigned char headless)
 {
+	const GLubyte* version;
+	const GLubyte* vendor;
+	const GLubyte* renderer;
+
 	if(driver) return GFX_TRUE;
 
 	gfxGen = gfxCreateGeneral();
@@ -86,6 +157,8 @@ unsigned char gfxInit()
 	driver->textureInternalFormats[GFX_R32F] = GL_R32F;
 	driver->textureInternalFormats[GFX_RG16F] = GL_RG16F;
 	driver->textureInternalFormats[GFX_RG32F] = GL_RG32F;
+	driver->textureInternalFormats[GFX_DXT1] = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	driver->textureInternalFormats[GFX_DXT5] = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
 
 	driver->textureDataFormats[GFX_LUMINANCE] = GL_LUMINANCE;
 	driver->textureDataFormats[GFX_LUMINANCE_ALPHA] = GL_LUMINANCE_ALPHA;
@@ -106,6 +179,8 @@ unsigned char gfxInit()
 	driver->textureDataFormats[GFX_R32F] = GL_R;
 	driver->textureDataFormats[GFX_RG16F] = GL_RG;
 	driver->textureDataFormats[GFX_RG32F] = GL_RG;
+	driver->textureDataFormats[GFX_DXT1] = GL_RGB;
+	driver->textureDataFormats[GFX_DXT5] = GL_RGBA;
 
 	driver->vertexDataDrawModes[GFX_VERTEX_DATA_STATIC] = GL_STATIC_DRAW;
 	driver->vertexDataDrawModes[GFX_VERTEX_DATA_DYNAMIC] = GL_DYNAMIC_DRAW;
@@ -114,9 +189,24 @@ unsigned char gfxInit()
 	driver->shaderConfig.textures = 255;
 	driver->shaderConfig.light = 255;
 
+	// without a context the version stays at zero, so vertex data never gets a vbo and no
+	// shaders are built, textures and render targets are created without touching gl
+	if(headless)
+	{
+		driver->headless = GFX_TRUE;
+		driver->maxTextureSize = 16384;
+		driver->maxDrawBuffers = 1;
+		driver->textureCompression = GFX_TRUE;
+		elfLogWrite("headless, no OpenGL context\n");
+		return GFX_TRUE;
+	}
+
 	glewInit();
 
-	elfLogWrite("OpenGL %s; %s; %s\n", glGetString(GL_VERSION), glGetString(GL_VENDOR), glGetString(GL_RENDERER));
+	version = glGetString(GL_VERSION);
+	vendor = glGetString(GL_VENDOR);
+	renderer = glGetString(GL_RENDERER);
+	elfLogWrite("OpenGL %s; %s; %s\n", version, vendor, renderer);
 
 	if(glewIsSupported("GL_VERSION_1_0")) driver->version = 100;
 	if(glewIsSupported("GL_VERSION_1_1")) driver->version = 110;
@@ -164,6 +254,23 @@ unsigned char gfxInit()
 	glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS_EXT, &driver->maxColorAttachments);
 	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &driver->maxAnisotropy);
 
+	// the bone palette shares the vertex uniforms with the matrices and light parameters,
+	// a quarter of them is left for those
+	if(driver->version >= 200)
+	{
+		glGetIntegerv(GL_MAX_VERTEX_UNIFORM_COMPONENTS, &driver->maxBones);
+		driver->maxBones = (driver->maxBones-driver->maxBones/4)/16;
+		if(driver->maxBones > GFX_MAX_BONES) driver->maxBones = GFX_MAX_BONES;
+	}
+
+	// per instance transforms come from a vertex buffer stepped once per instance
+	if(driver->version >= 200 && glewIsSupported("GL_ARB_draw_instanced GL_ARB_instanced_arrays"))
+		driver->instancing = GFX_TRUE;
+
+	// without s3tc the engine decodes compressed textures itself before uploading them
+	if(glewIsSupported("GL_EXT_texture_compression_s3tc"))
+		driver->textureCompression = GFX_TRUE;
+
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	glClearDepth(1.0f);
 
@@ -183,6 +290,8 @@ void gfxDeinit()
 	if(!driver) return;
 
 	if(driver->shaderPrograms) gfxDestroyShaderPrograms(driver->shaderPrograms);
+	if(driver->shaderProgramTable) free(driver->shaderProgramTable);
+	if(driver->instanceVbo) glDeleteBuffers(1, &driver->instanceVbo);
 
 	free(driver);
 	driver = NULL;
@@ -218,11 +327,31 @@ void gfxDeinit()
 	gfxDestroyGeneral(gfxGen);
 }
 
+unsigned char gfxIsHeadless()
+{
+	return driver->headless;
+}
+
 int gfxGetVersion()
 {
 	return driver->version;
 }
 
+int gfxGetMaxBones()
+{
+	return driver->maxBones;
+}
+
+unsigned char gfxIsInstancingSupported()
+{
+	return driver->instancing;
+}
+
+unsigned char gfxIsTextureCompressionSupported()
+{
+	return driver->textureCompression;
+}
+
 void gfxClearBuffers(float r, float g, float b, float a, float d)
 {
 	glClearColor(r, g, b, a);
@@ -270,6 +399,56 @@ int gfxGetVerticesDrawn(unsigned int drawMode)
 	return driver->verticesDrawn[drawMode];
 }
 
+void gfxResetGlCalls()
+{
+	driver->glCalls = 0;
+}
+
+int gfxGetGlCalls()
+{
+	return driver->glCalls;
+}
+
+void gfxResetDrawStats()
+{
+	driver->drawCalls = 0;
+	driver->instancesDrawn = 0;
+	driver->shaderSwitches = 0;
+	driver->textureSwitches = 0;
+	driver->blendSwitches = 0;
+	driver->uploads = 0;
+}
+
+int gfxGetDrawCalls()
+{
+	return driver->drawCalls;
+}
+
+int gfxGetInstancesDrawn()
+{
+	return driver->instancesDrawn;
+}
+
+int gfxGetShaderSwitches()
+{
+	return driver->shaderSwitches;
+}
+
+int gfxGetTextureSwitches()
+{
+	return driver->textureSwitches;
+}
+
+int gfxGetBlendSwitches()
+{
+	return driver->blendSwitches;
+}
+
+int gfxGetUploads()
+{
+	return driver->uploads;
+}
+
 void gfxPrintGLError()
 {
 	GLenum err;
@@ -32,6 +32,7 @@ extern "C" {
 #define GFX_WEIGHTS					0x0005
 #define GFX_BONEIDS					0x0006
 #define GFX_MAX_VERTEX_ARRAYS				0x0007
+#define GFX_INSTANCE_MATRIX				0x0008
 
 #define GFX_POINTS					0x0000
 #define GFX_LINES					0x0001
@@ -61,7 +62,9 @@ extern "C" {
 #define GFX_R32F					0x0010
 #define GFX_RG16F					0x0011
 #define GFX_RG32F					0x0012
-#define GFX_MAX_TEXTURE_FORMATS				0x0013
+#define GFX_DXT1					0x0013
+#define GFX_DXT5					0x0014
+#define GFX_MAX_TEXTURE_FORMATS				0x0015
 
 #define GFX_CLAMP					0x0000
 #define GFX_REPEAT					0x0001
@@ -73,6 +76,7 @@ extern "C" {
 #define GFX_SHADOW_PROJECTION				0x0001
 
 #define GFX_MAX_TEXTURES				0x0008
+#define GFX_MAX_BONES					0x0040
 
 #define GFX_NEVER					0x0000
 #define GFX_LESS					0x0001
@@ -138,6 +142,7 @@ typedef struct gfxVertexData				gfxVertexData;
 typedef struct gfxVertexArray				gfxVertexArray;
 typedef struct gfxVertexIndex				gfxVertexIndex;
 typedef struct gfxTexture				gfxTexture;
+typedef struct gfxUniform				gfxUniform;
 typedef struct gfxShaderProgram			gfxShaderProgram;
 typedef struct gfxRenderTarget			gfxRenderTarget;
 typedef struct gfxQuery				gfxQuery;
@@ -226,6 +231,9 @@ typedef struct gfxShaderParams {
 	float invProjectionMatrix[16];
 	float modelviewMatrix[16];
 	float normalMatrix[9];
+	float* bonePalette;
+	int boneCount;
+	int instanceCount;
 	gfxGbuffer* gbuffer;
 	unsigned char gbufferMode;
 	gfxShaderProgram* shaderProgram;
@@ -239,6 +247,8 @@ typedef struct gfxShaderConfig {
 	unsigned char vertexColor;
 	unsigned char fog;
 	unsigned char blend;
+	unsigned char skin;
+	unsigned char instanced;
 } gfxShaderConfig;
 
 //////////////////////////////// GENERAL ////////////////////////////////
@@ -291,10 +301,16 @@ void gfxMulMatrix4Vec3(float* m1, float* vec1, float* vec2);
 void gfxMulMatrix4Vec4(float* m1, float* vec1, float* vec2);
 void gfxMulMatrix4Matrix4(float* m1, float* m2, float* m3);
 void gfxMulMatrix3Matrix4(float* m1, float* m2, float* m3);
+void gfxSkinVertices(float* palette, int boneCount, int* boneids, float* weights,
+	float* vertices, float* normals, int count, float* outVertices, float* outNormals);
+void gfxMulAddArray(float* out, float* in, float scale, int count);
+void gfxAddArray(float* out, float value, int count);
 
 unsigned char gfxBoxSphereIntersect(float* bmin, float* bmax, float* spos, float srad);
+unsigned char gfxRayBoxIntersect(float* start, float* dir, float* bmin, float* bmax, float* t);
 
 unsigned char gfxAabbInsideFrustum(float frustum[6][4], float* min, float* max);
+int gfxAabbsInsideFrustum(float frustum[6][4], float* aabbs, int count, int* visible);
 unsigned char gfxSphereInsideFrustum(float frustum[6][4], float* pos, float radius);
 
 //////////////////////////////// TRANSFORM ////////////////////////////////
@@ -333,10 +349,14 @@ void gfxGetTransformOrientation(gfxTransform* transform, float* params);
 
 //////////////////////////////// DRIVER ////////////////////////////////
 
-unsigned char gfxInit();
+unsigned char gfxInit(unsigned char headless);
 void gfxDeinit();
+unsigned char gfxIsHeadless();
 
 int gfxGetVersion();
+int gfxGetMaxBones();
+unsigned char gfxIsInstancingSupported();
+unsigned char gfxIsTextureCompressionSupported();
 
 void gfxClearBuffers(float r, float g, float b, float a, float d);
 void gfxClearColorBuffer(float r, float g, float b, float a);
@@ -347,12 +367,22 @@ void gfxCopyFrameBuffer(gfxTexture* texture, int ox, int oy, int x, int y, int w
 
 void gfxResetVerticesDrawn();
 int gfxGetVerticesDrawn(unsigned int drawMode);
+void gfxResetGlCalls();
+int gfxGetGlCalls();
+void gfxResetDrawStats();
+int gfxGetDrawCalls();
+int gfxGetInstancesDrawn();
+int gfxGetShaderSwitches();
+int gfxGetTextureSwitches();
+int gfxGetBlendSwitches();
+int gfxGetUploads();
 
 void gfxPrintGLError();
 
 //////////////////////////////// VERTEX ARRAY/INDEX ////////////////////////////////
 
 gfxVertexData* gfxCreateVertexData(int count, int format, int dataType);
+gfxVertexData* gfxCreateVertexDataFromBuffer(int count, int format, int dataType, void* buffer);
 void gfxDestroyVertexData(void* data);
 int gfxGetVertexDataCount(gfxVertexData* data);
 int gfxGetVertexDataFormat(gfxVertexData* data);
@@ -376,6 +406,8 @@ void gfxDestroyVertexIndex(void* data);
 
 int gfxGetVertexIndexIndiceCount(gfxVertexIndex* vertexIndex);
 void gfxDrawVertexIndex(gfxVertexIndex* vertexIndex, unsigned int drawMode);
+void gfxSetInstanceMatrices(float* matrices, int count);
+void gfxDrawVertexIndexInstanced(gfxVertexIndex* vertexIndex, unsigned int drawMode, int instanceCount);
 
 //////////////////////////////// TEXTURE ////////////////////////////////
 
@@ -383,6 +415,7 @@ int gfxGetMaxTextureSize();
 
 gfxTexture* gfxCreateTexture();
 gfxTexture* gfxCreate2dTexture(unsigned int width, unsigned int height, float anisotropy, int mode, int filter, int format, int internalFormat, int dataFormat, void* data);
+gfxTexture* gfxCreate2dCompressedTexture(unsigned int width, unsigned int height, float anisotropy, int mode, int format, int levelCount, void** levels, int* levelSizes);
 gfxTexture* gfxCreateCubeMap(unsigned int width, unsigned int height, float anisotropy, int mode, int filter, int format, int internalFormat, int dataFormat, void* xpos, void* xneg, void* ypos, void* yneg, void* zpos, void* zneg);
 void gfxDestroyTexture(void* data);
 
@@ -410,6 +443,14 @@ void gfxSetShaderProgramUniformVec3(const char* name, float x, float y, float z)
 void gfxSetShaderProgramUniformVec4(const char* name, float x, float y, float z, float w);
 void gfxSetShaderProgramUniformMat4(const char* name, float* matrix);
 
+int gfxGetShaderProgramUniformLocation(gfxShaderProgram* shaderProgram, const char* name);
+void gfxSetUniform1i(int location, int i);
+void gfxSetUniform1f(int location, float f);
+void gfxSetUniformVec2(int location, float x, float y);
+void gfxSetUniformVec3(int location, float x, float y, float z);
+void gfxSetUniformVec4(int location, float x, float y, float z, float w);
+void gfxSetUniformMat4(int location, float* matrix);
+
 //////////////////////////////// RENDER TARGET ////////////////////////////////
 
 gfxRenderTarget* gfxCreateRenderTarget(unsigned int width, unsigned int height);
@@ -433,6 +474,8 @@ void gfxSetShaderParams(gfxShaderParams* shaderParams);
 
 void gfxGetShaderProgramConfig(gfxShaderParams* shaderParams, gfxShaderConfig* shaderConfig);
 gfxShaderProgram* gfxGetShaderProgram(gfxShaderConfig* config);
+gfxShaderProgram* gfxGetGbufShaderProgram(gfxShaderConfig* config);
+int gfxGetShaderProgramCount();
 
 //////////////////////////////// QUERY ////////////////////////////////
 
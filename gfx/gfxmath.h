@@ -688,6 +688,110 @@ void gfxMulMatrix3Matrix4(float* m1, float* m2, float* m3)
 	m3[8] = m1[6]*m2[2]+m1[7]*m2[6]+m1[8]*m2[10];
 }
 
+void gfxSkinVertices(float* palette, int boneCount, int* boneids, float* weights,
+	float* vertices, float* normals, int count, float* outVertices, float* outNormals)
+{
+	// palette holds four columns of four floats per bone, the last column is the translation.
+	// the weighted palette matrices are summed first, then each vertex is transformed once
+	float* mat;
+	float w;
+	int id;
+	int i, j;
+#ifdef __SSE__
+	__m128 c0, c1, c2, c3;
+	__m128 wv;
+	__m128 res;
+	float tmp[4];
+#else
+	float c[16];
+	int k;
+#endif
+
+	for(i = 0; i < count; i++)
+	{
+#ifdef __SSE__
+		c0 = c1 = c2 = c3 = _mm_setzero_ps();
+#else
+		memset(c, 0x0, sizeof(float)*16);
+#endif
+
+		for(j = 0; j < 4; j++)
+		{
+			id = boneids[i*4+j];
+			w = weights[i*4+j];
+			if(id < 0 || id > boneCount-1 || w == 0.0f) continue;
+
+			mat = &palette[id*16];
+
+#ifdef __SSE__
+			wv = _mm_set1_ps(w);
+			c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(&mat[0]), wv));
+			c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(&mat[4]), wv));
+			c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(&mat[8]), wv));
+			c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(&mat[12]), wv));
+#else
+			for(k = 0; k < 16; k++) c[k] += mat[k]*w;
+#endif
+		}
+
+#ifdef __SSE__
+		res = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(vertices[i*3])),
+			_mm_mul_ps(c1, _mm_set1_ps(vertices[i*3+1]))),
+			_mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(vertices[i*3+2])), c3));
+		_mm_storeu_ps(tmp, res);
+		memcpy(&outVertices[i*3], tmp, sizeof(float)*3);
+
+		res = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(normals[i*3])),
+			_mm_mul_ps(c1, _mm_set1_ps(normals[i*3+1]))),
+			_mm_mul_ps(c2, _mm_set1_ps(normals[i*3+2])));
+		_mm_storeu_ps(tmp, res);
+		memcpy(&outNormals[i*3], tmp, sizeof(float)*3);
+#else
+		for(k = 0; k < 3; k++)
+		{
+			outVertices[i*3+k] = c[k]*vertices[i*3]+c[4+k]*vertices[i*3+1]+c[8+k]*vertices[i*3+2]+c[12+k];
+			outNormals[i*3+k] = c[k]*normals[i*3]+c[4+k]*normals[i*3+1]+c[8+k]*normals[i*3+2];
+		}
+#endif
+	}
+}
+
+void gfxMulAddArray(float* out, float* in, float scale, int count)
+{
+	int i;
+#ifdef __SSE__
+	__m128 s;
+
+	s = _mm_set1_ps(scale);
+	for(i = 0; i+4 <= count; i += 4)
+	{
+		_mm_storeu_ps(&out[i], _mm_add_ps(_mm_loadu_ps(&out[i]), _mm_mul_ps(_mm_loadu_ps(&in[i]), s)));
+	}
+#else
+	i = 0;
+#endif
+
+	for(; i < count; i++) out[i] += in[i]*scale;
+}
+
+void gfxAddArray(float* out, float value, int count)
+{
+	int i;
+#ifdef __SSE__
+	__m128 v;
+
+	v = _mm_set1_ps(value);
+	for(i = 0; i+4 <= count; i += 4)
+	{
+		_mm_storeu_ps(&out[i], _mm_add_ps(_mm_loadu_ps(&out[i]), v));
+	}
+#else
+	i = 0;
+#endif
+
+	for(; i < count; i++) out[i] += value;
+}
+
 unsigned char gfxBoxSphereIntersect(float* bmin, float* bmax, float* spos, float srad)
 {
 	float dmin;
@@ -708,6 +812,38 @@ unsigned char gfxBoxSphereIntersect(float* bmin, float* bmax, float* spos, float
 	return GFX_FALSE;
 }
 
+unsigned char gfxRayBoxIntersect(float* start, float* dir, float* bmin, float* bmax, float* t)
+{
+	float tmin, tmax;
+	float t0, t1, tmp;
+	int i;
+
+	// dir spans the whole segment, so a hit has t in [0, 1]
+	tmin = 0.0f;
+	tmax = 1.0f;
+
+	for(i = 0; i < 3; i++)
+	{
+		if(fabs(dir[i]) < 0.000001f)
+		{
+			if(start[i] < bmin[i] || start[i] > bmax[i]) return GFX_FALSE;
+			continue;
+		}
+
+		t0 = (bmin[i]-start[i])/dir[i];
+		t1 = (bmax[i]-start[i])/dir[i];
+		if(t0 > t1) {tmp = t0; t0 = t1; t1 = tmp;}
+
+		if(t0 > tmin) tmin = t0;
+		if(t1 < tmax) tmax = t1;
+		if(tmin > tmax) return GFX_FALSE;
+	}
+
+	if(t) *t = tmin;
+
+	return GFX_TRUE;
+}
+
 unsigned char gfxAabbInsideFrustum(float frustum[6][4], float* min, float* max)
 {
 	int i;
@@ -736,6 +872,70 @@ unsigned char gfxAabbInsideFrustum(float frustum[6][4], float* min, float* max)
 	return GFX_TRUE;
 }
 
+int gfxAabbsInsideFrustum(float frustum[6][4], float* aabbs, int count, int* visible)
+{
+	// the boxes are packed in blocks of four, minx[4] miny[4] minz[4] maxx[4] maxy[4] maxz[4].
+	// a box is outside a plane when the corner furthest along the plane normal is behind it,
+	// which gives the same result as testing all eight corners in gfxAabbInsideFrustum
+	float* block;
+	float* x;
+	float* y;
+	float* z;
+	int outside;
+	int i, j, k;
+	int n;
+#ifdef __SSE__
+	__m128 a, b, c, d;
+	__m128 dist;
+	__m128 zero;
+
+	zero = _mm_setzero_ps();
+#else
+	float dist;
+#endif
+
+	n = 0;
+
+	for(i = 0; i < count; i += 4)
+	{
+		block = &aabbs[i*6];
+		outside = 0;
+
+		for(j = 0; j < 6; j++)
+		{
+			x = frustum[j][0] > 0.0f ? &block[12] : &block[0];
+			y = frustum[j][1] > 0.0f ? &block[16] : &block[4];
+			z = frustum[j][2] > 0.0f ? &block[20] : &block[8];
+
+#ifdef __SSE__
+			a = _mm_set1_ps(frustum[j][0]);
+			b = _mm_set1_ps(frustum[j][1]);
+			c = _mm_set1_ps(frustum[j][2]);
+			d = _mm_set1_ps(frustum[j][3]);
+
+			dist = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a, _mm_loadu_ps(x)),
+				_mm_mul_ps(b, _mm_loadu_ps(y))), _mm_mul_ps(c, _mm_loadu_ps(z))), d);
+			outside |= _mm_movemask_ps(_mm_cmpngt_ps(dist, zero));
+#else
+			for(k = 0; k < 4; k++)
+			{
+				dist = frustum[j][0]*x[k]+frustum[j][1]*y[k]+frustum[j][2]*z[k]+frustum[j][3];
+				if(!(dist > 0.0f)) outside |= 1 << k;
+			}
+#endif
+
+			if(outside == 0xF) break;
+		}
+
+		for(k = 0; k < 4 && i+k < count; k++)
+		{
+			if(!(outside & (1 << k))) visible[n++] = i+k;
+		}
+	}
+
+	return n;
+}
+
 unsigned char gfxSphereInsideFrustum(float frustum[6][4], float* pos, float radius)
 {
 	int i;
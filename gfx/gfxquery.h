@@ -6,14 +6,14 @@ gfxQuery* gfxCreateQuery()
 	query = (gfxQuery*)malloc(sizeof(gfxQuery));
 	memset(query, 0x0, sizeof(gfxQuery));
 
-	glGenQueries(1, &query->id);
+	if(!driver->headless) glGenQueries(1, &query->id);
 
 	return query;
 }
 
 void gfxDestroyQuery(gfxQuery* query)
 {
-	glDeleteQueries(1, &query->id);
+	if(query->id) glDeleteQueries(1, &query->id);
 	free(query);
 }
 
@@ -44,7 +44,7 @@ gfxRenderTarget* gfxCreateRenderTarget(unsigned int width, unsigned int height)
 	renderTarget->objType = GFX_RENDER_TARGET;
 	renderTarget->objDestr = gfxDestroyRenderTarget;
 
-	glGenFramebuffersEXT(1, &renderTarget->fb);
+	if(!driver->headless) glGenFramebuffersEXT(1, &renderTarget->fb);
 
 	gfxIncObj(GFX_RENDER_TARGET);
 
@@ -71,7 +71,7 @@ void gfxSetRenderTargetColorTexture(gfxRenderTarget* renderTarget, unsigned int
 {
 	gfxRenderTarget* rt;
 
-	if((int)n > driver->maxDrawBuffers-1) return;
+	if((int)n > driver->maxDrawBuffers-1 || driver->headless) return;
 
 	if(driver->renderTarget != renderTarget)
 		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, renderTarget->fb);
@@ -97,6 +97,8 @@ void gfxSetRenderTargetDepthTexture(gfxRenderTarget* renderTarget, gfxTexture* d
 {
 	gfxRenderTarget* rt;
 
+	if(driver->headless) return;
+
 	if(driver->renderTarget != renderTarget)
 		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, renderTarget->fb);
 
@@ -132,7 +134,7 @@ unsigned char gfxSetRenderTarget(gfxRenderTarget* renderTarget)
 	int i, j;
 	GLenum drawBuffers[16];
 
-	if(driver->renderTarget == renderTarget) return GFX_TRUE;
+	if(driver->renderTarget == renderTarget || driver->headless) return GFX_TRUE;
 
 	for(i = 0, j = 0; i < driver->maxDrawBuffers; i++)
 	{
@@ -29,6 +29,101 @@ void gfxDestroyString(char* str)
 	free(str);
 }
 
+unsigned int gfxGetShaderConfigKey(gfxShaderConfig* config)
+{
+	unsigned int key;
+
+	// each field gets the bits of the values the generator knows, textures the nine maps,
+	// light and gbuffer a type of 0-3, blend a mode of 0-4 and the rest a flag. the masks
+	// keep a wider value out of its neighbours, matches are compared in full anyway
+	key = config->textures&0x1ff;
+	key |= (unsigned int)(config->light&0x3)<<9;
+	key |= (unsigned int)(config->gbuffer&0x3)<<11;
+	key |= (unsigned int)(config->blend&0x7)<<13;
+	key |= (unsigned int)(config->fog&0x1)<<16;
+	key |= (unsigned int)(config->specular&0x1)<<17;
+	key |= (unsigned int)(config->vertexColor&0x1)<<18;
+	key |= (unsigned int)(config->skin&0x1)<<19;
+	key |= (unsigned int)(config->instanced&0x1)<<20;
+
+	return key;
+}
+
+int gfxGetShaderProgramBucket(unsigned int key, int tableSize)
+{
+	return (int)((key*2654435761u)>>16)&(tableSize-1);
+}
+
+gfxShaderProgram* gfxFindShaderProgram(gfxShaderConfig* config)
+{
+	gfxShaderProgram* shaderProgram;
+	unsigned int key;
+
+	if(!driver->shaderProgramTable) return NULL;
+
+	key = gfxGetShaderConfigKey(config);
+
+	shaderProgram = driver->shaderProgramTable[gfxGetShaderProgramBucket(key, driver->shaderProgramTableSize)];
+	while(shaderProgram)
+	{
+		if(shaderProgram->key == key && !memcmp(&shaderProgram->config, config, sizeof(gfxShaderConfig)))
+			return shaderProgram;
+		shaderProgram = shaderProgram->hashNext;
+	}
+
+	return NULL;
+}
+
+void gfxResizeShaderProgramTable(int tableSize)
+{
+	gfxShaderProgram* shaderProgram;
+	int bucket;
+
+	if(driver->shaderProgramTable) free(driver->shaderProgramTable);
+
+	driver->shaderProgramTableSize = tableSize;
+	driver->shaderProgramTable = (gfxShaderProgram**)malloc(sizeof(gfxShaderProgram*)*tableSize);
+	memset(driver->shaderProgramTable, 0x0, sizeof(gfxShaderProgram*)*tableSize);
+
+	for(shaderProgram = driver->shaderPrograms; shaderProgram; shaderProgram = shaderProgram->next)
+	{
+		bucket = gfxGetShaderProgramBucket(shaderProgram->key, tableSize);
+		shaderProgram->hashNext = driver->shaderProgramTable[bucket];
+		driver->shaderProgramTable[bucket] = shaderProgram;
+	}
+}
+
+void gfxAddShaderProgram(gfxShaderProgram* shaderProgram, gfxShaderConfig* config)
+{
+	int bucket;
+
+	memcpy(&shaderProgram->config, config, sizeof(gfxShaderConfig));
+	shaderProgram->key = gfxGetShaderConfigKey(config);
+
+	shaderProgram->next = driver->shaderPrograms;
+	driver->shaderPrograms = shaderProgram;
+	driver->shaderProgramCount++;
+
+	if(!driver->shaderProgramTable) gfxResizeShaderProgramTable(64);
+	else if(driver->shaderProgramCount > driver->shaderProgramTableSize)
+	{
+		// the new program is already in the list, the rebuild picks it up
+		gfxResizeShaderProgramTable(driver->shaderProgramTableSize*2);
+		return;
+	}
+	else
+	{
+		bucket = gfxGetShaderProgramBucket(shaderProgram->key, driver->shaderProgramTableSize);
+		shaderProgram->hashNext = driver->shaderProgramTable[bucket];
+		driver->shaderProgramTable[bucket] = shaderProgram;
+	}
+}
+
+int gfxGetShaderProgramCount()
+{
+	return driver->shaderProgramCount;
+}
+
 gfxLine* gfxCreateLine()
 {
 	gfxLine* line;
@@ -156,6 +251,55 @@ void gfxGetShaderProgramConfig(gfxShaderParams* shaderParams, gfxShaderConfig* s
 	shaderConfig->gbuffer = shaderParams->gbufferMode;
 	shaderConfig->fog = shaderParams->fogParams.mode;
 	shaderConfig->blend = shaderParams->renderParams.blendMode;
+	shaderConfig->skin = shaderParams->bonePalette && shaderParams->boneCount > 0;
+	shaderConfig->instanced = shaderParams->instanceCount > 0;
+}
+
+void gfxAddVertexInstancingAttributes(gfxDocument* document, gfxShaderConfig* config)
+{
+	if(!config->instanced) return;
+
+	gfxAddDocumentLine(document, "attribute mat4 elf_InstanceMatrixAttr;");
+}
+
+void gfxAddVertexInstancingCalcs(gfxDocument* document, gfxShaderConfig* config)
+{
+	if(!config->instanced) return;
+
+	// only uniformly scaled entities are instanced, the rotation part normalized is their normal matrix
+	gfxAddDocumentLine(document, "\tmat3 instanceNormalMatrix = mat3(elf_InstanceMatrixAttr[0].xyz, elf_InstanceMatrixAttr[1].xyz, elf_InstanceMatrixAttr[2].xyz)/length(elf_InstanceMatrixAttr[0].xyz);");
+	gfxAddDocumentLine(document, "#define elf_ModelviewMatrix elf_InstanceMatrixAttr");
+	gfxAddDocumentLine(document, "#define elf_NormalMatrix instanceNormalMatrix");
+}
+
+void gfxAddVertexSkinningAttributes(gfxDocument* document, gfxShaderConfig* config)
+{
+	char str[64];
+
+	if(!config->skin) return;
+
+	gfxAddDocumentLine(document, "attribute vec4 elf_WeightsAttr;");
+	gfxAddDocumentLine(document, "attribute vec4 elf_BoneIdsAttr;");
+	sprintf(str, "uniform mat4 elf_BonePalette[%d];", driver->maxBones);
+	gfxAddDocumentLine(document, str);
+}
+
+void gfxAddVertexSkinningCalcs(gfxDocument* document, gfxShaderConfig* config, unsigned char normal, unsigned char tangent)
+{
+	if(!config->skin) return;
+
+	gfxAddDocumentLine(document, "\tmat4 skinMatrix = elf_BonePalette[int(elf_BoneIdsAttr.x)]*elf_WeightsAttr.x;");
+	gfxAddDocumentLine(document, "\tskinMatrix += elf_BonePalette[int(elf_BoneIdsAttr.y)]*elf_WeightsAttr.y;");
+	gfxAddDocumentLine(document, "\tskinMatrix += elf_BonePalette[int(elf_BoneIdsAttr.z)]*elf_WeightsAttr.z;");
+	gfxAddDocumentLine(document, "\tskinMatrix += elf_BonePalette[int(elf_BoneIdsAttr.w)]*elf_WeightsAttr.w;");
+	gfxAddDocumentLine(document, "\tvec3 skinVertex = (skinMatrix*vec4(elf_VertexAttr, 1.0)).xyz;");
+	if(normal) gfxAddDocumentLine(document, "\tvec3 skinNormal = (skinMatrix*vec4(elf_NormalAttr, 0.0)).xyz;");
+	if(tangent) gfxAddDocumentLine(document, "\tvec3 skinTangent = (skinMatrix*vec4(elf_TangentAttr, 0.0)).xyz;");
+
+	// the rest of main reads the attributes by name, redirect them to the skinned values
+	gfxAddDocumentLine(document, "#define elf_VertexAttr skinVertex");
+	if(normal) gfxAddDocumentLine(document, "#define elf_NormalAttr skinNormal");
+	if(tangent) gfxAddDocumentLine(document, "#define elf_TangentAttr skinTangent");
 }
 
 void gfxAddVertexAttributes(gfxDocument* document, gfxShaderConfig* config)
@@ -165,6 +309,8 @@ void gfxAddVertexAttributes(gfxDocument* document, gfxShaderConfig* config)
 	if(config->textures) gfxAddDocumentLine(document, "attribute vec2 elf_TexCoordAttr;");
 	if((config->light && config->textures & GFX_NORMAL_MAP) || config->textures & GFX_HEIGHT_MAP) gfxAddDocumentLine(document, "attribute vec3 elf_TangentAttr;");
 	if(config->vertexColor) gfxAddDocumentLine(document, "attribute vec4 elf_ColorAttr;");
+	gfxAddVertexSkinningAttributes(document, config);
+	gfxAddVertexInstancingAttributes(document, config);
 }
 
 void gfxAddVertexUniforms(gfxDocument* document, gfxShaderConfig* config)
@@ -196,6 +342,10 @@ void gfxAddVertexInit(gfxDocument* document, gfxShaderConfig* config)
 {
 	gfxAddDocumentLine(document, "void main()");
 	gfxAddDocumentLine(document, "{");
+	gfxAddVertexInstancingCalcs(document, config);
+	gfxAddVertexSkinningCalcs(document, config,
+		config->light || config->textures & GFX_HEIGHT_MAP || config->textures & GFX_CUBE_MAP,
+		(config->light && config->textures & GFX_NORMAL_MAP) || config->textures & GFX_HEIGHT_MAP);
 	gfxAddDocumentLine(document, "\tvec4 vertex = elf_ModelviewMatrix*vec4(elf_VertexAttr, 1.0);");
 }
 
@@ -434,17 +584,11 @@ gfxShaderProgram* gfxGetShaderProgram(gfxShaderConfig* config)
 {
 	gfxDocument* document;
 	gfxShaderProgram* shaderProgram;
-	gfxShaderProgram* lshpr;
 	char* vertShdr;
 	char* fragShdr;
 
-	shaderProgram = driver->shaderPrograms;
-	while(shaderProgram)
-	{
-		if(!memcmp(&shaderProgram->config, config, sizeof(gfxShaderConfig)))
-			return shaderProgram;
-		shaderProgram = shaderProgram->next;
-	}
+	shaderProgram = gfxFindShaderProgram(config);
+	if(shaderProgram) return shaderProgram;
 
 	document = gfxCreateDocument();
 
@@ -499,18 +643,7 @@ gfxShaderProgram* gfxGetShaderProgram(gfxShaderConfig* config)
 	free(vertShdr);
 	free(fragShdr);
 
-	if(shaderProgram)
-	{
-		memcpy(&shaderProgram->config, config, sizeof(gfxShaderConfig));
-
-		if(!driver->shaderPrograms) driver->shaderPrograms = shaderProgram;
-		else
-		{
-			lshpr = driver->shaderPrograms;
-			while(lshpr->next) lshpr = lshpr->next;
-			lshpr->next = shaderProgram;
-		}
-	}
+	if(shaderProgram) gfxAddShaderProgram(shaderProgram, config);
 
 	return shaderProgram;
 }
@@ -522,6 +655,8 @@ void gfxAddGbufVertexAttributes(gfxDocument* document, gfxShaderConfig* config)
 	if(config->textures) gfxAddDocumentLine(document, "attribute vec2 elf_TexCoordAttr;");
 	if(config->textures & GFX_NORMAL_MAP) gfxAddDocumentLine(document, "attribute vec3 elf_TangentAttr;");
 	if(config->vertexColor) gfxAddDocumentLine(document, "attribute vec4 elf_ColorAttr;");
+	gfxAddVertexSkinningAttributes(document, config);
+	gfxAddVertexInstancingAttributes(document, config);
 }
 
 void gfxAddGbufVertexUniforms(gfxDocument* document, gfxShaderConfig* config)
@@ -549,6 +684,8 @@ void gfxAddGbufVertexInit(gfxDocument* document, gfxShaderConfig* config)
 {
 	gfxAddDocumentLine(document, "void main()");
 	gfxAddDocumentLine(document, "{");
+	gfxAddVertexInstancingCalcs(document, config);
+	gfxAddVertexSkinningCalcs(document, config, GFX_TRUE, config->textures & GFX_NORMAL_MAP ? GFX_TRUE : GFX_FALSE);
 	gfxAddDocumentLine(document, "\tvec4 vertex = elf_ModelviewMatrix*vec4(elf_VertexAttr, 1.0);");
 }
 
@@ -665,17 +802,11 @@ gfxShaderProgram* gfxGetGbufShaderProgram(gfxShaderConfig* config)
 {
 	gfxDocument* document;
 	gfxShaderProgram* shaderProgram;
-	gfxShaderProgram* lshpr;
 	char* vertShdr;
 	char* fragShdr;
 
-	shaderProgram = driver->shaderPrograms;
-	while(shaderProgram)
-	{
-		if(!memcmp(&shaderProgram->config, config, sizeof(gfxShaderConfig)))
-			return shaderProgram;
-		shaderProgram = shaderProgram->next;
-	}
+	shaderProgram = gfxFindShaderProgram(config);
+	if(shaderProgram) return shaderProgram;
 
 	document = gfxCreateDocument();
 
@@ -685,11 +816,15 @@ gfxShaderProgram* gfxGetGbufShaderProgram(gfxShaderConfig* config)
 	{
 		gfxAddDocumentLine(document, "attribute vec3 elf_VertexAttr;");
 		if(config->textures & GFX_COLOR_MAP) gfxAddDocumentLine(document, "attribute vec2 elf_TexCoordAttr;");
+		gfxAddVertexSkinningAttributes(document, config);
+		gfxAddVertexInstancingAttributes(document, config);
 		gfxAddDocumentLine(document, "uniform mat4 elf_ProjectionMatrix;");
 		gfxAddDocumentLine(document, "uniform mat4 elf_ModelviewMatrix;");
 		if(config->textures & GFX_COLOR_MAP) gfxAddDocumentLine(document, "varying vec2 elf_TexCoord;");
 		gfxAddDocumentLine(document, "void main()");
 		gfxAddDocumentLine(document, "{");
+		gfxAddVertexInstancingCalcs(document, config);
+		gfxAddVertexSkinningCalcs(document, config, GFX_FALSE, GFX_FALSE);
 		if(config->textures & GFX_COLOR_MAP) gfxAddDocumentLine(document, "\telf_TexCoord = elf_TexCoordAttr;");
 		gfxAddDocumentLine(document, "\tgl_Position = elf_ProjectionMatrix*(elf_ModelviewMatrix*vec4(elf_VertexAttr, 1.0));");
 		gfxAddDocumentLine(document, "}");
@@ -860,18 +995,7 @@ gfxShaderProgram* gfxGetGbufShaderProgram(gfxShaderConfig* config)
 	free(vertShdr);
 	free(fragShdr);
 
-	if(shaderProgram)
-	{
-		memcpy(&shaderProgram->config, config, sizeof(gfxShaderConfig));
-
-		if(!driver->shaderPrograms) driver->shaderPrograms = shaderProgram;
-		else
-		{
-			lshpr = driver->shaderPrograms;
-			while(lshpr->next) lshpr = lshpr->next;
-			lshpr->next = shaderProgram;
-		}
-	}
+	if(shaderProgram) gfxAddShaderProgram(shaderProgram, config);
 
 	return shaderProgram;
 }
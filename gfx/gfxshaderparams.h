@@ -106,6 +106,9 @@ void gfxSetShaderParams(gfxShaderParams* shaderParams)
 		}
 		else glDisable(GL_ALPHA_TEST);
 
+		if(shaderParams->renderParams.blendMode != driver->shaderParams.renderParams.blendMode)
+			driver->blendSwitches++;
+
 		switch(shaderParams->renderParams.blendMode)
 		{
 			case GFX_NONE:
@@ -171,6 +174,9 @@ void gfxSetShaderParams(gfxShaderParams* shaderParams)
 		{
 			for(i = 0; i < GFX_MAX_TEXTURES; i++)
 			{
+				if(shaderParams->textureParams[i].texture != driver->shaderParams.textureParams[i].texture)
+					driver->textureSwitches++;
+
 				glActiveTexture(GL_TEXTURE0+i);
 				glClientActiveTexture(GL_TEXTURE0+i);
 
@@ -314,6 +320,9 @@ void gfxSetShaderParams(gfxShaderParams* shaderParams)
 		{
 			for(i = 0; i < GFX_MAX_TEXTURES; i++)
 			{
+				if(shaderParams->textureParams[i].texture != driver->shaderParams.textureParams[i].texture)
+					driver->textureSwitches++;
+
 				glActiveTexture(GL_TEXTURE0+i);
 				glClientActiveTexture(GL_TEXTURE0+i);
 
@@ -350,7 +359,10 @@ void gfxSetShaderParams(gfxShaderParams* shaderParams)
 		if(shaderProgram)
 		{
 			if(shaderProgram != driver->shaderParams.shaderProgram)
+			{
 				glUseProgram(shaderProgram->id);
+				driver->shaderSwitches++;
+			}
 
 			// just inputting with values that do not make sense
 			driver->shaderConfig.textures = 255;
@@ -364,8 +376,9 @@ void gfxSetShaderParams(gfxShaderParams* shaderParams)
 				memcpy(&driver->shaderConfig, &shaderConfig, sizeof(gfxShaderConfig));
 				if(shaderParams->gbufferMode > 0) shaderProgram = gfxGetGbufShaderProgram(&shaderConfig);
 				else shaderProgram = gfxGetShaderProgram(&shaderConfig);
-				if(shaderProgram) glUseProgram(shaderProgram->id);
-				else return;
+				if(!shaderProgram) return;
+				if(shaderProgram != driver->shaderParams.shaderProgram) driver->shaderSwitches++;
+				glUseProgram(shaderProgram->id);
 			}
 			else
 			{
@@ -385,6 +398,9 @@ void gfxSetShaderParams(gfxShaderParams* shaderParams)
 		if(shaderProgram->normalMatrixLoc != -1)
 			glUniformMatrix3fv(shaderProgram->normalMatrixLoc,
 				1, GL_FALSE, shaderParams->normalMatrix);
+		if(shaderProgram->bonePaletteLoc != -1 && shaderParams->bonePalette)
+			glUniformMatrix4fv(shaderProgram->bonePaletteLoc, shaderParams->boneCount < driver->maxBones ?
+				shaderParams->boneCount : driver->maxBones, GL_FALSE, shaderParams->bonePalette);
 
 		if(shaderProgram->fogStartLoc != -1)
 			glUniform1f(shaderProgram->fogStartLoc, shaderParams->fogParams.start);
@@ -1,4 +1,102 @@
 
+unsigned int gfxGetUniformHash(const char* name)
+{
+	unsigned int hash;
+
+	hash = 2166136261u;
+	while(*name)
+	{
+		hash ^= (unsigned char)*name++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+int gfxCompareUniforms(const void* a, const void* b)
+{
+	const gfxUniform* ua = (const gfxUniform*)a;
+	const gfxUniform* ub = (const gfxUniform*)b;
+
+	if(ua->hash < ub->hash) return -1;
+	if(ua->hash > ub->hash) return 1;
+	return 0;
+}
+
+void gfxCacheShaderProgramUniforms(gfxShaderProgram* shaderProgram)
+{
+	int count;
+	int maxLength;
+	int length;
+	int size;
+	GLenum type;
+	char* name;
+	char* bracket;
+	int location;
+	int i;
+
+	glGetProgramiv(shaderProgram->id, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(shaderProgram->id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	if(count < 1 || maxLength < 1) return;
+
+	shaderProgram->uniforms = (gfxUniform*)malloc(sizeof(gfxUniform)*count);
+	memset(shaderProgram->uniforms, 0x0, sizeof(gfxUniform)*count);
+
+	name = (char*)malloc(sizeof(char)*(maxLength+1));
+
+	for(i = 0; i < count; i++)
+	{
+		memset(name, 0x0, sizeof(char)*(maxLength+1));
+		glGetActiveUniform(shaderProgram->id, i, maxLength, &length, &size, &type, name);
+
+		// built in gl_ uniforms have no location
+		location = glGetUniformLocation(shaderProgram->id, name);
+		if(location < 0) continue;
+
+		// arrays are reported as name[0], they are looked up by their plain name
+		bracket = strchr(name, '[');
+		if(bracket) *bracket = '\0';
+
+		shaderProgram->uniforms[shaderProgram->uniformCount].name = (char*)malloc(sizeof(char)*(strlen(name)+1));
+		memcpy(shaderProgram->uniforms[shaderProgram->uniformCount].name, name, sizeof(char)*(strlen(name)+1));
+		shaderProgram->uniforms[shaderProgram->uniformCount].hash = gfxGetUniformHash(name);
+		shaderProgram->uniforms[shaderProgram->uniformCount].location = location;
+		shaderProgram->uniformCount++;
+	}
+
+	free(name);
+
+	qsort(shaderProgram->uniforms, shaderProgram->uniformCount, sizeof(gfxUniform), gfxCompareUniforms);
+}
+
+int gfxGetShaderProgramUniformLocation(gfxShaderProgram* shaderProgram, const char* name)
+{
+	unsigned int hash;
+	int first, last, mid;
+
+	// individual array elements are not in the table
+	if(strchr(name, '[')) return glGetUniformLocation(shaderProgram->id, name);
+
+	hash = gfxGetUniformHash(name);
+
+	first = 0;
+	last = shaderProgram->uniformCount-1;
+	while(first <= last)
+	{
+		mid = (first+last)/2;
+		if(shaderProgram->uniforms[mid].hash < hash) first = mid+1;
+		else last = mid-1;
+	}
+
+	for(; first < shaderProgram->uniformCount && shaderProgram->uniforms[first].hash == hash; first++)
+	{
+		if(!strcmp(shaderProgram->uniforms[first].name, name)) return shaderProgram->uniforms[first].location;
+	}
+
+	return -1;
+}
+
 gfxShaderProgram* gfxCreateShaderProgram(const char* vertex, const char* fragment)
 {
 	const GLchar* myStringPtrs[1];
@@ -85,6 +183,9 @@ gfxShaderProgram* gfxCreateShaderProgram(const char* vertex, const char* fragmen
 	glBindAttribLocation(shaderProgram->id, GFX_TEX_COORD, "elf_TexCoordAttr");
 	glBindAttribLocation(shaderProgram->id, GFX_COLOR, "elf_ColorAttr");
 	glBindAttribLocation(shaderProgram->id, GFX_TANGENT, "elf_TangentAttr");
+	glBindAttribLocation(shaderProgram->id, GFX_WEIGHTS, "elf_WeightsAttr");
+	glBindAttribLocation(shaderProgram->id, GFX_BONEIDS, "elf_BoneIdsAttr");
+	glBindAttribLocation(shaderProgram->id, GFX_INSTANCE_MATRIX, "elf_InstanceMatrixAttr");
 
 	glLinkProgram(shaderProgram->id);
 
@@ -110,52 +211,60 @@ gfxShaderProgram* gfxCreateShaderProgram(const char* vertex, const char* fragmen
 		return NULL;
 	}
 
-	shaderProgram->projectionMatrixLoc = glGetUniformLocation(shaderProgram->id, "elf_ProjectionMatrix");
-	shaderProgram->invProjectionMatrixLoc = glGetUniformLocation(shaderProgram->id, "elf_InvProjectionMatrix");
-	shaderProgram->modelviewMatrixLoc = glGetUniformLocation(shaderProgram->id, "elf_ModelviewMatrix");
-	shaderProgram->normalMatrixLoc = glGetUniformLocation(shaderProgram->id, "elf_NormalMatrix");
-	shaderProgram->texture0Loc = glGetUniformLocation(shaderProgram->id, "elf_Texture0");
-	shaderProgram->texture1Loc = glGetUniformLocation(shaderProgram->id, "elf_Texture1");
-	shaderProgram->texture2Loc = glGetUniformLocation(shaderProgram->id, "elf_Texture2");
-	shaderProgram->texture3Loc = glGetUniformLocation(shaderProgram->id, "elf_Texture3");
-	shaderProgram->colorMapLoc = glGetUniformLocation(shaderProgram->id, "elf_ColorMap");
-	shaderProgram->normalMapLoc = glGetUniformLocation(shaderProgram->id, "elf_NormalMap");
-	shaderProgram->heightMapLoc = glGetUniformLocation(shaderProgram->id, "elf_HeightMap");
-	shaderProgram->specularMapLoc = glGetUniformLocation(shaderProgram->id, "elf_SpecularMap");
-	shaderProgram->colorRampMapLoc = glGetUniformLocation(shaderProgram->id, "elf_ColorRampMap");
-	shaderProgram->lightMapLoc = glGetUniformLocation(shaderProgram->id, "elf_LightMap");
-	shaderProgram->shadowProjectionMatrixLoc = glGetUniformLocation(shaderProgram->id, "elf_ShadowProjectionMatrix");
-	shaderProgram->shadowMapLoc = glGetUniformLocation(shaderProgram->id, "elf_ShadowMap");
-	shaderProgram->cubeMapLoc = glGetUniformLocation(shaderProgram->id, "elf_CubeMap");
-	shaderProgram->ambientColorLoc = glGetUniformLocation(shaderProgram->id, "elf_AmbientColor");
-	shaderProgram->diffuseColorLoc = glGetUniformLocation(shaderProgram->id, "elf_DiffuseColor");
-	shaderProgram->specularColorLoc = glGetUniformLocation(shaderProgram->id, "elf_SpecularColor");
-	shaderProgram->shininessLoc = glGetUniformLocation(shaderProgram->id, "elf_Shininess");
-	shaderProgram->lightPositionLoc = glGetUniformLocation(shaderProgram->id, "elf_LightPosition");
-	shaderProgram->lightColorLoc = glGetUniformLocation(shaderProgram->id, "elf_LightColor");
-	shaderProgram->lightSpotDirectionLoc = glGetUniformLocation(shaderProgram->id, "elf_LightSpotDirection");
-	shaderProgram->lightRangeLoc = glGetUniformLocation(shaderProgram->id, "elf_LightRange");
-	shaderProgram->lightFadeRangeLoc = glGetUniformLocation(shaderProgram->id, "elf_LightFadeRange");
-	shaderProgram->lightInnerConeCosLoc = glGetUniformLocation(shaderProgram->id, "elf_LightInnerConeCos");
-	shaderProgram->lightOuterConeCosLoc = glGetUniformLocation(shaderProgram->id, "elf_LightOuterConeCos");
-	shaderProgram->cameraPositionLoc = glGetUniformLocation(shaderProgram->id, "elf_CameraPosition");
-	shaderProgram->clipStartLoc = glGetUniformLocation(shaderProgram->id, "elf_ClipStart");
-	shaderProgram->clipEndLoc = glGetUniformLocation(shaderProgram->id, "elf_ClipEnd");
-	shaderProgram->viewportWidthLoc = glGetUniformLocation(shaderProgram->id, "elf_ViewportWidth");
-	shaderProgram->viewportHeightLoc = glGetUniformLocation(shaderProgram->id, "elf_ViewportHeight");
-	shaderProgram->parallaxScaleLoc = glGetUniformLocation(shaderProgram->id, "elf_ParallaxScale");
-	shaderProgram->alphaThresholdLoc = glGetUniformLocation(shaderProgram->id, "elf_AlphaThreshold");
-	shaderProgram->fogStartLoc = glGetUniformLocation(shaderProgram->id, "elf_FogStart");
-	shaderProgram->fogEndLoc = glGetUniformLocation(shaderProgram->id, "elf_FogEnd");
-	shaderProgram->fogColorLoc = glGetUniformLocation(shaderProgram->id, "elf_FogColor");
+	gfxCacheShaderProgramUniforms(shaderProgram);
+
+	shaderProgram->projectionMatrixLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ProjectionMatrix");
+	shaderProgram->invProjectionMatrixLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_InvProjectionMatrix");
+	shaderProgram->modelviewMatrixLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ModelviewMatrix");
+	shaderProgram->normalMatrixLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_NormalMatrix");
+	shaderProgram->texture0Loc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_Texture0");
+	shaderProgram->texture1Loc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_Texture1");
+	shaderProgram->texture2Loc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_Texture2");
+	shaderProgram->texture3Loc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_Texture3");
+	shaderProgram->colorMapLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ColorMap");
+	shaderProgram->normalMapLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_NormalMap");
+	shaderProgram->heightMapLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_HeightMap");
+	shaderProgram->specularMapLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_SpecularMap");
+	shaderProgram->colorRampMapLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ColorRampMap");
+	shaderProgram->lightMapLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_LightMap");
+	shaderProgram->shadowProjectionMatrixLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ShadowProjectionMatrix");
+	shaderProgram->shadowMapLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ShadowMap");
+	shaderProgram->cubeMapLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_CubeMap");
+	shaderProgram->ambientColorLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_AmbientColor");
+	shaderProgram->diffuseColorLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_DiffuseColor");
+	shaderProgram->specularColorLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_SpecularColor");
+	shaderProgram->shininessLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_Shininess");
+	shaderProgram->lightPositionLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_LightPosition");
+	shaderProgram->lightColorLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_LightColor");
+	shaderProgram->lightSpotDirectionLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_LightSpotDirection");
+	shaderProgram->lightRangeLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_LightRange");
+	shaderProgram->lightFadeRangeLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_LightFadeRange");
+	shaderProgram->lightInnerConeCosLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_LightInnerConeCos");
+	shaderProgram->lightOuterConeCosLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_LightOuterConeCos");
+	shaderProgram->cameraPositionLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_CameraPosition");
+	shaderProgram->clipStartLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ClipStart");
+	shaderProgram->clipEndLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ClipEnd");
+	shaderProgram->viewportWidthLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ViewportWidth");
+	shaderProgram->viewportHeightLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ViewportHeight");
+	shaderProgram->parallaxScaleLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_ParallaxScale");
+	shaderProgram->alphaThresholdLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_AlphaThreshold");
+	shaderProgram->fogStartLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_FogStart");
+	shaderProgram->fogEndLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_FogEnd");
+	shaderProgram->fogColorLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_FogColor");
+	shaderProgram->bonePaletteLoc = gfxGetShaderProgramUniformLocation(shaderProgram, "elf_BonePalette[0]");
 
 	return shaderProgram;
 }
 
 void gfxDestroyShaderProgram(gfxShaderProgram* shaderProgram)
 {
+	int i;
+
 	if(shaderProgram->id) glDeleteShader(shaderProgram->id);
 
+	for(i = 0; i < shaderProgram->uniformCount; i++) free(shaderProgram->uniforms[i].name);
+	if(shaderProgram->uniforms) free(shaderProgram->uniforms);
+
 	free(shaderProgram);
 }
 
@@ -181,36 +290,72 @@ void gfxSetShaderProgram(gfxShaderProgram* shaderProgram)
 void gfxSetShaderProgramUniform1i(const char* name, int i)
 {
 	if(!driver->shaderParams.shaderProgram) return;
-	glUniform1i(glGetUniformLocation(driver->shaderParams.shaderProgram->id, name), i);
+	gfxSetUniform1i(gfxGetShaderProgramUniformLocation(driver->shaderParams.shaderProgram, name), i);
 }
 
 void gfxSetShaderProgramUniform1f(const char* name, float f)
 {
 	if(!driver->shaderParams.shaderProgram) return;
-	glUniform1f(glGetUniformLocation(driver->shaderParams.shaderProgram->id, name), f);
+	gfxSetUniform1f(gfxGetShaderProgramUniformLocation(driver->shaderParams.shaderProgram, name), f);
 }
 
 void gfxSetShaderProgramUniformVec2(const char* name, float x, float y)
 {
 	if(!driver->shaderParams.shaderProgram) return;
-	glUniform2f(glGetUniformLocation(driver->shaderParams.shaderProgram->id, name), x, y);
+	gfxSetUniformVec2(gfxGetShaderProgramUniformLocation(driver->shaderParams.shaderProgram, name), x, y);
 }
 
 void gfxSetShaderProgramUniformVec3(const char* name, float x, float y, float z)
 {
 	if(!driver->shaderParams.shaderProgram) return;
-	glUniform3f(glGetUniformLocation(driver->shaderParams.shaderProgram->id, name), x, y, z);
+	gfxSetUniformVec3(gfxGetShaderProgramUniformLocation(driver->shaderParams.shaderProgram, name), x, y, z);
 }
 
 void gfxSetShaderProgramUniformVec4(const char* name, float x, float y, float z, float w)
 {
 	if(!driver->shaderParams.shaderProgram) return;
-	glUniform4f(glGetUniformLocation(driver->shaderParams.shaderProgram->id, name), x, y, z, w);
+	gfxSetUniformVec4(gfxGetShaderProgramUniformLocation(driver->shaderParams.shaderProgram, name), x, y, z, w);
 }
 
 void gfxSetShaderProgramUniformMat4(const char* name, float* matrix)
 {
 	if(!driver->shaderParams.shaderProgram) return;
-	glUniformMatrix4fv(glGetUniformLocation(driver->shaderParams.shaderProgram->id, name), 1, GL_FALSE, matrix);
+	gfxSetUniformMat4(gfxGetShaderProgramUniformLocation(driver->shaderParams.shaderProgram, name), matrix);
+}
+
+void gfxSetUniform1i(int location, int i)
+{
+	if(location < 0) return;
+	glUniform1i(location, i);
+}
+
+void gfxSetUniform1f(int location, float f)
+{
+	if(location < 0) return;
+	glUniform1f(location, f);
+}
+
+void gfxSetUniformVec2(int location, float x, float y)
+{
+	if(location < 0) return;
+	glUniform2f(location, x, y);
+}
+
+void gfxSetUniformVec3(int location, float x, float y, float z)
+{
+	if(location < 0) return;
+	glUniform3f(location, x, y, z);
+}
+
+void gfxSetUniformVec4(int location, float x, float y, float z, float w)
+{
+	if(location < 0) return;
+	glUniform4f(location, x, y, z, w);
+}
+
+void gfxSetUniformMat4(int location, float* matrix)
+{
+	if(location < 0) return;
+	glUniformMatrix4fv(location, 1, GL_FALSE, matrix);
 }
 
@@ -48,6 +48,8 @@ gfxTexture* gfxCreate2dTexture(unsigned int width, unsigned int height, float an
 	texture->format = format;
 	texture->dataFormat = dataFormat;
 
+	if(driver->headless) return texture;
+
 	glActiveTexture(GL_TEXTURE0);
 	glClientActiveTexture(GL_TEXTURE0);
 
@@ -97,6 +99,88 @@ gfxTexture* gfxCreate2dTexture(unsigned int width, unsigned int height, float an
 
 	glTexImage2D(GL_TEXTURE_2D, 0, driver->textureInternalFormats[internalFormat], width, height, 0,
 		driver->textureDataFormats[format], driver->formats[dataFormat], data);
+	if(data) driver->uploads++;
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	driver->shaderParams.textureParams[0].texture = NULL;
+
+	return texture;
+}
+
+gfxTexture* gfxCreate2dCompressedTexture(unsigned int width, unsigned int height, float anisotropy, int mode, int format, int levelCount, void** levels, int* levelSizes)
+{
+	gfxTexture* texture;
+	unsigned int levelWidth;
+	unsigned int levelHeight;
+	int i;
+
+	if(width == 0 || height == 0 || (int)width > gfxGetMaxTextureSize() || (int)height > gfxGetMaxTextureSize())
+	{
+		printf("error: invalid dimensions when creating texture\n");
+		return NULL;
+	}
+
+	if(format != GFX_DXT1 && format != GFX_DXT5)
+	{
+		printf("error: invalid format when creating compressed texture\n");
+		return NULL;
+	}
+
+	if(!driver->textureCompression)
+	{
+		printf("error: s3tc texture compression is not supported\n");
+		return NULL;
+	}
+
+	texture = gfxCreateTexture();
+
+	texture->type = GFX_2D_MAP_TEXTURE;
+	texture->width = width;
+	texture->height = height;
+	texture->format = format;
+	texture->dataFormat = GFX_UBYTE;
+
+	if(driver->headless) return texture;
+
+	glActiveTexture(GL_TEXTURE0);
+	glClientActiveTexture(GL_TEXTURE0);
+
+	glGenTextures(1, &texture->id);
+
+	glBindTexture(GL_TEXTURE_2D, texture->id);
+
+	// the mip chain comes with the data, so the driver doesn't have to generate one
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount-1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	if(mode == GFX_REPEAT)
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	}
+	else
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	if(anisotropy > 1.0f && driver->version >= 200)
+	{
+		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+	}
+
+	levelWidth = width;
+	levelHeight = height;
+	for(i = 0; i < levelCount; i++)
+	{
+		glCompressedTexImage2D(GL_TEXTURE_2D, i, driver->textureInternalFormats[format], levelWidth, levelHeight, 0,
+			levelSizes[i], levels[i]);
+
+		if(levelWidth > 1) levelWidth /= 2;
+		if(levelHeight > 1) levelHeight /= 2;
+	}
+	driver->uploads++;
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 	driver->shaderParams.textureParams[0].texture = NULL;
@@ -108,7 +192,7 @@ gfxTexture* gfxCreateCubeMap(unsigned int width, unsigned int height, float anis
 {
 	gfxTexture* texture;
 
-	if(driver->version < 130) return NULL;
+	if(driver->version < 130 && !driver->headless) return NULL;
 
 	if(width == 0 || height == 0 || (int)width > gfxGetMaxTextureSize() || (int)height > gfxGetMaxTextureSize())
 	{
@@ -136,6 +220,8 @@ gfxTexture* gfxCreateCubeMap(unsigned int width, unsigned int height, float anis
 	texture->format = format;
 	texture->dataFormat = dataFormat;
 
+	if(driver->headless) return texture;
+
 	glActiveTexture(GL_TEXTURE0);
 	glClientActiveTexture(GL_TEXTURE0);
 
@@ -161,6 +247,7 @@ gfxTexture* gfxCreateCubeMap(unsigned int width, unsigned int height, float anis
 		driver->textureDataFormats[format], driver->formats[dataFormat], zpos);
 	glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, 0, driver->textureInternalFormats[internalFormat], width, height, 0,
 		driver->textureDataFormats[format], driver->formats[dataFormat], zneg);
+	driver->uploads++;
 
 	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
 	driver->shaderParams.textureParams[0].texture = NULL;
@@ -207,6 +294,8 @@ int gfxGetTextureDataFormat(gfxTexture* texture)
 
 void gfxSetTexture(gfxTexture* texture, int slot)
 {
+	if(driver->headless) return;
+
 	glActiveTexture(GL_TEXTURE0+slot);
 	glClientActiveTexture(GL_TEXTURE0+slot);
 
@@ -25,6 +25,9 @@ struct gfxDriver {
 
 	gfxRenderTarget* renderTarget;
 	gfxShaderProgram* shaderPrograms;
+	gfxShaderProgram** shaderProgramTable;
+	int shaderProgramTableSize;
+	int shaderProgramCount;
 	gfxShaderParams shaderParams;
 
 	int version;
@@ -33,8 +36,20 @@ struct gfxDriver {
 	int maxDrawBuffers;
 	int maxColorAttachments;
 	float maxAnisotropy;
+	int maxBones;
+	unsigned char headless;
+	unsigned char instancing;
+	unsigned char textureCompression;
+	unsigned int instanceVbo;
 	unsigned char dirtyVertexArrays;
 	unsigned int verticesDrawn[GFX_MAX_DRAW_MODES];
+	unsigned int glCalls;
+	unsigned int drawCalls;
+	unsigned int instancesDrawn;
+	unsigned int shaderSwitches;
+	unsigned int textureSwitches;
+	unsigned int blendSwitches;
+	unsigned int uploads;
 
 	gfxShaderConfig shaderConfig;
 };
@@ -59,6 +74,7 @@ struct gfxVertexData {
 	int dataType;
 	void* data;
 	unsigned char changed;
+	unsigned char external;
 };
 
 typedef struct gfxVarr {
@@ -92,9 +108,19 @@ struct gfxTexture {
 	int dataFormat;
 };
 
+struct gfxUniform {
+	char* name;
+	unsigned int hash;
+	int location;
+};
+
 struct gfxShaderProgram {
 	gfxShaderProgram* next;
+	gfxShaderProgram* hashNext;
+	unsigned int key;
 	unsigned int id;
+	gfxUniform* uniforms;
+	int uniformCount;
 	int projectionMatrixLoc;
 	int invProjectionMatrixLoc;
 	int modelviewMatrixLoc;
@@ -133,6 +159,7 @@ struct gfxShaderProgram {
 	int fogStartLoc;
 	int fogEndLoc;
 	int fogColorLoc;
+	int bonePaletteLoc;
 	gfxShaderConfig config;
 };
 
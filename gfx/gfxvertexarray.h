@@ -24,13 +24,39 @@ gfxVertexData* gfxCreateVertexData(int count, int format, int dataType)
 	return data;
 }
 
+// uses the buffer in place instead of copying it, the caller has to keep it alive for as long as the vertex data
+gfxVertexData* gfxCreateVertexDataFromBuffer(int count, int format, int dataType, void* buffer)
+{
+	gfxVertexData* data;
+
+	if(count <= 0 || !buffer) return NULL;
+	if(!(format >= GFX_FLOAT && format < GFX_MAX_FORMATS)) return NULL;
+	if(!(dataType >= GFX_VERTEX_DATA_STATIC && dataType < GFX_MAX_VERTEX_DATA_TYPES)) return NULL;
+
+	data = (gfxVertexData*)malloc(sizeof(gfxVertexData));
+	memset(data, 0x0, sizeof(gfxVertexData));
+	data->objType = GFX_VERTEX_DATA;
+	data->objDestr = gfxDestroyVertexData;
+
+	data->count = count;
+	data->format = format;
+	data->sizeBytes = driver->formatSizes[format]*count;
+	data->dataType = dataType;
+	data->data = buffer;
+	data->external = GFX_TRUE;
+
+	gfxIncObj(GFX_VERTEX_DATA);
+
+	return data;
+}
+
 void gfxDestroyVertexData(void* data)
 {
 	gfxVertexData* vertexData = (gfxVertexData*)data;
 
 	if(vertexData->vbo) glDeleteBuffers(1, &vertexData->vbo);
 
-	free(vertexData->data);
+	if(!vertexData->external) free(vertexData->data);
 	free(vertexData);
 
 	gfxDecObj(GFX_VERTEX_DATA);
@@ -63,6 +89,7 @@ void gfxUpdateVertexData(gfxVertexData* data)
 		glBindBuffer(GL_ARRAY_BUFFER, data->vbo);
 		glBufferSubData(GL_ARRAY_BUFFER, 0, data->sizeBytes, data->data);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		driver->uploads++;
 	}
 	data->changed = GFX_FALSE;
 }
@@ -77,6 +104,7 @@ void gfxUpdateVertexDataSubData(gfxVertexData* data, int start, int length)
 		glBindBuffer(GL_ARRAY_BUFFER, data->vbo);
 		glBufferSubData(GL_ARRAY_BUFFER, start, length, &((char*)data->data)[start]);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		driver->uploads++;
 	}
 	data->changed = GFX_FALSE;
 }
@@ -90,6 +118,7 @@ void gfxInitVertexDataVbo(gfxVertexData* data)
 		glBufferData(GL_ARRAY_BUFFER, data->sizeBytes, data->data,
 			driver->vertexDataDrawModes[data->dataType]);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		driver->uploads++;
 	}
 	data->changed = GFX_FALSE;
 }
@@ -302,6 +331,8 @@ void gfxDrawVertexArray(gfxVertexArray* vertexArray, int count, int drawMode)
 	glDrawArrays(driver->drawModes[drawMode], 0, count);
 
 	driver->verticesDrawn[drawMode] += count;
+	driver->drawCalls++;
+	driver->instancesDrawn++;
 }
 
 gfxVertexIndex* gfxCreateVertexIndex(unsigned char gpuData, gfxVertexData* data)
@@ -358,5 +389,52 @@ void gfxDrawVertexIndex(gfxVertexIndex* vertexIndex, unsigned int drawMode)
 	}
 
 	driver->verticesDrawn[drawMode] += vertexIndex->indiceCount;
+	driver->drawCalls++;
+	driver->instancesDrawn++;
+}
+
+void gfxSetInstanceMatrices(float* matrices, int count)
+{
+	int i;
+
+	if(!driver->instancing) return;
+
+	if(!matrices || count < 1)
+	{
+		for(i = 0; i < 4; i++) glDisableVertexAttribArray(GFX_INSTANCE_MATRIX+i);
+		return;
+	}
+
+	if(!driver->instanceVbo) glGenBuffers(1, &driver->instanceVbo);
+
+	// the storage is orphaned for every batch so the upload doesn't wait on the previous draw
+	glBindBuffer(GL_ARRAY_BUFFER, driver->instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float)*16*count, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(float)*16*count, matrices);
+	driver->uploads++;
+
+	// a mat4 attribute takes four locations, one per column
+	for(i = 0; i < 4; i++)
+	{
+		glEnableVertexAttribArray(GFX_INSTANCE_MATRIX+i);
+		glVertexAttribPointer(GFX_INSTANCE_MATRIX+i, 4, GL_FLOAT, GL_FALSE, sizeof(float)*16, (char*)NULL+sizeof(float)*4*i);
+		glVertexAttribDivisorARB(GFX_INSTANCE_MATRIX+i, 1);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void gfxDrawVertexIndexInstanced(gfxVertexIndex* vertexIndex, unsigned int drawMode, int instanceCount)
+{
+	if(!driver->instancing || !vertexIndex->gpuData || instanceCount < 1) return;
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vertexIndex->data->vbo);
+	glDrawElementsInstancedARB(driver->drawModes[drawMode], vertexIndex->indiceCount,
+		driver->formats[vertexIndex->data->format], 0, instanceCount);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	driver->verticesDrawn[drawMode] += vertexIndex->indiceCount*instanceCount;
+	driver->drawCalls++;
+	driver->instancesDrawn += instanceCount;
 }
 
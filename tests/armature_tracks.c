@@ -0,0 +1,243 @@
+// checks that a scene saved, loaded and saved again writes the armature frames it
+// was loaded from, not the ones sampled back from the compressed track, and
+// prints how far the track alone would have moved them
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+#include "fixtures.h"
+
+#define BONES		24
+#define FRAMES		120
+#define TOLERANCE	0.01f
+#define FIRST_PATH	"armature_tracks.pak"
+#define SECOND_PATH	"armature_tracks_resaved.pak"
+
+static elfBoneFrame source[BONES][FRAMES];
+
+// smooth motion with some noise on top, enough for the track to drop keys and still be lossy
+static void createFrames(elfBone* bone, elfBoneFrame* frames)
+{
+	float axis[4];
+	float offsetQua[4];
+	float speed;
+	float t;
+	int j;
+
+	speed = 0.02f+(float)fabs(randomFloat(0.08f));
+
+	for(j = 0; j < FRAMES; j++)
+	{
+		t = (float)j*speed;
+
+		memset(&frames[j], 0x0, sizeof(elfBoneFrame));
+		frames[j].pos.x = bone->pos.x+(float)sin(t)+randomFloat(0.002f);
+		frames[j].pos.y = bone->pos.y+(float)cos(t*0.7f)*0.5f+randomFloat(0.002f);
+		frames[j].pos.z = bone->pos.z+randomFloat(0.002f);
+
+		axis[0] = (float)sin(t*0.5f);
+		axis[1] = 0.3f+randomFloat(0.002f);
+		axis[2] = (float)cos(t*0.3f);
+		axis[3] = 1.0f;
+		gfxQuaNormalize(axis, offsetQua);
+		gfxMulQuaQua(offsetQua, &bone->qua.x, &frames[j].qua.x);
+	}
+}
+
+static elfArmature* createTrackedArmature()
+{
+	elfArmature* armature;
+	elfBone* bone;
+	char name[32];
+	int i;
+
+	armature = elfCreateArmature("armature");
+	armature->frameCount = FRAMES;
+
+	for(i = 0; i < BONES; i++)
+	{
+		sprintf(name, "bone%d", i);
+		bone = elfCreateBone(name);
+		bone->id = i;
+		bone->pos.x = randomFloat(3.0f);
+		bone->pos.y = randomFloat(3.0f);
+		bone->pos.z = randomFloat(3.0f);
+		randomQua(&bone->qua.x);
+
+		createFrames(bone, source[i]);
+
+		// an armature made in code has nothing to reload from, so the frames are handed to the save directly
+		bone->frames = (elfBoneFrame*)malloc(sizeof(elfBoneFrame)*FRAMES);
+		memcpy(bone->frames, source[i], sizeof(elfBoneFrame)*FRAMES);
+
+		elfAddRootBoneToArmature(armature, bone);
+	}
+
+	return armature;
+}
+
+static elfArmature* loadArmature(elfScene* scene)
+{
+	elfEntity* entity;
+
+	entity = elfGetSceneEntity(scene, "entity");
+	if(!entity) return NULL;
+
+	return elfGetEntityArmature(entity);
+}
+
+// the largest distance between the source positions and what the compressed track gives back
+static float getTrackError(elfArmature* armature, int* keyCount)
+{
+	elfBone* bone;
+	float offsetPos[3];
+	float offsetQua[4];
+	float d, maxError;
+	int i, j, k;
+
+	maxError = 0.0f;
+	*keyCount = 0;
+
+	for(i = 0; i < BONES; i++)
+	{
+		bone = elfGetBoneFromArmatureById(i, armature);
+		if(!bone) continue;
+
+		*keyCount += bone->keyCount;
+
+		for(j = 0; j < FRAMES; j++)
+		{
+			elfSampleBoneTrack(bone, FRAMES, (float)(j+1), offsetPos, offsetQua);
+			for(k = 0; k < 3; k++)
+			{
+				d = (float)fabs((&bone->pos.x)[k]+offsetPos[k]-(&source[i][j].pos.x)[k]);
+				if(d > maxError) maxError = d;
+			}
+		}
+	}
+
+	return maxError;
+}
+
+static int compareFrames(elfArmature* armature)
+{
+	elfBone* bone;
+	int i, j;
+	int failed = 0;
+
+	if(!elfLoadArmatureFrames(armature))
+	{
+		printf("failed: can't read the frames back from \"%s\"\n", SECOND_PATH);
+		return 1;
+	}
+
+	for(i = 0; i < BONES; i++)
+	{
+		bone = elfGetBoneFromArmatureById(i, armature);
+		if(!bone || !bone->frames)
+		{
+			failed++;
+			continue;
+		}
+
+		for(j = 0; j < FRAMES; j++)
+		{
+			if(memcmp(&bone->frames[j].pos.x, &source[i][j].pos.x, sizeof(float)*3) ||
+				memcmp(&bone->frames[j].qua.x, &source[i][j].qua.x, sizeof(float)*4)) failed++;
+		}
+	}
+
+	elfUnloadArmatureFrames(armature);
+
+	return failed;
+}
+
+int main()
+{
+	elfConfig* config;
+	elfScene* scene;
+	elfEntity* entity;
+	elfArmature* armature;
+	float maxError;
+	int keyCount;
+	int failed = 0;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigAnimationTolerance(config, TOLERANCE);
+	elfSetConfigLogPath(config, "armature_tracks.log");
+
+	if(!elfInit(config)) return 1;
+
+	srand(1);
+
+	scene = elfCreateScene("armature_tracks");
+	elfIncRef((elfObject*)scene);
+
+	entity = elfCreateEntity("entity");
+	elfSetEntityArmature(entity, createTrackedArmature());
+	elfAddSceneEntity(scene, entity);
+
+	if(!elfSaveScene(scene, FIRST_PATH))
+	{
+		printf("failed: can't save \"%s\"\n", FIRST_PATH);
+		elfDecRef((elfObject*)scene);
+		elfDeinit();
+		return 1;
+	}
+	elfDecRef((elfObject*)scene);
+
+	// the loaded armature only keeps the reduced track, the resave has to go back to the first pak
+	scene = elfCreateSceneFromFile("armature_tracks", FIRST_PATH);
+	if(!scene || !(armature = loadArmature(scene)))
+	{
+		printf("failed: can't load the armature from \"%s\"\n", FIRST_PATH);
+		elfDeinit();
+		return 1;
+	}
+	elfIncRef((elfObject*)scene);
+
+	maxError = getTrackError(armature, &keyCount);
+	printf("%d bones, %d frames: %d keys kept, the track is up to %.4f off the source positions\n",
+		BONES, FRAMES, keyCount, maxError);
+	printf("track %d bytes, source frames %d bytes, only held while saving\n",
+		keyCount*(int)sizeof(elfBoneKey), BONES*FRAMES*7*(int)sizeof(float));
+
+	if(!elfSaveScene(scene, SECOND_PATH))
+	{
+		printf("failed: can't save \"%s\"\n", SECOND_PATH);
+		failed++;
+	}
+	elfDecRef((elfObject*)scene);
+
+	if(!failed)
+	{
+		scene = elfCreateSceneFromFile("armature_tracks", SECOND_PATH);
+		if(!scene || !(armature = loadArmature(scene)))
+		{
+			printf("failed: can't load the armature from \"%s\"\n", SECOND_PATH);
+			elfDeinit();
+			return 1;
+		}
+		elfIncRef((elfObject*)scene);
+
+		failed += compareFrames(armature);
+		printf("resaved frames: %d differ from the source\n", failed);
+
+		elfDecRef((elfObject*)scene);
+	}
+
+	elfDeinit();
+
+	remove(FIRST_PATH);
+	remove(SECOND_PATH);
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
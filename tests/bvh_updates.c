@@ -0,0 +1,244 @@
+// checks that the scene bvh stays valid while entities are added, removed and
+// moved, that ray casts through it find what a linear scan finds, and times
+// frames of a 100000 entity scene with entities coming and going
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+#include "fixtures.h"
+
+#define ENTITIES	20000
+#define FRAMES		50
+#define CHANGES		200
+#define RAYS		200
+#define BENCH_ENTITIES	100000
+#define BENCH_FRAMES	20
+#define BENCH_CHANGES	100
+
+static void moveEntity(elfEntity* entity, float range)
+{
+	elfSetActorPosition((elfActor*)entity, randomFloat(range), randomFloat(range), randomFloat(range*0.1f));
+	elfCalcEntityAabb(entity);
+}
+
+static void addEntity(elfScene* scene, elfModel* model, float range)
+{
+	elfEntity* entity;
+	float scale;
+
+	entity = elfCreateEntity("entity");
+	scale = 0.2f+(float)fabs(randomFloat(2.0f));
+	elfSetEntityScale(entity, scale, scale, scale);
+	elfSetEntityModel(entity, model);
+	moveEntity(entity, range);
+	elfAddSceneEntity(scene, entity);
+}
+
+static void removeEntity(elfScene* scene)
+{
+	elfRemoveSceneEntityByIndex(scene, rand()%elfGetSceneEntityCount(scene));
+}
+
+static int boxContains(elfVec3f* min, elfVec3f* max, elfVec3f* innerMin, elfVec3f* innerMax)
+{
+	return min->x <= innerMin->x && min->y <= innerMin->y && min->z <= innerMin->z &&
+		max->x >= innerMax->x && max->y >= innerMax->y && max->z >= innerMax->z;
+}
+
+static int checkTree(elfScene* scene)
+{
+	elfBvh* bvh = &scene->bvh;
+	elfBvhNode* node;
+	elfEntity* ent;
+	int i, j;
+	int count = 0;
+	int failed = 0;
+
+	for(i = 0; i < bvh->nodeCount; i++)
+	{
+		node = &bvh->nodes[i];
+
+		if(node->left > -1)
+		{
+			if((bvh->nodes[node->left].count || bvh->nodes[node->left].left > -1) &&
+				!boxContains(&node->min, &node->max, &bvh->nodes[node->left].min, &bvh->nodes[node->left].max)) failed++;
+			if((bvh->nodes[node->right].count || bvh->nodes[node->right].left > -1) &&
+				!boxContains(&node->min, &node->max, &bvh->nodes[node->right].min, &bvh->nodes[node->right].max)) failed++;
+			continue;
+		}
+
+		for(j = node->first; j < node->first+node->count; j++)
+		{
+			ent = bvh->entities[j];
+			if(ent->scene != scene || ent->bvhNode != i) failed++;
+			if(!boxContains(&node->min, &node->max, &ent->cullAabbMin, &ent->cullAabbMax)) failed++;
+			count++;
+		}
+	}
+
+	if(count != elfGetSceneEntityCount(scene)) failed++;
+
+	return failed;
+}
+
+static elfEntity* rayCastLinear(elfScene* scene, float* start, float* dir)
+{
+	elfEntity* ent;
+	elfEntity* result = NULL;
+	float closest = 2.0f;
+	float t;
+	int i;
+
+	for(i = 0; i < elfGetSceneEntityCount(scene); i++)
+	{
+		ent = elfGetSceneEntityByIndex(scene, i);
+		if(gfxRayBoxIntersect(start, dir, &ent->cullAabbMin.x, &ent->cullAabbMax.x, &t) && t < closest)
+		{
+			closest = t;
+			result = ent;
+		}
+	}
+
+	return result;
+}
+
+static float getHitDistance(elfEntity* ent, float* start, float* dir)
+{
+	float t;
+
+	if(!ent || !gfxRayBoxIntersect(start, dir, &ent->cullAabbMin.x, &ent->cullAabbMax.x, &t)) return 2.0f;
+
+	return t;
+}
+
+static int checkRays(elfScene* scene)
+{
+	elfEntity* expected;
+	elfEntity* result;
+	float start[3];
+	float end[3];
+	int i, j;
+	int failed = 0;
+
+	for(i = 0; i < RAYS; i++)
+	{
+		for(j = 0; j < 3; j++)
+		{
+			start[j] = randomFloat(100.0f);
+			end[j] = randomFloat(100.0f);
+		}
+
+		result = elfGetSceneRayCastEntity(scene, start[0], start[1], start[2], end[0], end[1], end[2]);
+
+		for(j = 0; j < 3; j++) end[j] -= start[j];
+		expected = rayCastLinear(scene, start, end);
+
+		// boxes that overlap can be hit at the same distance, either of them is right
+		if(getHitDistance(result, start, end) != getHitDistance(expected, start, end)) failed++;
+	}
+
+	return failed;
+}
+
+static int testUpdates(elfModel* model)
+{
+	elfScene* scene;
+	int i, frame;
+	int treeFailed = 0;
+	int rayFailed = 0;
+
+	scene = elfCreateScene("updates");
+	elfIncRef((elfObject*)scene);
+	elfSetSceneSpatialIndex(scene, ELF_TRUE);
+
+	for(i = 0; i < ENTITIES; i++) addEntity(scene, model, 100.0f);
+
+	for(frame = 0; frame < FRAMES; frame++)
+	{
+		for(i = 0; i < CHANGES; i++)
+		{
+			switch(rand()%3)
+			{
+				case 0: addEntity(scene, model, 100.0f); break;
+				case 1: removeEntity(scene); break;
+				case 2: moveEntity(elfGetSceneEntityByIndex(scene, rand()%elfGetSceneEntityCount(scene)), 100.0f); break;
+			}
+		}
+
+		rayFailed += checkRays(scene);
+		treeFailed += checkTree(scene);
+	}
+
+	printf("%d frames of %d changes: %d tree errors, %d ray casts differ\n", FRAMES, CHANGES, treeFailed, rayFailed);
+
+	elfDecRef((elfObject*)scene);
+
+	return treeFailed+rayFailed;
+}
+
+static void benchUpdates(elfModel* model)
+{
+	elfScene* scene;
+	clock_t start;
+	double seconds;
+	int i, frame;
+
+	scene = elfCreateScene("bench");
+	elfIncRef((elfObject*)scene);
+	elfSetSceneSpatialIndex(scene, ELF_TRUE);
+
+	for(i = 0; i < BENCH_ENTITIES; i++) addEntity(scene, model, 1000.0f);
+	elfUpdateBvh(&scene->bvh, scene->entities);
+
+	// every frame some entities are spawned and some removed, then the tree is queried
+	start = clock();
+	for(frame = 0; frame < BENCH_FRAMES; frame++)
+	{
+		for(i = 0; i < BENCH_CHANGES; i++)
+		{
+			removeEntity(scene);
+			addEntity(scene, model, 1000.0f);
+		}
+		elfGetSceneRayCastEntity(scene, 0.0f, 0.0f, 0.0f, 1000.0f, 1000.0f, 100.0f);
+	}
+	seconds = (double)(clock()-start)/CLOCKS_PER_SEC;
+
+	printf("%d entities, %d added and removed a frame: %.3f ms a frame\n",
+		BENCH_ENTITIES, BENCH_CHANGES, seconds*1000.0/BENCH_FRAMES);
+
+	elfDecRef((elfObject*)scene);
+}
+
+int main()
+{
+	elfConfig* config;
+	elfModel* model;
+	int failed;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigLogPath(config, "bvh_updates.log");
+
+	if(!elfInit(config)) return 1;
+
+	srand(1);
+
+	model = createBox();
+	elfIncRef((elfObject*)model);
+
+	failed = testUpdates(model);
+	benchUpdates(model);
+
+	elfDecRef((elfObject*)model);
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
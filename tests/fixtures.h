@@ -0,0 +1,175 @@
+// random values and the models and armatures the tests build their scenes from,
+// every test is a program of its own so the functions are defined right here
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+float randomFloat(float range)
+{
+	return ((float)rand()/(float)RAND_MAX*2.0f-1.0f)*range;
+}
+
+float randomRange(float min, float max)
+{
+	return min+(max-min)*(float)rand()/(float)RAND_MAX;
+}
+
+void randomQua(float* qua)
+{
+	float axis[4];
+
+	axis[0] = randomFloat(1.0f);
+	axis[1] = randomFloat(1.0f);
+	axis[2] = randomFloat(1.0f);
+	axis[3] = randomFloat(1.0f);
+	gfxQuaNormalize(axis, qua);
+}
+
+// a single triangle at the origin, for tests that only need some model
+elfModel* createTriangle()
+{
+	elfMeshData* meshData;
+	elfModel* model;
+	int i;
+
+	meshData = elfCreateMeshData();
+	elfIncRef((elfObject*)meshData);
+
+	for(i = 0; i < 3; i++) elfAddMeshDataVertex(meshData, elfCreateVertex());
+	elfAddMeshDataFace(meshData, 0, 1, 2);
+
+	model = elfCreateModelFromMeshData(meshData);
+	elfDecRef((elfObject*)meshData);
+
+	return model;
+}
+
+// a closed box from -1 to 1 on every axis
+elfModel* createBox()
+{
+	static int faces[12][3] = {
+		{0, 4, 6}, {0, 6, 2}, {1, 3, 7}, {1, 7, 5},
+		{0, 1, 5}, {0, 5, 4}, {2, 6, 7}, {2, 7, 3},
+		{0, 2, 3}, {0, 3, 1}, {4, 5, 7}, {4, 7, 6}
+	};
+	elfMeshData* meshData;
+	elfVertex* vertex;
+	elfModel* model;
+	int i;
+
+	meshData = elfCreateMeshData();
+	elfIncRef((elfObject*)meshData);
+
+	for(i = 0; i < 8; i++)
+	{
+		vertex = elfCreateVertex();
+		vertex->position.x = i & 1 ? 1.0f : -1.0f;
+		vertex->position.y = i & 2 ? 1.0f : -1.0f;
+		vertex->position.z = i & 4 ? 1.0f : -1.0f;
+		vertex->normal = vertex->position;
+		elfAddMeshDataVertex(meshData, vertex);
+	}
+
+	for(i = 0; i < 12; i++) elfAddMeshDataFace(meshData, faces[i][0], faces[i][1], faces[i][2]);
+
+	model = elfCreateModelFromMeshData(meshData);
+	elfDecRef((elfObject*)meshData);
+
+	return model;
+}
+
+// root bones at random rest poses with random frames, the bone ids go up by idStep
+// so a step above one leaves holes in the palette
+elfArmature* createArmature(int boneCount, int frameCount, int idStep)
+{
+	elfArmature* armature;
+	elfBone* bone;
+	elfBoneFrame* frames;
+	int i, j;
+
+	armature = elfCreateArmature("armature");
+	armature->frameCount = frameCount;
+
+	frames = (elfBoneFrame*)malloc(sizeof(elfBoneFrame)*frameCount);
+
+	for(i = 0; i < boneCount; i++)
+	{
+		bone = elfCreateBone("bone");
+		bone->id = i*idStep;
+		bone->pos.x = randomFloat(3.0f);
+		bone->pos.y = randomFloat(3.0f);
+		bone->pos.z = randomFloat(3.0f);
+		randomQua(&bone->qua.x);
+
+		for(j = 0; j < frameCount; j++)
+		{
+			memset(&frames[j], 0x0, sizeof(elfBoneFrame));
+			frames[j].offsetPos.x = randomFloat(1.0f);
+			frames[j].offsetPos.y = randomFloat(1.0f);
+			frames[j].offsetPos.z = randomFloat(1.0f);
+			randomQua(&frames[j].offsetQua.x);
+		}
+		elfCompressBoneTrack(bone, frames, frameCount, 0.0f);
+
+		elfAddRootBoneToArmature(armature, bone);
+	}
+
+	free(frames);
+
+	return armature;
+}
+
+// random triangles with four normalized weights a vertex, the fourth one is zero for about half
+// of them. the bone ids are picked below boneIdCount, whether those bones exist is up to the test
+elfModel* createSkinnedModel(int vertexCount, int boneIdCount)
+{
+	elfMeshData* meshData;
+	elfVertex* vertex;
+	elfModel* model;
+	float* weights;
+	int* boneids;
+	float sum;
+	int i, j;
+
+	meshData = elfCreateMeshData();
+	elfIncRef((elfObject*)meshData);
+
+	for(i = 0; i < vertexCount; i++)
+	{
+		vertex = elfCreateVertex();
+		vertex->position.x = randomFloat(5.0f);
+		vertex->position.y = randomFloat(5.0f);
+		vertex->position.z = randomFloat(5.0f);
+		vertex->normal.x = randomFloat(1.0f);
+		vertex->normal.y = randomFloat(1.0f);
+		vertex->normal.z = randomFloat(1.0f);
+		elfAddMeshDataVertex(meshData, vertex);
+	}
+	for(i = 0; i+2 < vertexCount; i += 3) elfAddMeshDataFace(meshData, i, i+1, i+2);
+
+	model = elfCreateModelFromMeshData(meshData);
+	elfDecRef((elfObject*)meshData);
+
+	model->weights = gfxCreateVertexData(4*model->verticeCount, GFX_FLOAT, GFX_VERTEX_DATA_STATIC);
+	gfxIncRef((gfxObject*)model->weights);
+	model->boneids = gfxCreateVertexData(4*model->verticeCount, GFX_INT, GFX_VERTEX_DATA_STATIC);
+	gfxIncRef((gfxObject*)model->boneids);
+
+	weights = (float*)gfxGetVertexDataBuffer(model->weights);
+	boneids = (int*)gfxGetVertexDataBuffer(model->boneids);
+
+	for(i = 0; i < model->verticeCount; i++)
+	{
+		sum = 0.0f;
+		for(j = 0; j < 4; j++)
+		{
+			boneids[i*4+j] = rand()%boneIdCount;
+			weights[i*4+j] = j == 3 && rand()%2 ? 0.0f : (float)fabs(randomFloat(1.0f));
+			sum += weights[i*4+j];
+		}
+		for(j = 0; j < 4; j++) weights[i*4+j] /= sum;
+	}
+
+	return model;
+}
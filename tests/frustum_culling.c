@@ -0,0 +1,104 @@
+// checks that the batched frustum test gfxAabbsInsideFrustum keeps exactly
+// the boxes gfxAabbInsideFrustum keeps, over random frustums and boxes
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+#include "fixtures.h"
+
+#define ROUNDS		20000
+#define MAX_BOXES	300
+
+static void randomFrustum(float frustum[6][4])
+{
+	float proj[16];
+	float modl[16];
+	int i, j;
+
+	if(rand()%2)
+	{
+		// the planes of a perspective camera
+		gfxGetPerspectiveProjectionMatrix(20.0f+(float)(rand()%100), 0.5f+(float)(rand()%200)/100.0f,
+			0.1f+(float)(rand()%10), 50.0f+(float)(rand()%200), proj);
+		gfxMatrix4SetIdentity(modl);
+		gfxGetFrustum(proj, modl, frustum);
+
+		// move the planes around instead of building a view matrix
+		for(i = 0; i < 6; i++) frustum[i][3] += randomFloat(20.0f);
+		return;
+	}
+
+	// arbitrary planes, some with normals on an axis to hit the equal cases
+	for(i = 0; i < 6; i++)
+	{
+		for(j = 0; j < 4; j++) frustum[i][j] = randomFloat(j == 3 ? 50.0f : 1.0f);
+		if(rand()%8 == 0) frustum[i][rand()%3] = 0.0f;
+	}
+}
+
+int main()
+{
+	static float aabbs[MAX_BOXES*6+24];
+	static float mins[MAX_BOXES][3];
+	static float maxs[MAX_BOXES][3];
+	static int visible[MAX_BOXES];
+	float frustum[6][4];
+	float center, extent;
+	int round, i, j, k;
+	int count, visibleCount;
+	int tested = 0;
+	int failed = 0;
+	unsigned char inside, batched;
+
+	srand(1);
+
+	for(round = 0; round < ROUNDS; round++)
+	{
+		randomFrustum(frustum);
+
+		count = rand()%MAX_BOXES+1;
+		for(i = 0; i < count; i++)
+		{
+			for(j = 0; j < 3; j++)
+			{
+				// flat and point boxes are common for sprites and lights
+				center = randomFloat(60.0f);
+				extent = rand()%4 == 0 ? 0.0f : (float)(rand()%1000)/100.0f;
+				mins[i][j] = center-extent;
+				maxs[i][j] = center+extent;
+				aabbs[(i/4)*24+j*4+i%4] = mins[i][j];
+				aabbs[(i/4)*24+12+j*4+i%4] = maxs[i][j];
+			}
+		}
+
+		visibleCount = gfxAabbsInsideFrustum(frustum, aabbs, count, visible);
+
+		for(i = 0, k = 0; i < count; i++)
+		{
+			inside = gfxAabbInsideFrustum(frustum, mins[i], maxs[i]);
+			batched = k < visibleCount && visible[k] == i;
+			if(batched) k++;
+
+			if(inside != batched)
+			{
+				if(failed < 10) printf("failed: round %d box %d, single %d batched %d\n", round, i, inside, batched);
+				failed++;
+			}
+			tested++;
+		}
+
+		if(k != visibleCount)
+		{
+			printf("failed: round %d returned %d boxes that are not in order or out of range\n", round, visibleCount-k);
+			failed++;
+		}
+	}
+
+	printf("%d boxes tested, %d mismatches\n", tested, failed);
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,294 @@
+// compiles every shader permutation with skinning turned on and checks that
+// vertices skinned by the shaders land where gfxSkinVertices puts them,
+// needs a GL context, under mesa it runs with LIBGL_ALWAYS_SOFTWARE=1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+#include "fixtures.h"
+
+#define SIZE		128
+#define EXTENT		4.0f
+#define BONES		4
+#define VERTICES	32
+
+static int textureMasks[] = {
+	0,
+	GFX_COLOR_MAP,
+	GFX_COLOR_MAP|GFX_NORMAL_MAP,
+	GFX_COLOR_MAP|GFX_NORMAL_MAP|GFX_HEIGHT_MAP,
+	GFX_COLOR_MAP|GFX_NORMAL_MAP|GFX_SPECULAR_MAP|GFX_DETAIL_MAP,
+	GFX_COLOR_MAP|GFX_SHADOW_MAP,
+	GFX_COLOR_MAP|GFX_LIGHT_MAP|GFX_CUBE_MAP,
+	GFX_COLOR_RAMP_MAP,
+	GFX_COLOR_MAP|GFX_NORMAL_MAP|GFX_HEIGHT_MAP|GFX_SPECULAR_MAP|GFX_DETAIL_MAP|GFX_SHADOW_MAP|GFX_COLOR_RAMP_MAP|GFX_LIGHT_MAP|GFX_CUBE_MAP
+};
+
+static gfxShaderProgram* getProgram(gfxShaderConfig* config)
+{
+	if(config->gbuffer) return gfxGetGbufShaderProgram(config);
+	return gfxGetShaderProgram(config);
+}
+
+// a permutation counts as broken only when it compiles without skinning and not with it
+static int testConfig(gfxShaderConfig* config, int* count)
+{
+	config->skin = GFX_FALSE;
+	if(!getProgram(config)) return 0;
+
+	(*count)++;
+	config->skin = GFX_TRUE;
+	if(getProgram(config)) return 0;
+
+	printf("failed: textures 0x%x light %d gbuffer %d specular %d vertex color %d fog %d\n",
+		config->textures, config->light, config->gbuffer, config->specular, config->vertexColor, config->fog);
+
+	return 1;
+}
+
+static int testPermutations()
+{
+	gfxShaderConfig config;
+	int i, light, specular, extra;
+	int count = 0;
+	int failed = 0;
+
+	for(i = 0; i < (int)(sizeof(textureMasks)/sizeof(int)); i++)
+	{
+		for(light = 0; light <= GFX_SPOT_LIGHT; light++)
+		{
+			for(specular = 0; specular < 2; specular++)
+			{
+				for(extra = 0; extra < 2; extra++)
+				{
+					memset(&config, 0x0, sizeof(gfxShaderConfig));
+					config.textures = textureMasks[i];
+					config.light = light;
+					config.specular = specular;
+					config.vertexColor = extra;
+					config.fog = extra;
+					failed += testConfig(&config, &count);
+				}
+			}
+		}
+
+		memset(&config, 0x0, sizeof(gfxShaderConfig));
+		config.textures = textureMasks[i];
+		config.gbuffer = GFX_GBUFFER_DEPTH;
+		failed += testConfig(&config, &count);
+
+		config.gbuffer = GFX_GBUFFER_FILL;
+		for(specular = 0; specular < 2; specular++)
+		{
+			config.specular = specular;
+			failed += testConfig(&config, &count);
+		}
+	}
+
+	printf("skinned permutations: %d compiled, %d failed\n", count-failed, failed);
+
+	return failed;
+}
+
+static void buildPalette(float* palette)
+{
+	float axis[3];
+	float len, angle, s, c, t;
+	float* mat;
+	int i;
+
+	for(i = 0; i < BONES; i++)
+	{
+		mat = &palette[i*16];
+
+		axis[0] = randomRange(-1.0f, 1.0f);
+		axis[1] = randomRange(-1.0f, 1.0f);
+		axis[2] = randomRange(-1.0f, 1.0f);
+		len = (float)sqrt(axis[0]*axis[0]+axis[1]*axis[1]+axis[2]*axis[2]);
+		axis[0] /= len; axis[1] /= len; axis[2] /= len;
+		angle = randomRange(-3.0f, 3.0f);
+		s = (float)sin(angle); c = (float)cos(angle); t = 1.0f-c;
+
+		mat[0] = t*axis[0]*axis[0]+c;
+		mat[1] = t*axis[0]*axis[1]+s*axis[2];
+		mat[2] = t*axis[0]*axis[2]-s*axis[1];
+		mat[4] = t*axis[0]*axis[1]-s*axis[2];
+		mat[5] = t*axis[1]*axis[1]+c;
+		mat[6] = t*axis[1]*axis[2]+s*axis[0];
+		mat[8] = t*axis[0]*axis[2]+s*axis[1];
+		mat[9] = t*axis[1]*axis[2]-s*axis[0];
+		mat[10] = t*axis[2]*axis[2]+c;
+		mat[12] = randomRange(-1.0f, 1.0f);
+		mat[13] = randomRange(-1.0f, 1.0f);
+		mat[14] = randomRange(-1.0f, 1.0f);
+		mat[3] = mat[7] = mat[11] = 0.0f;
+		mat[15] = 1.0f;
+	}
+}
+
+static int findLitPixel(unsigned char* pixels, int* x, int* y)
+{
+	int i, j;
+
+	for(i = 0; i < SIZE; i++)
+	{
+		for(j = 0; j < SIZE; j++)
+		{
+			if(pixels[(i*SIZE+j)*4] > 127)
+			{
+				*x = j;
+				*y = i;
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int testRendering()
+{
+	float palette[BONES*16];
+	float vertices[VERTICES*3];
+	float normals[VERTICES*3];
+	float weights[VERTICES*4];
+	int boneids[VERTICES*4];
+	float skinned[VERTICES*3];
+	float skinnedNormals[VERTICES*3];
+	unsigned char* pixels;
+	gfxShaderParams shaderParams;
+	gfxVertexArray* vertexArray;
+	gfxVertexData* data[4];
+	float sum;
+	int i, j, x, y, ex, ey;
+	int failed = 0;
+
+	buildPalette(palette);
+
+	for(i = 0; i < VERTICES; i++)
+	{
+		vertices[i*3] = randomRange(-1.0f, 1.0f);
+		vertices[i*3+1] = randomRange(-1.0f, 1.0f);
+		vertices[i*3+2] = randomRange(-1.0f, 1.0f);
+		normals[i*3] = 0.0f; normals[i*3+1] = 0.0f; normals[i*3+2] = 1.0f;
+
+		sum = 0.0f;
+		for(j = 0; j < 4; j++)
+		{
+			boneids[i*4+j] = rand()%BONES;
+			weights[i*4+j] = randomRange(0.0f, 1.0f);
+			// unused slots are loaded as the first bone with no weight
+			if(j > 0 && i%(j+1) == 0)
+			{
+				boneids[i*4+j] = 0;
+				weights[i*4+j] = 0.0f;
+			}
+			sum += weights[i*4+j];
+		}
+		for(j = 0; j < 4; j++) weights[i*4+j] /= sum;
+	}
+
+	gfxSkinVertices(palette, BONES, boneids, weights, vertices, normals, VERTICES, skinned, skinnedNormals);
+
+	gfxSetShaderParamsDefault(&shaderParams);
+	shaderParams.renderParams.depthTest = GFX_FALSE;
+	shaderParams.renderParams.cullFace = GFX_FALSE;
+	gfxSetColor(&shaderParams.materialParams.ambientColor, 1.0f, 1.0f, 1.0f, 1.0f);
+	gfxSetColor(&shaderParams.materialParams.specularColor, 0.0f, 0.0f, 0.0f, 0.0f);
+	gfxGetOrthographicProjectionMatrix(-EXTENT, EXTENT, -EXTENT, EXTENT, -10.0f, 10.0f, shaderParams.projectionMatrix);
+	shaderParams.bonePalette = palette;
+	shaderParams.boneCount = BONES;
+
+	pixels = (unsigned char*)malloc(SIZE*SIZE*4);
+	gfxSetViewport(0, 0, SIZE, SIZE);
+
+	for(i = 0; i < VERTICES; i++)
+	{
+		data[0] = gfxCreateVertexDataFromBuffer(3, GFX_FLOAT, GFX_VERTEX_DATA_STATIC, &vertices[i*3]);
+		data[1] = gfxCreateVertexDataFromBuffer(3, GFX_FLOAT, GFX_VERTEX_DATA_STATIC, &normals[i*3]);
+		data[2] = gfxCreateVertexDataFromBuffer(4, GFX_FLOAT, GFX_VERTEX_DATA_STATIC, &weights[i*4]);
+		data[3] = gfxCreateVertexDataFromBuffer(4, GFX_INT, GFX_VERTEX_DATA_STATIC, &boneids[i*4]);
+
+		vertexArray = gfxCreateVertexArray(GFX_FALSE);
+		gfxIncRef((gfxObject*)vertexArray);
+		gfxSetVertexArrayData(vertexArray, GFX_VERTEX, data[0]);
+		gfxSetVertexArrayData(vertexArray, GFX_NORMAL, data[1]);
+		gfxSetVertexArrayData(vertexArray, GFX_WEIGHTS, data[2]);
+		gfxSetVertexArrayData(vertexArray, GFX_BONEIDS, data[3]);
+
+		gfxClearBuffers(0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+		gfxSetShaderParams(&shaderParams);
+		gfxDrawVertexArray(vertexArray, 1, GFX_POINTS);
+		gfxReadPixels(0, 0, SIZE, SIZE, GFX_RGBA, GFX_UBYTE, pixels);
+
+		gfxDecRef((gfxObject*)vertexArray);
+
+		ex = (int)((skinned[i*3]+EXTENT)/(EXTENT*2.0f)*SIZE);
+		ey = (int)((skinned[i*3+1]+EXTENT)/(EXTENT*2.0f)*SIZE);
+
+		if(!findLitPixel(pixels, &x, &y))
+		{
+			printf("failed: vertex %d was not drawn, expected at %d %d\n", i, ex, ey);
+			failed++;
+		}
+		else if(abs(x-ex) > 1 || abs(y-ey) > 1)
+		{
+			printf("failed: vertex %d drawn at %d %d, expected at %d %d\n", i, x, y, ex, ey);
+			failed++;
+		}
+	}
+
+	free(pixels);
+
+	printf("skinned vertices: %d matched, %d failed\n", VERTICES-failed, failed);
+
+	return failed;
+}
+
+// a clear is only GL 1.1 calls, none of them goes through a function pointer glew loaded
+static int testGlCalls()
+{
+	gfxResetGlCalls();
+	gfxClearBuffers(0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+
+	if(gfxGetGlCalls() != 3)
+	{
+		printf("failed: a clear counted %d gl calls instead of 3\n", gfxGetGlCalls());
+		return 1;
+	}
+
+	return 0;
+}
+
+int main()
+{
+	elfConfig* config;
+	int failed;
+
+	config = elfCreateConfig();
+	elfSetConfigWindowSize(config, SIZE, SIZE);
+	elfSetConfigLogPath(config, "gpu_skinning.log");
+
+	if(!elfInit(config))
+	{
+		printf("could not initialize a gl context\n");
+		return 1;
+	}
+
+	srand(1);
+
+	failed = testPermutations();
+	failed += testRendering();
+	failed += testGlCalls();
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
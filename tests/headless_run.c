@@ -0,0 +1,99 @@
+// checks that a headless engine starts its job threads like a windowed one,
+// runs jobs on them and reports how many ticks a second a headless scene runs at
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+
+#define THREADS		4
+#define JOBS		256
+#define ENTITIES	2000
+#define TICKS		500
+
+static int results[JOBS];
+
+static void runJob(void* data)
+{
+	int* result = (int*)data;
+	int i;
+
+	for(i = 0; i < 10000; i++) *result += i%7;
+}
+
+static int testJobs()
+{
+	elfJobQueue* queue;
+	int i;
+	int failed = 0;
+
+	printf("job threads: %d\n", elfGetThreadCount());
+	if(elfGetThreadCount() != THREADS)
+	{
+		printf("failed: expected %d job threads\n", THREADS);
+		failed++;
+	}
+
+	// a queue of its own, its workers are glfw threads as well
+	queue = elfCreateJobQueue(THREADS);
+	elfIncRef((elfObject*)queue);
+
+	for(i = 0; i < JOBS; i++) elfAddJob(queue, runJob, &results[i]);
+	elfWaitJobs(queue);
+
+	elfDecRef((elfObject*)queue);
+
+	for(i = 0; i < JOBS; i++)
+	{
+		if(results[i] != 29994)
+		{
+			if(failed < 5) printf("failed: job %d gave %d\n", i, results[i]);
+			failed++;
+		}
+	}
+
+	return failed;
+}
+
+static void benchScene()
+{
+	elfScene* scene;
+	elfEntity* entity;
+	int i;
+
+	scene = elfCreateScene("headless");
+	elfSetScene(scene);
+
+	for(i = 0; i < ENTITIES; i++)
+	{
+		entity = elfCreateEntity("entity");
+		elfSetActorPosition((elfActor*)entity, (float)(i%50), (float)(i/50), 0.0f);
+		elfAddSceneEntity(scene, entity);
+	}
+
+	printf("%d entities: %.0f ticks a second\n", ENTITIES, elfBenchmark(TICKS));
+}
+
+int main()
+{
+	elfConfig* config;
+	int failed;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigThreadCount(config, THREADS);
+	elfSetConfigLogPath(config, "headless_run.log");
+
+	if(!elfInit(config)) return 1;
+
+	failed = testJobs();
+	benchScene();
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,222 @@
+// checks the baked curve keys against the points sorted by hand, also
+// after points are moved, and times sampling 1000 ipos of 500 keys a frame
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+#include "fixtures.h"
+
+#define CURVE_POINTS	200
+#define ACTORS		1000
+#define KEYS		500
+#define CHANNELS	7
+
+// keeps the timed loops from being optimized away
+static volatile float sink;
+
+// the expected value, the points sorted by hand and searched one by one
+static float getCurveValueBySorting(elfBezierCurve* curve, float x)
+{
+	elfBezierPoint* points[CURVE_POINTS+1];
+	elfBezierPoint* point;
+	int count, i, j;
+	float t;
+
+	count = elfGetListLength(curve->points);
+	for(i = 0; i < count; i++)
+	{
+		point = (elfBezierPoint*)elfGetListObject(curve->points, i);
+		for(j = i; j > 0 && points[j-1]->p.x > point->p.x; j--) points[j] = points[j-1];
+		points[j] = point;
+	}
+
+	if(x < points[0]->p.x) return points[0]->p.y;
+
+	for(i = 0; i < count-1; i++)
+	{
+		if(x >= points[i]->p.x && x < points[i+1]->p.x)
+		{
+			t = (x-points[i]->p.x)/(points[i+1]->p.x-points[i]->p.x);
+			return points[i]->p.y+(points[i+1]->p.y-points[i]->p.y)*t;
+		}
+	}
+
+	return points[count-1]->p.y;
+}
+
+// how curves were sampled before the keys were baked, walking the point list up to x
+static float getCurveValueByWalking(elfBezierCurve* curve, float x)
+{
+	elfBezierPoint* pnt;
+	elfBezierPoint* point1 = NULL;
+	elfBezierPoint* point2 = NULL;
+	float t;
+
+	for(pnt = (elfBezierPoint*)elfBeginList(curve->points); pnt;
+		pnt = (elfBezierPoint*)elfGetListNext(curve->points))
+	{
+		if(pnt->p.x > x)
+		{
+			point2 = pnt;
+			break;
+		}
+		point1 = pnt;
+	}
+
+	if(!point1) return point2 ? point2->p.y : 0.0f;
+	if(!point2) return point1->p.y;
+
+	t = (x-point1->p.x)/(point2->p.x-point1->p.x);
+	return point1->p.y+(point2->p.y-point1->p.y)*t;
+}
+
+static int compareCurve(elfBezierCurve* curve, const char* when)
+{
+	float x, expected, value;
+	int failed = 0;
+
+	for(x = -5.0f; x < 1105.0f; x += 0.37f)
+	{
+		expected = getCurveValueBySorting(curve, x);
+		value = elfGetBezierCurveValue(curve, x);
+		if(value != expected)
+		{
+			if(failed < 5) printf("failed %s: at %f got %f, expected %f\n", when, x, value, expected);
+			failed++;
+		}
+	}
+
+	return failed;
+}
+
+static int testCurve()
+{
+	elfBezierCurve* curve;
+	elfBezierPoint* point;
+	int i;
+	int failed = 0;
+
+	curve = elfCreateBezierCurve();
+	elfIncRef((elfObject*)curve);
+
+	// distinct positions so the order of points is well defined
+	for(i = 0; i < CURVE_POINTS; i++)
+	{
+		point = elfCreateBezierPoint();
+		elfSetBezierPointPosition(point, (float)((i*37)%CURVE_POINTS)*5.0f+1.0f, randomRange(0.0f, 10.0f));
+		elfAddBezierCurvePoint(curve, point);
+	}
+
+	failed += compareCurve(curve, "after adding");
+
+	// nudge some points, move others past their neighbours, then add one to the dirty curve
+	for(i = 0; i < CURVE_POINTS; i += 3)
+	{
+		point = elfGetPointFromBezierCurve(curve, i);
+		elfSetBezierPointPosition(point, point->p.x+(i%2 ? 2.5f : 312.5f), randomRange(0.0f, 10.0f));
+	}
+	point = elfCreateBezierPoint();
+	elfSetBezierPointPosition(point, 3.5f, 20.0f);
+	elfAddBezierCurvePoint(curve, point);
+
+	failed += compareCurve(curve, "after moving");
+
+	elfDecRef((elfObject*)curve);
+
+	printf("curve samples: %d failed\n", failed);
+
+	return failed;
+}
+
+static void benchIpos()
+{
+	elfIpo* ipos[ACTORS];
+	elfBezierCurve* curve;
+	elfBezierPoint* point;
+	float values[ELF_QUA_W+1];
+	float sum = 0.0f;
+	clock_t start;
+	double baked, walked;
+	int i, j, k, frame;
+
+	for(i = 0; i < ACTORS; i++)
+	{
+		ipos[i] = elfCreateIpo();
+		elfIncRef((elfObject*)ipos[i]);
+
+		for(j = 0; j < CHANNELS; j++)
+		{
+			curve = elfCreateBezierCurve();
+			elfSetBezierCurveType(curve, j < 3 ? ELF_LOC_X+j : ELF_QUA_X+j-3);
+			for(k = 0; k < KEYS; k++)
+			{
+				point = elfCreateBezierPoint();
+				elfSetBezierPointPosition(point, (float)k+1.0f, randomRange(0.0f, 1.0f));
+				elfAddBezierCurvePoint(curve, point);
+			}
+			elfAddIpoCurve(ipos[i], curve);
+		}
+	}
+
+	// every actor steps through the animation a frame at a time like the frame players do
+	start = clock();
+	for(frame = 1; frame <= KEYS; frame++)
+	{
+		for(i = 0; i < ACTORS; i++)
+		{
+			elfGetIpoValues(ipos[i], (float)frame+0.5f, values);
+			sum += values[ELF_LOC_X];
+		}
+	}
+	baked = (double)(clock()-start)/CLOCKS_PER_SEC;
+
+	// the walk is quadratic, a tenth of the frames is enough to time it
+	start = clock();
+	for(frame = 1; frame <= KEYS/10; frame++)
+	{
+		for(i = 0; i < ACTORS; i++)
+		{
+			for(j = 0; j < CHANNELS; j++)
+			{
+				curve = elfGetCurveFromIpo(ipos[i], j);
+				sum += getCurveValueByWalking(curve, (float)frame*10.0f+0.5f);
+			}
+		}
+	}
+	walked = (double)(clock()-start)/CLOCKS_PER_SEC*10.0;
+
+	sink = sum;
+
+	printf("%d actors, %d channels of %d keys: %.3f ms a frame baked, %.3f ms a frame walking the points\n",
+		ACTORS, CHANNELS, KEYS, baked*1000.0/KEYS, walked*1000.0/KEYS);
+
+	for(i = 0; i < ACTORS; i++) elfDecRef((elfObject*)ipos[i]);
+}
+
+int main()
+{
+	elfConfig* config;
+	int failed;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigLogPath(config, "ipo_curves.log");
+
+	if(!elfInit(config)) return 1;
+
+	srand(1);
+
+	failed = testCurve();
+	benchIpos();
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,211 @@
+// times scene updates and pre draws of skinned entities and particle emitters
+// with 1, 2, 4 and 8 job threads, and checks that every thread count ends up
+// with the same vertices and particles
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+#include "fixtures.h"
+
+#define BONES		32
+#define FRAMES		60
+#define VERTICES	6000
+#define ENTITIES	48
+#define EMITTERS	32
+#define PARTICLES	2000
+#define BENCH_FRAMES	60
+
+typedef struct scalingResult {
+	int threads;
+	double seconds;
+	unsigned int checksum;
+} scalingResult;
+
+static int threadCounts[] = {1, 2, 4, 8};
+
+// 0 in the config picks the processor count, the queue knows what it ended up with
+extern elfEngine* eng;
+
+static elfScene* createScene()
+{
+	elfScene* scene;
+	elfArmature* armature;
+	elfModel* model;
+	elfEntity* entity;
+	elfParticles* particles;
+	int i;
+
+	scene = elfCreateScene("job_scaling");
+	elfIncRef((elfObject*)scene);
+
+	armature = createArmature(BONES, FRAMES, 1);
+	model = createSkinnedModel(VERTICES, BONES);
+
+	for(i = 0; i < ENTITIES; i++)
+	{
+		entity = elfCreateEntity("entity");
+		elfSetEntityModel(entity, model);
+		elfSetEntityArmature(entity, armature);
+		elfAddSceneEntity(scene, entity);
+	}
+
+	for(i = 0; i < EMITTERS; i++)
+	{
+		particles = elfCreateParticles("particles", PARTICLES);
+		elfSetParticlesSpawnCount(particles, PARTICLES*10);
+		elfSetParticlesLifeSpan(particles, 0.5f, 2.0f);
+		elfSetParticlesGravity(particles, 0.0f, 0.0f, -9.8f);
+		elfSetParticlesVelocityMin(particles, -1.0f, -1.0f, 0.0f);
+		elfSetParticlesVelocityMax(particles, 1.0f, 1.0f, 5.0f);
+		elfAddSceneParticles(scene, particles);
+	}
+
+	return scene;
+}
+
+static unsigned int getChecksum(float* data, int count, unsigned int checksum)
+{
+	int i;
+
+	for(i = 0; i < count; i++) checksum = checksum*31+*(unsigned int*)&data[i];
+
+	return checksum;
+}
+
+static unsigned int getSceneChecksum(elfScene* scene)
+{
+	elfEntity* entity;
+	elfParticles* particles;
+	unsigned int checksum = 0;
+	int i;
+
+	for(i = 0; i < elfGetSceneEntityCount(scene); i++)
+	{
+		entity = elfGetSceneEntityByIndex(scene, i);
+		checksum = getChecksum((float*)gfxGetVertexDataBuffer(entity->vertices), entity->model->verticeCount*3, checksum);
+		checksum = getChecksum((float*)gfxGetVertexDataBuffer(entity->normals), entity->model->verticeCount*3, checksum);
+	}
+
+	for(particles = (elfParticles*)elfBeginList(scene->particles); particles;
+		particles = (elfParticles*)elfGetListNext(scene->particles))
+	{
+		checksum = getChecksum(particles->pool.positionX, particles->pool.count, checksum);
+		checksum = getChecksum(particles->pool.positionY, particles->pool.count, checksum);
+		checksum = getChecksum(particles->pool.positionZ, particles->pool.count, checksum);
+	}
+
+	return checksum;
+}
+
+static int runFrames(int threads, scalingResult* result)
+{
+	elfConfig* config;
+	elfScene* scene;
+	struct timeval start, end;
+	int i, frame;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigThreadCount(config, threads);
+	elfSetConfigLogPath(config, "job_scaling.log");
+
+	if(!elfInit(config)) return 1;
+
+	srand(1);
+
+	scene = createScene();
+
+	// every entity shows another frame each time, so every one of them is skinned again
+	gettimeofday(&start, NULL);
+	for(frame = 0; frame < BENCH_FRAMES; frame++)
+	{
+		for(i = 0; i < elfGetSceneEntityCount(scene); i++)
+			elfSetEntityArmatureFrame(elfGetSceneEntityByIndex(scene, i), (float)((frame+i)%FRAMES+1));
+
+		elfUpdateScene(scene, 1.0f/60.0f);
+		elfScenePreDraw(scene);
+		elfScenePostDraw(scene);
+	}
+	gettimeofday(&end, NULL);
+
+	result->threads = elfGetJobQueueThreadCount(eng->jobs);
+	result->seconds = (double)(end.tv_sec-start.tv_sec)+(double)(end.tv_usec-start.tv_usec)/1000000.0;
+	result->checksum = getSceneChecksum(scene);
+
+	elfDecRef((elfObject*)scene);
+	elfDeinit();
+
+	return 0;
+}
+
+// the job queue is sized when the engine starts, so every thread count gets a process of its own
+static int runChild(int threads, scalingResult* result)
+{
+	int fds[2];
+	int status;
+	pid_t pid;
+
+	memset(result, 0x0, sizeof(scalingResult));
+
+	if(pipe(fds)) return 1;
+
+	pid = fork();
+	if(pid < 0) return 1;
+
+	if(pid == 0)
+	{
+		close(fds[0]);
+		status = runFrames(threads, result);
+		if(write(fds[1], result, sizeof(scalingResult)) != sizeof(scalingResult)) status = 1;
+		close(fds[1]);
+		_exit(status);
+	}
+
+	close(fds[1]);
+	if(read(fds[0], result, sizeof(scalingResult)) != sizeof(scalingResult)) result->threads = -1;
+	close(fds[0]);
+
+	if(waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) return 1;
+
+	return WEXITSTATUS(status) || result->threads < 0;
+}
+
+int main()
+{
+	scalingResult results[sizeof(threadCounts)/sizeof(int)];
+	int i;
+	int failed = 0;
+
+	printf("%d skinned entities of %d vertices, %d emitters of %d particles, %ld processors\n",
+		ENTITIES, VERTICES, EMITTERS, PARTICLES, sysconf(_SC_NPROCESSORS_ONLN));
+
+	for(i = 0; i < (int)(sizeof(threadCounts)/sizeof(int)); i++)
+	{
+		if(runChild(threadCounts[i], &results[i]))
+		{
+			printf("failed: the run with %d threads didn't finish\n", threadCounts[i]);
+			return 1;
+		}
+
+		printf("%d threads: %.3f ms a frame, %.2fx the single thread\n", results[i].threads,
+			results[i].seconds*1000.0/BENCH_FRAMES, results[0].seconds/results[i].seconds);
+
+		if(results[i].checksum != results[0].checksum)
+		{
+			printf("failed: %d threads left other vertices or particles than one\n", threadCounts[i]);
+			failed++;
+		}
+	}
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+// checks the matrix palette skinning against the per bone quaternion
+// transform it replaced, and times gfxSkinVertices in skinned vertices a second
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+#include "fixtures.h"
+
+#define BONES		40
+#define FRAMES		30
+#define VERTICES	20000
+#define BENCH_VERTICES	200000
+#define BENCH_ROUNDS	20
+
+// the transform elfDeformEntityWithArmature did per bone and vertex before the palette
+static void skinWithQuaternions(elfArmature* armature, elfModel* model, float* vertices, float* normals)
+{
+	float* origVertices;
+	float* origNormals;
+	float* weights;
+	int* boneids;
+	float tempVec1[3];
+	float tempVec2[3];
+	elfBone* bone;
+	int i, j, k;
+	int id;
+
+	origVertices = (float*)gfxGetVertexDataBuffer(model->vertices);
+	origNormals = (float*)gfxGetVertexDataBuffer(model->normals);
+	weights = (float*)gfxGetVertexDataBuffer(model->weights);
+	boneids = (int*)gfxGetVertexDataBuffer(model->boneids);
+
+	for(i = 0; i < model->verticeCount; i++)
+	{
+		memset(&vertices[i*3], 0x0, sizeof(float)*3);
+		memset(&normals[i*3], 0x0, sizeof(float)*3);
+
+		for(j = 0; j < 4; j++)
+		{
+			id = boneids[i*4+j];
+			if(id < 0 || id > armature->boneCount-1 || !(bone = armature->bones[id])) continue;
+
+			tempVec1[0] = origVertices[i*3]-bone->pos.x;
+			tempVec1[1] = origVertices[i*3+1]-bone->pos.y;
+			tempVec1[2] = origVertices[i*3+2]-bone->pos.z;
+			gfxMulQuaVec(&bone->curOffsetQua.x, tempVec1, tempVec2);
+			tempVec2[0] += bone->pos.x+bone->curOffsetPos.x;
+			tempVec2[1] += bone->pos.y+bone->curOffsetPos.y;
+			tempVec2[2] += bone->pos.z+bone->curOffsetPos.z;
+
+			for(k = 0; k < 3; k++) vertices[i*3+k] += tempVec2[k]*weights[i*4+j];
+
+			gfxMulQuaVec(&bone->curOffsetQua.x, &origNormals[i*3], tempVec2);
+
+			for(k = 0; k < 3; k++) normals[i*3+k] += tempVec2[k]*weights[i*4+j];
+		}
+	}
+}
+
+static int testSkinning()
+{
+	elfArmature* armature;
+	elfModel* model;
+	elfEntity* entity;
+	float* vertices;
+	float* normals;
+	float* skinnedVertices;
+	float* skinnedNormals;
+	float* mat;
+	float err;
+	float maxErr = 0.0f;
+	int i, frame;
+	int failed = 0;
+
+	// every other id is left out, the palette keeps a slot for it. ids of missing bones
+	// and past the armature are skipped by both paths
+	armature = createArmature(BONES, FRAMES, 2);
+	model = createSkinnedModel(VERTICES, BONES*2+2);
+
+	entity = elfCreateEntity("entity");
+	elfIncRef((elfObject*)entity);
+	elfSetEntityModel(entity, model);
+	elfSetEntityArmature(entity, armature);
+
+	vertices = (float*)malloc(sizeof(float)*3*model->verticeCount);
+	normals = (float*)malloc(sizeof(float)*3*model->verticeCount);
+
+	for(frame = 1; frame <= FRAMES; frame += 7)
+	{
+		elfDeformEntityWithArmature(armature, entity, (float)frame+0.5f);
+		skinWithQuaternions(armature, model, vertices, normals);
+
+		skinnedVertices = (float*)gfxGetVertexDataBuffer(entity->vertices);
+		skinnedNormals = (float*)gfxGetVertexDataBuffer(entity->normals);
+
+		for(i = 0; i < model->verticeCount*3; i++)
+		{
+			err = (float)fabs(skinnedVertices[i]-vertices[i]);
+			if(err > maxErr) maxErr = err;
+			err = (float)fabs(skinnedNormals[i]-normals[i]);
+			if(err > maxErr) maxErr = err;
+		}
+
+		for(i = 0; i < entity->paletteSize; i++)
+		{
+			if(!armature->bones[i]) continue;
+			mat = &entity->palette[i*16];
+			if(mat[3] != 0.0f || mat[7] != 0.0f || mat[11] != 0.0f || mat[15] != 1.0f)
+			{
+				printf("failed: palette entry %d is not affine at frame %d\n", i, frame);
+				failed++;
+			}
+		}
+	}
+
+	printf("%d vertices, largest difference to the quaternion path %g\n", model->verticeCount, maxErr);
+	if(maxErr > 0.0001f) failed++;
+
+	free(vertices);
+	free(normals);
+	elfDecRef((elfObject*)entity);
+
+	return failed;
+}
+
+static void benchSkinning()
+{
+	float* palette;
+	float* vertices;
+	float* normals;
+	float* weights;
+	int* boneids;
+	float* outVertices;
+	float* outNormals;
+	clock_t start;
+	double seconds;
+	int i;
+
+	palette = (float*)malloc(sizeof(float)*16*BONES);
+	vertices = (float*)malloc(sizeof(float)*3*BENCH_VERTICES);
+	normals = (float*)malloc(sizeof(float)*3*BENCH_VERTICES);
+	weights = (float*)malloc(sizeof(float)*4*BENCH_VERTICES);
+	boneids = (int*)malloc(sizeof(int)*4*BENCH_VERTICES);
+	outVertices = (float*)malloc(sizeof(float)*3*BENCH_VERTICES);
+	outNormals = (float*)malloc(sizeof(float)*3*BENCH_VERTICES);
+
+	for(i = 0; i < 16*BONES; i++) palette[i] = randomFloat(1.0f);
+	for(i = 0; i < 3*BENCH_VERTICES; i++) { vertices[i] = randomFloat(5.0f); normals[i] = randomFloat(1.0f); }
+	for(i = 0; i < 4*BENCH_VERTICES; i++) { weights[i] = 0.25f; boneids[i] = rand()%BONES; }
+
+	start = clock();
+	for(i = 0; i < BENCH_ROUNDS; i++)
+	{
+		gfxSkinVertices(palette, BONES, boneids, weights, vertices, normals, BENCH_VERTICES, outVertices, outNormals);
+	}
+	seconds = (double)(clock()-start)/CLOCKS_PER_SEC;
+
+	printf("gfxSkinVertices: %.1f million skinned vertices a second\n", BENCH_VERTICES*BENCH_ROUNDS/seconds/1000000.0);
+
+	free(palette);
+	free(vertices);
+	free(normals);
+	free(weights);
+	free(boneids);
+	free(outVertices);
+	free(outNormals);
+}
+
+int main()
+{
+	elfConfig* config;
+	int failed;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigLogPath(config, "matrix_skinning.log");
+
+	if(!elfInit(config)) return 1;
+
+	srand(1);
+
+	failed = testSkinning();
+	benchSkinning();
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
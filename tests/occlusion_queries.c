@@ -0,0 +1,100 @@
+// checks that an entity hidden behind an occluder is culled by the
+// occlusion queries and comes back once the occluder moves away,
+// needs a GL context, under mesa it runs with LIBGL_ALWAYS_SOFTWARE=1
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+#include "fixtures.h"
+
+#define FRAMES		8
+
+static elfEntity* createEntity(elfScene* scene, elfModel* model, float x, float y, float z, float scale)
+{
+	elfEntity* entity;
+
+	entity = elfCreateEntity("box");
+	elfSetEntityModel(entity, model);
+	elfSetEntityScale(entity, scale, scale, scale);
+	elfSetActorPosition((elfActor*)entity, x, y, z);
+	elfAddSceneEntity(scene, entity);
+
+	return entity;
+}
+
+// runs frames until the entity is culled or drawn as expected, returns the frames it took or -1
+static int runUntil(elfEntity* entity, unsigned char culled)
+{
+	int i;
+
+	for(i = 1; i <= FRAMES; i++)
+	{
+		elfRun();
+		if(entity->culled == culled) return i;
+	}
+
+	return -1;
+}
+
+int main()
+{
+	elfConfig* config;
+	elfScene* scene;
+	elfCamera* camera;
+	elfModel* model;
+	elfEntity* occluder;
+	elfEntity* hidden;
+	elfEntity* beside;
+	int frames;
+	int failed = 0;
+
+	config = elfCreateConfig();
+	elfSetConfigWindowSize(config, 256, 256);
+	elfSetConfigLogPath(config, "occlusion_queries.log");
+
+	if(!elfInit(config))
+	{
+		printf("could not initialize a gl context\n");
+		return 1;
+	}
+
+	scene = elfCreateScene("occlusion");
+	elfSetScene(scene);
+	elfSetSceneOcclusionCulling(scene, ELF_TRUE);
+
+	camera = elfCreateCamera("camera");
+	elfAddSceneCamera(scene, camera);
+	elfSetSceneActiveCamera(scene, camera);
+
+	model = createBox();
+	occluder = createEntity(scene, model, 0.0f, 0.0f, -10.0f, 1.0f);
+	elfSetEntityOccluder(occluder, ELF_TRUE);
+	hidden = createEntity(scene, model, 0.0f, 0.0f, -40.0f, 1.0f);
+	beside = createEntity(scene, model, 10.0f, 0.0f, -40.0f, 1.0f);
+
+	frames = runUntil(hidden, ELF_TRUE);
+	printf("hidden entity culled after %d frames\n", frames);
+	if(frames < 0) failed++;
+
+	if(beside->culled)
+	{
+		printf("failed: the entity beside the occluder is culled\n");
+		failed++;
+	}
+
+	// the occluder stays in view so the queries keep running
+	elfSetActorPosition((elfActor*)occluder, -2.5f, 0.0f, -10.0f);
+
+	frames = runUntil(hidden, ELF_FALSE);
+	printf("hidden entity drawn again after %d frames\n", frames);
+	if(frames < 0) failed++;
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
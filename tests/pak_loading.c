@@ -0,0 +1,241 @@
+// loads the same scene with paks read through stdio and with paks mapped,
+// checks that both give the same vertex data and reports the load time,
+// what is resident right after loading, once the mapped pages are dropped,
+// the peak resident memory and what stays resident once the arrays are used
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+
+#define MODELS		24
+#define VERTICES	60000
+#define PAK_PATH	"pak_loading.pak"
+
+typedef struct loadResult {
+	double seconds;
+	long loadedKb;
+	long peakKb;
+	long residentKb;
+	int models;
+	unsigned int checksum;
+} loadResult;
+
+static unsigned char initEngine(unsigned char mapPaks)
+{
+	elfConfig* config;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigMapPaks(config, mapPaks);
+	elfSetConfigLogPath(config, "pak_loading.log");
+
+	return elfInit(config);
+}
+
+static elfModel* createModel(int seed)
+{
+	elfMeshData* meshData;
+	elfVertex* vertex;
+	elfModel* model;
+	int i;
+
+	meshData = elfCreateMeshData();
+	elfIncRef((elfObject*)meshData);
+
+	for(i = 0; i < VERTICES; i++)
+	{
+		vertex = elfCreateVertex();
+		vertex->position.x = (float)((i*7+seed)%1000)/100.0f;
+		vertex->position.y = (float)((i*13+seed)%1000)/100.0f;
+		vertex->position.z = (float)((i*17+seed)%1000)/100.0f;
+		vertex->normal.z = 1.0f;
+		vertex->texCoord.x = (float)(i%100)/100.0f;
+		vertex->texCoord.y = (float)(seed%100)/100.0f;
+		elfAddMeshDataVertex(meshData, vertex);
+	}
+	for(i = 0; i+2 < VERTICES; i += 3) elfAddMeshDataFace(meshData, i, i+1, i+2);
+
+	model = elfCreateModelFromMeshData(meshData);
+	elfDecRef((elfObject*)meshData);
+
+	return model;
+}
+
+static int saveScene()
+{
+	elfScene* scene;
+	elfEntity* entity;
+	char name[32];
+	int i;
+
+	if(!initEngine(ELF_FALSE)) return 1;
+
+	scene = elfCreateScene("pak_loading");
+	elfIncRef((elfObject*)scene);
+
+	for(i = 0; i < MODELS; i++)
+	{
+		sprintf(name, "entity%d", i);
+		entity = elfCreateEntity(name);
+		elfSetEntityModel(entity, createModel(i));
+		elfAddSceneEntity(scene, entity);
+	}
+
+	if(!elfSaveScene(scene, PAK_PATH)) return 1;
+
+	elfDecRef((elfObject*)scene);
+	elfDeinit();
+
+	return 0;
+}
+
+static long getResidentKb()
+{
+	FILE* file;
+	long size = 0;
+	long resident = 0;
+
+	file = fopen("/proc/self/statm", "r");
+	if(!file) return 0;
+	if(fscanf(file, "%ld %ld", &size, &resident) != 2) resident = 0;
+	fclose(file);
+
+	return resident*(sysconf(_SC_PAGESIZE)/1024);
+}
+
+static unsigned int getChecksum(gfxVertexData* data)
+{
+	unsigned char* bytes;
+	unsigned int checksum = 0;
+	int i;
+
+	if(!data) return 0;
+
+	bytes = (unsigned char*)gfxGetVertexDataBuffer(data);
+	for(i = 0; i < gfxGetVertexDataSizeBytes(data); i++) checksum = checksum*31+bytes[i];
+
+	return checksum;
+}
+
+static int loadScene(unsigned char mapPaks, loadResult* result)
+{
+	elfScene* scene;
+	elfEntity* entity;
+	elfModel* model;
+	struct timeval start, end;
+	struct rusage usage;
+	int i, j;
+
+	if(!initEngine(mapPaks)) return 1;
+
+	gettimeofday(&start, NULL);
+	scene = elfCreateSceneFromFile("pak_loading", PAK_PATH);
+	gettimeofday(&end, NULL);
+	if(!scene) return 1;
+
+	elfIncRef((elfObject*)scene);
+
+	result->seconds = (double)(end.tv_sec-start.tv_sec)+(double)(end.tv_usec-start.tv_usec)/1000000.0;
+	result->loadedKb = getResidentKb();
+
+	// reads every array like the buffer uploads and the physics meshes do before the memory is measured
+	for(i = 0; i < elfGetSceneEntityCount(scene); i++)
+	{
+		entity = elfGetSceneEntityByIndex(scene, i);
+		if(!(model = entity->model)) continue;
+
+		result->models++;
+		result->checksum = result->checksum*31+getChecksum(model->vertices);
+		result->checksum = result->checksum*31+getChecksum(model->normals);
+		result->checksum = result->checksum*31+getChecksum(model->texCoords);
+		for(j = 0; j < model->areaCount; j++)
+			result->checksum = result->checksum*31+getChecksum(model->areas[j].index);
+	}
+
+	getrusage(RUSAGE_SELF, &usage);
+	result->peakKb = usage.ru_maxrss;
+	result->residentKb = getResidentKb();
+
+	elfDecRef((elfObject*)scene);
+	elfDeinit();
+
+	return 0;
+}
+
+// every step runs in a process of its own so the memory numbers don't carry over
+static int runChild(int step, loadResult* result)
+{
+	int fds[2];
+	int status;
+	pid_t pid;
+
+	memset(result, 0x0, sizeof(loadResult));
+
+	if(pipe(fds)) return 1;
+
+	pid = fork();
+	if(pid < 0) return 1;
+
+	if(pid == 0)
+	{
+		close(fds[0]);
+		status = step < 0 ? saveScene() : loadScene((unsigned char)step, result);
+		if(write(fds[1], result, sizeof(loadResult)) != sizeof(loadResult)) status = 1;
+		close(fds[1]);
+		_exit(status);
+	}
+
+	close(fds[1]);
+	if(read(fds[0], result, sizeof(loadResult)) != sizeof(loadResult)) result->models = -1;
+	close(fds[0]);
+
+	if(waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) return 1;
+
+	return WEXITSTATUS(status) || result->models < 0;
+}
+
+int main()
+{
+	loadResult saved, readPak, mappedPak;
+	int failed = 0;
+
+	if(runChild(-1, &saved))
+	{
+		printf("could not save the scene\n");
+		return 1;
+	}
+
+	failed += runChild(ELF_FALSE, &readPak);
+	failed += runChild(ELF_TRUE, &mappedPak);
+
+	printf("%d models of %d vertices\n", MODELS, VERTICES);
+	printf("read:   %.1f ms, loaded %ld kb, peak %ld kb, resident %ld kb\n",
+		readPak.seconds*1000.0, readPak.loadedKb, readPak.peakKb, readPak.residentKb);
+	printf("mapped: %.1f ms, loaded %ld kb, peak %ld kb, resident %ld kb\n",
+		mappedPak.seconds*1000.0, mappedPak.loadedKb, mappedPak.peakKb, mappedPak.residentKb);
+
+	if(readPak.models != MODELS || mappedPak.models != MODELS)
+	{
+		printf("failed: loaded %d models read and %d mapped\n", readPak.models, mappedPak.models);
+		failed++;
+	}
+	if(readPak.checksum != mappedPak.checksum)
+	{
+		printf("failed: the mapped vertex data differs from the data read\n");
+		failed++;
+	}
+
+	remove(PAK_PATH);
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
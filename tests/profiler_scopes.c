@@ -0,0 +1,266 @@
+// checks that a profiled headless run records every scripted actor inside the
+// scene update, that the scopes nest and that the trace file has an event for
+// each of them, then times the same scene with profiling off and on
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+
+#define ACTORS		100
+#define FRAMES		10
+#define BENCH_ACTORS	100
+#define BENCH_TICKS	2000
+#define BENCH_SCOPES	100
+#define BENCH_FRAMES	20000
+#define TRACE_PATH	"profiler_scopes.json"
+
+// the trace is checked against the recorded frames and the scope timing drives them by hand
+extern elfEngine* eng;
+
+static const char* stepText =
+	"local p = GetActorPosition(me)\n"
+	"SetActorPosition(me, p.x, p.y, p.z+1.0)\n";
+
+static elfScene* createScene(int count)
+{
+	elfScene* scene;
+	elfScript* script;
+	elfEntity* entity;
+	char name[32];
+	int i;
+
+	scene = elfCreateScene("profiler_scopes");
+
+	script = elfCreateScript("step");
+	elfSetScriptText(script, stepText);
+
+	for(i = 0; i < count; i++)
+	{
+		sprintf(name, "e%d", i);
+		entity = elfCreateEntity(name);
+		elfSetActorScript((elfActor*)entity, script);
+		elfAddSceneEntity(scene, entity);
+	}
+
+	return scene;
+}
+
+static int findScope(const char* name)
+{
+	int i;
+
+	for(i = 0; i < elfGetProfileScopeCount(); i++)
+	{
+		if(!strcmp(elfGetProfileScopeName(i), name)) return i;
+	}
+
+	return -1;
+}
+
+static int testScopes()
+{
+	elfProfileFrame* frame;
+	char name[32];
+	int update, idx, parent;
+	int i;
+	int failed = 0;
+
+	for(i = 0; i < FRAMES; i++) elfRun();
+
+	if(elfGetProfileFrameCount() != FRAMES)
+	{
+		printf("failed: %d frames recorded instead of %d\n", elfGetProfileFrameCount(), FRAMES);
+		failed++;
+	}
+
+	update = findScope("update scene");
+	if(update < 0)
+	{
+		printf("failed: no update scene scope\n");
+		return failed+1;
+	}
+
+	for(i = 0; i < ACTORS; i++)
+	{
+		sprintf(name, "e%d", i);
+		idx = findScope(name);
+		if(idx < 0 || elfGetProfileScopeDepth(idx) <= elfGetProfileScopeDepth(update))
+		{
+			if(failed < 5) printf("failed: actor %s is missing or not inside the scene update\n", name);
+			failed++;
+		}
+	}
+
+	// every scope lies inside the closest one before it that is a level up
+	frame = elfGetLastProfileFrame();
+	for(i = 0; i < frame->scopeCount; i++)
+	{
+		if(frame->scopes[i].depth == 0) continue;
+
+		for(parent = i-1; parent >= 0 && frame->scopes[parent].depth != frame->scopes[i].depth-1; parent--);
+
+		if(parent < 0 || frame->scopes[i].start < frame->scopes[parent].start ||
+			frame->scopes[i].end > frame->scopes[parent].end)
+		{
+			if(failed < 5) printf("failed: scope %s is outside its parent\n", frame->scopes[i].name);
+			failed++;
+		}
+	}
+
+	printf("%d scopes in the last frame, update scene %.3f ms, %d failed\n",
+		elfGetProfileScopeCount(), elfGetProfileTime("update scene"), failed);
+
+	return failed;
+}
+
+static int countText(const char* text, const char* pattern)
+{
+	int count = 0;
+
+	while((text = strstr(text, pattern)))
+	{
+		count++;
+		text += strlen(pattern);
+	}
+
+	return count;
+}
+
+static int testTrace()
+{
+	FILE* file;
+	char* text;
+	long size;
+	int events, counters;
+	int expected;
+	int i;
+	int failed = 0;
+
+	if(!elfSaveProfileTrace(TRACE_PATH))
+	{
+		printf("failed: can't save the trace\n");
+		return 1;
+	}
+
+	file = fopen(TRACE_PATH, "rb");
+	if(!file) return 1;
+
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	text = (char*)malloc(size+1);
+	text[fread(text, 1, size, file)] = '\0';
+	fclose(file);
+
+	events = countText(text, "\"ph\":\"X\"");
+	counters = countText(text, "\"ph\":\"C\"");
+
+	// the fixed steps don't land on every frame, so the scopes are counted frame by frame
+	expected = 0;
+	for(i = 0; i < eng->profiler->frameCount; i++) expected += eng->profiler->frames[i].scopeCount+1;
+
+	if(strncmp(text, "{\"traceEvents\":[", 16) || !strstr(text, "]}") ||
+		events != expected || counters != FRAMES)
+	{
+		printf("failed: trace has %d events and %d counters, expected %d and %d\n", events, counters, expected, FRAMES);
+		failed++;
+	}
+
+	printf("trace: %d events, %d counters, %ld bytes\n", events, counters, size);
+
+	free(text);
+	remove(TRACE_PATH);
+
+	return failed;
+}
+
+// the disabled profiler is a branch per scope, the enabled one two clock reads
+static void benchScopes()
+{
+	struct timeval start, end;
+	double off, on;
+	int i, j;
+
+	elfSetProfiling(ELF_FALSE);
+	gettimeofday(&start, NULL);
+	for(i = 0; i < BENCH_FRAMES; i++)
+	{
+		elfBeginProfileFrame(eng->profiler);
+		for(j = 0; j < BENCH_SCOPES; j++)
+		{
+			elfBeginProfileScope("scope");
+			elfEndProfileScope();
+		}
+		elfEndProfileFrame(eng->profiler);
+	}
+	gettimeofday(&end, NULL);
+	off = (double)(end.tv_sec-start.tv_sec)*1000000000.0+(double)(end.tv_usec-start.tv_usec)*1000.0;
+
+	elfSetProfiling(ELF_TRUE);
+	gettimeofday(&start, NULL);
+	for(i = 0; i < BENCH_FRAMES; i++)
+	{
+		elfBeginProfileFrame(eng->profiler);
+		for(j = 0; j < BENCH_SCOPES; j++)
+		{
+			elfBeginProfileScope("scope");
+			elfEndProfileScope();
+		}
+		elfEndProfileFrame(eng->profiler);
+	}
+	gettimeofday(&end, NULL);
+	on = (double)(end.tv_sec-start.tv_sec)*1000000000.0+(double)(end.tv_usec-start.tv_usec)*1000.0;
+
+	printf("a scope: %.1f ns with profiling off, %.1f ns with it on\n",
+		off/(BENCH_FRAMES*BENCH_SCOPES), on/(BENCH_FRAMES*BENCH_SCOPES));
+}
+
+static void benchScene()
+{
+	float off, on;
+
+	elfSetScene(createScene(BENCH_ACTORS));
+
+	elfSetProfiling(ELF_FALSE);
+	off = elfBenchmark(BENCH_TICKS);
+	elfSetProfiling(ELF_TRUE);
+	on = elfBenchmark(BENCH_TICKS);
+	elfSetProfiling(ELF_FALSE);
+
+	printf("%d scripted actors: %.0f ticks a second with profiling off, %.0f with it on\n", BENCH_ACTORS, off, on);
+}
+
+int main()
+{
+	elfConfig* config;
+	int failed = 0;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigLogPath(config, "profiler_scopes.log");
+
+	if(!elfInit(config)) return 1;
+
+	elfSetScene(createScene(ACTORS));
+
+	elfSetProfiling(ELF_TRUE);
+	failed += testScopes();
+	failed += testTrace();
+	elfSetProfiling(ELF_FALSE);
+	elfClearProfile();
+
+	benchScopes();
+	benchScene();
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+// checks that entities drawing with the same model and materials get the same
+// state bits in their render keys and counts how many different combinations
+// end up sharing them, and that translucent entities sort after the opaque ones
+// from far to near
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+#include "fixtures.h"
+
+#define MODELS		64
+#define MATERIALS	8
+#define TEXTURES	16
+#define COPIES		3
+
+// the state part of an opaque key, everything above the depth
+static unsigned long long getStateKey(elfEntity* entity, gfxShaderParams* shaderParams)
+{
+	return elfGetEntityRenderKey(entity, 0, shaderParams)>>16;
+}
+
+// an opaque entity between two translucent ones, the sorted queue has to be opaque, far, near
+static int testTranslucentOrder(elfModel* model, elfMaterial* opaque, elfMaterial* translucent,
+	gfxShaderParams* shaderParams)
+{
+	elfEntity* entities[3];
+	elfRenderItem queue[3];
+	int i;
+	int failed = 0;
+
+	for(i = 0; i < 3; i++)
+	{
+		entities[i] = elfCreateEntity("entity");
+		elfIncRef((elfObject*)entities[i]);
+		elfAddEntityMaterial(entities[i], i == 1 ? opaque : translucent);
+		elfSetEntityModel(entities[i], model);
+		queue[i].entity = entities[i];
+	}
+
+	elfSetActorPosition((elfActor*)entities[0], 0.0f, 0.0f, -10.0f);
+	elfSetActorPosition((elfActor*)entities[1], 0.0f, 0.0f, -30.0f);
+	elfSetActorPosition((elfActor*)entities[2], 0.0f, 0.0f, -50.0f);
+
+	// the key reads the position the entity caches before it's drawn
+	for(i = 0; i < 3; i++) elfEntityPreDraw(entities[i]);
+
+	for(i = 0; i < 3; i++) queue[i].key = elfGetEntityRenderKey(queue[i].entity, ELF_DRAW_WITH_LIGHTING, shaderParams);
+	qsort(queue, 3, sizeof(elfRenderItem), elfCompareRenderItems);
+
+	if(queue[0].entity != entities[1] || queue[1].entity != entities[2] || queue[2].entity != entities[0])
+	{
+		printf("failed: translucent entities aren't drawn after the opaque one from far to near\n");
+		failed++;
+	}
+
+	for(i = 0; i < 3; i++) elfDecRef((elfObject*)entities[i]);
+
+	return failed;
+}
+
+int main()
+{
+	elfConfig* config;
+	elfImage* image;
+	elfModel* models[MODELS];
+	elfMaterial* materials[MATERIALS];
+	elfMaterial* translucent;
+	elfTexture* textures[TEXTURES];
+	elfEntity* entities[MODELS*MATERIALS][COPIES];
+	unsigned long long keys[MODELS*MATERIALS];
+	gfxShaderParams shaderParams;
+	int i, j;
+	int shared = 0;
+	int failed = 0;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigLogPath(config, "render_keys.log");
+
+	if(!elfInit(config)) return 1;
+
+	gfxSetShaderParamsDefault(&shaderParams);
+	gfxMatrix4SetIdentity(shaderParams.cameraMatrix);
+	shaderParams.clipEnd = 100.0f;
+
+	image = elfCreateEmptyImage(4, 4, 24);
+	elfIncRef((elfObject*)image);
+	for(i = 0; i < TEXTURES; i++)
+	{
+		textures[i] = elfCreateTextureFromImage("texture", image);
+		elfIncRef((elfObject*)textures[i]);
+	}
+	elfDecRef((elfObject*)image);
+
+	for(i = 0; i < MATERIALS; i++)
+	{
+		materials[i] = elfCreateMaterial("material");
+		elfIncRef((elfObject*)materials[i]);
+		elfSetMaterialDiffuseMap(materials[i], textures[i%TEXTURES]);
+		elfSetMaterialNormalMap(materials[i], textures[(i*5+3)%TEXTURES]);
+	}
+
+	for(i = 0; i < MODELS; i++)
+	{
+		models[i] = createTriangle();
+		elfIncRef((elfObject*)models[i]);
+	}
+
+	for(i = 0; i < MODELS*MATERIALS; i++)
+	{
+		for(j = 0; j < COPIES; j++)
+		{
+			entities[i][j] = elfCreateEntity("entity");
+			elfIncRef((elfObject*)entities[i][j]);
+			// the material goes first, otherwise the model gives the entity one of its own
+			elfAddEntityMaterial(entities[i][j], materials[i%MATERIALS]);
+			elfSetEntityModel(entities[i][j], models[i/MATERIALS]);
+			elfSetActorPosition((elfActor*)entities[i][j], 0.0f, 0.0f, -(float)(j*10+1));
+		}
+
+		keys[i] = getStateKey(entities[i][0], &shaderParams);
+
+		// copies only differ in depth, they have to stay together when the queue is sorted
+		for(j = 1; j < COPIES; j++)
+		{
+			if(getStateKey(entities[i][j], &shaderParams) != keys[i])
+			{
+				if(failed < 5) printf("failed: copy %d of combination %d has another key\n", j, i);
+				failed++;
+			}
+		}
+	}
+
+	for(i = 0; i < MODELS*MATERIALS; i++)
+	{
+		for(j = 0; j < i; j++)
+		{
+			if(keys[i] == keys[j])
+			{
+				shared++;
+				break;
+			}
+		}
+	}
+
+	printf("%d combinations of model and material, %d share their state key with another\n",
+		MODELS*MATERIALS, shared);
+
+	translucent = elfCreateMaterial("translucent");
+	elfIncRef((elfObject*)translucent);
+	elfSetMaterialDiffuseColor(translucent, 1.0f, 1.0f, 1.0f, 0.5f);
+
+	failed += testTranslucentOrder(models[0], materials[0], translucent, &shaderParams);
+
+	elfDecRef((elfObject*)translucent);
+
+	for(i = 0; i < MODELS*MATERIALS; i++)
+		for(j = 0; j < COPIES; j++) elfDecRef((elfObject*)entities[i][j]);
+	for(i = 0; i < MODELS; i++) elfDecRef((elfObject*)models[i]);
+	for(i = 0; i < MATERIALS; i++) elfDecRef((elfObject*)materials[i]);
+	for(i = 0; i < TEXTURES; i++) elfDecRef((elfObject*)textures[i]);
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
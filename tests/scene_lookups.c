@@ -0,0 +1,177 @@
+// loads a scene of many entities sharing a few models and materials from a pak,
+// checks that every shared resource is loaded once and that a removed entity is
+// loaded again instead of found, and reports the load time
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+#include "fixtures.h"
+
+#define ENTITIES	20000
+#define MODELS		16
+#define MATERIALS	64
+#define PAK_PATH	"scene_lookups.pak"
+
+static int saveScene()
+{
+	elfScene* scene;
+	elfModel* models[MODELS];
+	elfMaterial* materials[MATERIALS];
+	elfEntity* entity;
+	char name[32];
+	int i;
+	int result;
+
+	scene = elfCreateScene("scene_lookups");
+	elfIncRef((elfObject*)scene);
+
+	for(i = 0; i < MODELS; i++)
+	{
+		sprintf(name, "model%d", i);
+		models[i] = createTriangle();
+		elfSetModelName(models[i], name);
+	}
+
+	for(i = 0; i < MATERIALS; i++)
+	{
+		sprintf(name, "material%d", i);
+		materials[i] = elfCreateMaterial(name);
+	}
+
+	for(i = 0; i < ENTITIES; i++)
+	{
+		sprintf(name, "entity%d", i);
+		entity = elfCreateEntity(name);
+		// the material goes first, otherwise the model gives the entity one of its own
+		elfAddEntityMaterial(entity, materials[i%MATERIALS]);
+		elfSetEntityModel(entity, models[i%MODELS]);
+		elfSetActorPosition((elfActor*)entity, (float)(i%200)*4.0f, (float)(i/200)*4.0f, 0.0f);
+		elfAddSceneEntity(scene, entity);
+	}
+
+	result = elfSaveScene(scene, PAK_PATH);
+
+	elfDecRef((elfObject*)scene);
+
+	return result;
+}
+
+static int checkScene(elfScene* scene)
+{
+	elfEntity* entity;
+	elfEntity* first[MATERIALS];
+	elfMaterial* material;
+	int i, idx;
+	int failed = 0;
+
+	if(elfGetSceneEntityCount(scene) != ENTITIES || elfGetListLength(scene->models) != MODELS ||
+		elfGetListLength(scene->materials) != MATERIALS)
+	{
+		printf("failed: loaded %d entities, %d models and %d materials, expected %d, %d and %d\n",
+			elfGetSceneEntityCount(scene), elfGetListLength(scene->models), elfGetListLength(scene->materials),
+			ENTITIES, MODELS, MATERIALS);
+		return 1;
+	}
+
+	memset(first, 0x0, sizeof(elfEntity*)*MATERIALS);
+
+	for(i = 0; i < ENTITIES; i++)
+	{
+		entity = elfGetSceneEntityByIndex(scene, i);
+		material = elfGetEntityMaterial(entity, 0);
+		if(!material || strncmp(material->name, "material", 8))
+		{
+			failed++;
+			continue;
+		}
+
+		// entities with the same material have to end up with the same object
+		idx = atoi(material->name+8)%MATERIALS;
+		if(!first[idx]) first[idx] = entity;
+		else if(elfGetEntityMaterial(first[idx], 0) != material) failed++;
+	}
+
+	if(failed) printf("failed: %d entities have a material other than the one loaded first\n", failed);
+
+	return failed;
+}
+
+static int checkReload(elfScene* scene)
+{
+	elfEntity* entity;
+	int failed = 0;
+
+	entity = elfGetSceneEntity(scene, "entity7");
+
+	if(elfGetOrLoadEntityByName(scene, "entity7") != entity)
+	{
+		printf("failed: a loaded entity is looked up again instead of found\n");
+		failed++;
+	}
+
+	// the index still points at the removed entity, which is gone once the scene lets go of it
+	elfRemoveSceneEntity(scene, "entity7");
+
+	entity = elfGetOrLoadEntityByName(scene, "entity7");
+	if(!entity || elfGetSceneEntity(scene, "entity7") != entity || elfGetSceneEntityCount(scene) != ENTITIES)
+	{
+		printf("failed: a removed entity isn't loaded again\n");
+		failed++;
+	}
+
+	return failed;
+}
+
+int main()
+{
+	elfConfig* config;
+	elfScene* scene;
+	struct timeval start, end;
+	int failed = 0;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigLogPath(config, "scene_lookups.log");
+
+	if(!elfInit(config)) return 1;
+
+	if(!saveScene())
+	{
+		printf("failed: can't save \"%s\"\n", PAK_PATH);
+		elfDeinit();
+		return 1;
+	}
+
+	gettimeofday(&start, NULL);
+	scene = elfCreateSceneFromFile("scene_lookups", PAK_PATH);
+	gettimeofday(&end, NULL);
+
+	if(!scene)
+	{
+		printf("failed: can't load \"%s\"\n", PAK_PATH);
+		elfDeinit();
+		return 1;
+	}
+	elfIncRef((elfObject*)scene);
+
+	printf("%d entities, %d models, %d materials: loaded in %.1f ms\n", ENTITIES, MODELS, MATERIALS,
+		(double)(end.tv_sec-start.tv_sec)*1000.0+(double)(end.tv_usec-start.tv_usec)/1000.0);
+
+	failed += checkScene(scene);
+	failed += checkReload(scene);
+
+	elfDecRef((elfObject*)scene);
+
+	elfDeinit();
+
+	remove(PAK_PATH);
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
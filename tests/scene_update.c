@@ -0,0 +1,142 @@
+// checks that every actor is updated once a frame while scripts remove actors
+// in front of, at and behind the one being updated, and times scene updates
+// of 50000 actors
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+
+#define ACTORS		100
+#define BENCH_ACTORS	50000
+#define BENCH_FRAMES	100
+
+static const char* stepText =
+	"local p = GetActorPosition(me)\n"
+	"SetActorPosition(me, p.x, p.y, p.z+1.0)\n";
+
+static elfScript* createScript(const char* name, const char* text)
+{
+	elfScript* script;
+
+	script = elfCreateScript(name);
+	elfSetScriptText(script, text);
+
+	return script;
+}
+
+static void addEntities(elfScene* scene, int count, elfScript* script)
+{
+	elfEntity* entity;
+	char name[32];
+	int i;
+
+	for(i = 0; i < count; i++)
+	{
+		sprintf(name, "e%d", i);
+		entity = elfCreateEntity(name);
+		elfSetActorPosition((elfActor*)entity, (float)i, 0.0f, 0.0f);
+		if(script) elfSetActorScript((elfActor*)entity, script);
+		elfAddSceneEntity(scene, entity);
+	}
+}
+
+static void setScript(elfScene* scene, const char* entityName, const char* text)
+{
+	elfSetActorScript((elfActor*)elfGetSceneEntity(scene, entityName), createScript(entityName, text));
+}
+
+static int testRemovals()
+{
+	elfScene* scene;
+	elfEntity* entity;
+	elfVec3f position;
+	int i, frame;
+	int failed = 0;
+
+	scene = elfCreateScene("removals");
+	elfSetScene(scene);
+
+	addEntities(scene, ACTORS, createScript("step", stepText));
+
+	// removes one that was updated already, which moves one that wasn't into its slot
+	setScript(scene, "e50", "RemoveSceneEntity(GetScene(), \"e10\")\n"
+		"local p = GetActorPosition(me)\nSetActorPosition(me, p.x, p.y, p.z+1.0)\n");
+	// removes itself
+	setScript(scene, "e60", "RemoveSceneEntity(GetScene(), \"e60\")\n");
+	// removes one that is still to come
+	setScript(scene, "e70", "RemoveSceneEntity(GetScene(), \"e80\")\n"
+		"local p = GetActorPosition(me)\nSetActorPosition(me, p.x, p.y, p.z+1.0)\n");
+	// removes two that were updated already in one go
+	setScript(scene, "e90", "RemoveSceneEntity(GetScene(), \"e20\")\nRemoveSceneEntity(GetScene(), \"e30\")\n"
+		"local p = GetActorPosition(me)\nSetActorPosition(me, p.x, p.y, p.z+1.0)\n");
+
+	for(frame = 1; frame <= 3; frame++)
+	{
+		elfUpdateScene(scene, 0.0f);
+
+		for(i = 0; i < elfGetSceneEntityCount(scene); i++)
+		{
+			entity = elfGetSceneEntityByIndex(scene, i);
+			position = elfGetActorPosition((elfActor*)entity);
+			if(position.z != (float)frame)
+			{
+				if(failed < 5) printf("failed: %s was updated %d times in %d frames\n", entity->name, (int)position.z, frame);
+				failed++;
+			}
+		}
+	}
+
+	if(elfGetSceneEntityCount(scene) != ACTORS-5)
+	{
+		printf("failed: %d entities left, expected %d\n", elfGetSceneEntityCount(scene), ACTORS-5);
+		failed++;
+	}
+
+	printf("removals: %d failed\n", failed);
+
+	return failed;
+}
+
+static void benchUpdate()
+{
+	elfScene* scene;
+	clock_t start;
+	double seconds;
+	int i;
+
+	scene = elfCreateScene("bench");
+	elfSetScene(scene);
+
+	addEntities(scene, BENCH_ACTORS, NULL);
+
+	start = clock();
+	for(i = 0; i < BENCH_FRAMES; i++) elfUpdateScene(scene, 0.0f);
+	seconds = (double)(clock()-start)/CLOCKS_PER_SEC;
+
+	printf("%d actors: %.3f ms a scene update\n", BENCH_ACTORS, seconds*1000.0/BENCH_FRAMES);
+}
+
+int main()
+{
+	elfConfig* config;
+	int failed;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigLogPath(config, "scene_update.log");
+
+	if(!elfInit(config)) return 1;
+
+	failed = testRemovals();
+	benchUpdate();
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+// times running the scripts of a few hundred actors a frame with the compiled
+// chunks elfRunScript keeps, against the luaL_dostring sequence elfUpdateActor
+// used before them, and checks that both move the actors the same way
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+
+#define ACTORS		300
+#define FRAMES		200
+
+// GetActor reads the actor being updated from the engine, the old sequence needs to set it too
+extern elfEngine* eng;
+
+static const char* stepText =
+	"local p = GetActorPosition(me)\n"
+	"local r = GetActorRotation(me)\n"
+	"if p.z < 100.0 then\n"
+	"	SetActorPosition(me, p.x, p.y+0.5, p.z+1.0)\n"
+	"else\n"
+	"	SetActorPosition(me, p.x, p.y, 0.0)\n"
+	"end\n"
+	"SetActorRotation(me, r.x, r.y, r.z+2.0)\n";
+
+static elfScene* createScene(elfScript* script)
+{
+	elfScene* scene;
+	elfEntity* entity;
+	char name[32];
+	int i;
+
+	scene = elfCreateScene("script_actors");
+	elfIncRef((elfObject*)scene);
+
+	for(i = 0; i < ACTORS; i++)
+	{
+		sprintf(name, "e%d", i);
+		entity = elfCreateEntity(name);
+		elfSetActorPosition((elfActor*)entity, (float)i, 0.0f, (float)(i%100));
+		elfSetActorScript((elfActor*)entity, script);
+		elfAddSceneEntity(scene, entity);
+	}
+
+	return scene;
+}
+
+// what elfUpdateActor did for every scripted actor before the scripts were compiled once
+static void runStrings(elfActor* actor)
+{
+	elfRunString("me = GetActor()");
+	elfRunString(actor->script->text);
+	elfRunString("me = nil");
+}
+
+static double runFrames(elfScene* scene, unsigned char compiled)
+{
+	elfActor* actor;
+	clock_t start;
+	int i, frame;
+
+	start = clock();
+	for(frame = 0; frame < FRAMES; frame++)
+	{
+		for(i = 0; i < elfGetSceneEntityCount(scene); i++)
+		{
+			actor = (elfActor*)elfGetSceneEntityByIndex(scene, i);
+			eng->actor = (elfObject*)actor;
+
+			if(compiled) elfRunScript(actor->script);
+			else runStrings(actor);
+
+			eng->actor = NULL;
+		}
+	}
+
+	return (double)(clock()-start)/CLOCKS_PER_SEC;
+}
+
+int main()
+{
+	elfConfig* config;
+	elfScript* script;
+	elfScene* before;
+	elfScene* after;
+	elfVec3f beforePos, afterPos;
+	double beforeSeconds, afterSeconds;
+	int i;
+	int failed = 0;
+
+	config = elfCreateConfig();
+	elfSetConfigHeadless(config, ELF_TRUE);
+	elfSetConfigLogPath(config, "script_actors.log");
+
+	if(!elfInit(config)) return 1;
+
+	script = elfCreateScript("step");
+	elfSetScriptText(script, stepText);
+	elfIncRef((elfObject*)script);
+
+	before = createScene(script);
+	after = createScene(script);
+
+	beforeSeconds = runFrames(before, ELF_FALSE);
+	afterSeconds = runFrames(after, ELF_TRUE);
+
+	for(i = 0; i < ACTORS; i++)
+	{
+		beforePos = elfGetActorPosition((elfActor*)elfGetSceneEntityByIndex(before, i));
+		afterPos = elfGetActorPosition((elfActor*)elfGetSceneEntityByIndex(after, i));
+		if(beforePos.x != afterPos.x || beforePos.y != afterPos.y || beforePos.z != afterPos.z) failed++;
+	}
+
+	printf("%d actors moved differently\n", failed);
+	printf("%d scripted actors: %.3f ms a frame compiling every run, %.3f ms a frame with compiled chunks\n",
+		ACTORS, beforeSeconds*1000.0/FRAMES, afterSeconds*1000.0/FRAMES);
+
+	elfDecRef((elfObject*)before);
+	elfDecRef((elfObject*)after);
+	elfDecRef((elfObject*)script);
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
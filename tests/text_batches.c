@@ -0,0 +1,140 @@
+// checks that a text list draws the same pixels every frame and after it scrolls
+// and times drawing a list's worth of strings, needs deffont.ttf next to the
+// program and a GL context, under mesa it runs with LIBGL_ALWAYS_SOFTWARE=1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+
+#define WIDTH		320
+#define HEIGHT		640
+#define ROWS		32
+#define ITEMS		48
+#define FRAMES		2000
+
+static unsigned char first[WIDTH*HEIGHT*4];
+static unsigned char pixels[WIDTH*HEIGHT*4];
+
+static void drawFrame(elfGui* gui, unsigned char* data)
+{
+	gfxClearBuffers(0.0f, 0.0f, 0.0f, 1.0f, 1.0f);
+	elfDrawGui(gui);
+	if(data) gfxReadPixels(0, 0, WIDTH, HEIGHT, GFX_RGBA, GFX_UBYTE, data);
+}
+
+static int testPixels(elfGui* gui, elfTextList* textList)
+{
+	int i;
+	int failed = 0;
+
+	drawFrame(gui, first);
+
+	for(i = 0; i < 3; i++) drawFrame(gui, NULL);
+	drawFrame(gui, pixels);
+	if(memcmp(first, pixels, sizeof(pixels)))
+	{
+		printf("failed: the list changed between frames\n");
+		failed++;
+	}
+
+	// scrolled rows take other strings to the same positions, then everything goes back
+	for(i = 1; i <= ITEMS-ROWS; i++)
+	{
+		elfSetTextListOffset(textList, i);
+		drawFrame(gui, NULL);
+	}
+	elfSetTextListOffset(textList, 0);
+	drawFrame(gui, pixels);
+	if(memcmp(first, pixels, sizeof(pixels)))
+	{
+		printf("failed: the list differs after scrolling back\n");
+		failed++;
+	}
+
+	printf("pixels: %d failed\n", failed);
+
+	return failed;
+}
+
+// the strings land left of the viewport, so the rasterizer drops them and what is left
+// is building and submitting them
+static void benchDraw(elfTextList* textList)
+{
+	gfxShaderParams shaderParams;
+	struct timeval start, end;
+	int i, j;
+
+	gfxSetShaderParamsDefault(&shaderParams);
+	shaderParams.renderParams.depthWrite = GFX_FALSE;
+	shaderParams.renderParams.depthTest = GFX_FALSE;
+	shaderParams.renderParams.blendMode = GFX_TRANSPARENT;
+	gfxSetViewport(0, 0, WIDTH, HEIGHT);
+	gfxGetOrthographicProjectionMatrix(0.0f, (float)WIDTH, 0.0f, (float)HEIGHT, -1.0f, 1.0f, shaderParams.projectionMatrix);
+
+	gettimeofday(&start, NULL);
+	for(i = 0; i < FRAMES; i++)
+	{
+		for(j = 0; j < ROWS; j++)
+			elfDrawString(elfGetTextListFont(textList), elfGetTextListItem(textList, j), -WIDTH*4, j*16, &shaderParams);
+	}
+	// reading a pixel back waits for the driver to get through the draws
+	gfxReadPixels(0, 0, 1, 1, GFX_RGBA, GFX_UBYTE, pixels);
+	gettimeofday(&end, NULL);
+
+	printf("%d strings: %.1f us a frame\n", ROWS,
+		((double)(end.tv_sec-start.tv_sec)*1000000.0+(double)(end.tv_usec-start.tv_usec))/FRAMES);
+}
+
+int main()
+{
+	elfConfig* config;
+	elfGui* gui;
+	elfTextList* textList;
+	char item[64];
+	int i;
+	int failed = 0;
+
+	config = elfCreateConfig();
+	elfSetConfigWindowSize(config, WIDTH, HEIGHT);
+	elfSetConfigLogPath(config, "text_batches.log");
+
+	if(!elfInit(config))
+	{
+		printf("can't initialize the engine\n");
+		return 1;
+	}
+
+	gui = elfCreateGui();
+	elfIncRef((elfObject*)gui);
+
+	textList = elfCreateTextList((elfGuiObject*)gui, "list", 0, 0, ROWS, WIDTH);
+	if(!elfGetTextListFont(textList))
+	{
+		printf("deffont.ttf not found, skipped\n");
+		elfDecRef((elfObject*)gui);
+		elfDeinit();
+		return 0;
+	}
+
+	for(i = 0; i < ITEMS; i++)
+	{
+		sprintf(item, "item %d: %s", i, i%3 ? "some text in a list" : "Another Row");
+		elfAddTextListItem(textList, item);
+	}
+
+	failed += testPixels(gui, textList);
+	benchDraw(textList);
+
+	elfDecRef((elfObject*)gui);
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,447 @@
+// checks that dxt blocks decode back close to the pixels they were made from and
+// to what the driver makes of them, that malformed block payloads are refused,
+// and times loading scenes with their textures saved as images and as blocks and
+// decoding the blocks where s3tc is missing,
+// needs a GL context, under mesa it runs with LIBGL_ALWAYS_SOFTWARE=1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <GL/glew.h>
+
+#include "gfx.h"
+#include "blendelf.h"
+#include "types.h"
+
+#define SIZE		64
+#define TEXTURES	8
+#define TEXTURE_SIZE	1024
+#define LOADS		3
+
+static void fillPixels(unsigned char* data, int width, int height, int bpp, int seed)
+{
+	unsigned char* pixel;
+	int x, y, dx, dy;
+
+	srand(seed);
+
+	// smooth ramps with a little noise on top, roughly what a photo or a painted map holds
+	for(y = 0; y < height; y++)
+	{
+		for(x = 0; x < width; x++)
+		{
+			pixel = &data[(y*width+x)*(bpp/8)];
+			pixel[0] = (unsigned char)(x*200/width+seed*7%40+rand()%12);
+			pixel[1] = (unsigned char)(y*240/height+rand()%12);
+			pixel[2] = (unsigned char)((x+y)*127/(width+height)+64+rand()%12);
+			if(bpp == 32)
+			{
+				dx = x-width/2;
+				dy = y-height/2;
+				pixel[3] = (unsigned char)((dx*dx+dy*dy)*255/(width*width/4+height*height/4+1));
+			}
+		}
+	}
+}
+
+static unsigned char* getLevel(unsigned char* blocks)
+{
+	// alpha flag, width, height, level count and the size of the first level come before it
+	return blocks+sizeof(int)*5;
+}
+
+static int testRoundTrip(int width, int height, int bpp)
+{
+	unsigned char* pixels;
+	unsigned char* blocks;
+	unsigned char* decoded;
+	int sizeBytes;
+	int bytes = bpp/8;
+	double error[4] = {0.0, 0.0, 0.0, 0.0};
+	int maxError = 0;
+	int d, i, c;
+	int failed = 0;
+
+	pixels = (unsigned char*)malloc(width*height*bytes);
+	decoded = (unsigned char*)malloc(width*height*bytes);
+	fillPixels(pixels, width, height, bpp, 1);
+
+	blocks = elfCompressImageData(pixels, width, height, bpp, &sizeBytes);
+	elfDecodeDxtLevel(getLevel(blocks), width, height, bpp == 32, decoded);
+
+	for(i = 0; i < width*height; i++)
+	{
+		for(c = 0; c < bytes; c++)
+		{
+			d = abs(pixels[i*bytes+c]-decoded[i*bytes+c]);
+			error[c] += d;
+			if(c < 3 && d > maxError) maxError = d;
+		}
+	}
+	for(c = 0; c < 4; c++) error[c] /= width*height;
+
+	printf("%dx%d %d bit round trip: mean error %.2f %.2f %.2f %.2f, largest color error %d\n",
+		width, height, bpp, error[0], error[1], error[2], error[3], maxError);
+
+	if(error[0] > 6.0 || error[1] > 6.0 || error[2] > 6.0 || error[3] > 2.0)
+	{
+		printf("failed: the decoded pixels are too far from the source\n");
+		failed++;
+	}
+
+	free(blocks);
+	free(decoded);
+	free(pixels);
+
+	return failed;
+}
+
+// the driver rounds the 565 expansion and the interpolated colors its own way, a step or two apart
+static int testDriver(elfScene* scene, int width, int height, int bpp)
+{
+	elfTexture* texture;
+	unsigned char* pixels;
+	unsigned char* blocks;
+	unsigned char* decoded;
+	unsigned char* driverPixels;
+	int sizeBytes;
+	int bytes = bpp/8;
+	int i;
+	int failed = 0;
+
+	if(!gfxIsTextureCompressionSupported())
+	{
+		printf("s3tc is not supported, the driver comparison is skipped\n");
+		return 0;
+	}
+
+	pixels = (unsigned char*)malloc(width*height*bytes);
+	decoded = (unsigned char*)malloc(width*height*bytes);
+	driverPixels = (unsigned char*)malloc(width*height*bytes);
+	fillPixels(pixels, width, height, bpp, 2);
+
+	blocks = elfCompressImageData(pixels, width, height, bpp, &sizeBytes);
+	elfDecodeDxtLevel(getLevel(blocks), width, height, bpp == 32, decoded);
+
+	texture = elfCreateTextureFromBlocks("driver", scene, (char*)blocks, sizeBytes);
+	if(!texture)
+	{
+		printf("failed: the blocks were not accepted\n");
+		failed++;
+	}
+	else
+	{
+		elfIncRef((elfObject*)texture);
+
+		gfxSetTexture(texture->texture, 0);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glGetTexImage(GL_TEXTURE_2D, 0, bpp == 32 ? GL_BGRA : GL_BGR, GL_UNSIGNED_BYTE, driverPixels);
+
+		for(i = 0; i < width*height*bytes; i++)
+		{
+			if(abs(decoded[i]-driverPixels[i]) > 2) failed++;
+		}
+
+		printf("%dx%d %d bit against the driver: %d channels differ\n", width, height, bpp, failed);
+
+		elfDecRef((elfObject*)texture);
+	}
+
+	free(blocks);
+	free(driverPixels);
+	free(decoded);
+	free(pixels);
+
+	return failed;
+}
+
+static int expectRefused(elfScene* scene, const char* what, unsigned char* blocks, int sizeBytes)
+{
+	elfTexture* texture;
+
+	texture = elfCreateTextureFromBlocks("malformed", scene, (char*)blocks, sizeBytes);
+	if(!texture) return 0;
+
+	printf("failed: blocks with %s were accepted\n", what);
+	elfDestroyTexture(texture);
+
+	return 1;
+}
+
+static int testMalformed(elfScene* scene)
+{
+	elfTexture* texture;
+	unsigned char pixels[SIZE*SIZE*3];
+	unsigned char* blocks;
+	unsigned char* longer;
+	int sizeBytes;
+	int value;
+	int failed = 0;
+
+	fillPixels(pixels, SIZE, SIZE, 24, 3);
+	blocks = elfCompressImageData(pixels, SIZE, SIZE, 24, &sizeBytes);
+
+	// the header claims twice the width, the first level holds the blocks of half of it
+	memcpy(&value, blocks+sizeof(int), sizeof(int));
+	value *= 2;
+	memcpy(blocks+sizeof(int), &value, sizeof(int));
+	failed += expectRefused(scene, "the wrong width", blocks, sizeBytes);
+	value /= 2;
+	memcpy(blocks+sizeof(int), &value, sizeof(int));
+
+	// the first level is short by a block and the second starts inside it
+	memcpy(&value, blocks+sizeof(int)*4, sizeof(int));
+	value -= 8;
+	memcpy(blocks+sizeof(int)*4, &value, sizeof(int));
+	failed += expectRefused(scene, "a short level", blocks, sizeBytes);
+	value += 8;
+	memcpy(blocks+sizeof(int)*4, &value, sizeof(int));
+
+	value = 2;
+	memcpy(blocks, &value, sizeof(int));
+	failed += expectRefused(scene, "an unknown alpha flag", blocks, sizeBytes);
+	value = 0;
+	memcpy(blocks, &value, sizeof(int));
+
+	failed += expectRefused(scene, "a missing byte", blocks, sizeBytes-1);
+
+	// a level past 1x1, the sizes are all right but there is nothing left to halve
+	longer = (unsigned char*)malloc(sizeBytes+sizeof(int)+8);
+	memcpy(longer, blocks, sizeBytes);
+	value = 8;
+	memcpy(longer+sizeBytes, &value, sizeof(int));
+	memset(longer+sizeBytes+sizeof(int), 0x0, 8);
+	memcpy(&value, longer+sizeof(int)*3, sizeof(int));
+	value++;
+	memcpy(longer+sizeof(int)*3, &value, sizeof(int));
+	failed += expectRefused(scene, "a level past 1x1", longer, sizeBytes+sizeof(int)+8);
+	free(longer);
+
+	texture = elfCreateTextureFromBlocks("untouched", scene, (char*)blocks, sizeBytes);
+	if(texture) elfDestroyTexture(texture);
+	else
+	{
+		printf("failed: the untouched blocks were refused\n");
+		failed++;
+	}
+
+	free(blocks);
+
+	printf("malformed blocks: %d failed\n", failed);
+
+	return failed;
+}
+
+static elfScene* createScene()
+{
+	elfScene* scene;
+	elfEntity* entity;
+	elfMaterial* material;
+	unsigned char* pixels;
+	char name[32];
+	char path[64];
+	int i;
+
+	scene = elfCreateScene("textures");
+	elfIncRef((elfObject*)scene);
+
+	pixels = (unsigned char*)malloc(TEXTURE_SIZE*TEXTURE_SIZE*3);
+
+	for(i = 0; i < TEXTURES; i++)
+	{
+		fillPixels(pixels, TEXTURE_SIZE, TEXTURE_SIZE, 24, i+10);
+		sprintf(path, "texture_compression%d.png", i);
+		elfSaveImageData(path, TEXTURE_SIZE, TEXTURE_SIZE, 24, pixels);
+
+		sprintf(name, "texture%d", i);
+		material = elfCreateMaterial(name);
+		elfSetMaterialDiffuseMap(material, elfCreateTextureFromFile(name, path));
+
+		sprintf(name, "entity%d", i);
+		entity = elfCreateEntity(name);
+		elfAddEntityMaterial(entity, material);
+		elfAddSceneEntity(scene, entity);
+	}
+
+	free(pixels);
+
+	return scene;
+}
+
+static int getLoadedTextureCount(elfScene* scene)
+{
+	elfEntity* entity;
+	elfTexture* texture;
+	int count = 0;
+	int i;
+
+	for(i = 0; i < elfGetSceneEntityCount(scene); i++)
+	{
+		entity = elfGetSceneEntityByIndex(scene, i);
+		if(!elfGetEntityMaterialCount(entity)) continue;
+
+		texture = elfGetMaterialDiffuseMap(elfGetEntityMaterial(entity, 0));
+		if(texture && texture->texture && gfxGetTextureWidth(texture->texture) == TEXTURE_SIZE) count++;
+	}
+
+	return count;
+}
+
+static double timeLoad(const char* filePath)
+{
+	elfScene* scene;
+	struct timeval start, end;
+	double seconds;
+	double best = 0.0;
+	int textures;
+	int i;
+
+	for(i = 0; i < LOADS; i++)
+	{
+		gettimeofday(&start, NULL);
+		scene = elfCreateSceneFromFile("textures", filePath);
+		gettimeofday(&end, NULL);
+		if(!scene) return -1.0;
+
+		elfIncRef((elfObject*)scene);
+		textures = getLoadedTextureCount(scene);
+		elfDecRef((elfObject*)scene);
+
+		if(textures != TEXTURES)
+		{
+			printf("failed: %s gave %d textures\n", filePath, textures);
+			return -1.0;
+		}
+
+		seconds = (double)(end.tv_sec-start.tv_sec)+(double)(end.tv_usec-start.tv_usec)/1000000.0;
+		if(i == 0 || seconds < best) best = seconds;
+	}
+
+	return best;
+}
+
+static long getFileSize(const char* filePath)
+{
+	FILE* file;
+	long size;
+
+	file = fopen(filePath, "rb");
+	if(!file) return 0;
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fclose(file);
+
+	return size;
+}
+
+static int benchLoad()
+{
+	elfScene* scene;
+	double images, blocks;
+	char path[64];
+	int i;
+	int failed = 0;
+
+	scene = createScene();
+
+	elfSetSaveTextureCompress(ELF_FALSE);
+	if(!elfSaveScene(scene, "texture_compression_images.pak")) failed++;
+	elfSetSaveTextureCompress(ELF_TRUE);
+	if(!elfSaveScene(scene, "texture_compression_blocks.pak")) failed++;
+
+	elfDecRef((elfObject*)scene);
+
+	images = timeLoad("texture_compression_images.pak");
+	blocks = timeLoad("texture_compression_blocks.pak");
+
+	if(failed || images < 0.0 || blocks < 0.0)
+	{
+		printf("failed: could not save or load the scenes\n");
+		failed++;
+	}
+	else
+	{
+		printf("%d textures of %dx%d, images: %.1f ms, %ld kb, blocks: %.1f ms, %ld kb\n",
+			TEXTURES, TEXTURE_SIZE, TEXTURE_SIZE,
+			images*1000.0, getFileSize("texture_compression_images.pak")/1024,
+			blocks*1000.0, getFileSize("texture_compression_blocks.pak")/1024);
+	}
+
+	for(i = 0; i < TEXTURES; i++)
+	{
+		sprintf(path, "texture_compression%d.png", i);
+		remove(path);
+	}
+	remove("texture_compression_images.pak");
+	remove("texture_compression_blocks.pak");
+
+	return failed;
+}
+
+// what a driver without s3tc costs on top of the upload, the top level decoded on the cpu
+static void benchDecode()
+{
+	unsigned char* pixels;
+	unsigned char* blocks;
+	unsigned char* decoded;
+	struct timeval start, end;
+	int sizeBytes;
+	int i;
+
+	pixels = (unsigned char*)malloc(TEXTURE_SIZE*TEXTURE_SIZE*3);
+	decoded = (unsigned char*)malloc(TEXTURE_SIZE*TEXTURE_SIZE*3);
+	fillPixels(pixels, TEXTURE_SIZE, TEXTURE_SIZE, 24, 4);
+	blocks = elfCompressImageData(pixels, TEXTURE_SIZE, TEXTURE_SIZE, 24, &sizeBytes);
+
+	gettimeofday(&start, NULL);
+	for(i = 0; i < TEXTURES; i++) elfDecodeDxtLevel(getLevel(blocks), TEXTURE_SIZE, TEXTURE_SIZE, ELF_FALSE, decoded);
+	gettimeofday(&end, NULL);
+
+	printf("decoding %d textures of %dx%d without s3tc: %.1f ms\n", TEXTURES, TEXTURE_SIZE, TEXTURE_SIZE,
+		(double)(end.tv_sec-start.tv_sec)*1000.0+(double)(end.tv_usec-start.tv_usec)/1000.0);
+
+	free(blocks);
+	free(decoded);
+	free(pixels);
+}
+
+int main()
+{
+	elfConfig* config;
+	elfScene* scene;
+	int failed = 0;
+
+	config = elfCreateConfig();
+	elfSetConfigWindowSize(config, SIZE, SIZE);
+	elfSetConfigLogPath(config, "texture_compression.log");
+
+	if(!elfInit(config))
+	{
+		printf("can't initialize the engine\n");
+		return 1;
+	}
+
+	scene = elfCreateScene("checks");
+	elfIncRef((elfObject*)scene);
+
+	failed += testRoundTrip(256, 256, 24);
+	failed += testRoundTrip(256, 256, 32);
+	failed += testRoundTrip(67, 45, 32);
+	failed += testDriver(scene, 256, 256, 24);
+	failed += testDriver(scene, 256, 256, 32);
+	failed += testDriver(scene, 67, 45, 32);
+	failed += testMalformed(scene);
+
+	elfDecRef((elfObject*)scene);
+
+	failed += benchLoad();
+	benchDecode();
+
+	elfDeinit();
+
+	printf(failed ? "FAILED\n" : "OK\n");
+
+	return failed ? 1 : 0;
+}